@@ -119,6 +119,10 @@ u64 AudioRenderer::GetRenderingStartTick(s32 session_id) const noexcept {
     return (1000 * command_buffers[session_id].render_time_taken_us) + signalled_tick;
 }
 
+std::chrono::microseconds AudioRenderer::GetOutputLatency() const noexcept {
+    return output_latency.load(std::memory_order_relaxed);
+}
+
 void AudioRenderer::CreateSinkStreams() {
     u32 channels{sink.GetDeviceChannels()};
     for (u32 i = 0; i < MaxRendererSessions; i++) {
@@ -199,6 +203,8 @@ void AudioRenderer::Main(std::stop_token stop_token) {
 
                     if (index == 0) {
                         streams[index]->WaitFreeSpace(stop_token);
+                        output_latency.store(streams[index]->GetLatency(),
+                                             std::memory_order_relaxed);
                     }
 
                     // Process the command list
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <thread>
 
@@ -79,6 +81,13 @@ public:
     void ClearRemainCommandCount(s32 session_id) noexcept;
     u64 GetRenderingStartTick(s32 session_id) const noexcept;
 
+    /**
+     * Get the latency of the first session's output stream, as measured after its last render.
+     *
+     * @return The output latency.
+     */
+    std::chrono::microseconds GetOutputLatency() const noexcept;
+
 private:
     /**
      * Main AudioRenderer thread, responsible for processing the command lists.
@@ -108,6 +117,8 @@ private:
     std::array<CommandListProcessor, MaxRendererSessions> command_list_processors{};
     /// The streams which will receive the processed samples
     std::array<Sink::SinkStream*, MaxRendererSessions> streams{};
+    /// Latency of the first session's output stream, read outside of the render thread
+    std::atomic<std::chrono::microseconds> output_latency{};
     /// CPU Tick when the DSP was signalled to process, uses time rather than tick
     u64 signalled_tick{0};
 };
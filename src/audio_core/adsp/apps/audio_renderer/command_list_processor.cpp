@@ -1,9 +1,14 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <chrono>
 #include <string>
+#include <thread>
 
 #include "audio_core/adsp/apps/audio_renderer/command_list_processor.h"
+#include "audio_core/adsp/apps/audio_renderer/voice_command_executor.h"
+#include "audio_core/renderer/command/command_cost_model.h"
 #include "audio_core/renderer/command/command_list_header.h"
 #include "audio_core/renderer/command/commands.h"
 #include "common/settings.h"
@@ -14,6 +19,13 @@
 
 namespace AudioCore::ADSP::AudioRenderer {
 
+/// Maximum number of threads processing voices alongside the ADSP thread
+constexpr u32 MaxVoiceWorkers = 3;
+
+CommandListProcessor::CommandListProcessor() = default;
+
+CommandListProcessor::~CommandListProcessor() = default;
+
 void CommandListProcessor::Initialize(Core::System& system_, Kernel::KProcess& process,
                                       CpuAddr buffer, u64 size, Sink::SinkStream* stream_) {
     system = &system_;
@@ -27,7 +39,16 @@ void CommandListProcessor::Initialize(Core::System& system_, Kernel::KProcess& p
     target_sample_rate = header->sample_rate;
     mix_buffers = header->samples_buffer;
     buffer_count = header->buffer_count;
+    measure_commands = header->measure_commands;
     processed_command_count = 0;
+
+    // Leave most host threads to the emulated cores and the GPU
+    const auto voice_worker_count{
+        std::min(std::thread::hardware_concurrency() / 4, MaxVoiceWorkers)};
+    if (!voice_executor && voice_worker_count > 0 &&
+        Settings::values.parallel_audio_voices.GetValue()) {
+        voice_executor = std::make_unique<VoiceCommandExecutor>(voice_worker_count);
+    }
 }
 
 void CommandListProcessor::SetProcessTimeMax(const u64 time) {
@@ -51,17 +72,22 @@ u64 CommandListProcessor::Process(u32 session_id) {
     } else {
         start_time = start_time_;
         current_processing_time = 0;
+        measured_time = 0;
     }
 
     std::string dump{fmt::format("\nSession {}\n", session_id)};
+    bool is_list_valid{true};
 
+    // Validate the commands first, so independent voices can be found and processed together
+    command_list.clear();
     for (u32 index = 0; index < command_count; index++) {
         auto& command{*reinterpret_cast<Renderer::ICommand*>(commands)};
 
         if (command.magic != 0xCAFEBABE) {
             LOG_ERROR(Service_Audio, "Command has invalid magic! Expected 0xCAFEBABE, got {:08X}",
                       command.magic);
-            return system->CoreTiming().GetGlobalTimeUs().count() - start_time_;
+            is_list_valid = false;
+            break;
         }
 
         auto current_offset{CpuAddr(commands) - command_base};
@@ -71,7 +97,8 @@ u64 CommandListProcessor::Process(u32 session_id) {
                       "Command exceeded command buffer, buffer size {:08X}, command ends at {:08X}",
                       commands_buffer_size,
                       CpuAddr(commands) + command.size - sizeof(Renderer::CommandListHeader));
-            return system->CoreTiming().GetGlobalTimeUs().count() - start_time_;
+            is_list_valid = false;
+            break;
         }
 
         if (Settings::values.dump_audio_commands) {
@@ -82,16 +109,37 @@ u64 CommandListProcessor::Process(u32 session_id) {
             break;
         }
 
-        if (command.enabled) {
-            command.Process(*this);
-        } else {
+        if (!command.enabled) {
             dump += fmt::format("\tDisabled!\n");
         }
 
-        processed_command_count++;
+        command_list.push_back(&command);
         commands += command.size;
     }
 
+    const bool use_voice_executor{voice_executor &&
+                                  Settings::values.parallel_audio_voices.GetValue()};
+    for (size_t index = 0; index < command_list.size();) {
+        if (use_voice_executor) {
+            const auto remaining{std::span(command_list).subspan(index)};
+            if (const auto processed{voice_executor->Process(*this, remaining)}; processed > 0) {
+                index += processed;
+                continue;
+            }
+        }
+
+        auto& command{*command_list[index]};
+        if (command.enabled) {
+            ProcessCommand(command);
+        }
+        index++;
+    }
+    processed_command_count += static_cast<u32>(command_list.size());
+
+    if (!is_list_valid) {
+        return system->CoreTiming().GetGlobalTimeUs().count() - start_time_;
+    }
+
     if (Settings::values.dump_audio_commands && dump != last_dump) {
         LOG_WARNING(Service_Audio, "{}", dump);
         last_dump = dump;
@@ -101,4 +149,26 @@ u64 CommandListProcessor::Process(u32 session_id) {
     return end_time - start_time_;
 }
 
+void CommandListProcessor::ProcessCommand(Renderer::ICommand& command) {
+    if (!measure_commands) {
+        command.Process(*this);
+        return;
+    }
+
+    const auto start{std::chrono::steady_clock::now()};
+    command.Process(*this);
+    const auto time{static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - start)
+                                         .count())};
+    measured_time += time;
+    Renderer::CommandCostModel::Get().Record(command.type, command.estimated_process_time, time);
+}
+
+u64 CommandListProcessor::GetProcessingTime() const {
+    if (measure_commands) {
+        return measured_time / 1000;
+    }
+    return system->CoreTiming().GetGlobalTimeUs().count() - start_time - current_processing_time;
+}
+
 } // namespace AudioCore::ADSP::AudioRenderer
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <memory>
 #include <span>
+#include <string>
+#include <vector>
 
 #include "audio_core/common/common.h"
 #include "audio_core/renderer/command/command_list_header.h"
@@ -27,15 +30,20 @@ class SinkStream;
 
 namespace Renderer {
 struct CommandListHeader;
-}
+struct ICommand;
+} // namespace Renderer
 
 namespace ADSP::AudioRenderer {
+class VoiceCommandExecutor;
 
 /**
  * A processor for command lists given to the AudioRenderer.
  */
 class CommandListProcessor {
 public:
+    CommandListProcessor();
+    ~CommandListProcessor();
+
     /**
      * Initialize the processor.
      *
@@ -77,6 +85,20 @@ public:
      */
     u64 Process(u32 session_id);
 
+    /**
+     * Process a single command, recording its time in the cost model if commands are measured.
+     *
+     * @param command - The command to process.
+     */
+    void ProcessCommand(Renderer::ICommand& command);
+
+    /**
+     * Get the time spent processing commands of this list.
+     *
+     * @return The processing time, in microseconds.
+     */
+    u64 GetProcessingTime() const;
+
     /// Core system
     Core::System* system{};
     /// Core memory
@@ -109,8 +131,17 @@ public:
     u64 current_processing_time{};
     /// The end processing time for this list
     u64 end_time{};
+    /// If the host time of each command is measured for the command cost model, set by the
+    /// renderer which generated the list
+    bool measure_commands{};
+    /// The measured host time of the commands processed so far in this list, in nanoseconds
+    u64 measured_time{};
     /// Last command list string generated, used for dumping audio commands to console
     std::string last_dump{};
+    /// Commands validated for processing
+    std::vector<Renderer::ICommand*> command_list{};
+    /// Executor running independent voices in parallel, null if the host has too few cores
+    std::unique_ptr<VoiceCommandExecutor> voice_executor{};
 };
 
 } // namespace ADSP::AudioRenderer
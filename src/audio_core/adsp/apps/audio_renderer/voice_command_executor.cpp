@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+
+#include "audio_core/adsp/apps/audio_renderer/command_list_processor.h"
+#include "audio_core/adsp/apps/audio_renderer/voice_command_executor.h"
+#include "audio_core/renderer/command/commands.h"
+
+namespace AudioCore::ADSP::AudioRenderer {
+namespace {
+using namespace Renderer;
+
+/// Batches with fewer voice chains are processed on the calling thread
+constexpr size_t MinParallelChains = 8;
+
+bool IsValidBuffer(const CommandListProcessor& processor, s16 index) {
+    return index >= 0 && static_cast<u32>(index) < processor.buffer_count;
+}
+} // Anonymous namespace
+
+VoiceCommandExecutor::VoiceCommandExecutor(u32 worker_count)
+    : thread_pool{worker_count, "AudioVoiceWorker"}, workers(worker_count + 1) {
+    for (auto& worker : workers) {
+        worker.processor = std::make_unique<CommandListProcessor>();
+    }
+}
+
+VoiceCommandExecutor::~VoiceCommandExecutor() = default;
+
+size_t VoiceCommandExecutor::FindVoiceChains(const CommandListProcessor& processor,
+                                             std::span<ICommand* const> commands) {
+    chains.clear();
+    scratch_buffers.assign(processor.buffer_count, false);
+    mixed_buffers.assign(processor.buffer_count, false);
+
+    // A chain may only read buffers it wrote itself, any other buffer is only mixed into
+    const auto write = [&](s16 index) {
+        if (!IsValidBuffer(processor, index)) {
+            return false;
+        }
+        chain_scratch_buffers[index] = true;
+        return true;
+    };
+    const auto read = [&](s16 index) {
+        return IsValidBuffer(processor, index) && chain_scratch_buffers[index];
+    };
+    const auto filter = [&](s16 input, s16 output) { return read(input) && write(output); };
+    const auto mix = [&](s16 input, s16 output) {
+        if (!read(input) || !IsValidBuffer(processor, output)) {
+            return false;
+        }
+        chain_mixed_buffers.push_back(output);
+        return true;
+    };
+    const auto is_independent = [&](ICommand& command) {
+        switch (command.type) {
+        case CommandId::DataSourcePcmInt16Version1:
+            return write(static_cast<PcmInt16DataSourceVersion1Command&>(command).output_index);
+        case CommandId::DataSourcePcmInt16Version2:
+            return write(static_cast<PcmInt16DataSourceVersion2Command&>(command).output_index);
+        case CommandId::DataSourcePcmFloatVersion1:
+            return write(static_cast<PcmFloatDataSourceVersion1Command&>(command).output_index);
+        case CommandId::DataSourcePcmFloatVersion2:
+            return write(static_cast<PcmFloatDataSourceVersion2Command&>(command).output_index);
+        case CommandId::DataSourceAdpcmVersion1:
+            return write(static_cast<AdpcmDataSourceVersion1Command&>(command).output_index);
+        case CommandId::DataSourceAdpcmVersion2:
+            return write(static_cast<AdpcmDataSourceVersion2Command&>(command).output_index);
+        case CommandId::Volume: {
+            const auto& volume{static_cast<VolumeCommand&>(command)};
+            return filter(volume.input_index, volume.output_index);
+        }
+        case CommandId::VolumeRamp: {
+            const auto& volume_ramp{static_cast<VolumeRampCommand&>(command)};
+            return filter(volume_ramp.input_index, volume_ramp.output_index);
+        }
+        case CommandId::BiquadFilter: {
+            const auto& biquad{static_cast<BiquadFilterCommand&>(command)};
+            return filter(biquad.input, biquad.output);
+        }
+        case CommandId::MultiTapBiquadFilter: {
+            const auto& biquad{static_cast<MultiTapBiquadFilterCommand&>(command)};
+            return filter(biquad.input, biquad.output);
+        }
+        case CommandId::MixRamp: {
+            const auto& mix_ramp{static_cast<MixRampCommand&>(command)};
+            return mix(mix_ramp.input_index, mix_ramp.output_index);
+        }
+        case CommandId::MixRampGrouped: {
+            const auto& mix_ramp{static_cast<MixRampGroupedCommand&>(command)};
+            for (u32 i = 0; i < std::min<u32>(mix_ramp.buffer_count, MaxMixBuffers); i++) {
+                if (!mix(mix_ramp.inputs[i], mix_ramp.outputs[i])) {
+                    return false;
+                }
+            }
+            return mix_ramp.buffer_count <= MaxMixBuffers;
+        }
+        case CommandId::DepopPrepare:
+            // Processed on the calling thread before the chains, as voices share the depop buffer
+            return true;
+        default:
+            return false;
+        }
+    };
+
+    size_t begin{0};
+    while (begin < commands.size()) {
+        const auto node_id{commands[begin]->node_id};
+        chain_scratch_buffers.assign(processor.buffer_count, false);
+        chain_mixed_buffers.clear();
+
+        size_t end{begin};
+        u64 cost{1};
+        for (; end < commands.size() && commands[end]->node_id == node_id; end++) {
+            auto& command{*commands[end]};
+            if (!command.enabled) {
+                continue;
+            }
+            if (!is_independent(command)) {
+                return begin;
+            }
+            cost += command.estimated_process_time;
+        }
+
+        // Chains can not read or overwrite the buffers other chains mix into
+        for (const auto output : chain_mixed_buffers) {
+            if (scratch_buffers[output] || chain_scratch_buffers[output]) {
+                return begin;
+            }
+        }
+        for (u32 buffer = 0; buffer < processor.buffer_count; buffer++) {
+            if (chain_scratch_buffers[buffer] && mixed_buffers[buffer]) {
+                return begin;
+            }
+        }
+
+        for (u32 buffer = 0; buffer < processor.buffer_count; buffer++) {
+            if (chain_scratch_buffers[buffer]) {
+                scratch_buffers[buffer] = true;
+            }
+        }
+        for (const auto output : chain_mixed_buffers) {
+            mixed_buffers[output] = true;
+        }
+        chains.push_back({begin, end, cost});
+        begin = end;
+    }
+    return begin;
+}
+
+void VoiceCommandExecutor::ProcessChains(CommandListProcessor& processor,
+                                         std::span<ICommand* const> commands, size_t first,
+                                         size_t last, bool skip_depop) {
+    if (first == last) {
+        return;
+    }
+    for (size_t index = chains[first].begin; index < chains[last - 1].end; index++) {
+        auto& command{*commands[index]};
+        if (command.enabled && !(skip_depop && command.type == CommandId::DepopPrepare)) {
+            processor.ProcessCommand(command);
+        }
+    }
+}
+
+size_t VoiceCommandExecutor::Process(CommandListProcessor& processor,
+                                     std::span<ICommand* const> commands) {
+    const auto batch_size{FindVoiceChains(processor, commands)};
+    if (chains.size() < MinParallelChains) {
+        ProcessChains(processor, commands, 0, chains.size(), false);
+        return batch_size;
+    }
+
+    // Prepare the depop of every voice before their chains mix into the output
+    for (size_t index = 0; index < batch_size; index++) {
+        auto& command{*commands[index]};
+        if (command.enabled && command.type == CommandId::DepopPrepare) {
+            processor.ProcessCommand(command);
+        }
+    }
+
+    // Split the chains between the workers by their estimated processing time
+    u64 total_cost{0};
+    for (const auto& chain : chains) {
+        total_cost += chain.cost;
+    }
+    size_t next_chain{0};
+    u64 assigned_cost{0};
+    for (size_t i = 0; i < workers.size(); i++) {
+        const u64 target_cost{total_cost * (i + 1) / workers.size()};
+        workers[i].first_chain = next_chain;
+        while (next_chain < chains.size() && assigned_cost < target_cost) {
+            assigned_cost += chains[next_chain++].cost;
+        }
+        workers[i].last_chain = next_chain;
+    }
+
+    // The first worker mixes straight into the output, the others into silent copies of it
+    const auto sample_count{processor.sample_count};
+    for (size_t i = 1; i < workers.size(); i++) {
+        auto& worker{workers[i]};
+        if (worker.first_chain == worker.last_chain) {
+            continue;
+        }
+        worker.mix_buffers.resize(processor.mix_buffers.size());
+        for (u32 buffer = 0; buffer < processor.buffer_count; buffer++) {
+            if (mixed_buffers[buffer]) {
+                std::fill_n(worker.mix_buffers.begin() + buffer * sample_count, sample_count, 0);
+            }
+        }
+
+        auto& worker_processor{*worker.processor};
+        worker_processor.system = processor.system;
+        worker_processor.memory = processor.memory;
+        worker_processor.sample_count = sample_count;
+        worker_processor.target_sample_rate = processor.target_sample_rate;
+        worker_processor.buffer_count = processor.buffer_count;
+        worker_processor.mix_buffers = worker.mix_buffers;
+        worker_processor.measure_commands = processor.measure_commands;
+        thread_pool.QueueWork([this, &worker, commands] {
+            ProcessChains(*worker.processor, commands, worker.first_chain, worker.last_chain,
+                          true);
+        });
+    }
+    ProcessChains(processor, commands, workers[0].first_chain, workers[0].last_chain, true);
+    const auto wait_start{std::chrono::steady_clock::now()};
+    thread_pool.WaitForRequests();
+    if (processor.measure_commands) {
+        // The processing time of the list is the time until the slowest worker is done
+        processor.measured_time += static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - wait_start)
+                .count());
+    }
+
+    // Mixing wraps around, so adding the workers' mixes gives the same result as mixing the
+    // voices one after another
+    for (u32 buffer = 0; buffer < processor.buffer_count; buffer++) {
+        if (!mixed_buffers[buffer]) {
+            continue;
+        }
+        auto output{processor.mix_buffers.subspan(buffer * sample_count, sample_count)};
+        for (size_t i = 1; i < workers.size(); i++) {
+            if (workers[i].first_chain == workers[i].last_chain) {
+                continue;
+            }
+            const auto* input{workers[i].mix_buffers.data() + buffer * sample_count};
+            for (u32 sample = 0; sample < sample_count; sample++) {
+                output[sample] = static_cast<s32>(static_cast<u32>(output[sample]) +
+                                                  static_cast<u32>(input[sample]));
+            }
+        }
+    }
+    return batch_size;
+}
+
+} // namespace AudioCore::ADSP::AudioRenderer
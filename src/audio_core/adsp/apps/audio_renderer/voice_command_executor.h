@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+
+namespace AudioCore {
+namespace Renderer {
+struct ICommand;
+}
+
+namespace ADSP::AudioRenderer {
+class CommandListProcessor;
+
+/**
+ * Processes the command chains of independent voices across a pool of workers.
+ *
+ * A voice decodes into its channel mix buffers, filters and ramps them in place, and then mixes
+ * them into the output mix buffers. Voices only depend on each other through that final mix, so
+ * consecutive voice chains are split between the workers, each with its own copy of the mix
+ * buffers. The mixed buffers are then added back into the processor's mix buffers in worker
+ * order, which gives the same result as processing the voices one after another. The channel
+ * buffers the voices decode into are scratch space, and are left with whatever the chains of the
+ * calling thread wrote to them.
+ */
+class VoiceCommandExecutor {
+public:
+    /**
+     * Create the executor.
+     *
+     * @param worker_count - Number of workers, besides the thread calling Process.
+     */
+    explicit VoiceCommandExecutor(u32 worker_count);
+    ~VoiceCommandExecutor();
+
+    /**
+     * Process the batch of independent voice chains at the start of the given commands.
+     * Only enabled commands are processed.
+     *
+     * @param processor - The CommandListProcessor owning the commands.
+     * @param commands  - Commands left to process.
+     * @return The number of commands processed, 0 if the first command does not start an
+     *         independent voice chain.
+     */
+    size_t Process(CommandListProcessor& processor, std::span<Renderer::ICommand* const> commands);
+
+private:
+    /// Range of commands of a single voice, and their estimated processing time.
+    struct VoiceChain {
+        size_t begin;
+        size_t end;
+        u64 cost;
+    };
+
+    /// A worker's copy of the mix buffers, and the chains it processes.
+    struct Worker {
+        std::unique_ptr<CommandListProcessor> processor;
+        std::vector<s32> mix_buffers;
+        size_t first_chain;
+        size_t last_chain;
+    };
+
+    /**
+     * Find the voice chains at the start of the given commands which do not depend on each other.
+     *
+     * @param processor - The CommandListProcessor owning the commands.
+     * @param commands  - Commands left to process.
+     * @return The number of commands in the found chains.
+     */
+    size_t FindVoiceChains(const CommandListProcessor& processor,
+                           std::span<Renderer::ICommand* const> commands);
+
+    /**
+     * Process a range of voice chains.
+     *
+     * @param processor  - The processor whose mix buffers the chains use.
+     * @param commands   - Commands of the chains.
+     * @param first      - Index of the first chain to process.
+     * @param last       - Index after the last chain to process.
+     * @param skip_depop - If true, depop prepare commands were already processed.
+     */
+    void ProcessChains(CommandListProcessor& processor,
+                       std::span<Renderer::ICommand* const> commands, size_t first, size_t last,
+                       bool skip_depop);
+
+    /// Pool running every worker but the first one, whose chains run on the calling thread
+    Common::ThreadWorker thread_pool;
+    /// Workers the voice chains are split between
+    std::vector<Worker> workers;
+    /// Voice chains of the current batch
+    std::vector<VoiceChain> chains;
+    /// Mix buffers written by the chains before they read them, per mix buffer
+    std::vector<bool> scratch_buffers;
+    /// Mix buffers the chains mix into, per mix buffer
+    std::vector<bool> mixed_buffers;
+    /// Scratch buffers written by the chain being searched
+    std::vector<bool> chain_scratch_buffers;
+    /// Mix buffers mixed into by the chain being searched
+    std::vector<s16> chain_mixed_buffers;
+};
+
+} // namespace ADSP::AudioRenderer
+} // namespace AudioCore
@@ -93,6 +93,7 @@ void DeviceSession::AppendBuffers(std::span<const AudioBuffer> buffers) {
             .frames_played = 0,
             .tag = buffer.tag,
             .consumed = false,
+            .queued_time = {},
         };
 
         tmp_samples.resize_destructive(buffer.size / sizeof(s16));
@@ -108,8 +109,9 @@ void DeviceSession::AppendBuffers(std::span<const AudioBuffer> buffers) {
 
 void DeviceSession::ReleaseBuffer(const AudioBuffer& buffer) const {
     if (type == Sink::StreamType::In) {
-        auto samples{stream->ReleaseBuffer(buffer.size / sizeof(s16))};
-        handle->GetMemory().WriteBlockUnsafe(buffer.samples, samples.data(), buffer.size);
+        Core::Memory::CpuGuestMemoryScoped<s16, Core::Memory::GuestMemoryFlags::UnsafeWrite>
+            samples(handle->GetMemory(), buffer.samples, buffer.size / sizeof(s16));
+        stream->ReleaseBuffer(samples);
     }
 }
 
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "audio_core/renderer/command/command_cost_model.h"
+#include "audio_core/renderer/command/dsp_kernels.h"
+#include "common/fixed_point.h"
+
+namespace AudioCore::Renderer {
+namespace {
+/// Weight of a new measurement in the moving averages
+constexpr f32 AverageWeight = 1.0f / 32.0f;
+/// Iterations of each kernel in the startup benchmark
+constexpr u32 CalibrationIterations = 256;
+
+/// Measure the average time of a function in ADSP ticks.
+template <typename Func>
+f32 MeasureTicks(Func&& func) {
+    const auto start{std::chrono::steady_clock::now()};
+    for (u32 i = 0; i < CalibrationIterations; i++) {
+        func();
+    }
+    const std::chrono::duration<f64, std::nano> elapsed{std::chrono::steady_clock::now() - start};
+    return static_cast<f32>(elapsed.count() * CommandCostModel::DspTicksPerNs /
+                            CalibrationIterations);
+}
+} // Anonymous namespace
+
+CommandCostModel& CommandCostModel::Get() {
+    static CommandCostModel model;
+    return model;
+}
+
+void CommandCostModel::Calibrate(u32 sample_count, u32 estimated_mix, u32 estimated_volume) {
+    std::call_once(calibrated, [&] {
+        std::vector<s32> input(sample_count, 0x123456);
+        std::vector<s32> output(sample_count);
+        const s64 gain{Common::FixedPoint<41, 23>{0.5f}.to_raw()};
+        const s64 ramp{
+            Common::FixedPoint<41, 23>{0.25f / static_cast<f32>(sample_count)}.to_raw()};
+
+        const auto mix_ticks{MeasureTicks(
+            [&] { DSP::MixGain<23>(output, input, gain, ramp, sample_count); })};
+        const auto volume_ticks{MeasureTicks(
+            [&] { DSP::ApplyGain<23>(output, input, gain, ramp, sample_count); })};
+
+        const auto mix_scale{mix_ticks / static_cast<f32>(std::max(estimated_mix, 1U))};
+        const auto volume_scale{volume_ticks / static_cast<f32>(std::max(estimated_volume, 1U))};
+        const auto scale{(mix_scale + volume_scale) / 2.0f};
+        for (auto& cost : costs) {
+            if (!cost.measured.load(std::memory_order_relaxed)) {
+                cost.scale.store(scale, std::memory_order_relaxed);
+                cost.ticks.store(mix_ticks, std::memory_order_relaxed);
+            }
+        }
+    });
+}
+
+u32 CommandCostModel::Scale(CommandId type, u32 estimate) const {
+    const auto index{static_cast<size_t>(type)};
+    if (index >= costs.size()) {
+        return estimate;
+    }
+    const auto& cost{costs[index]};
+    if (estimate == 0) {
+        return static_cast<u32>(cost.ticks.load(std::memory_order_relaxed));
+    }
+    const auto scale{cost.scale.load(std::memory_order_relaxed)};
+    return static_cast<u32>(static_cast<f32>(estimate) * scale);
+}
+
+void CommandCostModel::Record(CommandId type, u32 estimate, u64 time_ns) {
+    const auto index{static_cast<size_t>(type)};
+    if (index >= costs.size()) {
+        return;
+    }
+    auto& cost{costs[index]};
+    const auto ticks{static_cast<f32>(static_cast<f64>(time_ns) * DspTicksPerNs)};
+
+    // Updates from concurrent workers may be lost, which only slows the average down
+    const auto average_ticks{cost.ticks.load(std::memory_order_relaxed)};
+    cost.ticks.store(average_ticks + (ticks - average_ticks) * AverageWeight,
+                     std::memory_order_relaxed);
+    if (estimate != 0) {
+        // The estimate was already scaled, so correct the scale by how far off it was
+        const auto scale{cost.scale.load(std::memory_order_relaxed)};
+        const auto measured_scale{scale * ticks / static_cast<f32>(estimate)};
+        cost.scale.store(scale + (measured_scale - scale) * AverageWeight,
+                         std::memory_order_relaxed);
+    }
+    cost.measured.store(true, std::memory_order_relaxed);
+}
+
+} // namespace AudioCore::Renderer
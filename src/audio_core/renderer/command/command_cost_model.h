@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include "audio_core/renderer/command/icommand.h"
+#include "common/common_types.h"
+
+namespace AudioCore::Renderer {
+
+/**
+ * Measured cost of processing each type of command on the host.
+ *
+ * The hardware tables of the processing time estimators give the relative cost of a command
+ * from its parameters, but not how long the host takes to process it. The model keeps, for each
+ * command type, the ratio between the measured time and the table estimate. It is seeded with a
+ * short benchmark of the mix kernels, and then follows the processed commands with an
+ * exponentially weighted moving average.
+ */
+class CommandCostModel {
+public:
+    /// ADSP ticks per nanosecond, the unit of estimated processing times.
+    static constexpr f64 DspTicksPerNs = 0.576;
+
+    /**
+     * Get the cost model shared by all renderers.
+     *
+     * @return The cost model.
+     */
+    static CommandCostModel& Get();
+
+    /**
+     * Measure the host cost of mixing, and use it for every command type not measured yet.
+     * Only the first call benchmarks the host.
+     *
+     * @param sample_count      - Number of samples processed by each command.
+     * @param estimated_mix     - Table estimate of a mix ramp command.
+     * @param estimated_volume  - Table estimate of a volume ramp command.
+     */
+    void Calibrate(u32 sample_count, u32 estimated_mix, u32 estimated_volume);
+
+    /**
+     * Scale a table estimate to the measured host cost of its command type.
+     *
+     * @param type     - Type of the command.
+     * @param estimate - Table estimate of the command, in ADSP ticks.
+     * @return The host estimate, in ADSP ticks.
+     */
+    u32 Scale(CommandId type, u32 estimate) const;
+
+    /**
+     * Record the time taken to process a command.
+     *
+     * @param type     - Type of the command.
+     * @param estimate - Host estimate the command was generated with, in ADSP ticks.
+     * @param time_ns  - Time taken to process the command.
+     */
+    void Record(CommandId type, u32 estimate, u64 time_ns);
+
+private:
+    static constexpr size_t CommandTypeCount = static_cast<size_t>(CommandId::Compressor) + 1;
+
+    /// Measured cost of a command type.
+    struct Cost {
+        /// Ratio between the host and table estimates
+        std::atomic<f32> scale{1.0f};
+        /// Average ticks taken, used when the table estimates the command as free
+        std::atomic<f32> ticks{0.0f};
+        /// If the command type has been measured yet
+        std::atomic<bool> measured{};
+    };
+
+    /// Costs per command type
+    std::array<Cost, CommandTypeCount> costs{};
+    /// Guards the startup benchmark
+    std::once_flag calibrated;
+};
+
+} // namespace AudioCore::Renderer
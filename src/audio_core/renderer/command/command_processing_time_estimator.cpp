@@ -3617,4 +3617,130 @@ u32 CommandProcessingTimeEstimatorVersion5::Estimate(const CompressorCommand& co
     }
 }
 
+u32 HostCommandProcessingTimeEstimator::Estimate(
+    const PcmInt16DataSourceVersion1Command& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(
+    const PcmInt16DataSourceVersion2Command& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(
+    const PcmFloatDataSourceVersion1Command& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(
+    const PcmFloatDataSourceVersion2Command& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(
+    const AdpcmDataSourceVersion1Command& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(
+    const AdpcmDataSourceVersion2Command& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const VolumeCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const VolumeRampCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const BiquadFilterCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const MixCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const MixRampCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const MixRampGroupedCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const DepopPrepareCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const DepopForMixBuffersCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const DelayCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const UpsampleCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const DownMix6chTo2chCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const AuxCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const DeviceSinkCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const CircularBufferSinkCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const ReverbCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const I3dl2ReverbCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const PerformanceCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const ClearMixBufferCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const CopyMixBufferCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const LightLimiterVersion1Command& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const LightLimiterVersion2Command& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const MultiTapBiquadFilterCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const CaptureCommand& command) const {
+    return EstimateOnHost(command);
+}
+
+u32 HostCommandProcessingTimeEstimator::Estimate(const CompressorCommand& command) const {
+    return EstimateOnHost(command);
+}
+
 } // namespace AudioCore::Renderer
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <memory>
+
+#include "audio_core/renderer/command/command_cost_model.h"
 #include "audio_core/renderer/command/commands.h"
 #include "common/common_types.h"
 
@@ -251,4 +254,56 @@ private:
     u32 buffer_count{};
 };
 
+/**
+ * Scales the estimates of a hardware estimator to the measured host cost of each command type.
+ */
+class HostCommandProcessingTimeEstimator final : public ICommandProcessingTimeEstimator {
+public:
+    HostCommandProcessingTimeEstimator(std::unique_ptr<ICommandProcessingTimeEstimator> base_,
+                                       CommandCostModel& cost_model_)
+        : base{std::move(base_)}, cost_model{cost_model_} {}
+
+    u32 Estimate(const PcmInt16DataSourceVersion1Command& command) const override;
+    u32 Estimate(const PcmInt16DataSourceVersion2Command& command) const override;
+    u32 Estimate(const PcmFloatDataSourceVersion1Command& command) const override;
+    u32 Estimate(const PcmFloatDataSourceVersion2Command& command) const override;
+    u32 Estimate(const AdpcmDataSourceVersion1Command& command) const override;
+    u32 Estimate(const AdpcmDataSourceVersion2Command& command) const override;
+    u32 Estimate(const VolumeCommand& command) const override;
+    u32 Estimate(const VolumeRampCommand& command) const override;
+    u32 Estimate(const BiquadFilterCommand& command) const override;
+    u32 Estimate(const MixCommand& command) const override;
+    u32 Estimate(const MixRampCommand& command) const override;
+    u32 Estimate(const MixRampGroupedCommand& command) const override;
+    u32 Estimate(const DepopPrepareCommand& command) const override;
+    u32 Estimate(const DepopForMixBuffersCommand& command) const override;
+    u32 Estimate(const DelayCommand& command) const override;
+    u32 Estimate(const UpsampleCommand& command) const override;
+    u32 Estimate(const DownMix6chTo2chCommand& command) const override;
+    u32 Estimate(const AuxCommand& command) const override;
+    u32 Estimate(const DeviceSinkCommand& command) const override;
+    u32 Estimate(const CircularBufferSinkCommand& command) const override;
+    u32 Estimate(const ReverbCommand& command) const override;
+    u32 Estimate(const I3dl2ReverbCommand& command) const override;
+    u32 Estimate(const PerformanceCommand& command) const override;
+    u32 Estimate(const ClearMixBufferCommand& command) const override;
+    u32 Estimate(const CopyMixBufferCommand& command) const override;
+    u32 Estimate(const LightLimiterVersion1Command& command) const override;
+    u32 Estimate(const LightLimiterVersion2Command& command) const override;
+    u32 Estimate(const MultiTapBiquadFilterCommand& command) const override;
+    u32 Estimate(const CaptureCommand& command) const override;
+    u32 Estimate(const CompressorCommand& command) const override;
+
+private:
+    template <typename T>
+    u32 EstimateOnHost(const T& command) const {
+        return cost_model.Scale(command.type, base->Estimate(command));
+    }
+
+    /// Hardware estimator giving the relative cost of commands
+    std::unique_ptr<ICommandProcessingTimeEstimator> base;
+    /// Measured host cost of the command types
+    CommandCostModel& cost_model;
+};
+
 } // namespace AudioCore::Renderer
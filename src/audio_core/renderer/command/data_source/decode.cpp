@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "audio_core/renderer/command/data_source/decode.h"
+#include "audio_core/renderer/command/dsp_kernels.h"
 #include "audio_core/renderer/command/resample/resample.h"
 #include "common/fixed_point.h"
 #include "common/logging/log.h"
@@ -29,9 +30,6 @@ constexpr std::array<u8, 3> PitchBySrcQuality = {4, 8, 4};
 template <typename T>
 static u32 DecodePcm(Core::Memory::Memory& memory, std::span<s16> out_buffer,
                      const DecodeArg& req) {
-    constexpr s32 min{std::numeric_limits<s16>::min()};
-    constexpr s32 max{std::numeric_limits<s16>::max()};
-
     if (req.buffer == 0 || req.buffer_size == 0) {
         return 0;
     }
@@ -52,16 +50,13 @@ static u32 DecodePcm(Core::Memory::Memory& memory, std::span<s16> out_buffer,
 
         Core::Memory::CpuGuestMemory<T, Core::Memory::GuestMemoryFlags::UnsafeRead> samples(
             memory, source, size);
+        const std::span<const T> input{samples.data(), samples.size()};
         if constexpr (std::is_floating_point_v<T>) {
-            for (u32 i = 0; i < samples_to_decode; i++) {
-                auto sample{static_cast<s32>(samples[i * channel_count + req.target_channel] *
-                                             std::numeric_limits<s16>::max())};
-                out_buffer[i] = static_cast<s16>(std::clamp(sample, min, max));
-            }
+            DSP::ConvertPcmFloat(out_buffer, input, req.target_channel, channel_count,
+                                 samples_to_decode);
         } else {
-            for (u32 i = 0; i < samples_to_decode; i++) {
-                out_buffer[i] = samples[i * channel_count + req.target_channel];
-            }
+            DSP::DeinterleavePcm16(out_buffer, input, req.target_channel, channel_count,
+                                   samples_to_decode);
         }
     } break;
 
@@ -77,11 +72,8 @@ static u32 DecodePcm(Core::Memory::Memory& memory, std::span<s16> out_buffer,
             memory, source, samples_to_decode);
 
         if constexpr (std::is_floating_point_v<T>) {
-            for (u32 i = 0; i < samples_to_decode; i++) {
-                auto sample{static_cast<s32>(samples[i * channel_count + req.target_channel] *
-                                             std::numeric_limits<s16>::max())};
-                out_buffer[i] = static_cast<s16>(std::clamp(sample, min, max));
-            }
+            DSP::ConvertPcmFloat(out_buffer, {samples.data(), samples.size()}, 0, 1,
+                                 samples_to_decode);
         } else {
             std::memcpy(out_buffer.data(), samples.data(), samples_to_decode * sizeof(s16));
         }
@@ -139,13 +131,18 @@ static u32 DecodeAdpcm(Core::Memory::Memory& memory, std::span<s16> out_buffer,
         position_in_frame += 2;
     }
 
-    const auto size{std::max((samples_to_process / 8U) * SamplesPerFrame, 8U)};
+    // Read up to the byte holding the last sample to decode
+    const auto last_sample{start_pos + samples_to_process - 1};
+    const auto last_position{(last_sample / SamplesPerFrame) * NibblesPerFrame + 2 +
+                             last_sample % SamplesPerFrame};
+    const auto size{last_position / 2 - position_in_frame / 2 + 1};
     Core::Memory::CpuGuestMemory<u8, Core::Memory::GuestMemoryFlags::UnsafeRead> wavebuffer(
         memory, req.buffer + position_in_frame / 2, size);
+    const std::span<const u8> input{wavebuffer.data(), wavebuffer.size()};
 
     auto context{req.adpcm_context};
     auto header{context->header};
-    u8 coeff_index{static_cast<u8>((header >> 4U) & 0xFU)};
+    u8 coeff_index{static_cast<u8>((header >> 4U) & 0x7U)};
     u8 scale{static_cast<u8>(header & 0xFU)};
     s32 coeff0{req.coefficients[coeff_index * 2 + 0]};
     s32 coeff1{req.coefficients[coeff_index * 2 + 1]};
@@ -173,29 +170,25 @@ static u32 DecodeAdpcm(Core::Memory::Memory& memory, std::span<s16> out_buffer,
     while (samples_to_read > 0) {
         // Are we at a new frame?
         if ((position_in_frame % NibblesPerFrame) == 0) {
+            // Can we consume whole frames? Decode all of them at once
+            if (samples_to_read >= SamplesPerFrame) {
+                const auto frame_count{samples_to_read / SamplesPerFrame};
+                header = DSP::DecodeAdpcmFrames(out_buffer.subspan(write_index),
+                                                input.subspan(read_index), req.coefficients,
+                                                frame_count, yn0, yn1);
+                read_index += frame_count * (NibblesPerFrame / 2);
+                write_index += frame_count * SamplesPerFrame;
+                position_in_frame += frame_count * NibblesPerFrame;
+                samples_to_read -= frame_count * SamplesPerFrame;
+                continue;
+            }
+
             header = wavebuffer[read_index++];
-            coeff_index = (header >> 4) & 0xF;
+            coeff_index = (header >> 4) & 0x7;
             scale = header & 0xF;
             coeff0 = req.coefficients[coeff_index * 2 + 0];
             coeff1 = req.coefficients[coeff_index * 2 + 1];
             position_in_frame += 2;
-
-            // Can we consume all of this frame's samples?
-            if (samples_to_read >= SamplesPerFrame) {
-                // Can grab all samples until the next header
-                for (u32 i = 0; i < SamplesPerFrame / 2; i++) {
-                    auto code0{Steps[(wavebuffer[read_index] >> 4) & 0xF]};
-                    auto code1{Steps[wavebuffer[read_index] & 0xF]};
-                    read_index++;
-
-                    out_buffer[write_index++] = decode_sample(code0);
-                    out_buffer[write_index++] = decode_sample(code1);
-                }
-
-                position_in_frame += SamplesPerFrame;
-                samples_to_read -= SamplesPerFrame;
-                continue;
-            }
         }
 
         // Decode a single sample
@@ -270,7 +263,15 @@ void DecodeFromWaveBuffers(Core::Memory::Memory& memory, const DecodeFromWaveBuf
     u32 offset{voice_state.offset};
 
     auto output_buffer{args.output};
-    std::array<s16, TempBufferSize> temp_buffer{};
+    // Every sample read back from the buffer is written first, either decoded or as silence
+    std::array<s16, TempBufferSize> temp_buffer;
+
+    // The ADPCM coefficients are the same for every wavebuffer of the voice
+    std::array<s16, 16> coefficients{};
+    if (args.sample_format == SampleFormat::Adpcm) {
+        memory.ReadBlockUnsafe(args.data_address, coefficients.data(),
+                               std::min<u64>(args.data_size, sizeof(coefficients)));
+    }
 
     while (remaining_sample_count > 0) {
         const auto samples_to_write{std::min(remaining_sample_count, max_remaining_sample_count)};
@@ -323,7 +324,7 @@ void DecodeFromWaveBuffers(Core::Memory::Memory& memory, const DecodeFromWaveBuf
                 .start_offset{start_offset},
                 .end_offset{end_offset},
                 .channel_count{args.channel_count},
-                .coefficients{},
+                .coefficients{coefficients},
                 .adpcm_context{nullptr},
                 .target_channel{args.channel},
                 .offset{offset},
@@ -347,7 +348,6 @@ void DecodeFromWaveBuffers(Core::Memory::Memory& memory, const DecodeFromWaveBuf
 
             case SampleFormat::Adpcm: {
                 decode_arg.adpcm_context = &voice_state.adpcm_context;
-                memory.ReadBlockUnsafe(args.data_address, &decode_arg.coefficients, args.data_size);
                 samples_decoded = DecodeAdpcm(
                     memory, {&temp_buffer[temp_buffer_pos], TempBufferSize - temp_buffer_pos},
                     decode_arg);
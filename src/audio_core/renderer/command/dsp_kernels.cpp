@@ -0,0 +1,612 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#elif defined(ARCHITECTURE_arm64)
+#include <arm_neon.h>
+#endif
+
+#include "audio_core/renderer/command/dsp_kernels.h"
+
+#if defined(ARCHITECTURE_x86_64)
+#include "common/x64/cpu_detect.h"
+#endif
+
+#if defined(ARCHITECTURE_x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define ALWAYS_INLINE __forceinline
+#else
+#define ALWAYS_INLINE inline
+#endif
+
+namespace AudioCore::Renderer::DSP {
+namespace {
+std::atomic<Backend> current_backend{GetHostBackend()};
+
+/// Round a raw fixed point value to an integer, like Common::FixedPoint<64 - Q, Q>::to_int.
+template <size_t Q>
+constexpr s64 Round(s64 value) {
+    constexpr s64 fractional_mask = (s64{1} << Q) - 1;
+    return (value + ((value & fractional_mask) >> 1)) >> Q;
+}
+
+/// Multiply a sample by a raw fixed point gain, wrapping like the 128-bit fixed point product.
+constexpr s64 Multiply(s32 sample, s64 gain) {
+    return static_cast<s64>(static_cast<u64>(s64{sample}) * static_cast<u64>(gain));
+}
+
+/// Get the gain applied to a sample, after it has ramped for the previous samples.
+constexpr s64 RampedGain(s64 gain, s64 ramp, u32 samples) {
+    return static_cast<s64>(static_cast<u64>(gain) + static_cast<u64>(ramp) * samples);
+}
+
+/// Check if the gains of all samples fit in 32 bits, as the vector kernels multiply 32-bit
+/// samples by 32-bit gains into exact 64-bit products.
+bool GainsFit(s64 gain, s64 ramp, u32 sample_count) {
+    constexpr s64 min = std::numeric_limits<s32>::min();
+    constexpr s64 max = std::numeric_limits<s32>::max();
+    if (gain < min || gain > max || ramp < min || ramp > max) {
+        return false;
+    }
+    const s64 last_gain = gain + ramp * static_cast<s64>(sample_count);
+    return last_gain >= min && last_gain <= max;
+}
+
+template <size_t Q, bool Mix>
+void GainScalar(s32* output, const s32* input, s64 gain, s64 ramp, u32 sample_count) {
+    for (u32 i = 0; i < sample_count; i++) {
+        const s64 sample = Round<Q>(Multiply(input[i], gain));
+        if constexpr (Mix) {
+            output[i] = static_cast<s32>(output[i] + sample);
+        } else {
+            output[i] = static_cast<s32>(sample);
+        }
+        gain += ramp;
+    }
+}
+
+template <size_t Taps>
+s32 FilterScalar(const s16* input, const f32* lut) {
+    Common::FixedPoint<56, 8> sum{0};
+    for (size_t i = 0; i < Taps; i++) {
+        sum += Common::FixedPoint<56, 8>{input[i] * lut[i]};
+    }
+    return sum.to_int_floor();
+}
+
+void ConvertPcmFloatScalar(s16* output, const f32* input, u32 channel_count, u32 sample_count) {
+    constexpr s32 min = std::numeric_limits<s16>::min();
+    constexpr s32 max = std::numeric_limits<s16>::max();
+    for (u32 i = 0; i < sample_count; i++) {
+        const auto sample =
+            static_cast<s32>(input[i * channel_count] * std::numeric_limits<s16>::max());
+        output[i] = static_cast<s16>(std::clamp(sample, min, max));
+    }
+}
+
+void DeinterleavePcm16Scalar(s16* output, const s16* input, u32 channel_count,
+                             u32 sample_count) {
+    for (u32 i = 0; i < sample_count; i++) {
+        output[i] = input[i * channel_count];
+    }
+}
+
+/// Get the number of samples of one channel which can be read 8 at a time, without the vector
+/// loads of all interleaved channels reading past the end of the input.
+u32 PcmVectorCount(size_t input_size, u32 channel, u32 channel_count, u32 sample_count) {
+    const size_t available = input_size > channel ? (input_size - channel) / channel_count : 0;
+    return static_cast<u32>(std::min<size_t>(sample_count, available)) & ~7U;
+}
+
+#if defined(ARCHITECTURE_x86_64)
+template <size_t Q>
+TARGET_SSE41 __m128i RoundSSE41(__m128i even, __m128i odd) {
+    const __m128i fractional_mask = _mm_set1_epi64x((s64{1} << Q) - 1);
+    even = _mm_add_epi64(even, _mm_srli_epi64(_mm_and_si128(even, fractional_mask), 1));
+    odd = _mm_add_epi64(odd, _mm_srli_epi64(_mm_and_si128(odd, fractional_mask), 1));
+
+    // Logical shifts leave the same low 32 bits as arithmetic shifts for Q <= 32
+    even = _mm_srli_epi64(even, static_cast<int>(Q));
+    odd = _mm_slli_epi64(_mm_srli_epi64(odd, static_cast<int>(Q)), 32);
+    return _mm_blend_epi16(even, odd, 0xCC);
+}
+
+template <size_t Q, bool Mix>
+TARGET_SSE41 u32 GainSSE41(s32* output, const s32* input, s64 gain, s64 ramp, u32 sample_count) {
+    const u32 vector_count = sample_count & ~3U;
+    __m128i gains = _mm_setr_epi32(
+        static_cast<s32>(gain), static_cast<s32>(RampedGain(gain, ramp, 1)),
+        static_cast<s32>(RampedGain(gain, ramp, 2)), static_cast<s32>(RampedGain(gain, ramp, 3)));
+    const __m128i step = _mm_set1_epi32(static_cast<s32>(RampedGain(0, ramp, 4)));
+    for (u32 i = 0; i < vector_count; i += 4) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i even = _mm_mul_epi32(samples, gains);
+        const __m128i odd = _mm_mul_epi32(_mm_srli_epi64(samples, 32), _mm_srli_epi64(gains, 32));
+        __m128i result = RoundSSE41<Q>(even, odd);
+        if constexpr (Mix) {
+            result = _mm_add_epi32(result,
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(output + i)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), result);
+        gains = _mm_add_epi32(gains, step);
+    }
+    return vector_count;
+}
+
+template <size_t Q, bool Mix>
+TARGET_AVX2 u32 GainAVX2(s32* output, const s32* input, s64 gain, s64 ramp, u32 sample_count) {
+    const u32 vector_count = sample_count & ~7U;
+    alignas(32) std::array<s32, 8> initial_gains;
+    for (u32 i = 0; i < 8; i++) {
+        initial_gains[i] = static_cast<s32>(RampedGain(gain, ramp, i));
+    }
+    __m256i gains = _mm256_load_si256(reinterpret_cast<const __m256i*>(initial_gains.data()));
+    const __m256i step = _mm256_set1_epi32(static_cast<s32>(RampedGain(0, ramp, 8)));
+    const __m256i fractional_mask = _mm256_set1_epi64x((s64{1} << Q) - 1);
+    for (u32 i = 0; i < vector_count; i += 8) {
+        const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i even = _mm256_mul_epi32(samples, gains);
+        __m256i odd =
+            _mm256_mul_epi32(_mm256_srli_epi64(samples, 32), _mm256_srli_epi64(gains, 32));
+        even = _mm256_add_epi64(even,
+                                _mm256_srli_epi64(_mm256_and_si256(even, fractional_mask), 1));
+        odd = _mm256_add_epi64(odd, _mm256_srli_epi64(_mm256_and_si256(odd, fractional_mask), 1));
+        even = _mm256_srli_epi64(even, static_cast<int>(Q));
+        odd = _mm256_slli_epi64(_mm256_srli_epi64(odd, static_cast<int>(Q)), 32);
+        __m256i result = _mm256_blend_epi32(even, odd, 0xAA);
+        if constexpr (Mix) {
+            result = _mm256_add_epi32(
+                result, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(output + i)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), result);
+        gains = _mm256_add_epi32(gains, step);
+    }
+    return vector_count;
+}
+
+TARGET_SSE41 inline s32 HorizontalSumSSE41(__m128i values) {
+    values = _mm_add_epi32(values, _mm_shuffle_epi32(values, 0x4E));
+    values = _mm_add_epi32(values, _mm_shuffle_epi32(values, 0xB1));
+    return _mm_cvtsi128_si32(values);
+}
+
+TARGET_SSE41 inline __m128i FilterTermsSSE41(__m128i samples, const f32* lut) {
+    const __m128 products = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(samples)),
+                                       _mm_loadu_ps(lut));
+    return _mm_cvttps_epi32(_mm_mul_ps(products, _mm_set1_ps(256.0f)));
+}
+
+struct FilterSSE41 {
+    template <size_t Taps>
+    TARGET_SSE41 static s32 Apply(const s16* input, const f32* lut) {
+        __m128i terms =
+            FilterTermsSSE41(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)), lut);
+        if constexpr (Taps == 8) {
+            terms = _mm_add_epi32(
+                terms, FilterTermsSSE41(
+                           _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + 4)), lut + 4));
+        }
+        return HorizontalSumSSE41(terms) >> 8;
+    }
+};
+
+struct FilterAVX2 {
+    template <size_t Taps>
+    TARGET_AVX2 static s32 Apply(const s16* input, const f32* lut) {
+        if constexpr (Taps == 4) {
+            return HorizontalSumSSE41(FilterTermsSSE41(
+                       _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)), lut)) >>
+                   8;
+        } else {
+            const __m256i samples = _mm256_cvtepi16_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(input)));
+            const __m256 products =
+                _mm256_mul_ps(_mm256_cvtepi32_ps(samples), _mm256_loadu_ps(lut));
+            const __m256i terms =
+                _mm256_cvttps_epi32(_mm256_mul_ps(products, _mm256_set1_ps(256.0f)));
+            return HorizontalSumSSE41(_mm_add_epi32(_mm256_castsi256_si128(terms),
+                                                    _mm256_extracti128_si256(terms, 1))) >>
+                   8;
+        }
+    }
+};
+
+/// Convert 8 samples of mono or stereo float PCM. The vector conversion truncates and
+/// saturates out of range samples to the minimum, like the scalar conversion on x86.
+template <u32 ChannelCount>
+TARGET_SSE41 void ConvertPcmFloatSSE41(s16* output, const f32* input, u32 vector_count) {
+    const __m128 scale = _mm_set1_ps(std::numeric_limits<s16>::max());
+    for (u32 i = 0; i < vector_count; i += 8) {
+        __m128 low;
+        __m128 high;
+        if constexpr (ChannelCount == 1) {
+            low = _mm_loadu_ps(input + i);
+            high = _mm_loadu_ps(input + i + 4);
+        } else {
+            const f32* frames = input + i * 2;
+            low = _mm_shuffle_ps(_mm_loadu_ps(frames), _mm_loadu_ps(frames + 4),
+                                 _MM_SHUFFLE(2, 0, 2, 0));
+            high = _mm_shuffle_ps(_mm_loadu_ps(frames + 8), _mm_loadu_ps(frames + 12),
+                                  _MM_SHUFFLE(2, 0, 2, 0));
+        }
+        const __m128i samples = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(low, scale)),
+                                                _mm_cvttps_epi32(_mm_mul_ps(high, scale)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), samples);
+    }
+}
+
+/// Copy 8 samples of the first channel of stereo s16 PCM at a time.
+TARGET_SSE41 void DeinterleaveStereoSSE41(s16* output, const s16* input, u32 vector_count) {
+    for (u32 i = 0; i < vector_count; i += 8) {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2));
+        const __m128i high =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2 + 8));
+        // Sign extend the first sample of each frame, which packs back without saturating
+        const __m128i samples = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(low, 16), 16),
+                                                _mm_srai_epi32(_mm_slli_epi32(high, 16), 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), samples);
+    }
+}
+#elif defined(ARCHITECTURE_arm64)
+template <size_t Q, bool Mix>
+u32 GainNEON(s32* output, const s32* input, s64 gain, s64 ramp, u32 sample_count) {
+    const u32 vector_count = sample_count & ~3U;
+    const std::array<s32, 4> initial_gains{
+        static_cast<s32>(gain), static_cast<s32>(RampedGain(gain, ramp, 1)),
+        static_cast<s32>(RampedGain(gain, ramp, 2)), static_cast<s32>(RampedGain(gain, ramp, 3))};
+    int32x4_t gains = vld1q_s32(initial_gains.data());
+    const int32x4_t step = vdupq_n_s32(static_cast<s32>(RampedGain(0, ramp, 4)));
+    const int64x2_t fractional_mask = vdupq_n_s64((s64{1} << Q) - 1);
+    for (u32 i = 0; i < vector_count; i += 4) {
+        const int32x4_t samples = vld1q_s32(input + i);
+        int64x2_t low = vmull_s32(vget_low_s32(samples), vget_low_s32(gains));
+        int64x2_t high = vmull_high_s32(samples, gains);
+        low = vaddq_s64(low, vshrq_n_s64(vandq_s64(low, fractional_mask), 1));
+        high = vaddq_s64(high, vshrq_n_s64(vandq_s64(high, fractional_mask), 1));
+        int32x4_t result =
+            vcombine_s32(vmovn_s64(vshrq_n_s64(low, Q)), vmovn_s64(vshrq_n_s64(high, Q)));
+        if constexpr (Mix) {
+            result = vaddq_s32(result, vld1q_s32(output + i));
+        }
+        vst1q_s32(output + i, result);
+        gains = vaddq_s32(gains, step);
+    }
+    return vector_count;
+}
+
+inline int32x4_t FilterTermsNEON(int32x4_t samples, const f32* lut) {
+    const float32x4_t products = vmulq_f32(vcvtq_f32_s32(samples), vld1q_f32(lut));
+    return vcvtq_s32_f32(vmulq_n_f32(products, 256.0f));
+}
+
+struct FilterNEON {
+    template <size_t Taps>
+    static s32 Apply(const s16* input, const f32* lut) {
+        if constexpr (Taps == 4) {
+            return vaddvq_s32(FilterTermsNEON(vmovl_s16(vld1_s16(input)), lut)) >> 8;
+        } else {
+            const int16x8_t samples = vld1q_s16(input);
+            return vaddvq_s32(vaddq_s32(FilterTermsNEON(vmovl_s16(vget_low_s16(samples)), lut),
+                                        FilterTermsNEON(vmovl_high_s16(samples), lut + 4))) >>
+                   8;
+        }
+    }
+};
+
+/// Convert 8 samples of mono or stereo float PCM. The vector conversion truncates and
+/// saturates out of range samples, like the scalar conversion on arm64.
+template <u32 ChannelCount>
+void ConvertPcmFloatNEON(s16* output, const f32* input, u32 vector_count) {
+    for (u32 i = 0; i < vector_count; i += 8) {
+        float32x4_t low;
+        float32x4_t high;
+        if constexpr (ChannelCount == 1) {
+            low = vld1q_f32(input + i);
+            high = vld1q_f32(input + i + 4);
+        } else {
+            low = vld2q_f32(input + i * 2).val[0];
+            high = vld2q_f32(input + i * 2 + 8).val[0];
+        }
+        const int32x4_t low_samples = vcvtq_s32_f32(vmulq_n_f32(low, 32767.0f));
+        const int32x4_t high_samples = vcvtq_s32_f32(vmulq_n_f32(high, 32767.0f));
+        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(low_samples), vqmovn_s32(high_samples)));
+    }
+}
+
+/// Copy 8 samples of the first channel of stereo s16 PCM at a time.
+void DeinterleaveStereoNEON(s16* output, const s16* input, u32 vector_count) {
+    for (u32 i = 0; i < vector_count; i += 8) {
+        vst1q_s16(output + i, vld2q_s16(input + i * 2).val[0]);
+    }
+}
+#endif
+
+template <size_t Q, bool Mix>
+void Gain(std::span<s32> output, std::span<const s32> input, s64 gain, s64 ramp,
+          u32 sample_count) {
+    u32 processed = 0;
+    if (GainsFit(gain, ramp, sample_count)) {
+        switch (GetBackend()) {
+#if defined(ARCHITECTURE_x86_64)
+        case Backend::AVX2:
+            processed =
+                GainAVX2<Q, Mix>(output.data(), input.data(), gain, ramp, sample_count);
+            break;
+        case Backend::SSE41:
+            processed =
+                GainSSE41<Q, Mix>(output.data(), input.data(), gain, ramp, sample_count);
+            break;
+#elif defined(ARCHITECTURE_arm64)
+        case Backend::NEON:
+            processed =
+                GainNEON<Q, Mix>(output.data(), input.data(), gain, ramp, sample_count);
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+    GainScalar<Q, Mix>(output.data() + processed, input.data() + processed,
+                       RampedGain(gain, ramp, processed), ramp, sample_count - processed);
+}
+
+template <size_t Taps, typename Filter>
+ALWAYS_INLINE void ResampleLoop(s32* output, const s16* input, const f32* lut, s64 ratio,
+                                s64& fraction, u32 samples_to_write) {
+    constexpr s64 fractional_mask = (s64{1} << 15) - 1;
+    u32 read_index{0};
+    for (u32 i = 0; i < samples_to_write; i++) {
+        const auto lut_index{((fraction & fractional_mask) >> 8) * static_cast<s64>(Taps)};
+        output[i] = Filter::template Apply<Taps>(input + read_index, lut + lut_index);
+        fraction += ratio;
+        read_index += static_cast<u32>(fraction >> 15);
+        fraction &= fractional_mask;
+    }
+}
+
+struct FilterScalarWrapper {
+    template <size_t Taps>
+    static s32 Apply(const s16* input, const f32* lut) {
+        return FilterScalar<Taps>(input, lut);
+    }
+};
+
+template <size_t Taps>
+void ResampleScalar(s32* output, const s16* input, const f32* lut, s64 ratio, s64& fraction,
+                    u32 samples_to_write) {
+    ResampleLoop<Taps, FilterScalarWrapper>(output, input, lut, ratio, fraction,
+                                            samples_to_write);
+}
+
+#if defined(ARCHITECTURE_x86_64)
+template <size_t Taps>
+TARGET_SSE41 void ResampleSSE41(s32* output, const s16* input, const f32* lut, s64 ratio,
+                                s64& fraction, u32 samples_to_write) {
+    ResampleLoop<Taps, FilterSSE41>(output, input, lut, ratio, fraction, samples_to_write);
+}
+
+template <size_t Taps>
+TARGET_AVX2 void ResampleAVX2(s32* output, const s16* input, const f32* lut, s64 ratio,
+                              s64& fraction, u32 samples_to_write) {
+    ResampleLoop<Taps, FilterAVX2>(output, input, lut, ratio, fraction, samples_to_write);
+}
+#endif
+} // Anonymous namespace
+
+Backend GetHostBackend() {
+#if defined(ARCHITECTURE_x86_64)
+    const auto& caps = Common::GetCPUCaps();
+    if (caps.avx2) {
+        return Backend::AVX2;
+    }
+    if (caps.sse4_1) {
+        return Backend::SSE41;
+    }
+    return Backend::Scalar;
+#elif defined(ARCHITECTURE_arm64)
+    return Backend::NEON;
+#else
+    return Backend::Scalar;
+#endif
+}
+
+Backend GetBackend() {
+    return current_backend.load(std::memory_order_relaxed);
+}
+
+void SetBackend(Backend backend) {
+    const Backend host = GetHostBackend();
+    const bool supported = backend == Backend::Scalar || backend == host ||
+                           (backend == Backend::SSE41 && host == Backend::AVX2);
+    if (supported) {
+        current_backend.store(backend, std::memory_order_relaxed);
+    }
+}
+
+template <size_t Q>
+void ApplyGain(std::span<s32> output, std::span<const s32> input, s64 gain, s64 ramp,
+               u32 sample_count) {
+    Gain<Q, false>(output, input, gain, ramp, sample_count);
+}
+
+template <size_t Q>
+s32 MixGain(std::span<s32> output, std::span<const s32> input, s64 gain, s64 ramp,
+            u32 sample_count) {
+    if (sample_count == 0) {
+        return 0;
+    }
+    Gain<Q, true>(output, input, gain, ramp, sample_count);
+    const s64 last_gain = RampedGain(gain, ramp, sample_count - 1);
+    return static_cast<s32>(Round<Q>(Multiply(input[sample_count - 1], last_gain)));
+}
+
+template <size_t Taps>
+void ResampleFilter(std::span<s32> output, std::span<const s16> input, std::span<const f32> lut,
+                    const Common::FixedPoint<49, 15>& sample_rate_ratio,
+                    Common::FixedPoint<49, 15>& fraction, u32 samples_to_write) {
+    const s64 ratio = sample_rate_ratio.to_raw();
+    s64 raw_fraction = fraction.to_raw();
+    switch (GetBackend()) {
+#if defined(ARCHITECTURE_x86_64)
+    case Backend::AVX2:
+        ResampleAVX2<Taps>(output.data(), input.data(), lut.data(), ratio, raw_fraction,
+                           samples_to_write);
+        break;
+    case Backend::SSE41:
+        ResampleSSE41<Taps>(output.data(), input.data(), lut.data(), ratio, raw_fraction,
+                            samples_to_write);
+        break;
+#elif defined(ARCHITECTURE_arm64)
+    case Backend::NEON:
+        ResampleLoop<Taps, FilterNEON>(output.data(), input.data(), lut.data(), ratio,
+                                       raw_fraction, samples_to_write);
+        break;
+#endif
+    default:
+        ResampleScalar<Taps>(output.data(), input.data(), lut.data(), ratio, raw_fraction,
+                             samples_to_write);
+        break;
+    }
+    fraction = Common::FixedPoint<49, 15>::from_base(raw_fraction);
+}
+
+void ConvertPcmFloat(std::span<s16> output, std::span<const f32> input, u32 channel,
+                     u32 channel_count, u32 sample_count) {
+    u32 processed = 0;
+    if (channel_count <= 2) {
+        const u32 vector_count = PcmVectorCount(input.size(), channel, channel_count, sample_count);
+        const f32* channel_input = input.data() + channel;
+        switch (GetBackend()) {
+#if defined(ARCHITECTURE_x86_64)
+        case Backend::AVX2:
+        case Backend::SSE41:
+            if (channel_count == 1) {
+                ConvertPcmFloatSSE41<1>(output.data(), channel_input, vector_count);
+            } else {
+                ConvertPcmFloatSSE41<2>(output.data(), channel_input, vector_count);
+            }
+            processed = vector_count;
+            break;
+#elif defined(ARCHITECTURE_arm64)
+        case Backend::NEON:
+            if (channel_count == 1) {
+                ConvertPcmFloatNEON<1>(output.data(), channel_input, vector_count);
+            } else {
+                ConvertPcmFloatNEON<2>(output.data(), channel_input, vector_count);
+            }
+            processed = vector_count;
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+    ConvertPcmFloatScalar(output.data() + processed,
+                          input.data() + channel + processed * channel_count, channel_count,
+                          sample_count - processed);
+}
+
+void DeinterleavePcm16(std::span<s16> output, std::span<const s16> input, u32 channel,
+                       u32 channel_count, u32 sample_count) {
+    if (channel_count == 1) {
+        std::memcpy(output.data(), input.data() + channel, sample_count * sizeof(s16));
+        return;
+    }
+    u32 processed = 0;
+    if (channel_count == 2) {
+        const u32 vector_count = PcmVectorCount(input.size(), channel, channel_count, sample_count);
+        switch (GetBackend()) {
+#if defined(ARCHITECTURE_x86_64)
+        case Backend::AVX2:
+        case Backend::SSE41:
+            DeinterleaveStereoSSE41(output.data(), input.data() + channel, vector_count);
+            processed = vector_count;
+            break;
+#elif defined(ARCHITECTURE_arm64)
+        case Backend::NEON:
+            DeinterleaveStereoNEON(output.data(), input.data() + channel, vector_count);
+            processed = vector_count;
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+    DeinterleavePcm16Scalar(output.data() + processed,
+                            input.data() + channel + processed * channel_count, channel_count,
+                            sample_count - processed);
+}
+
+u8 DecodeAdpcmFrames(std::span<s16> output, std::span<const u8> input,
+                     std::span<const s16, 16> coefficients, u32 frame_count, s16& yn0,
+                     s16& yn1) {
+    constexpr u32 SamplesPerFrame = 14;
+    constexpr u32 BytesPerFrame = 8;
+
+    u8 header = 0;
+    s32 history0 = yn0;
+    s32 history1 = yn1;
+    for (u32 frame = 0; frame < frame_count; frame++) {
+        const u8* data = input.data() + frame * BytesPerFrame;
+        s16* frame_output = output.data() + frame * SamplesPerFrame;
+        header = data[0];
+        const u32 coefficient_index = (header >> 4) & 7;
+        const s32 coeff0 = coefficients[coefficient_index * 2 + 0];
+        const s32 coeff1 = coefficients[coefficient_index * 2 + 1];
+        const s32 scale = 1 << (header & 0xF);
+
+        // Sign extend and scale every code of the frame first, leaving only the predictor in the
+        // sample loop
+        std::array<s32, SamplesPerFrame> codes;
+        for (u32 i = 0; i < SamplesPerFrame / 2; i++) {
+            const u8 byte = data[1 + i];
+            const s32 high = static_cast<s8>(byte) >> 4;
+            const s32 low = static_cast<s8>(byte << 4) >> 4;
+            codes[i * 2 + 0] = ((high * scale) << 11) + 0x400;
+            codes[i * 2 + 1] = ((low * scale) << 11) + 0x400;
+        }
+
+        for (u32 i = 0; i < SamplesPerFrame; i++) {
+            const s32 sample = (codes[i] + coeff0 * history0 + coeff1 * history1) >> 11;
+            history1 = history0;
+            history0 = std::clamp<s32>(sample, -0x8000, 0x7FFF);
+            frame_output[i] = static_cast<s16>(history0);
+        }
+    }
+    yn0 = static_cast<s16>(history0);
+    yn1 = static_cast<s16>(history1);
+    return header;
+}
+
+template void ApplyGain<15>(std::span<s32>, std::span<const s32>, s64, s64, u32);
+template void ApplyGain<23>(std::span<s32>, std::span<const s32>, s64, s64, u32);
+template s32 MixGain<15>(std::span<s32>, std::span<const s32>, s64, s64, u32);
+template s32 MixGain<23>(std::span<s32>, std::span<const s32>, s64, s64, u32);
+template void ResampleFilter<4>(std::span<s32>, std::span<const s16>, std::span<const f32>,
+                                const Common::FixedPoint<49, 15>&, Common::FixedPoint<49, 15>&,
+                                u32);
+template void ResampleFilter<8>(std::span<s32>, std::span<const s16>, std::span<const f32>,
+                                const Common::FixedPoint<49, 15>&, Common::FixedPoint<49, 15>&,
+                                u32);
+
+} // namespace AudioCore::Renderer::DSP
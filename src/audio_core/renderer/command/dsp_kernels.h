@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <span>
+
+#include "common/common_types.h"
+#include "common/fixed_point.h"
+
+namespace AudioCore::Renderer::DSP {
+
+/// Instruction sets the DSP kernels are implemented with.
+enum class Backend {
+    Scalar,
+    SSE41,
+    AVX2,
+    NEON,
+};
+
+/**
+ * Get the fastest backend supported by the host.
+ *
+ * @return The host backend.
+ */
+Backend GetHostBackend();
+
+/**
+ * Get the backend used by the DSP kernels, the host backend by default.
+ *
+ * @return The current backend.
+ */
+Backend GetBackend();
+
+/**
+ * Set the backend used by the DSP kernels, used to compare backends in tests and benchmarks.
+ * Backends the host does not support are ignored.
+ *
+ * @param backend - Backend to use.
+ */
+void SetBackend(Backend backend);
+
+/**
+ * Apply a linearly ramping gain to the input mix buffer, saving to the output buffer.
+ * Results are rounded like Common::FixedPoint<64 - Q, Q>::to_int.
+ *
+ * @tparam Q           - Number of bits for fixed point operations.
+ * @param output       - Output mix buffer.
+ * @param input        - Input mix buffer.
+ * @param gain         - Raw fixed point gain applied to the first sample.
+ * @param ramp         - Raw fixed point gain added after every sample.
+ * @param sample_count - Number of samples to process.
+ */
+template <size_t Q>
+void ApplyGain(std::span<s32> output, std::span<const s32> input, s64 gain, s64 ramp,
+               u32 sample_count);
+
+/**
+ * Mix the input mix buffer into the output mix buffer, with a linearly ramping gain applied to
+ * the input. Results are rounded like Common::FixedPoint<64 - Q, Q>::to_int.
+ *
+ * @tparam Q           - Number of bits for fixed point operations.
+ * @param output       - Output mix buffer.
+ * @param input        - Input mix buffer.
+ * @param gain         - Raw fixed point gain applied to the first sample.
+ * @param ramp         - Raw fixed point gain added after every sample.
+ * @param sample_count - Number of samples to process.
+ * @return The last sample mixed into the output, 0 if there are no samples.
+ */
+template <size_t Q>
+s32 MixGain(std::span<s32> output, std::span<const s32> input, s64 gain, s64 ramp,
+            u32 sample_count);
+
+/**
+ * Resample an input buffer with a polyphase filter.
+ *
+ * @tparam Taps             - Number of input samples filtered for every output sample.
+ * @param output            - Output buffer.
+ * @param input             - Input buffer.
+ * @param lut               - Filter coefficients, Taps for each of the 128 phases.
+ * @param sample_rate_ratio - Ratio for resampling.
+ * @param fraction          - Current read fraction, written to and should be passed back in for
+ *                            multiple calls.
+ * @param samples_to_write  - Number of samples to write.
+ */
+template <size_t Taps>
+void ResampleFilter(std::span<s32> output, std::span<const s16> input, std::span<const f32> lut,
+                    const Common::FixedPoint<49, 15>& sample_rate_ratio,
+                    Common::FixedPoint<49, 15>& fraction, u32 samples_to_write);
+
+/**
+ * Convert one channel of interleaved float PCM samples to s16, saturating out of range samples.
+ *
+ * @param output        - Output buffer.
+ * @param input         - Interleaved float samples.
+ * @param channel       - Channel to convert.
+ * @param channel_count - Number of interleaved channels.
+ * @param sample_count  - Number of samples to convert.
+ */
+void ConvertPcmFloat(std::span<s16> output, std::span<const f32> input, u32 channel,
+                     u32 channel_count, u32 sample_count);
+
+/**
+ * Copy one channel of interleaved s16 PCM samples.
+ *
+ * @param output        - Output buffer.
+ * @param input         - Interleaved s16 samples.
+ * @param channel       - Channel to copy.
+ * @param channel_count - Number of interleaved channels.
+ * @param sample_count  - Number of samples to copy.
+ */
+void DeinterleavePcm16(std::span<s16> output, std::span<const s16> input, u32 channel,
+                       u32 channel_count, u32 sample_count);
+
+/**
+ * Decode whole ADPCM frames, each made of a header byte followed by 14 4-bit samples.
+ * The sample codes of a frame are unpacked before running the predictor over them.
+ *
+ * @param output       - Output buffer, receiving 14 samples per frame.
+ * @param input        - ADPCM frames, 8 bytes each.
+ * @param coefficients - Predictor coefficients, a pair for each of the 8 coefficient sets.
+ * @param frame_count  - Number of frames to decode.
+ * @param yn0          - Last decoded sample, written to and should be passed back in.
+ * @param yn1          - Sample before the last decoded one, written to and should be passed
+ *                       back in.
+ * @return The header of the last decoded frame.
+ */
+u8 DecodeAdpcmFrames(std::span<s16> output, std::span<const u8> input,
+                     std::span<const s16, 16> coefficients, u32 frame_count, s16& yn0, s16& yn1);
+
+} // namespace AudioCore::Renderer::DSP
@@ -31,6 +31,7 @@ void DeviceSinkCommand::Process(const AudioRenderer::CommandListProcessor& proce
         .frames_played{0},
         .tag{0},
         .consumed{false},
+        .queued_time{},
     };
 
     std::array<s16, TargetSampleCount * MaxChannels> samples{};
@@ -29,6 +29,7 @@
 #include "audio_core/renderer/voice/voice_info.h"
 #include "audio_core/renderer/voice/voice_state.h"
 #include "common/alignment.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/kernel/k_event.h"
@@ -394,6 +395,20 @@ Result System::Initialize(const AudioRendererParameterInternal& params,
                                                                      mix_buffer_count);
     }
 
+    use_host_cost_model = Settings::values.audio_host_cost_model.GetValue();
+    if (use_host_cost_model) {
+        MixRampCommand mix_ramp{};
+        mix_ramp.type = CommandId::MixRamp;
+        VolumeRampCommand volume_ramp{};
+        volume_ramp.type = CommandId::VolumeRamp;
+
+        auto& cost_model{CommandCostModel::Get()};
+        cost_model.Calibrate(sample_count, command_processing_time_estimator->Estimate(mix_ramp),
+                             command_processing_time_estimator->Estimate(volume_ramp));
+        command_processing_time_estimator = std::make_unique<HostCommandProcessingTimeEstimator>(
+            std::move(command_processing_time_estimator), cost_model);
+    }
+
     initialized = true;
     return ResultSuccess;
 }
@@ -641,6 +656,7 @@ u64 System::GenerateCommand(std::span<u8> in_command_buffer,
     command_list_header->sample_count = sample_count;
     command_list_header->sample_rate = sample_rate;
     command_list_header->samples_buffer = samples_workbuffer;
+    command_list_header->measure_commands = use_host_cost_model;
 
     const auto performance_initialized{performance_manager.IsInitialized()};
     if (performance_initialized) {
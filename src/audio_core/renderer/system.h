@@ -267,6 +267,8 @@ private:
     SplitterContext splitter_context{};
     /// Estimates the time taken for each command
     std::unique_ptr<ICommandProcessingTimeEstimator> command_processing_time_estimator{};
+    /// Are the estimates scaled by the host cost model, whose commands must then be measured?
+    bool use_host_cost_model{};
     /// Session id of this system
     s32 session_id{};
     /// Number of channels in use by voices
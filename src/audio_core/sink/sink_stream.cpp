@@ -1,17 +1,24 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
+#include <chrono>
 #include <memory>
+#include <numeric>
 #include <span>
 #include <vector>
 
+#include <fmt/ranges.h>
+
 #include "audio_core/audio_core.h"
 #include "audio_core/common/common.h"
 #include "audio_core/sink/sink_stream.h"
 #include "common/common_types.h"
 #include "common/fixed_point.h"
+#include "common/logging/log.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "core/core.h"
@@ -19,7 +26,41 @@
 
 namespace AudioCore::Sink {
 
+namespace {
+/// Write samples straight into reserved slots of the sample ring
+/// @param slots       The reserved slots
+/// @param get_sample  Gives the sample to write at each index of the reserved slots
+/// @returns The number of samples written
+template <typename Func>
+size_t WriteSamples(std::array<std::span<s16>, 2> slots, Func&& get_sample) {
+    size_t index{0};
+    for (const auto slot : slots) {
+        for (auto& sample : slot) {
+            sample = get_sample(index++);
+        }
+    }
+    return index;
+}
+
+std::chrono::nanoseconds GetHostTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch());
+}
+} // Anonymous namespace
+
+SinkStream::~SinkStream() {
+    const auto statistics{GetStatistics()};
+    const auto& histogram{statistics.latency_histogram};
+    if (std::accumulate(histogram.begin(), histogram.end(), u64{0}) == 0) {
+        return;
+    }
+    LOG_INFO(Audio_Sink,
+             "Stream {}: {} underruns, buffer latency histogram <1ms..>=128ms [{}]", name,
+             statistics.underruns, fmt::join(histogram, ", "));
+}
+
 void SinkStream::AppendBuffer(SinkBuffer& buffer, std::span<s16> samples) {
+    buffer.queued_time = GetHostTime();
     SCOPE_EXIT {
         queue.enqueue(buffer);
         ++queued_buffers;
@@ -37,6 +78,9 @@ void SinkStream::AppendBuffer(SinkBuffer& buffer, std::span<s16> samples) {
         sudachi_volume = 0.6f + 20 * std::log10(sudachi_volume);
     }
     auto volume{system_volume * device_volume * sudachi_volume};
+    const auto scale = [&](f32 sample) {
+        return static_cast<s16>(std::clamp(static_cast<s32>(sample * volume), min, max));
+    };
 
     if (system_channels == 6 && device_channels == 2) {
         // We're given 6 channels, but our device only outputs 2, so downmix.
@@ -46,38 +90,21 @@ void SinkStream::AppendBuffer(SinkBuffer& buffer, std::span<s16> samples) {
         // Back = 0.707
         static constexpr std::array<f32, 4> down_mix_coeff{1.0, 0.596f, 0.354f, 0.707f};
 
-        for (u32 read_index = 0, write_index = 0; read_index < samples.size();
-             read_index += system_channels, write_index += device_channels) {
-            const auto fl =
-                static_cast<f32>(samples[read_index + static_cast<u32>(Channels::FrontLeft)]);
-            const auto fr =
-                static_cast<f32>(samples[read_index + static_cast<u32>(Channels::FrontRight)]);
-            const auto c =
-                static_cast<f32>(samples[read_index + static_cast<u32>(Channels::Center)]);
-            const auto lfe =
-                static_cast<f32>(samples[read_index + static_cast<u32>(Channels::LFE)]);
-            const auto bl =
-                static_cast<f32>(samples[read_index + static_cast<u32>(Channels::BackLeft)]);
-            const auto br =
-                static_cast<f32>(samples[read_index + static_cast<u32>(Channels::BackRight)]);
-
-            const auto left_sample{
-                static_cast<s32>((fl * down_mix_coeff[0] + c * down_mix_coeff[1] +
-                                  lfe * down_mix_coeff[2] + bl * down_mix_coeff[3]) *
-                                 volume)};
-
-            const auto right_sample{
-                static_cast<s32>((fr * down_mix_coeff[0] + c * down_mix_coeff[1] +
-                                  lfe * down_mix_coeff[2] + br * down_mix_coeff[3]) *
-                                 volume)};
-
-            samples[write_index + static_cast<u32>(Channels::FrontLeft)] =
-                static_cast<s16>(std::clamp(left_sample, min, max));
-            samples[write_index + static_cast<u32>(Channels::FrontRight)] =
-                static_cast<s16>(std::clamp(right_sample, min, max));
-        }
-
-        samples_buffer.Push(samples.subspan(0, samples.size() / system_channels * device_channels));
+        const auto frame_count{samples.size() / system_channels};
+        const auto slots{samples_buffer.Reserve(frame_count * device_channels)};
+        samples_buffer.Commit(WriteSamples(slots, [&](size_t index) {
+            const auto frame{samples.subspan(index / device_channels * system_channels)};
+            const bool left{index % device_channels == static_cast<u32>(Channels::FrontLeft)};
+            const auto front = static_cast<f32>(
+                frame[static_cast<u32>(left ? Channels::FrontLeft : Channels::FrontRight)]);
+            const auto c = static_cast<f32>(frame[static_cast<u32>(Channels::Center)]);
+            const auto lfe = static_cast<f32>(frame[static_cast<u32>(Channels::LFE)]);
+            const auto back = static_cast<f32>(
+                frame[static_cast<u32>(left ? Channels::BackLeft : Channels::BackRight)]);
+
+            return scale(front * down_mix_coeff[0] + c * down_mix_coeff[1] +
+                         lfe * down_mix_coeff[2] + back * down_mix_coeff[3]);
+        }));
         return;
     }
 
@@ -85,46 +112,34 @@ void SinkStream::AppendBuffer(SinkBuffer& buffer, std::span<s16> samples) {
         // We need moar samples! Not all games will provide 6 channel audio.
         // TODO: Implement some upmixing here. Currently just passthrough, with other
         // channels left as silence.
-        std::vector<s16> new_samples(samples.size() / system_channels * device_channels);
-
-        for (u32 read_index = 0, write_index = 0; read_index < samples.size();
-             read_index += system_channels, write_index += device_channels) {
-            const auto left_sample{static_cast<s16>(std::clamp(
-                static_cast<s32>(
-                    static_cast<f32>(samples[read_index + static_cast<u32>(Channels::FrontLeft)]) *
-                    volume),
-                min, max))};
-
-            new_samples[write_index + static_cast<u32>(Channels::FrontLeft)] = left_sample;
-
-            const auto right_sample{static_cast<s16>(std::clamp(
-                static_cast<s32>(
-                    static_cast<f32>(samples[read_index + static_cast<u32>(Channels::FrontRight)]) *
-                    volume),
-                min, max))};
-
-            new_samples[write_index + static_cast<u32>(Channels::FrontRight)] = right_sample;
-        }
-
-        samples_buffer.Push(new_samples);
+        const auto frame_count{samples.size() / system_channels};
+        const auto slots{samples_buffer.Reserve(frame_count * device_channels)};
+        samples_buffer.Commit(WriteSamples(slots, [&](size_t index) {
+            const auto channel{index % device_channels};
+            if (channel >= system_channels) {
+                return s16{0};
+            }
+            return scale(static_cast<f32>(
+                samples[index / device_channels * system_channels + channel]));
+        }));
         return;
     }
 
-    if (volume != 1.0f) {
-        for (u32 i = 0; i < samples.size(); ++i) {
-            samples[i] = static_cast<s16>(
-                std::clamp(static_cast<s32>(static_cast<f32>(samples[i]) * volume), min, max));
-        }
+    if (volume == 1.0f) {
+        samples_buffer.Push(samples);
+        return;
     }
 
-    samples_buffer.Push(samples);
+    const auto slots{samples_buffer.Reserve(samples.size())};
+    samples_buffer.Commit(WriteSamples(
+        slots, [&](size_t index) { return scale(static_cast<f32>(samples[index])); }));
 }
 
-std::vector<s16> SinkStream::ReleaseBuffer(u64 num_samples) {
+void SinkStream::ReleaseBuffer(std::span<s16> samples) {
     constexpr s32 min = std::numeric_limits<s16>::min();
     constexpr s32 max = std::numeric_limits<s16>::max();
 
-    auto samples{samples_buffer.Pop(num_samples)};
+    const auto count{samples_buffer.Pop(samples.data(), samples.size())};
 
     // TODO: Up-mix to 6 channels if the game expects it.
     // For audio input this is unlikely to ever be the case though.
@@ -132,15 +147,12 @@ std::vector<s16> SinkStream::ReleaseBuffer(u64 num_samples) {
     // Incoming mic volume seems to always be very quiet, so multiply by an additional 8 here.
     // TODO: Play with this and find something that works better.
     auto volume{system_volume * device_volume * 8};
-    for (u32 i = 0; i < samples.size(); i++) {
+    for (u32 i = 0; i < count; i++) {
         samples[i] = static_cast<s16>(
             std::clamp(static_cast<s32>(static_cast<f32>(samples[i]) * volume), min, max));
     }
 
-    if (samples.size() < num_samples) {
-        samples.resize(num_samples, 0);
-    }
-    return samples;
+    std::fill(samples.begin() + count, samples.end(), s16{0});
 }
 
 void SinkStream::ClearQueue() {
@@ -201,30 +213,140 @@ void SinkStream::ProcessAudioIn(std::span<const s16> input_buffer, std::size_t n
 }
 
 void SinkStream::ProcessAudioOutAndRender(std::span<s16> output_buffer, std::size_t num_frames) {
+    ProcessAudioOutAndRender(output_buffer, num_frames, GetHostTime());
+}
+
+void SinkStream::ProcessAudioOutAndRender(std::span<s16> output_buffer, std::size_t num_frames,
+                                          std::chrono::nanoseconds callback_time) {
     const std::size_t num_channels = GetDeviceChannels();
     const std::size_t frame_size = num_channels;
     const std::size_t frame_size_bytes = frame_size * sizeof(s16);
-    size_t frames_written{0};
-    size_t actual_frames_written{0};
 
     // If we're paused or going to shut down, we don't want to consume buffers as coretiming is
     // paused and we'll desync, so just play silence.
     if (system.IsPaused() || system.IsShuttingDown()) {
         if (system.IsShuttingDown()) {
-            {
-                std::scoped_lock lk{release_mutex};
-                queued_buffers.store(0);
-            }
+            queued_buffers.store(0);
             release_cv.notify_one();
         }
 
         static constexpr std::array<s16, 6> silence{};
-        for (size_t i = frames_written; i < num_frames; i++) {
+        for (size_t i = 0; i < num_frames; i++) {
             std::memcpy(&output_buffer[i * frame_size], &silence[0], frame_size_bytes);
         }
         return;
     }
 
+    const auto queued_frames{samples_buffer.Size() / frame_size};
+    latency.store(std::chrono::microseconds{(queued_frames + num_frames) * 1'000'000 /
+                                            TargetSampleRate},
+                  std::memory_order_relaxed);
+
+    size_t actual_frames_written{};
+    if (IsLowLatency()) {
+        const auto previous_underruns{underruns.load(std::memory_order_relaxed)};
+        actual_frames_written = StretchFrames(output_buffer, num_frames, queued_frames);
+        UpdateLatencyTarget(callback_time, num_frames,
+                            underruns.load(std::memory_order_relaxed) != previous_underruns);
+    } else {
+        actual_frames_written = PopFrames(output_buffer, num_frames);
+    }
+
+    // The callback is the only writer of the sample counts, so they are published with a
+    // sequence lock rather than blocking it on a mutex
+    const auto sequence{sample_count_sequence.load(std::memory_order_relaxed)};
+    sample_count_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const auto played_sample_count{max_played_sample_count.load(std::memory_order_relaxed)};
+    last_sample_count_update_time.store(system.CoreTiming().GetGlobalTimeNs(),
+                                        std::memory_order_relaxed);
+    min_played_sample_count.store(played_sample_count, std::memory_order_relaxed);
+    max_played_sample_count.store(played_sample_count + actual_frames_written,
+                                  std::memory_order_relaxed);
+    sample_count_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+u64 SinkStream::GetExpectedPlayedSampleCount() {
+    u64 sequence{};
+    u64 min_played{};
+    u64 max_played{};
+    std::chrono::nanoseconds last_update_time{};
+    do {
+        sequence = sample_count_sequence.load(std::memory_order_acquire);
+        min_played = min_played_sample_count.load(std::memory_order_relaxed);
+        max_played = max_played_sample_count.load(std::memory_order_relaxed);
+        last_update_time = last_sample_count_update_time.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) != 0 ||
+             sample_count_sequence.load(std::memory_order_relaxed) != sequence);
+
+    auto cur_time{system.CoreTiming().GetGlobalTimeNs()};
+    auto time_delta{cur_time - last_update_time};
+    auto exp_played_sample_count{min_played +
+                                 (TargetSampleRate * time_delta) / std::chrono::seconds{1}};
+
+    // Add 15ms of latency in sample reporting to allow for some leeway in scheduler timings
+    return std::min<u64>(exp_played_sample_count, max_played) + TargetSampleCount * 3;
+}
+
+void SinkStream::WaitFreeSpace(std::stop_token stop_token) {
+    const auto has_free_space = [this] { return paused || queued_buffers < GetTargetQueueSize(); };
+
+    std::unique_lock lk{release_mutex};
+    if (IsLowLatency()) {
+        // Hold the queue at its target size, it is what bounds the latency
+        while (!stop_token.stop_requested() &&
+               !release_cv.wait_for(lk, std::chrono::milliseconds(5), has_free_space)) {
+        }
+        return;
+    }
+
+    release_cv.wait_for(lk, std::chrono::milliseconds(5), has_free_space);
+    if (queued_buffers > max_queue_size + 3) {
+        // The callback may signal between the check and the wait, so keep the waits bounded
+        while (!stop_token.stop_requested() &&
+               !release_cv.wait_for(lk, std::chrono::milliseconds(5), has_free_space)) {
+        }
+    }
+}
+
+u32 SinkStream::GetTargetQueueSize() const {
+    const auto target{target_queue_size.load(std::memory_order_relaxed)};
+    if (!IsLowLatency() || target == 0) {
+        return max_queue_size;
+    }
+    return std::min(target, max_queue_size);
+}
+
+SinkStreamStatistics SinkStream::GetStatistics() const {
+    SinkStreamStatistics statistics{
+        .underruns = underruns.load(std::memory_order_relaxed),
+        .latency_histogram{},
+    };
+    for (size_t i = 0; i < LatencyBucketCount; i++) {
+        statistics.latency_histogram[i] = latency_histogram[i].load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
+void SinkStream::RecordLatency(std::chrono::nanoseconds buffer_latency) {
+    const auto milliseconds{
+        static_cast<u64>(std::max<s64>(buffer_latency / std::chrono::milliseconds{1}, 0))};
+    const auto bucket{std::min<size_t>(std::bit_width(milliseconds), LatencyBucketCount - 1)};
+    latency_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+bool SinkStream::IsLowLatency() const {
+    return type == StreamType::Render && Settings::values.audio_low_latency.GetValue();
+}
+
+size_t SinkStream::PopFrames(std::span<s16> output_buffer, size_t num_frames) {
+    const std::size_t num_channels = GetDeviceChannels();
+    const std::size_t frame_size = num_channels;
+    const std::size_t frame_size_bytes = frame_size * sizeof(s16);
+    size_t frames_written{0};
+    size_t actual_frames_written{0};
+
     while (frames_written < num_frames) {
         // If the playing buffer has been consumed or has no frames, we need a new one
         if (playing_buffer.consumed || playing_buffer.frames == 0) {
@@ -235,13 +357,15 @@ void SinkStream::ProcessAudioOutAndRender(std::span<s16> output_buffer, std::siz
                     std::memcpy(&output_buffer[i * frame_size], &last_frame[0], frame_size_bytes);
                 }
                 frames_written = num_frames;
+                underruns.fetch_add(1, std::memory_order_relaxed);
                 continue;
             }
             // Successfully dequeued a new buffer.
             queued_buffers--;
+            RecordLatency(GetHostTime() - playing_buffer.queued_time);
 
-            { std::unique_lock lk{release_mutex}; }
-
+            // Not taking release_mutex may lose this wakeup, WaitFreeSpace only waits for a
+            // bounded time for this reason
             release_cv.notify_one();
         }
 
@@ -264,36 +388,95 @@ void SinkStream::ProcessAudioOutAndRender(std::span<s16> output_buffer, std::siz
         }
     }
 
-    std::memcpy(&last_frame[0], &output_buffer[(frames_written - 1) * frame_size],
-                frame_size_bytes);
-
-    {
-        std::scoped_lock lk{sample_count_lock};
-        last_sample_count_update_time = system.CoreTiming().GetGlobalTimeNs();
-        min_played_sample_count = max_played_sample_count;
-        max_played_sample_count += actual_frames_written;
+    if (frames_written > 0) {
+        std::memcpy(&last_frame[0], &output_buffer[(frames_written - 1) * frame_size],
+                    frame_size_bytes);
     }
+    return actual_frames_written;
 }
 
-u64 SinkStream::GetExpectedPlayedSampleCount() {
-    std::scoped_lock lk{sample_count_lock};
-    auto cur_time{system.CoreTiming().GetGlobalTimeNs()};
-    auto time_delta{cur_time - last_sample_count_update_time};
-    auto exp_played_sample_count{min_played_sample_count +
-                                 (TargetSampleRate * time_delta) / std::chrono::seconds{1}};
+size_t SinkStream::StretchFrames(std::span<s16> output_buffer, size_t num_frames,
+                                 size_t queued_frames) {
+    // Largest change in playback rate, small enough to not be heard as a change in pitch
+    constexpr f64 MaxStretch = 0.02;
+    // Rate change per relative difference between the queued and target frames
+    constexpr f64 StretchGain = 0.05;
+    // Weight of the new rate in the smoothed rate
+    constexpr f64 StretchSmoothing = 0.1;
 
-    // Add 15ms of latency in sample reporting to allow for some leeway in scheduler timings
-    return std::min<u64>(exp_played_sample_count, max_played_sample_count) + TargetSampleCount * 3;
+    const std::size_t frame_size = GetDeviceChannels();
+    const std::size_t frame_size_bytes = frame_size * sizeof(s16);
+
+    // Consume more frames than played while the queue is above its target, and fewer while it is
+    // below, so drift in emulation speed is absorbed without dropping or repeating buffers
+    if (target_queued_frames > 0.0) {
+        const auto error{(static_cast<f64>(queued_frames) - target_queued_frames) /
+                         target_queued_frames};
+        const auto ratio{1.0 + std::clamp(error * StretchGain, -MaxStretch, MaxStretch)};
+        stretch_ratio += (ratio - stretch_ratio) * StretchSmoothing;
+    }
+    const auto wanted_frames{static_cast<f64>(num_frames) * stretch_ratio + stretch_carry};
+    const auto input_frames{static_cast<size_t>(wanted_frames)};
+    stretch_carry = wanted_frames - static_cast<f64>(input_frames);
+    if (num_frames == 0 || input_frames == 0 || input_frames > MaxStretchFrames) {
+        return PopFrames(output_buffer, num_frames);
+    }
+
+    // Interpolate linearly from the last played frame, so the last output frame is the last
+    // popped one and consecutive callbacks join up
+    const auto previous_frame{last_frame};
+    const std::span<s16> input{stretch_buffer.data(), input_frames * frame_size};
+    const auto actual_frames_written{PopFrames(input, input_frames)};
+    const auto get_frame = [&](size_t index) {
+        return index == 0 ? previous_frame.data() : &input[(index - 1) * frame_size];
+    };
+
+    const auto output_frames{static_cast<s64>(num_frames)};
+    for (size_t i = 0; i < num_frames; i++) {
+        const auto position{(i + 1) * input_frames};
+        const auto index{position / num_frames};
+        const auto fraction{static_cast<s64>(position % num_frames)};
+        const auto* a{get_frame(index)};
+        if (fraction == 0) {
+            std::memcpy(&output_buffer[i * frame_size], a, frame_size_bytes);
+            continue;
+        }
+        const auto* b{get_frame(index + 1)};
+        for (size_t channel = 0; channel < frame_size; channel++) {
+            output_buffer[i * frame_size + channel] =
+                static_cast<s16>(a[channel] + (b[channel] - a[channel]) * fraction / output_frames);
+        }
+    }
+    return actual_frames_written;
 }
 
-void SinkStream::WaitFreeSpace(std::stop_token stop_token) {
-    std::unique_lock lk{release_mutex};
-    release_cv.wait_for(lk, std::chrono::milliseconds(5),
-                        [this]() { return paused || queued_buffers < max_queue_size; });
-    if (queued_buffers > max_queue_size + 3) {
-        Common::CondvarWait(release_cv, lk, stop_token,
-                            [this] { return paused || queued_buffers < max_queue_size; });
+void SinkStream::UpdateLatencyTarget(std::chrono::nanoseconds callback_time, size_t num_frames,
+                                     bool underrun) {
+    // Weight kept by the jitter peak per callback, so the queue drains over a few seconds
+    constexpr f64 JitterDecay = 0.998;
+    constexpr u32 MinQueueSize = 2;
+
+    if (last_callback_time.count() != 0) {
+        // Callbacks are due once the frames of the previous one have been played
+        const auto expected{std::chrono::nanoseconds{
+            last_callback_frames * std::chrono::nanoseconds{std::chrono::seconds{1}}.count() /
+            TargetSampleRate}};
+        const auto jitter{std::chrono::abs(callback_time - last_callback_time - expected)};
+        const auto jitter_frames{std::chrono::duration<f64>{jitter}.count() * TargetSampleRate};
+        jitter_peak = std::max(jitter_frames, jitter_peak * JitterDecay);
+    }
+    if (underrun) {
+        jitter_peak += TargetSampleCount;
     }
+    jitter_peak = std::min(jitter_peak, static_cast<f64>(max_queue_size * TargetSampleCount));
+    last_callback_time = callback_time;
+    last_callback_frames = num_frames;
+
+    // The ring must hold the next callback's frames, plus the jitter, plus the frames rendered
+    // at once by the renderer
+    target_queued_frames = static_cast<f64>(num_frames) + jitter_peak + TargetSampleCount;
+    const auto queue_size{static_cast<u32>(std::ceil(target_queued_frames / TargetSampleCount))};
+    target_queue_size.store(std::max(queue_size, MinQueueSize), std::memory_order_relaxed);
 }
 
 void SinkStream::SignalPause() {
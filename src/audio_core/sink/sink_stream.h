@@ -35,6 +35,23 @@ struct SinkBuffer {
     u64 frames_played;
     u64 tag;
     bool consumed;
+    /// Host time the buffer was appended at, used to measure its latency
+    std::chrono::nanoseconds queued_time;
+};
+
+/// Number of buckets in the latency histogram of a stream
+constexpr size_t LatencyBucketCount = 9;
+
+/**
+ * Instrumentation of a sink stream.
+ */
+struct SinkStreamStatistics {
+    /// Number of callbacks which ran out of samples to play
+    u64 underruns;
+    /// Number of buffers by the time between being appended and starting to play.
+    /// The first bucket counts buffers under 1ms, each following bucket doubles the time, and
+    /// the last one counts everything above.
+    std::array<u64, LatencyBucketCount> latency_histogram;
 };
 
 /**
@@ -56,7 +73,7 @@ struct SinkBuffer {
 class SinkStream {
 public:
     explicit SinkStream(Core::System& system_, StreamType type_) : system{system_}, type{type_} {}
-    virtual ~SinkStream() {}
+    virtual ~SinkStream();
 
     /**
      * Finalize the sink stream.
@@ -164,8 +181,26 @@ public:
         max_queue_size = ring_size;
     }
 
+    /**
+     * Get the number of buffers the renderer may queue before waiting.
+     * In low-latency mode this follows the measured callback jitter, up to the ring size.
+     *
+     * @return The target buffer queue size.
+     */
+    u32 GetTargetQueueSize() const;
+
+    /**
+     * Get the time between samples being appended and played, as of the last callback.
+     *
+     * @return The output latency.
+     */
+    std::chrono::microseconds GetLatency() const {
+        return latency.load(std::memory_order_relaxed);
+    }
+
     /**
      * Append a new buffer and its samples to a waiting queue to play.
+     * The samples are mixed to the device channels and volume straight into the sample ring.
      *
      * @param buffer  - Audio buffer information to be queued.
      * @param samples - The s16 samples to be queue for playback.
@@ -174,11 +209,11 @@ public:
 
     /**
      * Release a buffer. Audio In only, will fill a buffer with recorded samples.
+     * Samples missing from the recording are filled with silence.
      *
-     * @param num_samples - Maximum number of samples to receive.
-     * @return Vector of recorded samples. May have fewer than num_samples.
+     * @param samples - Buffer to fill with the recorded samples.
      */
-    virtual std::vector<s16> ReleaseBuffer(u64 num_samples);
+    virtual void ReleaseBuffer(std::span<s16> samples);
 
     /**
      * Empty out the buffer queue.
@@ -213,12 +248,78 @@ public:
      */
     void WaitFreeSpace(std::stop_token stop_token);
 
+    /**
+     * Get the underrun count and latency histogram of this stream.
+     *
+     * @return The stream statistics.
+     */
+    SinkStreamStatistics GetStatistics() const;
+
 protected:
     /**
      * Unblocks the ADSP if the stream is paused.
      */
     void SignalPause();
 
+    /**
+     * Callback for AudioOut and AudioRenderer, at a given host time.
+     *
+     * @param output_buffer - Output buffer to be filled with samples.
+     * @param num_frames    - Number of frames to be filled.
+     * @param callback_time - Host time the callback started, used to measure its jitter.
+     */
+    void ProcessAudioOutAndRender(std::span<s16> output_buffer, std::size_t num_frames,
+                                  std::chrono::nanoseconds callback_time);
+
+private:
+    /// Largest callback that can be time-stretched, in frames
+    static constexpr size_t MaxStretchFrames = 4096;
+
+    /**
+     * Check if the stream runs in low-latency mode.
+     *
+     * @return True if the buffer queue is sized from the callback jitter.
+     */
+    bool IsLowLatency() const;
+
+    /**
+     * Pop frames from the ring into an output buffer, releasing the buffers they belong to.
+     * Underruns are filled with the last played frame.
+     *
+     * @param output_buffer - Output buffer to be filled with frames.
+     * @param num_frames    - Number of frames to be filled.
+     * @return The number of frames popped from the ring.
+     */
+    size_t PopFrames(std::span<s16> output_buffer, size_t num_frames);
+
+    /**
+     * Fill an output buffer from more or fewer queued frames, resampled to the output size, to
+     * bring the queue back to its target without dropping or repeating buffers.
+     *
+     * @param output_buffer - Output buffer to be filled with frames.
+     * @param num_frames    - Number of frames to be filled.
+     * @param queued_frames - Number of frames queued in the ring.
+     * @return The number of frames popped from the ring.
+     */
+    size_t StretchFrames(std::span<s16> output_buffer, size_t num_frames, size_t queued_frames);
+
+    /**
+     * Update the target queue size from the jitter of the callbacks.
+     *
+     * @param callback_time - Host time the callback started.
+     * @param num_frames    - Number of frames requested by the callback.
+     * @param underrun      - If the callback ran out of frames.
+     */
+    void UpdateLatencyTarget(std::chrono::nanoseconds callback_time, size_t num_frames,
+                             bool underrun);
+
+    /**
+     * Count a buffer in the latency histogram.
+     *
+     * @param buffer_latency - Time between the buffer being appended and starting to play.
+     */
+    void RecordLatency(std::chrono::nanoseconds buffer_latency);
+
 protected:
     /// Core system
     Core::System& system;
@@ -246,19 +347,41 @@ private:
     std::atomic<u32> queued_buffers{};
     /// The ring size for audio out buffers (usually 4, rarely 2 or 8)
     u32 max_queue_size{};
-    /// Locks access to sample count tracking info
-    std::mutex sample_count_lock;
+    /// Sequence of the sample count tracking info, odd while the callback writes it
+    std::atomic<u64> sample_count_sequence{};
     /// Minimum number of total samples that have been played since the last callback
-    u64 min_played_sample_count{};
+    std::atomic<u64> min_played_sample_count{};
     /// Maximum number of total samples that can be played since the last callback
-    u64 max_played_sample_count{};
+    std::atomic<u64> max_played_sample_count{};
     /// The time the two above tracking variables were last written to
-    std::chrono::nanoseconds last_sample_count_update_time{};
+    std::atomic<std::chrono::nanoseconds> last_sample_count_update_time{};
+    /// Number of callbacks which ran out of samples to play
+    std::atomic<u64> underruns{};
+    /// Number of buffers by their latency, see SinkStreamStatistics
+    std::array<std::atomic<u64>, LatencyBucketCount> latency_histogram{};
     /// Set by the audio render/in/out system which uses this stream
     f32 system_volume{1.0f};
     /// Set via IAudioDevice service calls
     f32 device_volume{1.0f};
-    /// Signalled when ring buffer entries are consumed
+    /// Time between samples being appended and played, as of the last callback
+    std::atomic<std::chrono::microseconds> latency{};
+    /// Number of buffers the renderer may queue in low-latency mode, 0 until measured
+    std::atomic<u32> target_queue_size{};
+    /// Number of frames the callbacks keep queued in the ring in low-latency mode
+    f64 target_queued_frames{};
+    /// Decaying peak of the callback jitter, in frames
+    f64 jitter_peak{};
+    /// Host time and frame count of the last callback
+    std::chrono::nanoseconds last_callback_time{};
+    size_t last_callback_frames{};
+    /// Smoothed ratio of frames consumed to frames played
+    f64 stretch_ratio{1.0};
+    /// Fraction of a frame left over from the last stretched callback
+    f64 stretch_carry{};
+    /// Frames popped for a stretched callback
+    std::array<s16, MaxStretchFrames * MaxChannels> stretch_buffer{};
+    /// Signalled when ring buffer entries are consumed. The callback signals it without taking
+    /// the mutex, so waits on it are bounded.
     std::condition_variable_any release_cv;
     std::mutex release_mutex;
 };
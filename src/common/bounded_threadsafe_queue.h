@@ -56,6 +56,10 @@ public:
         return t;
     }
 
+    [[nodiscard]] bool Empty() const {
+        return m_read_index.load() == m_write_index.load();
+    }
+
 private:
     enum class PushMode {
         Try,
@@ -82,9 +86,11 @@ private:
         } else if constexpr (Mode == PushMode::Wait) {
             // Wait until we have free slots to write to.
             std::unique_lock lock{producer_cv_mutex};
+            ++m_producer_waiters;
             producer_cv.wait(lock, [this, write_index] {
-                return (write_index - m_read_index.load(std::memory_order::acquire)) < Capacity;
+                return (write_index - m_read_index.load()) < Capacity;
             });
+            --m_producer_waiters;
         } else {
             static_assert(Mode < PushMode::Count, "Invalid PushMode.");
         }
@@ -99,8 +105,7 @@ private:
         ++m_write_index;
 
         // Notify the consumer that we have pushed into the queue.
-        std::scoped_lock lock{consumer_cv_mutex};
-        consumer_cv.notify_one();
+        NotifyWaiter(m_consumer_waiters, consumer_cv, consumer_cv_mutex);
 
         return true;
     }
@@ -117,15 +122,19 @@ private:
         } else if constexpr (Mode == PopMode::Wait) {
             // Wait until the queue is not empty.
             std::unique_lock lock{consumer_cv_mutex};
+            ++m_consumer_waiters;
             consumer_cv.wait(lock, [this, read_index] {
-                return read_index != m_write_index.load(std::memory_order::acquire);
+                return read_index != m_write_index.load();
             });
+            --m_consumer_waiters;
         } else if constexpr (Mode == PopMode::WaitWithStopToken) {
             // Wait until the queue is not empty.
             std::unique_lock lock{consumer_cv_mutex};
+            ++m_consumer_waiters;
             Common::CondvarWait(consumer_cv, lock, stop_token, [this, read_index] {
-                return read_index != m_write_index.load(std::memory_order::acquire);
+                return read_index != m_write_index.load();
             });
+            --m_consumer_waiters;
             if (stop_token.stop_requested()) {
                 return false;
             }
@@ -143,17 +152,30 @@ private:
         ++m_read_index;
 
         // Notify the producer that we have popped off the queue.
-        std::scoped_lock lock{producer_cv_mutex};
-        producer_cv.notify_one();
+        NotifyWaiter(m_producer_waiters, producer_cv, producer_cv_mutex);
 
         return true;
     }
 
+    // A waiter registers itself before evaluating its predicate under the mutex, and the other
+    // side updates its index before reading the waiter count. Both are sequentially consistent,
+    // so the mutex only has to be taken when somebody may actually be sleeping.
+    static void NotifyWaiter(const std::atomic_size_t& waiters, std::condition_variable_any& cv,
+                             std::mutex& cv_mutex) {
+        if (waiters.load() == 0) {
+            return;
+        }
+        std::scoped_lock lock{cv_mutex};
+        cv.notify_one();
+    }
+
     alignas(128) std::atomic_size_t m_read_index{0};
     alignas(128) std::atomic_size_t m_write_index{0};
 
-    std::array<T, Capacity> m_data;
+    alignas(128) std::array<T, Capacity> m_data;
 
+    std::atomic_size_t m_producer_waiters{0};
+    std::atomic_size_t m_consumer_waiters{0};
     std::condition_variable_any producer_cv;
     std::mutex producer_cv_mutex;
     std::condition_variable_any consumer_cv;
@@ -195,6 +217,10 @@ public:
         return spsc_queue.PopWait(stop_token);
     }
 
+    [[nodiscard]] bool Empty() const {
+        return spsc_queue.Empty();
+    }
+
 private:
     SPSCQueue<T, Capacity> spsc_queue;
     std::mutex write_mutex;
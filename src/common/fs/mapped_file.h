@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "common/common_types.h"
+
+namespace Common::FS {
+
+class MappedFile final {
+public:
+    MappedFile();
+
+    /**
+     * A MappedFile is a read-only memory mapping of a whole file.
+     * The mapping shares the page cache with other processes mapping or reading the same file.
+     * Automatically unmaps the file on the destruction of a MappedFile object.
+     *
+     * Truncating the file while it is mapped makes accesses past its new end fault with SIGBUS.
+     * Private mappings fault the same way, as their pages are read from the file until they are
+     * written to, so only files that are not written to while in use should be mapped.
+     *
+     * @param path Filesystem path
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Maps the file at path. Empty files cannot be mapped.
+     *
+     * @param path Filesystem path
+     */
+    void Open(const std::filesystem::path& path);
+
+    /// Unmaps the file if it is mapped.
+    void Close();
+
+    /**
+     * Checks whether the file is mapped.
+     *
+     * @returns True if the file is mapped, false otherwise.
+     */
+    [[nodiscard]] bool IsOpen() const;
+
+    /**
+     * Gets a view of the contents of the file.
+     *
+     * @returns The mapped contents of the file, empty if the file is not mapped.
+     */
+    [[nodiscard]] std::span<const u8> GetSpan() const;
+
+private:
+    const u8* data = nullptr;
+    size_t size = 0;
+};
+
+} // namespace Common::FS
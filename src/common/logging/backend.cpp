@@ -1,10 +1,14 @@
 // SPDX-FileCopyrightText: 2014 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <climits>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -177,6 +181,26 @@ public:
 
 bool initialization_in_progress_suppress_logging = true;
 
+/**
+ * Entry waiting to be written. Messages logged with deferred arguments are only formatted once
+ * the logging thread writes them.
+ */
+struct QueuedEntry {
+    std::chrono::microseconds timestamp;
+    Class log_class{};
+    Level log_level{};
+    const char* filename = nullptr;
+    unsigned int line_num = 0;
+    const char* function = nullptr;
+    std::string message;
+    fmt::string_view format{};
+    DeferredArguments args{};
+};
+
+/// Lock-free queue owned by one logging thread, the backend thread is its only consumer
+constexpr size_t THREAD_QUEUE_CAPACITY = 256;
+using ThreadQueue = SPSCQueue<QueuedEntry, THREAD_QUEUE_CAPACITY>;
+
 /**
  * Static state as a singleton.
  */
@@ -222,6 +246,10 @@ public:
         filter = f;
     }
 
+    bool IsEnabled(Class log_class, Level log_level) const {
+        return filter.CheckMessage(log_class, log_level);
+    }
+
     void SetColorConsoleBackendEnabled(bool enabled) {
         color_console_backend.SetEnabled(enabled);
     }
@@ -231,8 +259,19 @@ public:
         if (!filter.CheckMessage(log_class, log_level)) {
             return;
         }
-        message_queue.EmplaceWait(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+        Push(CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+    }
+
+    void PushDeferredEntry(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, fmt::string_view format,
+                           const DeferredArguments& args) {
+        if (!filter.CheckMessage(log_class, log_level)) {
+            return;
+        }
+        QueuedEntry entry = CreateEntry(log_class, log_level, filename, line_num, function, {});
+        entry.format = format;
+        entry.args = args;
+        Push(std::move(entry));
     }
 
 private:
@@ -244,22 +283,16 @@ private:
     void StartBackendThread() {
         backend_thread = std::jthread([this](std::stop_token stop_token) {
             Common::SetCurrentThreadName("Logger");
-            Entry entry;
-            const auto write_logs = [this, &entry]() {
-                ForEachBackend([&entry](Backend& backend) { backend.Write(entry); });
-            };
+            std::vector<QueuedEntry> batch;
             while (!stop_token.stop_requested()) {
-                message_queue.PopWait(entry, stop_token);
-                if (entry.filename != nullptr) {
-                    write_logs();
-                }
+                WaitForEntries(stop_token);
+                CollectEntries(batch);
+                WriteEntries(batch, batch.size());
             }
-            // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a
+            // Drain the logging queues. Only writes out up to MAX_LOGS_TO_WRITE to prevent a
             // case where a system is repeatedly spamming logs even on close.
-            int max_logs_to_write = filter.IsDebug() ? INT_MAX : 100;
-            while (max_logs_to_write-- && message_queue.TryPop(entry)) {
-                write_logs();
-            }
+            CollectEntries(batch);
+            WriteEntries(batch, filter.IsDebug() ? batch.size() : 100);
         });
     }
 
@@ -272,8 +305,9 @@ private:
         ForEachBackend([](Backend& backend) { backend.Flush(); });
     }
 
-    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
-                      const char* function, std::string&& message) const {
+    QueuedEntry CreateEntry(Class log_class, Level log_level, const char* filename,
+                            unsigned int line_nr, const char* function,
+                            std::string&& message) const {
         using std::chrono::duration_cast;
         using std::chrono::microseconds;
         using std::chrono::steady_clock;
@@ -289,6 +323,80 @@ private:
         };
     }
 
+    void Push(QueuedEntry&& entry) {
+        thread_local std::shared_ptr<ThreadQueue> thread_queue;
+        if (!thread_queue) {
+            thread_queue = std::make_shared<ThreadQueue>();
+            std::scoped_lock lock{thread_queues_mutex};
+            thread_queues.push_back(thread_queue);
+        }
+        // Fall back to the shared queue when this thread logs faster than it can be written
+        if (!thread_queue->TryEmplace(std::move(entry))) {
+            overflow_queue.EmplaceWait(std::move(entry));
+        }
+        // Pushing is sequentially consistent, so a backend that is not counted as waiting yet
+        // will find the entry before going to sleep.
+        if (backend_waiters.load() != 0) {
+            std::scoped_lock lock{backend_mutex};
+            backend_cv.notify_one();
+        }
+    }
+
+    bool HasEntries() {
+        if (!overflow_queue.Empty()) {
+            return true;
+        }
+        std::scoped_lock lock{thread_queues_mutex};
+        return std::ranges::any_of(thread_queues,
+                                   [](const auto& thread_queue) { return !thread_queue->Empty(); });
+    }
+
+    void WaitForEntries(std::stop_token stop_token) {
+        std::unique_lock lock{backend_mutex};
+        ++backend_waiters;
+        Common::CondvarWait(backend_cv, lock, stop_token, [this] { return HasEntries(); });
+        --backend_waiters;
+    }
+
+    /// Moves the queued entries of every thread into batch, in timestamp order
+    void CollectEntries(std::vector<QueuedEntry>& batch) {
+        batch.clear();
+        QueuedEntry entry;
+        {
+            std::scoped_lock lock{thread_queues_mutex};
+            std::erase_if(thread_queues, [&](const std::shared_ptr<ThreadQueue>& thread_queue) {
+                // Only the registry holds the queue once its thread has exited
+                const bool thread_exited = thread_queue.use_count() == 1;
+                for (size_t i = 0; i < THREAD_QUEUE_CAPACITY && thread_queue->TryPop(entry); ++i) {
+                    batch.push_back(std::move(entry));
+                }
+                return thread_exited && thread_queue->Empty();
+            });
+        }
+        while (overflow_queue.TryPop(entry)) {
+            batch.push_back(std::move(entry));
+        }
+        std::ranges::stable_sort(batch, {}, &QueuedEntry::timestamp);
+    }
+
+    void WriteEntries(std::vector<QueuedEntry>& batch, size_t max_entries) {
+        const size_t count = std::min(batch.size(), max_entries);
+        Entry entry;
+        for (size_t i = 0; i < count; ++i) {
+            QueuedEntry& queued = batch[i];
+            entry.timestamp = queued.timestamp;
+            entry.log_class = queued.log_class;
+            entry.log_level = queued.log_level;
+            entry.filename = queued.filename;
+            entry.line_num = queued.line_num;
+            entry.function = queued.function;
+            entry.message = queued.args.formatter ? queued.args.Format(queued.format)
+                                                  : std::move(queued.message);
+            ForEachBackend([&entry](Backend& backend) { backend.Write(entry); });
+        }
+        batch.clear();
+    }
+
     void ForEachBackend(auto lambda) {
         lambda(static_cast<Backend&>(debugger_backend));
         lambda(static_cast<Backend&>(color_console_backend));
@@ -312,7 +420,14 @@ private:
     LogcatBackend lc_backend{};
 #endif
 
-    MPSCQueue<Entry> message_queue{};
+    std::mutex thread_queues_mutex;
+    std::vector<std::shared_ptr<ThreadQueue>> thread_queues;
+    MPSCQueue<QueuedEntry> overflow_queue{};
+
+    std::atomic_size_t backend_waiters{0};
+    std::condition_variable_any backend_cv;
+    std::mutex backend_mutex;
+
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
     std::jthread backend_thread;
 };
@@ -338,6 +453,11 @@ void SetGlobalFilter(const Filter& filter) {
     Impl::Instance().SetGlobalFilter(filter);
 }
 
+bool IsEnabled(Class log_class, Level log_level) {
+    return !initialization_in_progress_suppress_logging &&
+           Impl::Instance().IsEnabled(log_class, log_level);
+}
+
 void SetColorConsoleBackendEnabled(bool enabled) {
     Impl::Instance().SetColorConsoleBackendEnabled(enabled);
 }
@@ -350,4 +470,13 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                                    fmt::vformat(format, args));
     }
 }
+
+void FmtLogMessageDeferred(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, fmt::string_view format,
+                           const DeferredArguments& args) {
+    if (!initialization_in_progress_suppress_logging) {
+        Impl::Instance().PushDeferredEntry(log_class, log_level, filename, line_num, function,
+                                           format, args);
+    }
+}
 } // namespace Common::Log
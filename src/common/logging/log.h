@@ -9,6 +9,7 @@
 #include <fmt/format.h>
 
 #include "common/logging/formatter.h"
+#include "common/logging/log_arguments.h"
 #include "common/logging/types.h"
 
 namespace Common::Log {
@@ -22,14 +23,34 @@ constexpr const char* TrimSourcePath(std::string_view source) {
     return source.data() + idx;
 }
 
+/// Returns whether messages of the given class and level pass the global filter
+bool IsEnabled(Class log_class, Level log_level);
+
 /// Logs a message to the global logger, using fmt
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, fmt::string_view format,
                        const fmt::format_args& args);
 
+/// Logs a message to the global logger, formatting it on the logging thread.
+/// The format string must outlive the logger, as it does for string literals.
+void FmtLogMessageDeferred(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, fmt::string_view format,
+                           const DeferredArguments& args);
+
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, fmt::format_string<Args...> format, const Args&... args) {
+    if (!IsEnabled(log_class, log_level)) {
+        return;
+    }
+    if constexpr (DeferredArguments::IsDeferrable<Args...>) {
+        DeferredArguments deferred_args;
+        if (deferred_args.Pack(args...)) {
+            FmtLogMessageDeferred(log_class, log_level, filename, line_num, function, format,
+                                  deferred_args);
+            return;
+        }
+    }
     FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
                       fmt::make_format_args(args...));
 }
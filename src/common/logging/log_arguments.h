@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/logging/formatter.h"
+
+namespace Common::Log {
+
+namespace detail {
+
+template <typename T>
+constexpr bool IsStringArgument =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+    (std::is_array_v<T> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>);
+
+template <typename T>
+constexpr bool IsPointerArgument = std::is_same_v<T, void*> || std::is_same_v<T, const void*>;
+
+/// Arguments that can be copied by value and formatted later without referring to the caller
+template <typename T>
+constexpr bool IsDeferrable = std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+                              IsStringArgument<T> || IsPointerArgument<T>;
+
+/// Type an argument is stored and formatted as, strings are copied into the packed arguments
+template <typename T>
+using StoredArgument =
+    std::conditional_t<IsStringArgument<T>, std::string_view,
+                       std::conditional_t<IsPointerArgument<T>, const void*, T>>;
+
+} // namespace detail
+
+/**
+ * Log arguments packed by value, so a message can be formatted on the logging thread instead of
+ * at the call site. Only arithmetic, enum, string and pointer arguments can be packed, as any
+ * other type may refer to memory the caller releases before the message is formatted.
+ */
+struct DeferredArguments {
+    using Formatter = std::string (*)(fmt::string_view format, const char* packed);
+
+    static constexpr size_t Capacity = 160;
+
+    template <typename... Args>
+    static constexpr bool IsDeferrable = (detail::IsDeferrable<Args> && ...);
+
+    /// Packs the arguments, returns false when they do not fit
+    template <typename... Args>
+    bool Pack(const Args&... args) {
+        static_assert(IsDeferrable<Args...>);
+        size = 0;
+        if (!(PackArgument(args) && ...)) {
+            return false;
+        }
+        formatter = &FormatPacked<Args...>;
+        return true;
+    }
+
+    /// Formats the packed arguments, format must be the string they were packed for
+    [[nodiscard]] std::string Format(fmt::string_view format) const {
+        return formatter(format, data.data());
+    }
+
+    Formatter formatter = nullptr;
+    size_t size = 0;
+    std::array<char, Capacity> data;
+
+private:
+    template <typename T>
+    bool PackArgument(const T& value) {
+        if constexpr (detail::IsStringArgument<T>) {
+            std::string_view string;
+            if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+                string = value;
+            } else {
+                const char* const pointer = value;
+                if (pointer == nullptr) {
+                    return false;
+                }
+                string = pointer;
+            }
+            const u32 length = static_cast<u32>(string.size());
+            if (string.size() > Capacity - size || sizeof(length) > Capacity - size - length) {
+                return false;
+            }
+            std::memcpy(data.data() + size, &length, sizeof(length));
+            std::memcpy(data.data() + size + sizeof(length), string.data(), length);
+            size += sizeof(length) + length;
+        } else {
+            const detail::StoredArgument<T> stored = value;
+            if (sizeof(stored) > Capacity - size) {
+                return false;
+            }
+            std::memcpy(data.data() + size, &stored, sizeof(stored));
+            size += sizeof(stored);
+        }
+        return true;
+    }
+
+    template <typename T>
+    static detail::StoredArgument<T> UnpackArgument(const char*& cursor) {
+        if constexpr (detail::IsStringArgument<T>) {
+            u32 length;
+            std::memcpy(&length, cursor, sizeof(length));
+            const std::string_view string{cursor + sizeof(length), length};
+            cursor += sizeof(length) + length;
+            return string;
+        } else {
+            detail::StoredArgument<T> stored;
+            std::memcpy(&stored, cursor, sizeof(stored));
+            cursor += sizeof(stored);
+            return stored;
+        }
+    }
+
+    template <typename... Args>
+    static std::string FormatPacked(fmt::string_view format, const char* packed) {
+        [[maybe_unused]] const char* cursor = packed;
+        // Braced initialization unpacks the arguments in order
+        std::tuple<detail::StoredArgument<Args>...> values{UnpackArgument<Args>(cursor)...};
+        return std::apply(
+            [format](auto&... unpacked) {
+                return fmt::vformat(format, fmt::make_format_args(unpacked...));
+            },
+            values);
+    }
+};
+
+} // namespace Common::Log
@@ -59,6 +59,27 @@ public:
         return Push(input.data(), input.size());
     }
 
+    /// Reserves free slots for the producer to write in place, without copying
+    /// @param max_slots  Maximum number of slots to reserve
+    /// @returns The reserved slots, split in two where they wrap around the end of the buffer.
+    ///          They are pushed by a following call to Commit.
+    std::array<std::span<T>, 2> Reserve(std::size_t max_slots) {
+        const std::size_t write_index = m_write_index.load();
+        const std::size_t slots_free = capacity + m_read_index.load() - write_index;
+        const std::size_t reserve_count = std::min(max_slots, slots_free);
+
+        const std::size_t pos = write_index % capacity;
+        const std::size_t first_count = std::min(capacity - pos, reserve_count);
+        return {std::span<T>{m_data.data() + pos, first_count},
+                std::span<T>{m_data.data(), reserve_count - first_count}};
+    }
+
+    /// Pushes slots written in place after a call to Reserve
+    /// @param slot_count  Number of slots written, at most the number reserved
+    void Commit(std::size_t slot_count) {
+        m_write_index.store(m_write_index.load() + slot_count);
+    }
+
     /// Pops slots from the ring buffer
     /// @param output     Where to store the popped slots
     /// @param max_slots  Maximum number of slots to pop
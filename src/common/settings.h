@@ -189,6 +189,9 @@ struct Values {
         linkage, false, "audio_muted", Category::Audio, Specialization::Default, true, true};
     Setting<bool, false> dump_audio_commands{
         linkage, false, "dump_audio_commands", Category::Audio, Specialization::Default, false};
+    Setting<bool> parallel_audio_voices{linkage, false, "parallel_audio_voices", Category::Audio};
+    Setting<bool> audio_host_cost_model{linkage, false, "audio_host_cost_model", Category::Audio};
+    Setting<bool> audio_low_latency{linkage, false, "audio_low_latency", Category::Audio};
 
     // Core
     SwitchableSetting<bool> use_multi_core{linkage, true, "use_multi_core", Category::Core};
@@ -570,6 +573,12 @@ struct Values {
                                         Category::DataStorage};
     Setting<std::string> gamecard_path{linkage, std::string(), "gamecard_path",
                                        Category::DataStorage};
+    Setting<u32, true> vfs_block_cache_size{
+        linkage, 64, 0, 1024, "vfs_block_cache_size", Category::DataStorage};
+    Setting<bool> vfs_read_ahead{linkage, true, "vfs_read_ahead", Category::DataStorage};
+    Setting<bool> vfs_verify_integrity{linkage, false, "vfs_verify_integrity",
+                                       Category::DataStorage};
+    Setting<bool> lazy_layeredfs{linkage, true, "lazy_layeredfs", Category::DataStorage};
 
     // Debugging
     bool record_frame_times;
@@ -591,6 +600,9 @@ struct Values {
                                     Category::DebuggingGraphics};
     Setting<bool> disable_macro_hle{linkage, false, "disable_macro_hle",
                                     Category::DebuggingGraphics};
+    Setting<bool> memoize_macros{linkage, false, "memoize_macros", Category::DebuggingGraphics};
+    Setting<bool> profile_macros{linkage, false, "profile_macros", Category::DebuggingGraphics,
+                                 Specialization::Default, false};
     Setting<bool> extended_logging{
         linkage, false, "extended_logging", Category::Debugging, Specialization::Default, false};
     Setting<bool> use_debug_asserts{linkage, false, "use_debug_asserts", Category::Debugging};
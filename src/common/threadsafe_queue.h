@@ -19,11 +19,12 @@ template <typename T, bool with_stop_token = false>
 class SPSCQueue {
 public:
     SPSCQueue() {
-        write_ptr = read_ptr = new ElementPtr();
+        write_ptr = first_ptr = cached_read_ptr = new ElementPtr();
+        read_ptr.store(write_ptr);
     }
     ~SPSCQueue() {
-        // this will empty out the whole queue
-        delete read_ptr;
+        // this will empty out the whole queue, including the recycled elements
+        FreeElements(first_ptr);
     }
 
     [[nodiscard]] std::size_t Size() const {
@@ -35,37 +36,37 @@ public:
     }
 
     [[nodiscard]] T& Front() const {
-        return read_ptr->current;
+        return read_ptr.load(std::memory_order_relaxed)->current;
     }
 
     template <typename Arg>
     void Push(Arg&& t) {
         // create the element, add it to the queue
         write_ptr->current = std::move(t);
-        // set the next pointer to a new element ptr
+        // set the next pointer to a recycled or new element ptr
         // then advance the write pointer
-        ElementPtr* new_ptr = new ElementPtr();
+        ElementPtr* new_ptr = AllocateElement();
         write_ptr->next.store(new_ptr, std::memory_order_release);
         write_ptr = new_ptr;
         ++size;
 
-        // cv_mutex must be held or else there will be a missed wakeup if the other thread is in the
-        // line before cv.wait
-        // TODO(bunnei): This can be replaced with C++20 waitable atomics when properly supported.
-        // See discussion on https://github.com/sudachi-emu/sudachi/pull/3173 for details.
-        std::scoped_lock lock{cv_mutex};
-        cv.notify_one();
+        // The consumer announces itself in 'waiters' before checking the size under cv_mutex.
+        // Both sides use sequentially consistent operations, so either it sees the new size or we
+        // see it waiting, and only then cv_mutex has to be held to avoid a missed wakeup.
+        if (waiters.load() != 0) {
+            std::scoped_lock lock{cv_mutex};
+            cv.notify_one();
+        }
     }
 
     void Pop() {
         --size;
 
-        ElementPtr* tmpptr = read_ptr;
-        // advance the read pointer
-        read_ptr = tmpptr->next.load();
-        // set the next element to nullptr to stop the recursive deletion
-        tmpptr->next.store(nullptr);
-        delete tmpptr; // this also deletes the element
+        ElementPtr* tmpptr = read_ptr.load(std::memory_order_relaxed);
+        // release the element now instead of whenever its storage gets reused
+        tmpptr->current = T{};
+        // advance the read pointer, which hands the element back to the writer
+        read_ptr.store(tmpptr->next.load(std::memory_order_acquire), std::memory_order_release);
     }
 
     bool Pop(T& t) {
@@ -74,18 +75,18 @@ public:
 
         --size;
 
-        ElementPtr* tmpptr = read_ptr;
-        read_ptr = tmpptr->next.load(std::memory_order_acquire);
+        ElementPtr* tmpptr = read_ptr.load(std::memory_order_relaxed);
         t = std::move(tmpptr->current);
-        tmpptr->next.store(nullptr);
-        delete tmpptr;
+        read_ptr.store(tmpptr->next.load(std::memory_order_acquire), std::memory_order_release);
         return true;
     }
 
     void Wait() {
         if (Empty()) {
             std::unique_lock lock{cv_mutex};
+            ++waiters;
             cv.wait(lock, [this] { return !Empty(); });
+            --waiters;
         }
     }
 
@@ -99,7 +100,9 @@ public:
     T PopWait(std::stop_token stop_token) {
         if (Empty()) {
             std::unique_lock lock{cv_mutex};
+            ++waiters;
             Common::CondvarWait(cv, lock, stop_token, [this] { return !Empty(); });
+            --waiters;
         }
         if (stop_token.stop_requested()) {
             return T{};
@@ -112,8 +115,9 @@ public:
     // not thread-safe
     void Clear() {
         size.store(0);
-        delete read_ptr;
-        write_ptr = read_ptr = new ElementPtr();
+        FreeElements(first_ptr);
+        write_ptr = first_ptr = cached_read_ptr = new ElementPtr();
+        read_ptr.store(write_ptr);
     }
 
 private:
@@ -121,21 +125,43 @@ private:
     // and a pointer to the next ElementPtr
     class ElementPtr {
     public:
-        ElementPtr() {}
-        ~ElementPtr() {
-            ElementPtr* next_ptr = next.load();
-
-            if (next_ptr)
-                delete next_ptr;
-        }
-
         T current;
         std::atomic<ElementPtr*> next{nullptr};
     };
 
+    // Elements from first_ptr up to the read pointer have been consumed and are reused by the
+    // writer, so the queue only allocates when it grows past its previous high watermark.
+    ElementPtr* AllocateElement() {
+        if (first_ptr == cached_read_ptr) {
+            cached_read_ptr = read_ptr.load(std::memory_order_acquire);
+            if (first_ptr == cached_read_ptr) {
+                return new ElementPtr();
+            }
+        }
+        ElementPtr* element = first_ptr;
+        first_ptr = element->next.load(std::memory_order_relaxed);
+        element->next.store(nullptr, std::memory_order_relaxed);
+        return element;
+    }
+
+    static void FreeElements(ElementPtr* element) {
+        while (element) {
+            ElementPtr* next_ptr = element->next.load(std::memory_order_relaxed);
+            delete element;
+            element = next_ptr;
+        }
+    }
+
+    // writer side
     ElementPtr* write_ptr;
-    ElementPtr* read_ptr;
-    std::atomic_size_t size{0};
+    ElementPtr* first_ptr;
+    ElementPtr* cached_read_ptr;
+
+    // reader side
+    alignas(128) std::atomic<ElementPtr*> read_ptr;
+
+    alignas(128) std::atomic_size_t size{0};
+    std::atomic_size_t waiters{0};
     std::mutex cv_mutex;
     std::conditional_t<with_stop_token, std::condition_variable_any, std::condition_variable> cv;
 };
@@ -191,6 +217,8 @@ public:
 
 private:
     SPSCQueue<T, with_stop_token> spsc_queue;
+    // Only held for the few stores of an SPSC push, which no longer allocates once the queue
+    // has grown to its high watermark
     std::mutex write_lock;
 };
 } // namespace Common
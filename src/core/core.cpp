@@ -6,6 +6,7 @@
 #include <memory>
 #include <utility>
 
+#include "audio_core/adsp/adsp.h"
 #include "audio_core/audio_core.h"
 #include "common/fs/fs.h"
 #include "common/logging/log.h"
@@ -459,7 +460,12 @@ struct System::Impl {
     }
 
     PerfStatsResults GetAndResetPerfStats() {
-        return perf_stats->GetAndResetStats(core_timing.GetGlobalTimeUs());
+        auto results{perf_stats->GetAndResetStats(core_timing.GetGlobalTimeUs())};
+        if (audio_core) {
+            const auto latency{audio_core->ADSP().AudioRenderer().GetOutputLatency()};
+            results.audio_latency = static_cast<double>(latency.count()) / 1000.0;
+        }
+        return results;
     }
 
     mutable std::mutex suspend_guard;
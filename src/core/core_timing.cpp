@@ -5,6 +5,7 @@
 #include <mutex>
 #include <string>
 #include <tuple>
+#include <utility>
 
 #ifdef _WIN32
 #include "common/windows/timer_resolution.h"
@@ -30,6 +31,8 @@ struct CoreTiming::Event {
     s64 time;
     u64 fifo_order;
     std::weak_ptr<EventType> type;
+    /// Identifies the event type in scheduled_events, even after it has expired
+    const EventType* type_key;
     s64 reschedule_time;
     heap_t::handle_type handle{};
 
@@ -44,10 +47,16 @@ struct CoreTiming::Event {
     }
 };
 
+struct CoreTiming::PendingEvent {
+    Event event;
+    PendingEvent* next;
+};
+
 CoreTiming::CoreTiming() : clock{Common::CreateOptimalClock()} {}
 
 CoreTiming::~CoreTiming() {
     Reset();
+    ClearPendingEvents();
 }
 
 void CoreTiming::ThreadEntry(CoreTiming& instance) {
@@ -73,7 +82,12 @@ void CoreTiming::Initialize(std::function<void()>&& on_thread_init_) {
 
 void CoreTiming::ClearPendingEvents() {
     std::scoped_lock lock{advance_lock, basic_lock};
+    PendingEvent* node = pending_events.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+        delete std::exchange(node, node->next);
+    }
     event_queue.clear();
+    scheduled_events.clear();
     event.Set();
 }
 
@@ -112,18 +126,13 @@ bool CoreTiming::IsRunning() const {
 
 bool CoreTiming::HasPendingEvents() const {
     std::scoped_lock lock{basic_lock};
-    return !(wait_set && event_queue.empty());
+    return !(wait_set && event_queue.empty() && pending_events.load() == nullptr);
 }
 
 void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
                                const std::shared_ptr<EventType>& event_type, bool absolute_time) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
-
-        auto h{event_queue.emplace(Event{next_time.count(), event_fifo_id++, event_type, 0})};
-        (*h).handle = h;
-    }
+    const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
+    PushEvent(Event{next_time.count(), event_fifo_id++, event_type, event_type.get(), 0});
 
     event.Set();
 }
@@ -132,14 +141,9 @@ void CoreTiming::ScheduleLoopingEvent(std::chrono::nanoseconds start_time,
                                       std::chrono::nanoseconds resched_time,
                                       const std::shared_ptr<EventType>& event_type,
                                       bool absolute_time) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
-
-        auto h{event_queue.emplace(
-            Event{next_time.count(), event_fifo_id++, event_type, resched_time.count()})};
-        (*h).handle = h;
-    }
+    const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
+    PushEvent(Event{next_time.count(), event_fifo_id++, event_type, event_type.get(),
+                    resched_time.count()});
 
     event.Set();
 }
@@ -148,17 +152,14 @@ void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
                                  UnscheduleEventType type) {
     {
         std::scoped_lock lk{basic_lock};
+        InsertPendingEvents();
 
-        std::vector<heap_t::handle_type> to_remove;
-        for (auto itr = event_queue.begin(); itr != event_queue.end(); itr++) {
-            const Event& e = *itr;
-            if (e.type.lock().get() == event_type.get()) {
-                to_remove.push_back(itr->handle);
+        if (const auto it = scheduled_events.find(event_type.get());
+            it != scheduled_events.end()) {
+            for (const auto& h : it->second) {
+                event_queue.erase(h);
             }
-        }
-
-        for (auto& h : to_remove) {
-            event_queue.erase(h);
+            scheduled_events.erase(it);
         }
 
         event_type->sequence_number++;
@@ -197,8 +198,35 @@ u64 CoreTiming::GetGPUTicks() const {
     return Common::WallClock::CPUTickToGPUTick(cpu_ticks);
 }
 
+void CoreTiming::PushEvent(Event&& evt) {
+    auto* const node = new PendingEvent{std::move(evt), pending_events.load()};
+    while (!pending_events.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+    }
+}
+
+void CoreTiming::InsertPendingEvents() {
+    PendingEvent* node = pending_events.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+        const auto h{event_queue.push(std::move(node->event))};
+        (*h).handle = h;
+        scheduled_events[(*h).type_key].push_back(h);
+        delete std::exchange(node, node->next);
+    }
+}
+
+void CoreTiming::ForgetEvent(const Event& evt) {
+    const auto it = scheduled_events.find(evt.type_key);
+    auto& handles = it->second;
+    handles.erase(std::find(handles.begin(), handles.end(), evt.handle));
+    if (handles.empty()) {
+        scheduled_events.erase(it);
+    }
+}
+
 std::optional<s64> CoreTiming::Advance() {
     std::scoped_lock lock{advance_lock, basic_lock};
+    InsertPendingEvents();
     global_timer = GetGlobalTimeNs().count();
 
     while (!event_queue.empty() && event_queue.top().time <= global_timer) {
@@ -209,6 +237,7 @@ std::optional<s64> CoreTiming::Advance() {
             const auto evt_sequence_num = event_type->sequence_number;
 
             if (evt.reschedule_time == 0) {
+                ForgetEvent(evt);
                 event_queue.pop();
 
                 basic_lock.unlock();
@@ -241,11 +270,18 @@ std::optional<s64> CoreTiming::Advance() {
                     next_time = pause_end_time + next_schedule_time;
                 }
 
-                event_queue.update(evt.handle, Event{next_time, event_fifo_id++, evt.type,
-                                                     next_schedule_time, evt.handle});
+                event_queue.update(evt.handle,
+                                   Event{next_time, event_fifo_id++, evt.type, evt.type_key,
+                                         next_schedule_time, evt.handle});
             }
+        } else {
+            // The event type was destroyed without unscheduling it
+            ForgetEvent(evt);
+            event_queue.pop();
         }
 
+        // Events scheduled by the callbacks may already be due
+        InsertPendingEvents();
         global_timer = GetGlobalTimeNs().count();
     }
 
@@ -11,7 +11,9 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/heap/fibonacci_heap.hpp>
 
 #include "common/common_types.h"
@@ -95,7 +97,7 @@ public:
     /// Checks if there are any pending time events.
     bool HasPendingEvents() const;
 
-    /// Schedules an event in core timing
+    /// Schedules an event in core timing, without blocking on the timer thread
     void ScheduleEvent(std::chrono::nanoseconds ns_into_future,
                        const std::shared_ptr<EventType>& event_type, bool absolute_time = false);
 
@@ -106,6 +108,7 @@ public:
                               const std::shared_ptr<EventType>& event_type,
                               bool absolute_time = false);
 
+    /// Removes every scheduled instance of an event, in logarithmic time
     void UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
                          UnscheduleEventType type = UnscheduleEventType::Wait);
 
@@ -140,12 +143,22 @@ public:
 
 private:
     struct Event;
+    struct PendingEvent;
 
     static void ThreadEntry(CoreTiming& instance);
     void ThreadLoop();
 
     void Reset();
 
+    /// Queues an event to be inserted by the next thread taking basic_lock
+    void PushEvent(Event&& evt);
+
+    /// Moves the pushed events into the event queue, basic_lock must be held
+    void InsertPendingEvents();
+
+    /// Forgets the handle of an event about to leave the event queue, basic_lock must be held
+    void ForgetEvent(const Event& evt);
+
     std::unique_ptr<Common::WallClock> clock;
 
     s64 global_timer = 0;
@@ -158,7 +171,14 @@ private:
         boost::heap::fibonacci_heap<CoreTiming::Event, boost::heap::compare<std::greater<>>>;
 
     heap_t event_queue;
-    u64 event_fifo_id = 0;
+    std::atomic<u64> event_fifo_id{};
+
+    /// Handles of the events in event_queue, by event type
+    std::unordered_map<const EventType*, boost::container::small_vector<heap_t::handle_type, 1>>
+        scheduled_events;
+
+    /// Lock-free stack of events scheduled but not inserted into event_queue yet
+    std::atomic<PendingEvent*> pending_events{};
 
     Common::Event event{};
     Common::Event pause_event{};
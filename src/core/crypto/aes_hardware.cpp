@@ -0,0 +1,301 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <utility>
+
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+#include "common/assert.h"
+#include "common/swap.h"
+#include "core/crypto/aes_hardware.h"
+
+#if defined(ARCHITECTURE_x86_64)
+#include "common/x64/cpu_detect.h"
+#endif
+
+#if defined(ARCHITECTURE_x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AES __attribute__((target("aes,sse4.1")))
+#else
+#define TARGET_AES
+#endif
+
+namespace Core::Crypto::Hardware {
+namespace {
+// clang-format off
+constexpr std::array<u8, 256> SBOX{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+// clang-format on
+
+constexpr u8 XTime(u8 value) {
+    return static_cast<u8>((value << 1) ^ ((value & 0x80) != 0 ? 0x1B : 0));
+}
+
+void ExpandEncryptionKey(const Block& key, std::array<Block, 11>& round_keys) {
+    std::array<u8, 16 * 11> words;
+    std::memcpy(words.data(), key.data(), key.size());
+    u8 round_constant = 1;
+    for (size_t i = 16; i < words.size(); i += 4) {
+        std::array<u8, 4> temp{words[i - 4], words[i - 3], words[i - 2], words[i - 1]};
+        if (i % 16 == 0) {
+            temp = {static_cast<u8>(SBOX[temp[1]] ^ round_constant), SBOX[temp[2]], SBOX[temp[3]],
+                    SBOX[temp[0]]};
+            round_constant = XTime(round_constant);
+        }
+        for (size_t j = 0; j < temp.size(); ++j) {
+            words[i + j] = static_cast<u8>(words[i + j - 16] ^ temp[j]);
+        }
+    }
+    std::memcpy(round_keys.data(), words.data(), words.size());
+}
+
+#if defined(ARCHITECTURE_x86_64)
+/// Multiplies an XTS tweak by x in GF(2^128), stored as two little-endian halves
+void MultiplyTweak(u64& low, u64& high) {
+    const u64 carry = high >> 63;
+    high = (high << 1) | (low >> 63);
+    low = (low << 1) ^ (carry * 0x87);
+}
+
+std::pair<u64, u64> LoadTweak(const Block& tweak) {
+    u64 low;
+    u64 high;
+    std::memcpy(&low, tweak.data(), sizeof(low));
+    std::memcpy(&high, tweak.data() + sizeof(low), sizeof(high));
+    return {low, high};
+}
+#endif
+
+#if defined(ARCHITECTURE_x86_64)
+TARGET_AES __m128i EncryptBlock(const __m128i* keys, __m128i block) {
+    block = _mm_xor_si128(block, keys[0]);
+    for (size_t round = 1; round < 10; ++round) {
+        block = _mm_aesenc_si128(block, keys[round]);
+    }
+    return _mm_aesenclast_si128(block, keys[10]);
+}
+
+TARGET_AES void EncryptBlocks4(const __m128i* keys, __m128i& a, __m128i& b, __m128i& c,
+                               __m128i& d) {
+    a = _mm_xor_si128(a, keys[0]);
+    b = _mm_xor_si128(b, keys[0]);
+    c = _mm_xor_si128(c, keys[0]);
+    d = _mm_xor_si128(d, keys[0]);
+    for (size_t round = 1; round < 10; ++round) {
+        a = _mm_aesenc_si128(a, keys[round]);
+        b = _mm_aesenc_si128(b, keys[round]);
+        c = _mm_aesenc_si128(c, keys[round]);
+        d = _mm_aesenc_si128(d, keys[round]);
+    }
+    a = _mm_aesenclast_si128(a, keys[10]);
+    b = _mm_aesenclast_si128(b, keys[10]);
+    c = _mm_aesenclast_si128(c, keys[10]);
+    d = _mm_aesenclast_si128(d, keys[10]);
+}
+
+TARGET_AES __m128i DecryptBlock(const __m128i* keys, __m128i block) {
+    block = _mm_xor_si128(block, keys[0]);
+    for (size_t round = 1; round < 10; ++round) {
+        block = _mm_aesdec_si128(block, keys[round]);
+    }
+    return _mm_aesdeclast_si128(block, keys[10]);
+}
+
+TARGET_AES void DecryptBlocks4(const __m128i* keys, __m128i& a, __m128i& b, __m128i& c,
+                               __m128i& d) {
+    a = _mm_xor_si128(a, keys[0]);
+    b = _mm_xor_si128(b, keys[0]);
+    c = _mm_xor_si128(c, keys[0]);
+    d = _mm_xor_si128(d, keys[0]);
+    for (size_t round = 1; round < 10; ++round) {
+        a = _mm_aesdec_si128(a, keys[round]);
+        b = _mm_aesdec_si128(b, keys[round]);
+        c = _mm_aesdec_si128(c, keys[round]);
+        d = _mm_aesdec_si128(d, keys[round]);
+    }
+    a = _mm_aesdeclast_si128(a, keys[10]);
+    b = _mm_aesdeclast_si128(b, keys[10]);
+    c = _mm_aesdeclast_si128(c, keys[10]);
+    d = _mm_aesdeclast_si128(d, keys[10]);
+}
+
+TARGET_AES void MakeDecryptionKeys(AES128Keys& keys) {
+    const auto* const encrypt = reinterpret_cast<const __m128i*>(keys.encrypt.data());
+    auto* const decrypt = reinterpret_cast<__m128i*>(keys.decrypt.data());
+    decrypt[0] = encrypt[10];
+    for (size_t round = 1; round < 10; ++round) {
+        decrypt[round] = _mm_aesimc_si128(encrypt[10 - round]);
+    }
+    decrypt[10] = encrypt[0];
+}
+
+/// Big-endian 128-bit counter kept in native halves to increment it cheaply
+struct Counter {
+    TARGET_AES __m128i Next() {
+        const __m128i value = _mm_set_epi64x(static_cast<s64>(low), static_cast<s64>(high));
+        high += ++low == 0 ? 1 : 0;
+        return _mm_shuffle_epi8(value, _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3,
+                                                    4, 5, 6, 7));
+    }
+
+    u64 high;
+    u64 low;
+};
+
+TARGET_AES void CTRTranscodeImpl(const AES128Keys& keys, const Block& counter, const u8* src,
+                                 size_t size, u8* dest) {
+    const auto* const round_keys = reinterpret_cast<const __m128i*>(keys.encrypt.data());
+    Counter ctr;
+    std::memcpy(&ctr.high, counter.data(), sizeof(ctr.high));
+    std::memcpy(&ctr.low, counter.data() + sizeof(ctr.high), sizeof(ctr.low));
+    ctr.high = Common::swap64(ctr.high);
+    ctr.low = Common::swap64(ctr.low);
+
+    const auto* in = reinterpret_cast<const __m128i*>(src);
+    auto* out = reinterpret_cast<__m128i*>(dest);
+    size_t blocks = size / 16;
+    for (; blocks >= 4; blocks -= 4, in += 4, out += 4) {
+        __m128i a = ctr.Next();
+        __m128i b = ctr.Next();
+        __m128i c = ctr.Next();
+        __m128i d = ctr.Next();
+        EncryptBlocks4(round_keys, a, b, c, d);
+        _mm_storeu_si128(out + 0, _mm_xor_si128(a, _mm_loadu_si128(in + 0)));
+        _mm_storeu_si128(out + 1, _mm_xor_si128(b, _mm_loadu_si128(in + 1)));
+        _mm_storeu_si128(out + 2, _mm_xor_si128(c, _mm_loadu_si128(in + 2)));
+        _mm_storeu_si128(out + 3, _mm_xor_si128(d, _mm_loadu_si128(in + 3)));
+    }
+    for (; blocks > 0; --blocks, ++in, ++out) {
+        const __m128i stream = EncryptBlock(round_keys, ctr.Next());
+        _mm_storeu_si128(out, _mm_xor_si128(stream, _mm_loadu_si128(in)));
+    }
+    const size_t tail = size % 16;
+    if (tail != 0) {
+        alignas(16) Block block{};
+        std::memcpy(block.data(), in, tail);
+        const __m128i stream = EncryptBlock(round_keys, ctr.Next());
+        const __m128i value = _mm_load_si128(reinterpret_cast<const __m128i*>(block.data()));
+        _mm_store_si128(reinterpret_cast<__m128i*>(block.data()), _mm_xor_si128(stream, value));
+        std::memcpy(out, block.data(), tail);
+    }
+}
+
+TARGET_AES void XTSTranscodeImpl(const AES128Keys& data_keys, const AES128Keys& tweak_keys,
+                                 const Block& tweak, const u8* src, size_t size, u8* dest,
+                                 bool decrypt) {
+    const auto* const keys = reinterpret_cast<const __m128i*>(
+        decrypt ? data_keys.decrypt.data() : data_keys.encrypt.data());
+    const auto* const tweak_round_keys =
+        reinterpret_cast<const __m128i*>(tweak_keys.encrypt.data());
+
+    alignas(16) Block encrypted_tweak;
+    const __m128i tweak_input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tweak.data()));
+    _mm_store_si128(reinterpret_cast<__m128i*>(encrypted_tweak.data()),
+                    EncryptBlock(tweak_round_keys, tweak_input));
+    auto [low, high] = LoadTweak(encrypted_tweak);
+    const auto next_tweak = [&low, &high] {
+        const __m128i value = _mm_set_epi64x(static_cast<s64>(high), static_cast<s64>(low));
+        MultiplyTweak(low, high);
+        return value;
+    };
+
+    const auto* in = reinterpret_cast<const __m128i*>(src);
+    auto* out = reinterpret_cast<__m128i*>(dest);
+    size_t blocks = size / 16;
+    for (; blocks >= 4; blocks -= 4, in += 4, out += 4) {
+        const __m128i ta = next_tweak();
+        const __m128i tb = next_tweak();
+        const __m128i tc = next_tweak();
+        const __m128i td = next_tweak();
+        __m128i a = _mm_xor_si128(_mm_loadu_si128(in + 0), ta);
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(in + 1), tb);
+        __m128i c = _mm_xor_si128(_mm_loadu_si128(in + 2), tc);
+        __m128i d = _mm_xor_si128(_mm_loadu_si128(in + 3), td);
+        if (decrypt) {
+            DecryptBlocks4(keys, a, b, c, d);
+        } else {
+            EncryptBlocks4(keys, a, b, c, d);
+        }
+        _mm_storeu_si128(out + 0, _mm_xor_si128(a, ta));
+        _mm_storeu_si128(out + 1, _mm_xor_si128(b, tb));
+        _mm_storeu_si128(out + 2, _mm_xor_si128(c, tc));
+        _mm_storeu_si128(out + 3, _mm_xor_si128(d, td));
+    }
+    for (; blocks > 0; --blocks, ++in, ++out) {
+        const __m128i t = next_tweak();
+        const __m128i value = _mm_xor_si128(_mm_loadu_si128(in), t);
+        const __m128i result = decrypt ? DecryptBlock(keys, value) : EncryptBlock(keys, value);
+        _mm_storeu_si128(out, _mm_xor_si128(result, t));
+    }
+}
+#endif
+} // Anonymous namespace
+
+bool IsSupported() {
+#if defined(ARCHITECTURE_x86_64)
+    const auto& caps = Common::GetCPUCaps();
+    return caps.aes && caps.sse4_1;
+#else
+    return false;
+#endif
+}
+
+void ExpandKey(const Block& key, AES128Keys& keys) {
+    ExpandEncryptionKey(key, keys.encrypt);
+#if defined(ARCHITECTURE_x86_64)
+    MakeDecryptionKeys(keys);
+#endif
+}
+
+#if defined(ARCHITECTURE_x86_64)
+void CTRTranscode(const AES128Keys& keys, const Block& counter, const u8* src, std::size_t size,
+                  u8* dest) {
+    CTRTranscodeImpl(keys, counter, src, size, dest);
+}
+
+void XTSTranscode(const AES128Keys& data_keys, const AES128Keys& tweak_keys, const Block& tweak,
+                  const u8* src, std::size_t size, u8* dest, bool decrypt) {
+    XTSTranscodeImpl(data_keys, tweak_keys, tweak, src, size, dest, decrypt);
+}
+#else
+void CTRTranscode(const AES128Keys&, const Block&, const u8*, std::size_t, u8*) {
+    UNREACHABLE();
+}
+
+void XTSTranscode(const AES128Keys&, const AES128Keys&, const Block&, const u8*, std::size_t, u8*,
+                  bool) {
+    UNREACHABLE();
+}
+#endif
+
+void AddCounter(Block& counter, u64 blocks) {
+    for (size_t i = counter.size(); i > 0 && blocks != 0; --i) {
+        const u64 sum = counter[i - 1] + (blocks & 0xFF);
+        counter[i - 1] = static_cast<u8>(sum);
+        blocks = (blocks >> 8) + (sum >> 8);
+    }
+}
+
+} // namespace Core::Crypto::Hardware
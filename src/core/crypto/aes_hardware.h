@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "common/common_types.h"
+
+// AES-128 using the AES-NI instructions, used by AESCipher for the CTR and XTS modes instead of
+// mbedtls when the host supports them.
+namespace Core::Crypto::Hardware {
+
+using Block = std::array<u8, 16>;
+
+/// Round keys of an expanded AES-128 key
+struct AES128Keys {
+    alignas(16) std::array<Block, 11> encrypt;
+    /// Round keys of the equivalent inverse cipher, in decryption order
+    alignas(16) std::array<Block, 11> decrypt;
+};
+
+/// Returns true when the host supports the AES instructions used by this module
+[[nodiscard]] bool IsSupported();
+
+/// Expands a key. Only valid when IsSupported() is true, as do all the following functions.
+void ExpandKey(const Block& key, AES128Keys& keys);
+
+/// Encrypts or decrypts in counter mode, counter is the big-endian counter of the first block.
+/// A trailing partial block uses the start of the next key stream block.
+void CTRTranscode(const AES128Keys& keys, const Block& counter, const u8* src, std::size_t size,
+                  u8* dest);
+
+/**
+ * Encrypts or decrypts one XTS data unit without ciphertext stealing.
+ *
+ * @param tweak Tweak of the data unit before encryption with the tweak key
+ * @param size  Size of the data unit, must be a multiple of 16
+ */
+void XTSTranscode(const AES128Keys& data_keys, const AES128Keys& tweak_keys, const Block& tweak,
+                  const u8* src, std::size_t size, u8* dest, bool decrypt);
+
+/// Adds blocks to a big-endian 128-bit counter
+void AddCounter(Block& counter, u64 blocks);
+
+} // namespace Core::Crypto::Hardware
@@ -1,10 +1,20 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <optional>
+#include <thread>
 #include <mbedtls/cipher.h>
+#include "common/alignment.h"
 #include "common/assert.h"
+#include "common/div_ceil.h"
 #include "common/logging/log.h"
+#include "common/thread.h"
+#include "common/thread_worker.h"
+#include "core/crypto/aes_hardware.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 
@@ -20,6 +30,49 @@ NintendoTweak CalculateNintendoTweak(std::size_t sector_id) {
     }
     return out;
 }
+
+// Transcodes larger than this are split across the decryption workers
+constexpr std::size_t ParallelThreshold = 0x40000;
+
+std::size_t NumDecryptionWorkers() {
+    static const std::size_t num_workers =
+        std::min<std::size_t>(std::thread::hardware_concurrency() / 2, 4);
+    return num_workers;
+}
+
+Common::ThreadWorker& DecryptionWorkers() {
+    static Common::ThreadWorker workers(NumDecryptionWorkers(), "AESDecryption");
+    return workers;
+}
+
+/// Calls func(offset, size) over chunks of the data aligned to granularity, splitting large
+/// transcodes across the decryption workers and the calling thread
+template <typename Func>
+void ForEachChunk(std::size_t size, std::size_t granularity, Func&& func) {
+    if (size < ParallelThreshold || NumDecryptionWorkers() == 0) {
+        func(0, size);
+        return;
+    }
+    const std::size_t num_threads = NumDecryptionWorkers() + 1;
+    const std::size_t chunk_size = Common::AlignUp(Common::DivCeil(size, num_threads), granularity);
+    const std::size_t num_chunks = Common::DivCeil(size, chunk_size);
+
+    std::atomic<std::size_t> remaining_chunks{num_chunks};
+    Common::Event done;
+    const auto process_chunk = [&](std::size_t chunk) {
+        const std::size_t offset = chunk * chunk_size;
+        func(offset, std::min(chunk_size, size - offset));
+        if (remaining_chunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            done.Set();
+        }
+    };
+    auto& workers = DecryptionWorkers();
+    for (std::size_t chunk = 1; chunk < num_chunks; ++chunk) {
+        workers.QueueWork([&process_chunk, chunk] { process_chunk(chunk); });
+    }
+    process_chunk(0);
+    done.Wait();
+}
 } // Anonymous namespace
 
 static_assert(static_cast<std::size_t>(Mode::CTR) ==
@@ -36,6 +89,12 @@ static_assert(static_cast<std::size_t>(Mode::XTS) ==
 struct CipherContext {
     mbedtls_cipher_context_t encryption_context;
     mbedtls_cipher_context_t decryption_context;
+
+    // Keys for the AES instruction path, only set when the host and the mode support it
+    std::optional<Hardware::AES128Keys> data_keys;
+    std::optional<Hardware::AES128Keys> tweak_keys;
+    Mode mode;
+    Hardware::Block iv{};
 };
 
 template <typename Key, std::size_t KeySize>
@@ -57,6 +116,21 @@ Crypto::AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode)
     ASSERT(
         !mbedtls_cipher_setkey(&ctx->decryption_context, key.data(), KeySize * 8, MBEDTLS_DECRYPT));
     //"Failed to set key on mbedtls ciphers.");
+
+    ctx->mode = mode;
+    if (!Hardware::IsSupported()) {
+        return;
+    }
+    Hardware::Block data_key;
+    std::memcpy(data_key.data(), key.data(), data_key.size());
+    if (mode == Mode::CTR && KeySize == 0x10) {
+        Hardware::ExpandKey(data_key, ctx->data_keys.emplace());
+    } else if (mode == Mode::XTS && KeySize == 0x20) {
+        Hardware::Block tweak_key;
+        std::memcpy(tweak_key.data(), key.data() + data_key.size(), tweak_key.size());
+        Hardware::ExpandKey(data_key, ctx->data_keys.emplace());
+        Hardware::ExpandKey(tweak_key, ctx->tweak_keys.emplace());
+    }
 }
 
 template <typename Key, std::size_t KeySize>
@@ -67,6 +141,24 @@ AESCipher<Key, KeySize>::~AESCipher() {
 
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* dest, Op op) const {
+    if (ctx->data_keys && ctx->mode == Mode::CTR) {
+        // Partial blocks discard the rest of their key stream, as mbedtls does between calls
+        const Hardware::Block counter = ctx->iv;
+        ForEachChunk(size, Hardware::Block{}.size(), [&](std::size_t offset, std::size_t length) {
+            Hardware::Block chunk_counter = counter;
+            Hardware::AddCounter(chunk_counter, offset / chunk_counter.size());
+            Hardware::CTRTranscode(*ctx->data_keys, chunk_counter, src + offset, length,
+                                   dest + offset);
+        });
+        Hardware::AddCounter(ctx->iv, Common::DivCeil(size, ctx->iv.size()));
+        return;
+    }
+    if (ctx->data_keys && ctx->mode == Mode::XTS && size % ctx->iv.size() == 0) {
+        Hardware::XTSTranscode(*ctx->data_keys, *ctx->tweak_keys, ctx->iv, src, size, dest,
+                               op == Op::Decrypt);
+        return;
+    }
+
     auto* const context = op == Op::Encrypt ? &ctx->encryption_context : &ctx->decryption_context;
 
     mbedtls_cipher_reset(context);
@@ -111,6 +203,17 @@ void AESCipher<Key, KeySize>::XTSTranscode(const u8* src, std::size_t size, u8*
                                            std::size_t sector_id, std::size_t sector_size, Op op) {
     ASSERT_MSG(size % sector_size == 0, "XTS decryption size must be a multiple of sector size.");
 
+    if (ctx->data_keys && ctx->mode == Mode::XTS && sector_size % ctx->iv.size() == 0) {
+        ForEachChunk(size, sector_size, [&](std::size_t offset, std::size_t length) {
+            for (std::size_t i = offset; i < offset + length; i += sector_size) {
+                Hardware::XTSTranscode(*ctx->data_keys, *ctx->tweak_keys,
+                                       CalculateNintendoTweak(sector_id + i / sector_size),
+                                       src + i, sector_size, dest + i, op == Op::Decrypt);
+            }
+        });
+        return;
+    }
+
     for (std::size_t i = 0; i < size; i += sector_size) {
         SetIV(CalculateNintendoTweak(sector_id++));
         Transcode(src + i, sector_size, dest + i, op);
@@ -122,6 +225,9 @@ void AESCipher<Key, KeySize>::SetIV(std::span<const u8> data) {
     ASSERT_MSG((mbedtls_cipher_set_iv(&ctx->encryption_context, data.data(), data.size()) ||
                 mbedtls_cipher_set_iv(&ctx->decryption_context, data.data(), data.size())) == 0,
                "Failed to set IV on mbedtls ciphers.");
+    if (data.size() == ctx->iv.size()) {
+        std::memcpy(ctx->iv.data(), data.data(), ctx->iv.size());
+    }
 }
 
 template class AESCipher<Key128>;
@@ -639,6 +639,7 @@ KeyManager::KeyManager() {
 }
 
 void KeyManager::ReloadKeys() {
+    std::scoped_lock lock{key_mutex};
     // Initialize keys
     const auto sudachi_keys_dir = Common::FS::GetSudachiPath(Common::FS::SudachiPath::KeysDir);
 
@@ -676,6 +677,7 @@ static bool ValidCryptoRevisionString(std::string_view base, size_t begin, size_
 }
 
 void KeyManager::LoadFromFile(const std::filesystem::path& file_path, bool is_title_keys) {
+    std::scoped_lock lock{key_mutex};
     if (!Common::FS::Exists(file_path)) {
         return;
     }
@@ -786,10 +788,12 @@ void KeyManager::LoadFromFile(const std::filesystem::path& file_path, bool is_ti
 }
 
 bool KeyManager::AreKeysLoaded() const {
+    std::scoped_lock lock{key_mutex};
     return !s128_keys.empty() && !s256_keys.empty();
 }
 
 bool KeyManager::BaseDeriveNecessary() const {
+    std::scoped_lock lock{key_mutex};
     const auto check_key_existence = [this](auto key_type, u64 index1 = 0, u64 index2 = 0) {
         return !HasKey(key_type, index1, index2);
     };
@@ -813,14 +817,17 @@ bool KeyManager::BaseDeriveNecessary() const {
 }
 
 bool KeyManager::HasKey(S128KeyType id, u64 field1, u64 field2) const {
+    std::scoped_lock lock{key_mutex};
     return s128_keys.find({id, field1, field2}) != s128_keys.end();
 }
 
 bool KeyManager::HasKey(S256KeyType id, u64 field1, u64 field2) const {
+    std::scoped_lock lock{key_mutex};
     return s256_keys.find({id, field1, field2}) != s256_keys.end();
 }
 
 Key128 KeyManager::GetKey(S128KeyType id, u64 field1, u64 field2) const {
+    std::scoped_lock lock{key_mutex};
     if (!HasKey(id, field1, field2)) {
         return {};
     }
@@ -828,6 +835,7 @@ Key128 KeyManager::GetKey(S128KeyType id, u64 field1, u64 field2) const {
 }
 
 Key256 KeyManager::GetKey(S256KeyType id, u64 field1, u64 field2) const {
+    std::scoped_lock lock{key_mutex};
     if (!HasKey(id, field1, field2)) {
         return {};
     }
@@ -835,6 +843,7 @@ Key256 KeyManager::GetKey(S256KeyType id, u64 field1, u64 field2) const {
 }
 
 Key256 KeyManager::GetBISKey(u8 partition_id) const {
+    std::scoped_lock lock{key_mutex};
     Key256 out{};
 
     for (const auto& bis_type : {BISKeyType::Crypto, BISKeyType::Tweak}) {
@@ -889,6 +898,7 @@ void KeyManager::WriteKeyToFile(KeyCategory category, std::string_view keyname,
 }
 
 void KeyManager::SetKey(S128KeyType id, Key128 key, u64 field1, u64 field2) {
+    std::scoped_lock lock{key_mutex};
     if (s128_keys.find({id, field1, field2}) != s128_keys.end() || key == Key128{}) {
         return;
     }
@@ -942,6 +952,7 @@ void KeyManager::SetKey(S128KeyType id, Key128 key, u64 field1, u64 field2) {
 }
 
 void KeyManager::SetKey(S256KeyType id, Key256 key, u64 field1, u64 field2) {
+    std::scoped_lock lock{key_mutex};
     if (s256_keys.find({id, field1, field2}) != s256_keys.end() || key == Key256{}) {
         return;
     }
@@ -971,6 +982,7 @@ bool KeyManager::KeyFileExists(bool title) {
 }
 
 void KeyManager::DeriveSDSeedLazy() {
+    std::scoped_lock lock{key_mutex};
     if (HasKey(S128KeyType::SDSeed)) {
         return;
     }
@@ -990,6 +1002,7 @@ static Key128 CalculateCMAC(const u8* source, size_t size, const Key128& key) {
 }
 
 void KeyManager::DeriveBase() {
+    std::scoped_lock lock{key_mutex};
     if (!BaseDeriveNecessary()) {
         return;
     }
@@ -1120,6 +1133,7 @@ void KeyManager::DeriveBase() {
 
 void KeyManager::DeriveETicket(PartitionDataManager& data,
                                const FileSys::ContentProvider& provider) {
+    std::scoped_lock lock{key_mutex};
     // ETicket keys
     const auto es = provider.GetEntry(0x0100000000000033, FileSys::ContentRecordType::Program);
 
@@ -1199,6 +1213,7 @@ void KeyManager::DeriveETicket(PartitionDataManager& data,
 }
 
 void KeyManager::PopulateTickets() {
+    std::scoped_lock lock{key_mutex};
     if (ticket_databases_loaded) {
         return;
     }
@@ -1230,6 +1245,7 @@ void KeyManager::PopulateTickets() {
 }
 
 void KeyManager::SynthesizeTickets() {
+    std::scoped_lock lock{key_mutex};
     for (const auto& key : s128_keys) {
         if (key.first.type != S128KeyType::Titlekey) {
             continue;
@@ -1258,6 +1274,7 @@ void KeyManager::SetKeyWrapped(S256KeyType id, Key256 key, u64 field1, u64 field
 }
 
 void KeyManager::PopulateFromPartitionData(PartitionDataManager& data) {
+    std::scoped_lock lock{key_mutex};
     if (!BaseDeriveNecessary()) {
         return;
     }
@@ -1349,11 +1366,13 @@ void KeyManager::PopulateFromPartitionData(PartitionDataManager& data) {
     DeriveBase();
 }
 
-const std::map<u128, Ticket>& KeyManager::GetCommonTickets() const {
+std::map<u128, Ticket> KeyManager::GetCommonTickets() const {
+    std::scoped_lock lock{key_mutex};
     return common_tickets;
 }
 
-const std::map<u128, Ticket>& KeyManager::GetPersonalizedTickets() const {
+std::map<u128, Ticket> KeyManager::GetPersonalizedTickets() const {
+    std::scoped_lock lock{key_mutex};
     return personal_tickets;
 }
 
@@ -1363,6 +1382,7 @@ bool KeyManager::AddTicket(const Ticket& ticket) {
         return false;
     }
 
+    std::scoped_lock lock{key_mutex};
     const auto& rid = ticket.GetData().rights_id;
     u128 rights_id;
     std::memcpy(rights_id.data(), rid.data(), rid.size());
@@ -1,4 +1,261 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-namespace Crypto {} // namespace Crypto
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#elif defined(ARCHITECTURE_arm64) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#define HAS_ARM_SHA2
+#if defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+#endif
+
+#include <mbedtls/sha256.h>
+
+#include "common/div_ceil.h"
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "common/thread_worker.h"
+#include "core/crypto/sha_util.h"
+
+#if defined(ARCHITECTURE_x86_64)
+#include "common/x64/cpu_detect.h"
+#endif
+
+#if defined(ARCHITECTURE_x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SHA __attribute__((target("sha,sse4.1")))
+#else
+#define TARGET_SHA
+#endif
+
+namespace Core::Crypto {
+namespace {
+// Inputs larger than this are split across the hashing workers
+constexpr std::size_t ParallelThreshold = 0x40000;
+
+std::size_t NumHashingWorkers() {
+    static const std::size_t num_workers =
+        std::min<std::size_t>(std::thread::hardware_concurrency() / 2, 4);
+    return num_workers;
+}
+
+Common::ThreadWorker& HashingWorkers() {
+    static Common::ThreadWorker workers(NumHashingWorkers(), "SHA256Hashing");
+    return workers;
+}
+
+#if defined(ARCHITECTURE_x86_64) || defined(HAS_ARM_SHA2)
+using State = std::array<u32, 8>;
+
+constexpr State InitialState{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                             0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+// clang-format off
+alignas(16) constexpr std::array<u32, 64> K{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+// clang-format on
+#endif
+
+#if defined(ARCHITECTURE_x86_64)
+TARGET_SHA void CompressBlocks(State& state, const u8* data, std::size_t blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    const auto* const round_constants = reinterpret_cast<const __m128i*>(K.data());
+
+    // The instructions work on the state split as ABEF and CDGH
+    const __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data()));
+    const __m128i hgfe = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data() + 4));
+    const __m128i cdab = _mm_shuffle_epi32(dcba, 0xB1);
+    const __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1B);
+    __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const __m128i abef_save = abef;
+        const __m128i cdgh_save = cdgh;
+        const auto* const in = reinterpret_cast<const __m128i*>(data);
+        __m128i messages[4];
+        for (std::size_t i = 0; i < 16; ++i) {
+            __m128i& message = messages[i % 4];
+            if (i < 4) {
+                message = _mm_shuffle_epi8(_mm_loadu_si128(in + i), byte_swap);
+            } else {
+                const __m128i previous = messages[(i + 3) % 4];
+                message = _mm_add_epi32(_mm_sha256msg1_epu32(message, messages[(i + 1) % 4]),
+                                        _mm_alignr_epi8(previous, messages[(i + 2) % 4], 4));
+                message = _mm_sha256msg2_epu32(message, previous);
+            }
+            const __m128i words = _mm_add_epi32(message, _mm_load_si128(round_constants + i));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(words, 0x0E));
+        }
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state.data()), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state.data() + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+#elif defined(HAS_ARM_SHA2)
+void CompressBlocks(State& state, const u8* data, std::size_t blocks) {
+    uint32x4_t abcd = vld1q_u32(state.data());
+    uint32x4_t efgh = vld1q_u32(state.data() + 4);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const uint32x4_t abcd_save = abcd;
+        const uint32x4_t efgh_save = efgh;
+        uint32x4_t messages[4];
+        for (std::size_t i = 0; i < 16; ++i) {
+            uint32x4_t& message = messages[i % 4];
+            if (i < 4) {
+                message = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+            } else {
+                message = vsha256su1q_u32(vsha256su0q_u32(message, messages[(i + 1) % 4]),
+                                          messages[(i + 2) % 4], messages[(i + 3) % 4]);
+            }
+            const uint32x4_t words = vaddq_u32(message, vld1q_u32(K.data() + i * 4));
+            const uint32x4_t previous_abcd = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, words);
+            efgh = vsha256h2q_u32(efgh, previous_abcd, words);
+        }
+        abcd = vaddq_u32(abcd, abcd_save);
+        efgh = vaddq_u32(efgh, efgh_save);
+    }
+
+    vst1q_u32(state.data(), abcd);
+    vst1q_u32(state.data() + 4, efgh);
+}
+#endif
+
+#if defined(ARCHITECTURE_x86_64) || defined(HAS_ARM_SHA2)
+SHA256Hash CalculateHardware(const u8* data, std::size_t size) {
+    State state = InitialState;
+    CompressBlocks(state, data, size / 64);
+
+    // Pad the remaining data with a one bit and the big-endian bit length of the message
+    std::array<u8, 128> tail{};
+    const std::size_t remaining = size % 64;
+    std::memcpy(tail.data(), data + size - remaining, remaining);
+    tail[remaining] = 0x80;
+    const std::size_t tail_size = remaining < 56 ? 64 : 128;
+    const u64 bit_length = static_cast<u64>(size) * 8;
+    for (std::size_t i = 0; i < sizeof(bit_length); ++i) {
+        tail[tail_size - 1 - i] = static_cast<u8>(bit_length >> (i * 8));
+    }
+    CompressBlocks(state, tail.data(), tail_size / 64);
+
+    SHA256Hash out;
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            out[i * 4 + j] = static_cast<u8>(state[i] >> (24 - j * 8));
+        }
+    }
+    return out;
+}
+
+bool HasSHAInstructions() {
+#if defined(ARCHITECTURE_x86_64)
+    const auto& caps = Common::GetCPUCaps();
+    return caps.sha && caps.sse4_1;
+#elif defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#else
+    return true;
+#endif
+}
+
+/// Checks the hardware path against mbedtls on lengths covering both padding cases
+bool HardwareMatchesReference() {
+    std::array<u8, 200> data;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(i * 73 + 5);
+    }
+    for (const std::size_t size : {0U, 1U, 55U, 56U, 63U, 64U, 119U, 120U, 200U}) {
+        SHA256Hash expected;
+        mbedtls_sha256_ret(data.data(), size, expected.data(), 0);
+        if (CalculateHardware(data.data(), size) != expected) {
+            LOG_ERROR(Crypto, "SHA-256 instructions gave a wrong hash for {} bytes, using mbedtls",
+                      size);
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+} // Anonymous namespace
+
+bool IsSHA256HardwareSupported() {
+#if defined(ARCHITECTURE_x86_64) || defined(HAS_ARM_SHA2)
+    static const bool supported = HasSHAInstructions() && HardwareMatchesReference();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+SHA256Hash CalculateSHA256(const u8* data, std::size_t size) {
+#if defined(ARCHITECTURE_x86_64) || defined(HAS_ARM_SHA2)
+    if (IsSHA256HardwareSupported()) {
+        return CalculateHardware(data, size);
+    }
+#endif
+    SHA256Hash out;
+    mbedtls_sha256_ret(data, size, out.data(), 0);
+    return out;
+}
+
+void CalculateSHA256Blocks(const u8* data, std::size_t size, std::size_t block_size,
+                           SHA256Hash* out) {
+    const std::size_t num_blocks = Common::DivCeil(size, block_size);
+    const auto hash_blocks = [&](std::size_t first, std::size_t count) {
+        for (std::size_t i = first; i < first + count; ++i) {
+            const std::size_t offset = i * block_size;
+            out[i] = CalculateSHA256(data + offset, std::min(block_size, size - offset));
+        }
+    };
+    if (size < ParallelThreshold || num_blocks < 2 || NumHashingWorkers() == 0) {
+        hash_blocks(0, num_blocks);
+        return;
+    }
+    const std::size_t num_threads = std::min(NumHashingWorkers() + 1, num_blocks);
+    const std::size_t chunk_blocks = Common::DivCeil(num_blocks, num_threads);
+    const std::size_t num_chunks = Common::DivCeil(num_blocks, chunk_blocks);
+
+    std::atomic<std::size_t> remaining_chunks{num_chunks};
+    Common::Event done;
+    const auto process_chunk = [&](std::size_t chunk) {
+        const std::size_t first = chunk * chunk_blocks;
+        hash_blocks(first, std::min(chunk_blocks, num_blocks - first));
+        if (remaining_chunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            done.Set();
+        }
+    };
+    auto& workers = HashingWorkers();
+    for (std::size_t chunk = 1; chunk < num_chunks; ++chunk) {
+        workers.QueueWork([&process_chunk, chunk] { process_chunk(chunk); });
+    }
+    process_chunk(0);
+    done.Wait();
+}
+
+} // namespace Core::Crypto
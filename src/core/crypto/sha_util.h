@@ -3,17 +3,31 @@
 
 #pragma once
 
-#include "common/assert.h"
-#include "core/file_sys/vfs.h"
-#include "key_manager.h"
-#include "mbedtls/cipher.h"
+#include <array>
+#include <cstddef>
 
-namespace Crypto {
-typedef std::array<u8, 0x20> SHA256Hash;
+#include "common/common_types.h"
 
-inline SHA256Hash operator"" _HASH(const char* data, size_t len) {
-    if (len != 0x40)
-        return {};
-}
+namespace Core::Crypto {
 
-} // namespace Crypto
+using SHA256Hash = std::array<u8, 0x20>;
+
+/**
+ * Returns true when the host supports the SHA-NI or ARMv8 SHA2 instructions used for hashing.
+ * They are only used once they gave the same hashes as mbedtls on a known-answer check.
+ */
+[[nodiscard]] bool IsSHA256HardwareSupported();
+
+/// Calculates the SHA-256 hash of data, using the SHA instructions of the host when available
+[[nodiscard]] SHA256Hash CalculateSHA256(const u8* data, std::size_t size);
+
+/**
+ * Calculates the SHA-256 hash of each block of data. Large inputs are hashed in parallel.
+ *
+ * @param block_size Size of the blocks, the last block may be shorter
+ * @param out        Receives DivCeil(size, block_size) hashes
+ */
+void CalculateSHA256Blocks(const u8* data, std::size_t size, std::size_t block_size,
+                           SHA256Hash* out);
+
+} // namespace Core::Crypto
@@ -1,7 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <cstring>
+#include <numeric>
 #include <span>
 #include <string_view>
 #include "common/alignment.h"
@@ -9,6 +11,7 @@
 #include "core/file_sys/fsmitm_romfsbuild.h"
 #include "core/file_sys/ips_layer.h"
 #include "core/file_sys/vfs/vfs.h"
+#include "core/file_sys/vfs/vfs_lazy.h"
 #include "core/file_sys/vfs/vfs_vector.h"
 
 namespace FileSys {
@@ -53,28 +56,26 @@ struct RomFSFileEntry {
 };
 static_assert(sizeof(RomFSFileEntry) == 0x20, "RomFSFileEntry has incorrect size.");
 
-struct RomFSBuildFileContext;
-
 struct RomFSBuildDirectoryContext {
-    std::string path;
+    u32 path_ofs = 0;
     u32 cur_path_ofs = 0;
     u32 path_len = 0;
     u32 entry_offset = 0;
-    std::shared_ptr<RomFSBuildDirectoryContext> parent;
-    std::shared_ptr<RomFSBuildDirectoryContext> child;
-    std::shared_ptr<RomFSBuildDirectoryContext> sibling;
-    std::shared_ptr<RomFSBuildFileContext> file;
+    u32 parent = ROMFS_ENTRY_EMPTY;
+    u32 child = ROMFS_ENTRY_EMPTY;
+    u32 sibling = ROMFS_ENTRY_EMPTY;
+    u32 file = ROMFS_ENTRY_EMPTY;
 };
 
 struct RomFSBuildFileContext {
-    std::string path;
+    u32 path_ofs = 0;
     u32 cur_path_ofs = 0;
     u32 path_len = 0;
     u32 entry_offset = 0;
     u64 offset = 0;
     u64 size = 0;
-    std::shared_ptr<RomFSBuildDirectoryContext> parent;
-    std::shared_ptr<RomFSBuildFileContext> sibling;
+    u32 parent = ROMFS_ENTRY_EMPTY;
+    u32 sibling = ROMFS_ENTRY_EMPTY;
     VirtualFile source;
 };
 
@@ -106,81 +107,99 @@ static u64 romfs_get_hash_table_count(u64 num_entries) {
     return count;
 }
 
-void RomFSBuildContext::VisitDirectory(VirtualDir romfs_dir, VirtualDir ext_dir,
-                                       std::shared_ptr<RomFSBuildDirectoryContext> parent) {
+void RomFSBuildContext::VisitDirectory(VirtualDir romfs_dir, VirtualDir ext_dir, u32 parent) {
     for (auto& child_romfs_file : romfs_dir->GetFiles()) {
         const auto name = child_romfs_file->GetName();
-        const auto child = std::make_shared<RomFSBuildFileContext>();
-        // Set child's path.
-        child->cur_path_ofs = parent->path_len + 1;
-        child->path_len = child->cur_path_ofs + static_cast<u32>(name.size());
-        child->path = parent->path + "/" + name;
-
         if (ext_dir != nullptr && ext_dir->GetFile(name + ".stub") != nullptr) {
             continue;
         }
 
+        RomFSBuildFileContext child{};
+        // Set child's path.
+        child.cur_path_ofs = directories[parent].path_len + 1;
+        child.path_len = child.cur_path_ofs + static_cast<u32>(name.size());
+
         // Sanity check on path_len
-        ASSERT(child->path_len < FS_MAX_PATH);
+        ASSERT(child.path_len < FS_MAX_PATH);
 
-        child->source = std::move(child_romfs_file);
+        child.path_ofs = AddPath(parent, name);
+        child.size = child_romfs_file->GetSize();
+        child.source = std::move(child_romfs_file);
 
         if (ext_dir != nullptr) {
-            if (const auto ips = ext_dir->GetFile(name + ".ips")) {
-                if (auto patched = PatchIPS(child->source, ips)) {
-                    child->source = std::move(patched);
-                }
+            if (auto ips = ext_dir->GetFile(name + ".ips")) {
+                // IPS patches don't change the size of a file, so it is only patched once read.
+                child.source = std::make_shared<LazyVfsFile>(
+                    [source = std::move(child.source), ips = std::move(ips)] {
+                        auto patched = PatchIPS(source, ips);
+                        return patched != nullptr ? patched : source;
+                    },
+                    child.size, name);
             }
         }
 
-        child->size = child->source->GetSize();
-
         AddFile(parent, std::move(child));
     }
 
     for (auto& child_romfs_dir : romfs_dir->GetSubdirectories()) {
         const auto name = child_romfs_dir->GetName();
-        const auto child = std::make_shared<RomFSBuildDirectoryContext>();
-        // Set child's path.
-        child->cur_path_ofs = parent->path_len + 1;
-        child->path_len = child->cur_path_ofs + static_cast<u32>(name.size());
-        child->path = parent->path + "/" + name;
-
         if (ext_dir != nullptr && ext_dir->GetFile(name + ".stub") != nullptr) {
             continue;
         }
 
+        RomFSBuildDirectoryContext child{};
+        // Set child's path.
+        child.cur_path_ofs = directories[parent].path_len + 1;
+        child.path_len = child.cur_path_ofs + static_cast<u32>(name.size());
+
         // Sanity check on path_len
-        ASSERT(child->path_len < FS_MAX_PATH);
+        ASSERT(child.path_len < FS_MAX_PATH);
 
-        if (!AddDirectory(parent, child)) {
+        child.path_ofs = AddPath(parent, name);
+
+        const auto child_index = static_cast<u32>(directories.size());
+        if (!AddDirectory(parent, std::move(child))) {
             continue;
         }
 
         auto child_ext_dir = ext_dir != nullptr ? ext_dir->GetSubdirectory(name) : nullptr;
-        this->VisitDirectory(child_romfs_dir, child_ext_dir, child);
+        this->VisitDirectory(child_romfs_dir, child_ext_dir, child_index);
     }
 }
 
-bool RomFSBuildContext::AddDirectory(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
-                                     std::shared_ptr<RomFSBuildDirectoryContext> dir_ctx) {
+u32 RomFSBuildContext::AddPath(u32 parent, std::string_view name) {
+    const auto& parent_ctx = directories[parent];
+    const auto path_ofs = static_cast<u32>(path_pool.size());
+
+    // Reserve first, so that the parent path stays valid while it is appended.
+    path_pool.reserve(path_pool.size() + parent_ctx.path_len + 1 + name.size());
+    path_pool.append(path_pool.data() + parent_ctx.path_ofs, parent_ctx.path_len);
+    path_pool.push_back('/');
+    path_pool.append(name);
+    return path_ofs;
+}
+
+std::string_view RomFSBuildContext::GetPath(u32 path_ofs, u32 path_len) const {
+    return std::string_view{path_pool}.substr(path_ofs, path_len);
+}
+
+bool RomFSBuildContext::AddDirectory(u32 parent, RomFSBuildDirectoryContext&& dir_ctx) {
     // Add a new directory.
     num_dirs++;
     dir_table_size +=
-        sizeof(RomFSDirectoryEntry) + Common::AlignUp(dir_ctx->path_len - dir_ctx->cur_path_ofs, 4);
-    dir_ctx->parent = std::move(parent_dir_ctx);
+        sizeof(RomFSDirectoryEntry) + Common::AlignUp(dir_ctx.path_len - dir_ctx.cur_path_ofs, 4);
+    dir_ctx.parent = parent;
     directories.emplace_back(std::move(dir_ctx));
 
     return true;
 }
 
-bool RomFSBuildContext::AddFile(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
-                                std::shared_ptr<RomFSBuildFileContext> file_ctx) {
+bool RomFSBuildContext::AddFile(u32 parent, RomFSBuildFileContext&& file_ctx) {
     // Add a new file.
     num_files++;
     file_table_size +=
-        sizeof(RomFSFileEntry) + Common::AlignUp(file_ctx->path_len - file_ctx->cur_path_ofs, 4);
-    file_ctx->parent = std::move(parent_dir_ctx);
+        sizeof(RomFSFileEntry) + Common::AlignUp(file_ctx.path_len - file_ctx.cur_path_ofs, 4);
+    file_ctx.parent = parent;
     files.emplace_back(std::move(file_ctx));
 
     return true;
@@ -188,18 +207,17 @@ bool RomFSBuildContext::AddFile(std::shared_ptr<RomFSBuildDirectoryContext> pare
 
 RomFSBuildContext::RomFSBuildContext(VirtualDir base_, VirtualDir ext_)
     : base(std::move(base_)), ext(std::move(ext_)) {
-    root = std::make_shared<RomFSBuildDirectoryContext>();
-    root->path = "\0";
-    directories.emplace_back(root);
+    // The root has an empty path and no parent.
+    directories.emplace_back();
     num_dirs = 1;
     dir_table_size = 0x18;
 
-    VisitDirectory(base, ext, root);
+    VisitDirectory(base, ext, 0);
 }
 
 RomFSBuildContext::~RomFSBuildContext() = default;
 
-std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
+std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build(RomFSBuildLayout* layout) {
     const u64 dir_hash_table_entry_count = romfs_get_hash_table_count(num_dirs);
     const u64 file_hash_table_entry_count = romfs_get_hash_table_count(num_files);
     dir_hash_table_size = 4 * dir_hash_table_entry_count;
@@ -226,45 +244,65 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
     std::memset(dir_hash_table.data(), 0xFF, dir_hash_table.size_bytes());
     std::memset(file_hash_table.data(), 0xFF, file_hash_table.size_bytes());
 
-    // Sort tables by name.
-    std::sort(files.begin(), files.end(),
-              [](const auto& a, const auto& b) { return a->path < b->path; });
-    std::sort(directories.begin(), directories.end(),
-              [](const auto& a, const auto& b) { return a->path < b->path; });
+    // Sort tables by name. Directories are sorted through an index table, as the directories and
+    // files refer to their parent directory by index. The root sorts first with its empty path.
+    const auto path_less = [this](const auto& a, const auto& b) {
+        return GetPath(a.path_ofs, a.path_len) < GetPath(b.path_ofs, b.path_len);
+    };
+    std::sort(files.begin(), files.end(), path_less);
+
+    std::vector<u32> dir_order(directories.size());
+    std::iota(dir_order.begin(), dir_order.end(), 0);
+    std::sort(dir_order.begin(), dir_order.end(),
+              [&](u32 a, u32 b) { return path_less(directories[a], directories[b]); });
+    std::vector<u32> dir_index(directories.size());
+    for (u32 i = 0; i < dir_order.size(); ++i) {
+        dir_index[dir_order[i]] = i;
+    }
+    std::vector<RomFSBuildDirectoryContext> sorted_directories;
+    sorted_directories.reserve(directories.size());
+    for (const auto index : dir_order) {
+        auto& cur_dir = sorted_directories.emplace_back(directories[index]);
+        if (cur_dir.parent != ROMFS_ENTRY_EMPTY) {
+            cur_dir.parent = dir_index[cur_dir.parent];
+        }
+    }
+    directories = std::move(sorted_directories);
+    for (auto& cur_file : files) {
+        cur_file.parent = dir_index[cur_file.parent];
+    }
 
     // Determine file offsets.
     u32 entry_offset = 0;
-    std::shared_ptr<RomFSBuildFileContext> prev_file = nullptr;
-    for (const auto& cur_file : files) {
+    for (auto& cur_file : files) {
         file_partition_size = Common::AlignUp(file_partition_size, 16);
-        cur_file->offset = file_partition_size;
-        file_partition_size += cur_file->size;
-        cur_file->entry_offset = entry_offset;
+        cur_file.offset = file_partition_size;
+        file_partition_size += cur_file.size;
+        cur_file.entry_offset = entry_offset;
         entry_offset +=
             static_cast<u32>(sizeof(RomFSFileEntry) +
-                             Common::AlignUp(cur_file->path_len - cur_file->cur_path_ofs, 4));
-        prev_file = cur_file;
+                             Common::AlignUp(cur_file.path_len - cur_file.cur_path_ofs, 4));
     }
     // Assign deferred parent/sibling ownership.
-    for (auto it = files.rbegin(); it != files.rend(); ++it) {
-        auto& cur_file = *it;
-        cur_file->sibling = cur_file->parent->file;
-        cur_file->parent->file = cur_file;
+    for (u32 i = static_cast<u32>(files.size()); i-- > 0;) {
+        auto& parent = directories[files[i].parent];
+        files[i].sibling = parent.file;
+        parent.file = i;
     }
 
     // Determine directory offsets.
     entry_offset = 0;
-    for (const auto& cur_dir : directories) {
-        cur_dir->entry_offset = entry_offset;
+    for (auto& cur_dir : directories) {
+        cur_dir.entry_offset = entry_offset;
         entry_offset +=
             static_cast<u32>(sizeof(RomFSDirectoryEntry) +
-                             Common::AlignUp(cur_dir->path_len - cur_dir->cur_path_ofs, 4));
+                             Common::AlignUp(cur_dir.path_len - cur_dir.cur_path_ofs, 4));
     }
     // Assign deferred parent/sibling ownership.
-    for (auto it = directories.rbegin(); (*it) != root; ++it) {
-        auto& cur_dir = *it;
-        cur_dir->sibling = cur_dir->parent->child;
-        cur_dir->parent->child = cur_dir;
+    for (u32 i = static_cast<u32>(directories.size()) - 1; i > 0; --i) {
+        auto& parent = directories[directories[i].parent];
+        directories[i].sibling = parent.child;
+        parent.child = i;
     }
 
     // Create output map.
@@ -285,62 +323,84 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
 
     std::vector<u8> header_data(sizeof(RomFSHeader));
     std::memcpy(header_data.data(), &header, header_data.size());
+    if (layout != nullptr) {
+        layout->header = header_data;
+        layout->files.clear();
+        layout->files.reserve(num_files);
+    }
     out.emplace_back(0, std::make_shared<VectorVfsFile>(std::move(header_data)));
 
     // Populate file tables.
-    for (const auto& cur_file : files) {
+    for (auto& cur_file : files) {
         RomFSFileEntry cur_entry{};
 
-        cur_entry.parent = cur_file->parent->entry_offset;
-        cur_entry.sibling =
-            cur_file->sibling == nullptr ? ROMFS_ENTRY_EMPTY : cur_file->sibling->entry_offset;
-        cur_entry.offset = cur_file->offset;
-        cur_entry.size = cur_file->size;
-
-        const auto name_size = cur_file->path_len - cur_file->cur_path_ofs;
-        const auto hash = romfs_calc_path_hash(cur_file->parent->entry_offset, cur_file->path,
-                                               cur_file->cur_path_ofs, name_size);
+        const auto& parent = directories[cur_file.parent];
+        cur_entry.parent = parent.entry_offset;
+        cur_entry.sibling = cur_file.sibling == ROMFS_ENTRY_EMPTY
+                                ? ROMFS_ENTRY_EMPTY
+                                : files[cur_file.sibling].entry_offset;
+        cur_entry.offset = cur_file.offset;
+        cur_entry.size = cur_file.size;
+
+        const auto path = GetPath(cur_file.path_ofs, cur_file.path_len);
+        const auto name_size = cur_file.path_len - cur_file.cur_path_ofs;
+        const auto hash =
+            romfs_calc_path_hash(parent.entry_offset, path, cur_file.cur_path_ofs, name_size);
         cur_entry.hash = file_hash_table[hash % file_hash_table_entry_count];
-        file_hash_table[hash % file_hash_table_entry_count] = cur_file->entry_offset;
+        file_hash_table[hash % file_hash_table_entry_count] = cur_file.entry_offset;
 
         cur_entry.name_size = name_size;
 
-        out.emplace_back(cur_file->offset + ROMFS_FILEPARTITION_OFS, std::move(cur_file->source));
-        std::memcpy(file_table.data() + cur_file->entry_offset, &cur_entry, sizeof(RomFSFileEntry));
-        std::memset(file_table.data() + cur_file->entry_offset + sizeof(RomFSFileEntry), 0,
+        if (layout != nullptr) {
+            layout->files.push_back({cur_file.offset + ROMFS_FILEPARTITION_OFS, cur_file.size,
+                                     std::string{path}});
+        }
+        out.emplace_back(cur_file.offset + ROMFS_FILEPARTITION_OFS, std::move(cur_file.source));
+        std::memcpy(file_table.data() + cur_file.entry_offset, &cur_entry, sizeof(RomFSFileEntry));
+        std::memset(file_table.data() + cur_file.entry_offset + sizeof(RomFSFileEntry), 0,
                     Common::AlignUp(cur_entry.name_size, 4));
-        std::memcpy(file_table.data() + cur_file->entry_offset + sizeof(RomFSFileEntry),
-                    cur_file->path.data() + cur_file->cur_path_ofs, name_size);
+        std::memcpy(file_table.data() + cur_file.entry_offset + sizeof(RomFSFileEntry),
+                    path.data() + cur_file.cur_path_ofs, name_size);
     }
 
     // Populate dir tables.
-    for (const auto& cur_dir : directories) {
+    for (u32 i = 0; i < directories.size(); ++i) {
+        const auto& cur_dir = directories[i];
         RomFSDirectoryEntry cur_entry{};
 
-        cur_entry.parent = cur_dir == root ? 0 : cur_dir->parent->entry_offset;
-        cur_entry.sibling =
-            cur_dir->sibling == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->sibling->entry_offset;
-        cur_entry.child =
-            cur_dir->child == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->child->entry_offset;
-        cur_entry.file = cur_dir->file == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->file->entry_offset;
-
-        const auto name_size = cur_dir->path_len - cur_dir->cur_path_ofs;
-        const auto hash = romfs_calc_path_hash(cur_dir == root ? 0 : cur_dir->parent->entry_offset,
-                                               cur_dir->path, cur_dir->cur_path_ofs, name_size);
+        const u32 parent_offset = i == 0 ? 0 : directories[cur_dir.parent].entry_offset;
+        cur_entry.parent = parent_offset;
+        cur_entry.sibling = cur_dir.sibling == ROMFS_ENTRY_EMPTY
+                                ? ROMFS_ENTRY_EMPTY
+                                : directories[cur_dir.sibling].entry_offset;
+        cur_entry.child = cur_dir.child == ROMFS_ENTRY_EMPTY
+                              ? ROMFS_ENTRY_EMPTY
+                              : directories[cur_dir.child].entry_offset;
+        cur_entry.file = cur_dir.file == ROMFS_ENTRY_EMPTY ? ROMFS_ENTRY_EMPTY
+                                                           : files[cur_dir.file].entry_offset;
+
+        const auto path = GetPath(cur_dir.path_ofs, cur_dir.path_len);
+        const auto name_size = cur_dir.path_len - cur_dir.cur_path_ofs;
+        const auto hash =
+            romfs_calc_path_hash(parent_offset, path, cur_dir.cur_path_ofs, name_size);
         cur_entry.hash = dir_hash_table[hash % dir_hash_table_entry_count];
-        dir_hash_table[hash % dir_hash_table_entry_count] = cur_dir->entry_offset;
+        dir_hash_table[hash % dir_hash_table_entry_count] = cur_dir.entry_offset;
 
         cur_entry.name_size = name_size;
 
-        std::memcpy(dir_table.data() + cur_dir->entry_offset, &cur_entry,
+        std::memcpy(dir_table.data() + cur_dir.entry_offset, &cur_entry,
                     sizeof(RomFSDirectoryEntry));
-        std::memset(dir_table.data() + cur_dir->entry_offset + sizeof(RomFSDirectoryEntry), 0,
+        std::memset(dir_table.data() + cur_dir.entry_offset + sizeof(RomFSDirectoryEntry), 0,
                     Common::AlignUp(cur_entry.name_size, 4));
-        std::memcpy(dir_table.data() + cur_dir->entry_offset + sizeof(RomFSDirectoryEntry),
-                    cur_dir->path.data() + cur_dir->cur_path_ofs, name_size);
+        std::memcpy(dir_table.data() + cur_dir.entry_offset + sizeof(RomFSDirectoryEntry),
+                    path.data() + cur_dir.cur_path_ofs, name_size);
     }
 
     // Write metadata.
+    if (layout != nullptr) {
+        layout->metadata_offset = header.dir_hash_table_ofs;
+        layout->metadata = metadata;
+    }
     out.emplace_back(header.dir_hash_table_ofs,
                      std::make_shared<VectorVfsFile>(std::move(metadata)));
 
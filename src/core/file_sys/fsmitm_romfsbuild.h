@@ -6,6 +6,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "common/common_types.h"
 #include "core/file_sys/vfs/vfs.h"
 
@@ -16,20 +18,35 @@ struct RomFSBuildFileContext;
 struct RomFSDirectoryEntry;
 struct RomFSFileEntry;
 
+// The layout of a built RomFS, enough to rebuild it without walking its source directories.
+struct RomFSBuildLayout {
+    struct File {
+        u64 offset;
+        u64 size;
+        std::string path;
+    };
+
+    std::vector<u8> header;
+    u64 metadata_offset{};
+    std::vector<u8> metadata;
+    std::vector<File> files;
+};
+
 class RomFSBuildContext {
 public:
     explicit RomFSBuildContext(VirtualDir base, VirtualDir ext = nullptr);
     ~RomFSBuildContext();
 
-    // This finalizes the context.
-    std::vector<std::pair<u64, VirtualFile>> Build();
+    // This finalizes the context. If layout is not null, it receives the layout of the RomFS.
+    std::vector<std::pair<u64, VirtualFile>> Build(RomFSBuildLayout* layout = nullptr);
 
 private:
     VirtualDir base;
     VirtualDir ext;
-    std::shared_ptr<RomFSBuildDirectoryContext> root;
-    std::vector<std::shared_ptr<RomFSBuildDirectoryContext>> directories;
-    std::vector<std::shared_ptr<RomFSBuildFileContext>> files;
+    // The paths of all entries back to back, entries refer to their parent by index.
+    std::string path_pool;
+    std::vector<RomFSBuildDirectoryContext> directories;
+    std::vector<RomFSBuildFileContext> files;
     u64 num_dirs = 0;
     u64 num_files = 0;
     u64 dir_table_size = 0;
@@ -38,13 +55,13 @@ private:
     u64 file_hash_table_size = 0;
     u64 file_partition_size = 0;
 
-    void VisitDirectory(VirtualDir filesys, VirtualDir ext_dir,
-                        std::shared_ptr<RomFSBuildDirectoryContext> parent);
+    void VisitDirectory(VirtualDir filesys, VirtualDir ext_dir, u32 parent);
+
+    u32 AddPath(u32 parent, std::string_view name);
+    std::string_view GetPath(u32 path_ofs, u32 path_len) const;
 
-    bool AddDirectory(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
-                      std::shared_ptr<RomFSBuildDirectoryContext> dir_ctx);
-    bool AddFile(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
-                 std::shared_ptr<RomFSBuildFileContext> file_ctx);
+    bool AddDirectory(u32 parent, RomFSBuildDirectoryContext&& dir_ctx);
+    bool AddFile(u32 parent, RomFSBuildFileContext&& file_ctx);
 };
 
 } // namespace FileSys
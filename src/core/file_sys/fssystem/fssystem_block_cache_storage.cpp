@@ -0,0 +1,320 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/assert.h"
+#include "common/div_ceil.h"
+#include "common/settings.h"
+#include "core/file_sys/fssystem/fssystem_block_cache_storage.h"
+
+namespace FileSys {
+
+namespace {
+
+std::atomic<u64> g_next_storage_id{1};
+
+} // namespace
+
+BlockCache::BlockCache(size_t capacity)
+    : m_blocks_per_shard(capacity / BlockSize / ShardCount),
+      m_read_ahead_worker(1, "VfsReadAhead") {}
+
+BlockCache::~BlockCache() = default;
+
+BlockCache& BlockCache::GetInstance() {
+    static BlockCache cache(0);
+    cache.SetCapacity(Settings::values.vfs_block_cache_size.GetValue() * 1_MiB);
+    return cache;
+}
+
+void BlockCache::SetCapacity(size_t capacity) {
+    const size_t blocks_per_shard = capacity / BlockSize / ShardCount;
+    if (m_blocks_per_shard.exchange(blocks_per_shard) <= blocks_per_shard) {
+        return;
+    }
+    for (auto& shard : m_shards) {
+        std::scoped_lock lk{shard.mutex};
+        this->EvictExcess(shard);
+    }
+}
+
+size_t BlockCache::GetCapacity() const {
+    return m_blocks_per_shard.load() * BlockSize * ShardCount;
+}
+
+bool BlockCache::Read(u64 storage_id, u64 block_index, u8* buffer, size_t offset, size_t size) {
+    const Key key{storage_id, block_index};
+    auto& shard = this->GetShard(key);
+    {
+        std::scoped_lock lk{shard.mutex};
+        const auto it = shard.entries.find(key);
+        if (it != shard.entries.end() && offset + size <= it->second->data.size()) {
+            // Move the block to the front of the LRU list.
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+
+            Entry& entry = *it->second;
+            std::memcpy(buffer, entry.data.data() + offset, size);
+            if (entry.read_ahead) {
+                entry.read_ahead = false;
+                ++m_read_ahead_hits;
+            }
+            ++m_hits;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BlockCache::Contains(u64 storage_id, u64 block_index) const {
+    const Key key{storage_id, block_index};
+    const auto& shard = this->GetShard(key);
+    std::scoped_lock lk{shard.mutex};
+    return shard.entries.contains(key);
+}
+
+void BlockCache::Insert(u64 storage_id, u64 block_index, const u8* data, size_t size,
+                        bool read_ahead) {
+    ASSERT(size <= BlockSize);
+
+    // Blocks not read ahead are inserted after a miss.
+    if (read_ahead) {
+        ++m_read_ahead_blocks;
+    } else {
+        ++m_misses;
+    }
+
+    const Key key{storage_id, block_index};
+    auto& shard = this->GetShard(key);
+    std::scoped_lock lk{shard.mutex};
+    if (m_blocks_per_shard.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+        if (shard.entries.size() >= m_blocks_per_shard.load(std::memory_order_relaxed)) {
+            // Reuse the least recently used block.
+            auto last = std::prev(shard.lru.end());
+            shard.entries.erase(last->key);
+            shard.lru.splice(shard.lru.begin(), shard.lru, last);
+        } else {
+            shard.lru.emplace_front();
+        }
+        it = shard.entries.emplace(key, shard.lru.begin()).first;
+    } else {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    }
+
+    Entry& entry = *it->second;
+    entry.key = key;
+    entry.data.assign(data, data + size);
+    entry.read_ahead = read_ahead;
+}
+
+void BlockCache::Invalidate(u64 storage_id) {
+    for (auto& shard : m_shards) {
+        std::scoped_lock lk{shard.mutex};
+        for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+            if (it->key.storage_id == storage_id) {
+                shard.entries.erase(it->key);
+                it = shard.lru.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void BlockCache::QueueReadAhead(Common::UniqueFunction<void> task) {
+    m_read_ahead_worker.QueueWork(std::move(task));
+}
+
+void BlockCache::WaitForReadAhead() {
+    m_read_ahead_worker.WaitForRequests();
+}
+
+BlockCacheStatistics BlockCache::GetStatistics() const {
+    return {
+        .hits = m_hits.load(),
+        .misses = m_misses.load(),
+        .read_ahead_blocks = m_read_ahead_blocks.load(),
+        .read_ahead_hits = m_read_ahead_hits.load(),
+    };
+}
+
+void BlockCache::ResetStatistics() {
+    m_hits = 0;
+    m_misses = 0;
+    m_read_ahead_blocks = 0;
+    m_read_ahead_hits = 0;
+}
+
+BlockCache::Shard& BlockCache::GetShard(const Key& key) {
+    return m_shards[KeyHash{}(key) % ShardCount];
+}
+
+const BlockCache::Shard& BlockCache::GetShard(const Key& key) const {
+    return m_shards[KeyHash{}(key) % ShardCount];
+}
+
+void BlockCache::EvictExcess(Shard& shard) {
+    const size_t blocks_per_shard = m_blocks_per_shard.load(std::memory_order_relaxed);
+    while (shard.entries.size() > blocks_per_shard) {
+        shard.entries.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+    }
+}
+
+BlockCacheStorage::BlockCacheStorage(VirtualFile base, BlockCache& cache, bool read_ahead)
+    : m_state(std::make_shared<State>()), m_cache(cache), m_read_ahead(read_ahead) {
+    ASSERT(base != nullptr);
+
+    m_state->size = base->GetSize();
+    m_state->base_storage = std::move(base);
+    m_state->id = g_next_storage_id++;
+}
+
+BlockCacheStorage::~BlockCacheStorage() {
+    m_state->cancelled = true;
+    m_cache.Invalidate(m_state->id);
+}
+
+size_t BlockCacheStorage::Read(u8* buffer, size_t size, size_t offset) const {
+    // Clamp the read to the storage.
+    if (offset >= m_state->size) {
+        return 0;
+    }
+    size = std::min(size, m_state->size - offset);
+    if (size == 0) {
+        return 0;
+    }
+
+    // Copy the blocks, reading runs of missing blocks from the base storage at once.
+    const u64 first_block = offset / BlockCache::BlockSize;
+    const u64 end_block = Common::DivCeil(offset + size, BlockCache::BlockSize);
+    std::vector<u8> read_buffer;
+    size_t read_size = 0;
+    u64 block = first_block;
+    while (block < end_block) {
+        const size_t block_offset = block * BlockCache::BlockSize;
+        const size_t copy_offset = std::max(offset, block_offset);
+        const size_t copy_size =
+            std::min(offset + size, block_offset + BlockCache::BlockSize) - copy_offset;
+        if (m_cache.Read(m_state->id, block, buffer + (copy_offset - offset),
+                         copy_offset - block_offset, copy_size)) {
+            read_size += copy_size;
+            ++block;
+            continue;
+        }
+
+        // Find the end of the missing run.
+        u64 run_end = block + 1;
+        while (run_end < end_block && run_end - block < MaxReadBlocks &&
+               !m_cache.Contains(m_state->id, run_end)) {
+            ++run_end;
+        }
+
+        read_buffer.resize((run_end - block) * BlockCache::BlockSize);
+        const size_t run_read = ReadBlocks(*m_state, m_cache, read_buffer.data(), block,
+                                           run_end - block, false);
+
+        // Copy the requested part of the run.
+        const size_t run_copy_end = std::min(offset + size, block_offset + run_read);
+        if (run_copy_end <= copy_offset) {
+            break;
+        }
+        std::memcpy(buffer + (copy_offset - offset),
+                    read_buffer.data() + (copy_offset - block_offset), run_copy_end - copy_offset);
+        read_size += run_copy_end - copy_offset;
+        if (run_read < (run_end - block) * BlockCache::BlockSize &&
+            block_offset + run_read < m_state->size) {
+            // The base storage returned less than requested.
+            break;
+        }
+        block = run_end;
+    }
+
+    if (m_read_ahead) {
+        this->UpdateReadAhead(offset, size);
+    }
+    return read_size;
+}
+
+size_t BlockCacheStorage::GetSize() const {
+    return m_state->size;
+}
+
+size_t BlockCacheStorage::ReadBlocks(State& state, BlockCache& cache, u8* buffer,
+                                     u64 first_block, u64 num_blocks, bool read_ahead) {
+    const size_t offset = first_block * BlockCache::BlockSize;
+    const size_t size = std::min(num_blocks * BlockCache::BlockSize, state.size - offset);
+
+    size_t read_size;
+    {
+        std::scoped_lock lk{state.base_mutex};
+        read_size = state.base_storage->Read(buffer, size, offset);
+    }
+
+    // Only cache complete blocks, or the last block of the storage.
+    for (u64 i = 0; i < num_blocks; ++i) {
+        const size_t block_offset = i * BlockCache::BlockSize;
+        if (block_offset >= read_size) {
+            break;
+        }
+        const size_t block_size = std::min(BlockCache::BlockSize, read_size - block_offset);
+        if (block_size < BlockCache::BlockSize && offset + read_size < state.size) {
+            break;
+        }
+        cache.Insert(state.id, first_block + i, buffer + block_offset, block_size, read_ahead);
+    }
+    return read_size;
+}
+
+void BlockCacheStorage::UpdateReadAhead(size_t offset, size_t size) const {
+    // Detect sequential reads.
+    if (m_next_offset.exchange(offset + size) != offset) {
+        m_sequential_reads = 0;
+        return;
+    }
+    if (++m_sequential_reads < SequentialReadsForReadAhead) {
+        return;
+    }
+
+    // Keep the read ahead window in front of the reads, refilling it once half of it is used.
+    const u64 next_block = Common::DivCeil(offset + size, BlockCache::BlockSize);
+    const u64 num_blocks = Common::DivCeil(m_state->size, BlockCache::BlockSize);
+    const u64 window_start = std::max(next_block, m_read_ahead_end.load());
+    const u64 window_end = std::min(next_block + ReadAheadBlocks, num_blocks);
+    if (window_start >= window_end || window_start - next_block > ReadAheadBlocks / 2) {
+        return;
+    }
+    m_read_ahead_end = window_end;
+
+    m_cache.QueueReadAhead([state = m_state, &cache = m_cache, window_start, window_end] {
+        std::vector<u8> buffer;
+        u64 block = window_start;
+        while (block < window_end && !state->cancelled) {
+            if (cache.Contains(state->id, block)) {
+                ++block;
+                continue;
+            }
+            u64 run_end = block + 1;
+            while (run_end < window_end && !cache.Contains(state->id, run_end)) {
+                ++run_end;
+            }
+            buffer.resize((run_end - block) * BlockCache::BlockSize);
+            ReadBlocks(*state, cache, buffer.data(), block, run_end - block, true);
+            block = run_end;
+        }
+
+        // The storage may have been destroyed after its blocks were invalidated but before the
+        // last run was inserted.
+        if (state->cancelled) {
+            cache.Invalidate(state->id);
+        }
+    });
+}
+
+} // namespace FileSys
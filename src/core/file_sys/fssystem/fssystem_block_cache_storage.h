@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/literals.h"
+#include "common/thread_worker.h"
+#include "core/file_sys/fssystem/fs_i_storage.h"
+
+namespace FileSys {
+
+using namespace Common::Literals;
+
+struct BlockCacheStatistics {
+    u64 hits;
+    u64 misses;
+    u64 read_ahead_blocks;
+    u64 read_ahead_hits;
+
+    double HitRate() const {
+        const u64 lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+};
+
+/// Sharded LRU cache of storage blocks, shared by all the block cache storages.
+class BlockCache {
+    SUDACHI_NON_COPYABLE(BlockCache);
+    SUDACHI_NON_MOVEABLE(BlockCache);
+
+public:
+    static constexpr size_t BlockSize = 16_KiB;
+    static constexpr size_t ShardCount = 16;
+
+public:
+    explicit BlockCache(size_t capacity);
+    ~BlockCache();
+
+    /// Returns the cache used for game content, sized from the settings.
+    static BlockCache& GetInstance();
+
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const;
+
+    /// Copies size bytes at offset of a cached block, returns false when it is not cached.
+    bool Read(u64 storage_id, u64 block_index, u8* buffer, size_t offset, size_t size);
+    bool Contains(u64 storage_id, u64 block_index) const;
+    void Insert(u64 storage_id, u64 block_index, const u8* data, size_t size, bool read_ahead);
+
+    /// Drops the blocks of a storage.
+    void Invalidate(u64 storage_id);
+
+    /// Reads blocks of a storage in the background.
+    void QueueReadAhead(Common::UniqueFunction<void> task);
+    void WaitForReadAhead();
+
+    BlockCacheStatistics GetStatistics() const;
+    void ResetStatistics();
+
+private:
+    struct Key {
+        u64 storage_id;
+        u64 block_index;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return static_cast<size_t>((key.storage_id * 0x9E3779B97F4A7C15ULL) ^ key.block_index);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::vector<u8> data;
+        bool read_ahead;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;
+    };
+
+    Shard& GetShard(const Key& key);
+    const Shard& GetShard(const Key& key) const;
+    void EvictExcess(Shard& shard);
+
+    std::array<Shard, ShardCount> m_shards;
+    std::atomic<size_t> m_blocks_per_shard;
+
+    std::atomic<u64> m_hits{};
+    std::atomic<u64> m_misses{};
+    std::atomic<u64> m_read_ahead_blocks{};
+    std::atomic<u64> m_read_ahead_hits{};
+
+    // Declared last so read ahead stops before the shards are destroyed.
+    Common::ThreadWorker m_read_ahead_worker;
+};
+
+/// Caches the blocks read from a storage and reads ahead of sequential accesses.
+class BlockCacheStorage : public IReadOnlyStorage {
+    SUDACHI_NON_COPYABLE(BlockCacheStorage);
+    SUDACHI_NON_MOVEABLE(BlockCacheStorage);
+
+public:
+    static constexpr size_t MaxReadBlocks = 64;
+    static constexpr size_t ReadAheadBlocks = 32;
+    static constexpr u32 SequentialReadsForReadAhead = 2;
+
+public:
+    BlockCacheStorage(VirtualFile base, BlockCache& cache, bool read_ahead);
+    ~BlockCacheStorage() override;
+
+    virtual size_t Read(u8* buffer, size_t size, size_t offset) const override;
+    virtual size_t GetSize() const override;
+
+private:
+    struct State {
+        VirtualFile base_storage;
+        // Decryption storages are not safe to read from several threads at once.
+        std::mutex base_mutex;
+        size_t size;
+        u64 id;
+        // Set when the storage is destroyed, so queued read ahead no longer caches its blocks.
+        std::atomic<bool> cancelled{};
+    };
+
+    static size_t ReadBlocks(State& state, BlockCache& cache, u8* buffer, u64 first_block,
+                             u64 num_blocks, bool read_ahead);
+
+    void UpdateReadAhead(size_t offset, size_t size) const;
+
+    std::shared_ptr<State> m_state;
+    BlockCache& m_cache;
+    bool m_read_ahead;
+
+    mutable std::atomic<size_t> m_next_offset{};
+    mutable std::atomic<u32> m_sequential_reads{};
+    mutable std::atomic<u64> m_read_ahead_end{};
+};
+
+} // namespace FileSys
@@ -1,8 +1,15 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <cstring>
+#include <vector>
+
 #include "common/alignment.h"
+#include "common/div_ceil.h"
+#include "common/logging/log.h"
 #include "common/scope_exit.h"
+#include "common/settings.h"
+#include "core/crypto/sha_util.h"
 #include "core/file_sys/fssystem/fssystem_hierarchical_sha256_storage.h"
 
 namespace FileSys {
@@ -63,6 +70,24 @@ Result HierarchicalSha256Storage::Initialize(VirtualFile* base_storages, s32 lay
     base_storages[1]->Read(reinterpret_cast<u8*>(m_hash_buffer),
                            static_cast<size_t>(hash_storage_size), 0);
 
+    // Verify the data hashes. A mismatch only fails when verification was enabled.
+    const bool verify = Settings::values.vfs_verify_integrity.GetValue();
+    const auto hash = Core::Crypto::CalculateSHA256(reinterpret_cast<const u8*>(m_hash_buffer),
+                                                    static_cast<size_t>(hash_storage_size));
+    if (std::memcmp(hash.data(), master_hash.data(), HashSize) != 0) {
+        LOG_ERROR(Common_Filesystem, "Hash table does not match the master hash");
+        R_UNLESS(!verify, ResultHierarchicalSha256HashVerificationFailed);
+    }
+
+    // Prepare to verify the data, if we should.
+    if (verify) {
+        const s64 block_count = Common::DivCeil(m_base_storage_size,
+                                                static_cast<u64>(m_hash_target_block_size));
+        if (block_count * static_cast<s64>(HashSize) <= hash_storage_size) {
+            m_verified_blocks.Initialize(block_count, m_hash_target_block_size);
+        }
+    }
+
     R_SUCCEED();
 }
 
@@ -75,8 +100,52 @@ size_t HierarchicalSha256Storage::Read(u8* buffer, size_t size, size_t offset) c
     // Validate that we have a buffer to read into.
     ASSERT(buffer != nullptr);
 
-    // Read the data.
-    return m_base_storage->Read(buffer, size, offset);
+    // Read the data directly if we don't verify it.
+    const size_t base_size = static_cast<size_t>(m_base_storage_size);
+    if (!m_verified_blocks.IsInitialized() || offset >= base_size) {
+        return m_base_storage->Read(buffer, size, offset);
+    }
+
+    // Determine the blocks covered by the read. The last block is hashed without padding.
+    const size_t block_size = static_cast<size_t>(m_hash_target_block_size);
+    const size_t end = std::min(offset + size, base_size);
+    const size_t aligned_offset = Common::AlignDown(offset, block_size);
+    const size_t aligned_end = std::min(Common::AlignUp(end, block_size), base_size);
+    const s64 first_block = static_cast<s64>(aligned_offset / block_size);
+    const s64 block_count =
+        static_cast<s64>(Common::DivCeil(aligned_end - aligned_offset, block_size));
+
+    // Read the data directly if it was already verified.
+    if (m_verified_blocks.IsVerified(first_block, block_count)) {
+        return m_base_storage->Read(buffer, size, offset);
+    }
+
+    // Read the whole blocks, directly into the buffer if the read covers them.
+    const bool is_aligned = aligned_offset == offset && aligned_end == end;
+    std::vector<u8> block_buffer(is_aligned ? 0 : aligned_end - aligned_offset);
+    u8* const blocks = is_aligned ? buffer : block_buffer.data();
+    const size_t read_size =
+        m_base_storage->Read(blocks, aligned_end - aligned_offset, aligned_offset);
+
+    // Verify the blocks.
+    const auto* hashes = reinterpret_cast<const u8*>(m_hash_buffer) + first_block * HashSize;
+    const s64 corrupted_count = m_verified_blocks.Verify(first_block, blocks, read_size, hashes);
+    if (corrupted_count != 0) {
+        LOG_ERROR(Common_Filesystem, "{} corrupted blocks in range 0x{:X}-0x{:X}",
+                  corrupted_count, aligned_offset, aligned_offset + read_size);
+    }
+
+    // Copy the requested data out of the blocks.
+    if (is_aligned) {
+        return read_size;
+    }
+    const size_t copy_offset = offset - aligned_offset;
+    if (read_size <= copy_offset) {
+        return 0;
+    }
+    const size_t copy_size = std::min(end - offset, read_size - copy_offset);
+    std::memcpy(buffer, blocks + copy_offset, copy_size);
+    return copy_size;
 }
 
 } // namespace FileSys
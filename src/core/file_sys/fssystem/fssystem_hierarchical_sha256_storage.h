@@ -7,6 +7,7 @@
 
 #include "core/file_sys/errors.h"
 #include "core/file_sys/fssystem/fs_i_storage.h"
+#include "core/file_sys/fssystem/fssystem_verified_block_bitmap.h"
 #include "core/file_sys/vfs/vfs.h"
 
 namespace FileSys {
@@ -38,6 +39,7 @@ private:
     size_t m_hash_buffer_size;
     s32 m_hash_target_block_size;
     s32 m_log_size_ratio;
+    mutable VerifiedBlockBitmap m_verified_blocks;
     std::mutex m_mutex;
 };
 
@@ -1,7 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <cstring>
+#include <vector>
+
 #include "common/alignment.h"
+#include "common/div_ceil.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/file_sys/fssystem/fssystem_integrity_verification_storage.h"
 
 namespace FileSys {
@@ -40,11 +46,20 @@ void IntegrityVerificationStorage::Initialize(VirtualFile hs, VirtualFile ds, s6
 
     // Set data.
     m_is_real_data = is_real_data;
+
+    // Prepare to verify the data, if we should.
+    if (Settings::values.vfs_verify_integrity.GetValue()) {
+        m_verified_blocks.Initialize(
+            Common::DivCeil(static_cast<s64>(m_data_storage->GetSize()),
+                            static_cast<u64>(m_verification_block_size)),
+            m_verification_block_size);
+    }
 }
 
 void IntegrityVerificationStorage::Finalize() {
     m_hash_storage = VirtualFile();
     m_data_storage = VirtualFile();
+    m_verified_blocks.Finalize();
 }
 
 size_t IntegrityVerificationStorage::Read(u8* buffer, size_t size, size_t offset) const {
@@ -80,8 +95,50 @@ size_t IntegrityVerificationStorage::Read(u8* buffer, size_t size, size_t offset
         read_size = static_cast<size_t>(data_size - offset);
     }
 
-    // Perform the read.
-    return m_data_storage->Read(buffer, read_size, offset);
+    // Read the data directly if we don't verify it.
+    if (!m_verified_blocks.IsInitialized()) {
+        return m_data_storage->Read(buffer, read_size, offset);
+    }
+
+    // Determine the blocks covered by the read. The last block is hashed with its padding.
+    const size_t block_size = static_cast<size_t>(m_verification_block_size);
+    const size_t aligned_offset = Common::AlignDown(offset, block_size);
+    const size_t aligned_end = Common::AlignUp(offset + read_size, block_size);
+    const s64 first_block = static_cast<s64>(aligned_offset >> m_verification_block_order);
+    const s64 block_count =
+        static_cast<s64>((aligned_end - aligned_offset) >> m_verification_block_order);
+
+    // Read the data directly if it was already verified.
+    if (m_verified_blocks.IsVerified(first_block, block_count)) {
+        return m_data_storage->Read(buffer, read_size, offset);
+    }
+
+    // Read the whole blocks, directly into the buffer if the read covers them.
+    const size_t data_end = std::min(aligned_end, static_cast<size_t>(data_size));
+    const bool is_aligned = aligned_offset == offset && aligned_end == offset + size;
+    std::vector<u8> block_buffer(is_aligned ? 0 : aligned_end - aligned_offset);
+    u8* const blocks = is_aligned ? buffer : block_buffer.data();
+    const size_t blocks_read_size =
+        m_data_storage->Read(blocks, data_end - aligned_offset, aligned_offset);
+    ASSERT(blocks_read_size == data_end - aligned_offset);
+
+    // Read the hashes of the blocks.
+    std::vector<u8> hashes(static_cast<size_t>(block_count * HashSize));
+    m_hash_storage->Read(hashes.data(), hashes.size(), first_block * HashSize);
+
+    // Verify the blocks.
+    const s64 corrupted_count =
+        m_verified_blocks.Verify(first_block, blocks, aligned_end - aligned_offset, hashes.data());
+    if (corrupted_count != 0) {
+        LOG_ERROR(Common_Filesystem, "{} corrupted {} blocks in range 0x{:X}-0x{:X}",
+                  corrupted_count, m_is_real_data ? "data" : "hash", aligned_offset, data_end);
+    }
+
+    // Copy the requested data out of the blocks.
+    if (!is_aligned) {
+        std::memcpy(buffer, blocks + (offset - aligned_offset), read_size);
+    }
+    return read_size;
 }
 
 size_t IntegrityVerificationStorage::GetSize() const {
@@ -7,6 +7,7 @@
 
 #include "core/file_sys/fssystem/fs_i_storage.h"
 #include "core/file_sys/fssystem/fs_types.h"
+#include "core/file_sys/fssystem/fssystem_verified_block_bitmap.h"
 
 namespace FileSys {
 
@@ -60,6 +61,7 @@ private:
     s64 m_upper_layer_verification_block_size;
     s64 m_upper_layer_verification_block_order;
     bool m_is_real_data;
+    mutable VerifiedBlockBitmap m_verified_blocks;
 };
 
 } // namespace FileSys
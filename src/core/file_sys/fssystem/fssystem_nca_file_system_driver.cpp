@@ -1,10 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "common/settings.h"
 #include "core/file_sys/fssystem/fssystem_aes_ctr_counter_extended_storage.h"
 #include "core/file_sys/fssystem/fssystem_aes_ctr_storage.h"
 #include "core/file_sys/fssystem/fssystem_aes_xts_storage.h"
 #include "core/file_sys/fssystem/fssystem_alignment_matching_storage.h"
+#include "core/file_sys/fssystem/fssystem_block_cache_storage.h"
 #include "core/file_sys/fssystem/fssystem_compressed_storage.h"
 #include "core/file_sys/fssystem/fssystem_hierarchical_integrity_verification_storage.h"
 #include "core/file_sys/fssystem/fssystem_hierarchical_sha256_storage.h"
@@ -296,6 +298,9 @@ Result NcaFileSystemDriver::CreateStorageByRawStorage(VirtualFile* out,
     // Initialize storage as raw storage.
     VirtualFile storage = std::move(raw_storage);
 
+    // Cache the decrypted data read by the hash/integrity layer.
+    R_TRY(this->CreateBlockCacheStorage(std::addressof(storage), std::move(storage)));
+
     // Process hash/integrity layer.
     switch (header_reader->GetHashType()) {
     case NcaFsHeader::HashType::HierarchicalSha256Hash:
@@ -415,6 +420,28 @@ Result NcaFileSystemDriver::CreateBodySubStorage(VirtualFile* out, s64 offset, s
     R_SUCCEED();
 }
 
+Result NcaFileSystemDriver::CreateBlockCacheStorage(VirtualFile* out, VirtualFile base_storage) {
+    // Check pre-conditions.
+    ASSERT(out != nullptr);
+    ASSERT(base_storage != nullptr);
+
+    // If the cache is disabled, use the base storage.
+    auto& cache = BlockCache::GetInstance();
+    if (cache.GetCapacity() == 0) {
+        *out = std::move(base_storage);
+        R_SUCCEED();
+    }
+
+    // Create the block cache storage.
+    auto cache_storage = std::make_shared<BlockCacheStorage>(
+        std::move(base_storage), cache, Settings::values.vfs_read_ahead.GetValue());
+    R_UNLESS(cache_storage != nullptr, ResultAllocationMemoryFailedAllocateShared);
+
+    // Set the out storage.
+    *out = std::move(cache_storage);
+    R_SUCCEED();
+}
+
 Result NcaFileSystemDriver::CreateAesCtrStorage(
     VirtualFile* out, VirtualFile base_storage, s64 offset, const NcaAesCtrUpperIv& upper_iv,
     AlignmentStorageRequirement alignment_storage_requirement) {
@@ -280,6 +280,8 @@ private:
 
     Result CreateBodySubStorage(VirtualFile* out, s64 offset, s64 size);
 
+    Result CreateBlockCacheStorage(VirtualFile* out, VirtualFile base_storage);
+
     Result CreateAesCtrStorage(VirtualFile* out, VirtualFile base_storage, s64 offset,
                                const NcaAesCtrUpperIv& upper_iv,
                                AlignmentStorageRequirement alignment_storage_requirement);
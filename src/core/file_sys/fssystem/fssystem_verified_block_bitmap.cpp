@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/div_ceil.h"
+#include "core/crypto/sha_util.h"
+#include "core/file_sys/fssystem/fssystem_verified_block_bitmap.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr u64 BitsPerWord = sizeof(u64) * 8;
+
+} // namespace
+
+void VerifiedBlockBitmap::Initialize(s64 block_count, s64 block_size) {
+    // Validate preconditions.
+    ASSERT(block_count >= 0);
+    ASSERT(block_size > 0);
+
+    // Allocate the bitmap, with every block unverified.
+    const s64 word_count = std::max<s64>(Common::DivCeil(block_count, BitsPerWord), 1);
+    m_bits = std::make_unique<std::atomic<u64>[]>(static_cast<size_t>(word_count));
+    m_block_count = block_count;
+    m_block_size = block_size;
+}
+
+void VerifiedBlockBitmap::Finalize() {
+    m_bits.reset();
+    m_block_count = 0;
+    m_block_size = 0;
+}
+
+bool VerifiedBlockBitmap::IsVerified(s64 first_block, s64 block_count) const {
+    ASSERT(first_block >= 0 && first_block + block_count <= m_block_count);
+
+    for (s64 block = first_block; block < first_block + block_count; ++block) {
+        if (!this->IsBlockVerified(block)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+s64 VerifiedBlockBitmap::Verify(s64 first_block, const u8* data, size_t size,
+                                const u8* hashes) {
+    // Validate preconditions.
+    ASSERT(data != nullptr);
+    ASSERT(hashes != nullptr);
+
+    const s64 block_count =
+        Common::DivCeil(static_cast<s64>(size), static_cast<u64>(m_block_size));
+    ASSERT(first_block >= 0 && first_block + block_count <= m_block_count);
+
+    std::vector<Core::Crypto::SHA256Hash> calculated;
+    s64 corrupted_count = 0;
+
+    // Hash each run of unverified blocks at once, so that large runs are hashed in parallel.
+    s64 block = 0;
+    while (block < block_count) {
+        if (this->IsBlockVerified(first_block + block)) {
+            ++block;
+            continue;
+        }
+
+        // Find the end of the run.
+        s64 run_end = block + 1;
+        while (run_end < block_count && !this->IsBlockVerified(first_block + run_end)) {
+            ++run_end;
+        }
+
+        // Hash the blocks of the run.
+        const size_t run_offset = static_cast<size_t>(block * m_block_size);
+        const size_t run_size =
+            std::min(static_cast<size_t>((run_end - block) * m_block_size), size - run_offset);
+        calculated.resize(static_cast<size_t>(run_end - block));
+        Core::Crypto::CalculateSHA256Blocks(data + run_offset, run_size,
+                                            static_cast<size_t>(m_block_size), calculated.data());
+
+        // Compare them with the expected hashes.
+        for (s64 i = block; i < run_end; ++i) {
+            const u8* expected = hashes + i * HashSize;
+            if (std::memcmp(calculated[i - block].data(), expected, HashSize) != 0) {
+                ++corrupted_count;
+            }
+            this->SetBlockVerified(first_block + i);
+        }
+
+        block = run_end;
+    }
+
+    return corrupted_count;
+}
+
+bool VerifiedBlockBitmap::IsBlockVerified(s64 block) const {
+    const u64 index = static_cast<u64>(block);
+    const u64 mask = u64{1} << (index % BitsPerWord);
+    return (m_bits[index / BitsPerWord].load(std::memory_order_acquire) & mask) != 0;
+}
+
+void VerifiedBlockBitmap::SetBlockVerified(s64 block) {
+    const u64 index = static_cast<u64>(block);
+    const u64 mask = u64{1} << (index % BitsPerWord);
+    m_bits[index / BitsPerWord].fetch_or(mask, std::memory_order_release);
+}
+
+} // namespace FileSys
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+
+namespace FileSys {
+
+/// Remembers the blocks of a storage that were hashed, so that each block is verified once.
+class VerifiedBlockBitmap {
+    SUDACHI_NON_COPYABLE(VerifiedBlockBitmap);
+    SUDACHI_NON_MOVEABLE(VerifiedBlockBitmap);
+
+public:
+    static constexpr size_t HashSize = 256 / 8;
+
+public:
+    VerifiedBlockBitmap() : m_block_count(0), m_block_size(0) {}
+
+    void Initialize(s64 block_count, s64 block_size);
+    void Finalize();
+
+    bool IsInitialized() const {
+        return m_bits != nullptr;
+    }
+
+    /// Returns whether all the blocks in the range were verified.
+    bool IsVerified(s64 first_block, s64 block_count) const;
+
+    /**
+     * Hashes the blocks of a buffer that were not verified yet and compares them with their
+     * expected hashes. Corrupted blocks are only reported once, like the valid ones.
+     *
+     * @param first_block Index of the first block of the buffer
+     * @param data        Blocks to verify, the last one may be shorter than the block size
+     * @param size        Size of the buffer
+     * @param hashes      Expected hashes of the blocks, one after another
+     * @returns The number of corrupted blocks.
+     */
+    s64 Verify(s64 first_block, const u8* data, size_t size, const u8* hashes);
+
+private:
+    bool IsBlockVerified(s64 block) const;
+    void SetBlockVerified(s64 block);
+
+private:
+    std::unique_ptr<std::atomic<u64>[]> m_bits;
+    s64 m_block_count;
+    s64 m_block_size;
+};
+
+} // namespace FileSys
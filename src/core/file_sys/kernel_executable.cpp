@@ -1,9 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2019 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <cstring>
+#include <thread>
 
 #include "common/string_util.h"
+#include "common/thread_worker.h"
 #include "core/file_sys/kernel_executable.h"
 #include "core/file_sys/vfs/vfs_offset.h"
 #include "core/loader/loader.h"
@@ -12,6 +15,9 @@ namespace FileSys {
 
 constexpr u32 INI_MAX_KIPS = 0x50;
 
+// Sections smaller than this in total are decompressed on the calling thread
+constexpr std::size_t BLZ_PARALLEL_THRESHOLD = 0x40000;
+
 namespace {
 bool DecompressBLZ(std::vector<u8>& data) {
     if (data.size() < 0xC)
@@ -98,22 +104,43 @@ KIP::KIP(const VirtualFile& file) : status(Loader::ResultStatus::Success) {
     }
 
     u64 offset = sizeof(KIPHeader);
+    std::vector<std::size_t> compressed_sections;
+    std::size_t compressed_total = 0;
     for (std::size_t i = 0; i < header.sections.size(); ++i) {
         auto compressed = file->ReadBytes(header.sections[i].compressed_size, offset);
         offset += header.sections[i].compressed_size;
 
         if (header.sections[i].compressed_size == 0 && header.sections[i].decompressed_size != 0) {
             decompressed_sections[i] = std::vector<u8>(header.sections[i].decompressed_size);
-        } else if (header.sections[i].compressed_size == header.sections[i].decompressed_size) {
-            decompressed_sections[i] = std::move(compressed);
         } else {
-            decompressed_sections[i] = compressed;
-            if (!DecompressBLZ(decompressed_sections[i])) {
-                status = Loader::ResultStatus::ErrorBLZDecompressionFailed;
-                return;
+            decompressed_sections[i] = std::move(compressed);
+            if (header.sections[i].compressed_size != header.sections[i].decompressed_size) {
+                compressed_sections.push_back(i);
+                compressed_total += header.sections[i].compressed_size;
             }
         }
     }
+
+    // The sections are independent, large ones are decompressed in parallel
+    std::vector<u8> decompressed(header.sections.size());
+    const auto decompress = [this, &decompressed](std::size_t i) {
+        decompressed[i] = DecompressBLZ(decompressed_sections[i]);
+    };
+    const std::size_t num_workers =
+        std::min<std::size_t>(std::thread::hardware_concurrency(), compressed_sections.size());
+    if (compressed_total < BLZ_PARALLEL_THRESHOLD || num_workers <= 1) {
+        std::ranges::for_each(compressed_sections, decompress);
+    } else {
+        Common::ThreadWorker workers(num_workers, "BLZDecompression");
+        for (const std::size_t i : compressed_sections) {
+            workers.QueueWork([&decompress, i] { decompress(i); });
+        }
+        workers.WaitForRequests();
+    }
+
+    if (!std::ranges::all_of(compressed_sections, [&](std::size_t i) { return decompressed[i]; })) {
+        status = Loader::ResultStatus::ErrorBLZDecompressionFailed;
+    }
 }
 
 Loader::ResultStatus KIP::GetStatus() const {
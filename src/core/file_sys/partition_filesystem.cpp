@@ -5,6 +5,8 @@
 #include <cstddef>
 #include <cstring>
 #include <iterator>
+#include <span>
+#include <string_view>
 #include <utility>
 
 #include "common/logging/log.h"
@@ -44,12 +46,15 @@ PartitionFilesystem::PartitionFilesystem(VirtualFile file) {
     std::size_t metadata_size =
         sizeof(Header) + (pfs_header.num_entries * entry_size) + pfs_header.strtab_size;
 
-    // Actually read in now...
-    std::vector<u8> file_data = file->ReadBytes(metadata_size);
-    const std::size_t total_size = file_data.size();
-    file_data.push_back(0);
+    // Actually read in now, using the metadata in place when the file is memory mapped...
+    std::vector<u8> buffer;
+    std::span<const u8> file_data = file->GetSpan(metadata_size);
+    if (file_data.size() != metadata_size) {
+        buffer = file->ReadBytes(metadata_size);
+        file_data = buffer;
+    }
 
-    if (total_size != metadata_size) {
+    if (file_data.size() != metadata_size) {
         status = Loader::ResultStatus::ErrorIncorrectPFSFileSize;
         return;
     }
@@ -57,12 +62,15 @@ PartitionFilesystem::PartitionFilesystem(VirtualFile file) {
     std::size_t entries_offset = sizeof(Header);
     std::size_t strtab_offset = entries_offset + (pfs_header.num_entries * entry_size);
     content_offset = strtab_offset + pfs_header.strtab_size;
+    const std::string_view metadata{reinterpret_cast<const char*>(file_data.data()),
+                                    file_data.size()};
     for (u16 i = 0; i < pfs_header.num_entries; i++) {
         FSEntry entry;
 
         memcpy(&entry, &file_data[entries_offset + (i * entry_size)], sizeof(FSEntry));
-        std::string name(
-            reinterpret_cast<const char*>(&file_data[strtab_offset + entry.strtab_offset]));
+        std::string_view name_view =
+            metadata.substr(std::min(strtab_offset + entry.strtab_offset, metadata.size()));
+        std::string name{name_view.substr(0, name_view.find('\0'))};
 
         offsets.insert_or_assign(name, content_offset + entry.offset);
         sizes.insert_or_assign(name, entry.size);
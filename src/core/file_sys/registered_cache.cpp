@@ -4,12 +4,14 @@
 #include <algorithm>
 #include <random>
 #include <regex>
+#include <thread>
 #include <mbedtls/sha256.h>
 #include "common/assert.h"
 #include "common/fs/path_util.h"
 #include "common/hex_util.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
+#include "common/thread_worker.h"
 #include "core/crypto/key_manager.h"
 #include "core/file_sys/card_image.h"
 #include "core/file_sys/common_funcs.h"
@@ -17,7 +19,9 @@
 #include "core/file_sys/nca_metadata.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/submission_package.h"
+#include "core/file_sys/title_metadata_index.h"
 #include "core/file_sys/vfs/vfs_concat.h"
+#include "core/file_sys/vfs/vfs_vector.h"
 #include "core/loader/loader.h"
 
 namespace FileSys {
@@ -25,6 +29,9 @@ namespace FileSys {
 // The size of blocks to use when vfs raw copying into nand.
 constexpr size_t VFS_RC_LARGE_COPY_BLOCK = 0x400000;
 
+// The minimum number of new NCAs to parse them across threads on refresh.
+constexpr size_t PARALLEL_PROCESS_MIN_FILES = 8;
+
 std::string ContentProviderEntry::DebugInfo() const {
     return fmt::format("title_id={:016X}, content_type={:02X}", title_id, static_cast<u8>(type));
 }
@@ -412,29 +419,95 @@ std::vector<NcaID> RegisteredCache::AccumulateFiles() const {
     return ids;
 }
 
-void RegisteredCache::ProcessFiles(const std::vector<NcaID>& ids) {
-    for (const auto& id : ids) {
-        const auto file = GetFileAtID(id);
-
-        if (file == nullptr)
-            continue;
-        const auto nca = std::make_shared<NCA>(parser(file, id));
-        if (nca->GetStatus() != Loader::ResultStatus::Success ||
-            nca->GetType() != NCAContentType::Meta || nca->GetSubdirectories().empty()) {
-            continue;
-        }
-
-        const auto section0 = nca->GetSubdirectories()[0];
+// Reads the CNMT of a meta NCA, or returns an entry without titles for other NCAs. Returns
+// std::nullopt if the NCA could not be parsed, so that it is tried again on the next refresh.
+static std::optional<TitleMetadataIndexEntry> ReadMetaFile(const VirtualFile& parsed_file) {
+    const NCA nca{parsed_file};
+    if (nca.GetStatus() != Loader::ResultStatus::Success) {
+        return std::nullopt;
+    }
 
-        for (const auto& section0_file : section0->GetFiles()) {
+    TitleMetadataIndexEntry entry{};
+    entry.file_type = static_cast<u32>(Loader::FileType::NCA);
+    if (nca.GetType() == NCAContentType::Meta && !nca.GetSubdirectories().empty()) {
+        for (const auto& section0_file : nca.GetSubdirectories()[0]->GetFiles()) {
             if (section0_file->GetExtension() != "cnmt")
                 continue;
 
-            meta.insert_or_assign(nca->GetTitleId(), CNMT(section0_file));
-            meta_id.insert_or_assign(nca->GetTitleId(), id);
+            auto& title = entry.titles.emplace_back();
+            title.title_id = nca.GetTitleId();
+            title.cnmt = section0_file->ReadAllBytes();
             break;
         }
     }
+    return entry;
+}
+
+void RegisteredCache::ProcessFiles(const std::vector<NcaID>& ids) {
+    // Forget the NCAs that were removed since the last refresh.
+    std::erase_if(processed_ids, [this, &ids](const auto& processed) {
+        const auto& [id, title_id] = processed;
+        if (std::find(ids.begin(), ids.end(), id) != ids.end()) {
+            return false;
+        }
+        if (title_id && meta_id.contains(*title_id) && meta_id.at(*title_id) == id) {
+            meta.erase(*title_id);
+            meta_id.erase(*title_id);
+        }
+        return true;
+    });
+
+    // Only parse the NCAs that were not processed yet.
+    std::vector<NcaID> new_ids;
+    std::copy_if(ids.begin(), ids.end(), std::back_inserter(new_ids),
+                 [this](const NcaID& id) { return !processed_ids.contains(id); });
+
+    std::vector<std::optional<TitleMetadataIndexEntry>> entries(new_ids.size());
+    auto& index = TitleMetadataIndex::Instance();
+    const auto process = [this, &new_ids, &entries, &index](size_t i) {
+        const auto file = GetFileAtID(new_ids[i]);
+        if (file == nullptr) {
+            return;
+        }
+        const auto path = file->GetFullPath();
+        entries[i] = index.Find(path);
+        if (!entries[i]) {
+            entries[i] = ReadMetaFile(parser(file, new_ids[i]));
+            if (entries[i]) {
+                index.Insert(path, *entries[i]);
+            }
+        }
+    };
+    if (new_ids.size() < PARALLEL_PROCESS_MIN_FILES) {
+        for (size_t i = 0; i < new_ids.size(); ++i) {
+            process(i);
+        }
+    } else {
+        Common::ThreadWorker workers(std::max(std::thread::hardware_concurrency(), 1U),
+                                     "RegisteredCache");
+        for (size_t i = 0; i < new_ids.size(); ++i) {
+            workers.QueueWork([&process, i] { process(i); });
+        }
+        workers.WaitForRequests();
+    }
+
+    for (size_t i = 0; i < new_ids.size(); ++i) {
+        if (!entries[i]) {
+            continue;
+        }
+
+        std::optional<u64> title_id;
+        if (!entries[i]->titles.empty()) {
+            const auto& title = entries[i]->titles.front();
+            title_id = title.title_id;
+            meta.insert_or_assign(title.title_id,
+                                  CNMT(std::make_shared<VectorVfsFile>(title.cnmt)));
+            meta_id.insert_or_assign(title.title_id, new_ids[i]);
+        }
+        processed_ids.insert_or_assign(new_ids[i], title_id);
+    }
+
+    index.Save();
 }
 
 void RegisteredCache::AccumulateSudachiMeta() {
@@ -201,6 +201,8 @@ private:
     std::map<u64, CNMT> meta;
     // maps tid -> meta for CNMT in sudachi_meta
     std::map<u64, CNMT> sudachi_meta;
+    // maps NcaID -> tid of meta, for every NCA processed since construction
+    std::map<NcaID, std::optional<u64>> processed_ids;
 };
 
 enum class ContentProviderUnionSlot {
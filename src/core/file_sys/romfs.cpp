@@ -1,17 +1,35 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+
+#include <fmt/format.h>
 
 #include "common/assert.h"
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
 #include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/fsmitm_romfsbuild.h"
+#include "core/file_sys/ips_layer.h"
 #include "core/file_sys/romfs.h"
 #include "core/file_sys/vfs/vfs.h"
 #include "core/file_sys/vfs/vfs_cached.h"
 #include "core/file_sys/vfs/vfs_concat.h"
+#include "core/file_sys/vfs/vfs_layered.h"
+#include "core/file_sys/vfs/vfs_lazy.h"
 #include "core/file_sys/vfs/vfs_offset.h"
 #include "core/file_sys/vfs/vfs_vector.h"
 
@@ -123,6 +141,235 @@ void ProcessDirectory(const RomFSTraversalContext& ctx, u32 this_dir_offset,
         this_dir_offset = entry.first.sibling;
     }
 }
+
+constexpr u32 LAYOUT_MAGIC = Common::MakeMagic('S', 'L', 'F', 'S');
+constexpr u32 LAYOUT_VERSION = 1;
+
+struct LayoutHeader {
+    u32 magic;
+    u32 version;
+    u64 header_size;
+    u64 metadata_offset;
+    u64 metadata_size;
+    u64 file_count;
+};
+static_assert(sizeof(LayoutHeader) == 0x28, "LayoutHeader has incorrect size.");
+
+struct LayoutFileEntry {
+    u64 offset;
+    u64 size;
+    u64 path_size;
+};
+static_assert(sizeof(LayoutFileEntry) == 0x18, "LayoutFileEntry has incorrect size.");
+
+// The directories a layered RomFS is built from. The base RomFS is only extracted once a
+// directory is requested.
+class LayeredRomFSSources {
+public:
+    LayeredRomFSSources(VirtualFile base_, std::vector<VirtualDir> layers_,
+                        std::vector<VirtualDir> ext_layers_)
+        : base{std::move(base_)}, layers{std::move(layers_)}, ext_layers{std::move(ext_layers_)} {}
+
+    // Returns nullptr if the base RomFS could not be extracted.
+    const VirtualDir& GetDirectory() {
+        Open();
+        return dir;
+    }
+
+    const VirtualDir& GetExtDirectory() {
+        Open();
+        return ext_dir;
+    }
+
+    // Opens the file at path of the layered RomFS, with its IPS patch applied.
+    VirtualFile OpenFile(const std::string& path) {
+        Open();
+        if (dir == nullptr) {
+            return nullptr;
+        }
+        auto file = dir->GetFileRelative(path);
+        if (file == nullptr || ext_dir == nullptr) {
+            return file;
+        }
+        if (const auto ips = ext_dir->GetFileRelative(path + ".ips")) {
+            if (auto patched = PatchIPS(file, ips)) {
+                return patched;
+            }
+        }
+        return file;
+    }
+
+    // Hashes everything the layout of the layered RomFS depends on: the tables of the base RomFS
+    // and the names and sizes of the files in the layers. The contents of the files don't change
+    // the layout, as they are only read once the RomFS is read.
+    std::optional<u64> HashLayout() const {
+        RomFSHeader header{};
+        if (base == nullptr || base->ReadObject(&header) != sizeof(RomFSHeader) ||
+            header.header_size != sizeof(RomFSHeader)) {
+            return std::nullopt;
+        }
+
+        std::string state(reinterpret_cast<const char*>(&header), sizeof(RomFSHeader));
+        for (const auto& table : {header.directory_meta, header.file_meta}) {
+            const auto data = base->ReadBytes(table.size, table.offset);
+            state.append(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+        for (const auto& layer_list : {std::cref(layers), std::cref(ext_layers)}) {
+            state.push_back('\0');
+            for (const auto& layer : layer_list.get()) {
+                AppendDirectoryState(state, layer, {});
+                state.push_back('\0');
+            }
+        }
+        return Common::CityHash64(state.data(), state.size());
+    }
+
+private:
+    static void AppendDirectoryState(std::string& state, const VirtualDir& directory,
+                                     const std::string& path) {
+        for (const auto& file : directory->GetFiles()) {
+            const u64 size = file->GetSize();
+            state.append(path).append("/").append(file->GetName()).push_back('\0');
+            state.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        }
+        for (const auto& subdirectory : directory->GetSubdirectories()) {
+            const auto subdirectory_path = path + "/" + subdirectory->GetName();
+            state.append(subdirectory_path).push_back('\0');
+            AppendDirectoryState(state, subdirectory, subdirectory_path);
+        }
+    }
+
+    void Open() {
+        std::call_once(open_flag, [this] {
+            auto extracted = ExtractRomFS(base);
+            if (extracted == nullptr) {
+                return;
+            }
+            layers.push_back(std::move(extracted));
+            dir = LayeredVfsDirectory::MakeLayeredDirectory(std::move(layers));
+            ext_dir = LayeredVfsDirectory::MakeLayeredDirectory(std::move(ext_layers));
+        });
+    }
+
+    VirtualFile base;
+    std::vector<VirtualDir> layers;
+    std::vector<VirtualDir> ext_layers;
+    std::once_flag open_flag;
+    VirtualDir dir;
+    VirtualDir ext_dir;
+};
+
+std::filesystem::path GetLayoutPath(u64 key) {
+    return Common::FS::GetSudachiPath(Common::FS::SudachiPath::CacheDir) / "layeredfs" /
+           fmt::format("{:016X}.bin", key);
+}
+
+std::optional<RomFSBuildLayout> LoadLayout(u64 key) {
+    Common::FS::IOFile file{GetLayoutPath(key), Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return std::nullopt;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadSpan(std::span<u8>{data}) != data.size()) {
+        return std::nullopt;
+    }
+
+    size_t offset = 0;
+    const auto read = [&data, &offset](void* out, u64 size) {
+        if (size > data.size() - offset) {
+            return false;
+        }
+        std::memcpy(out, data.data() + offset, size);
+        offset += size;
+        return true;
+    };
+
+    LayoutHeader header{};
+    if (!read(&header, sizeof(header)) || header.magic != LAYOUT_MAGIC ||
+        header.version != LAYOUT_VERSION || header.header_size != sizeof(RomFSHeader) ||
+        header.metadata_size > data.size()) {
+        return std::nullopt;
+    }
+
+    RomFSBuildLayout layout{};
+    layout.metadata_offset = header.metadata_offset;
+    layout.header.resize(header.header_size);
+    layout.metadata.resize(header.metadata_size);
+    if (!read(layout.header.data(), layout.header.size()) ||
+        !read(layout.metadata.data(), layout.metadata.size())) {
+        return std::nullopt;
+    }
+    for (u64 i = 0; i < header.file_count; ++i) {
+        LayoutFileEntry entry{};
+        if (!read(&entry, sizeof(entry)) || entry.path_size > data.size() - offset) {
+            LOG_WARNING(Loader, "LayeredFS layout cache {:016X} is corrupted", key);
+            return std::nullopt;
+        }
+        auto& layout_file = layout.files.emplace_back();
+        layout_file.offset = entry.offset;
+        layout_file.size = entry.size;
+        layout_file.path.resize(entry.path_size);
+        read(layout_file.path.data(), entry.path_size);
+    }
+    return layout;
+}
+
+void SaveLayout(u64 key, const RomFSBuildLayout& layout) {
+    std::vector<u8> out;
+    const auto write = [&out](const void* data, u64 size) {
+        const auto* const bytes = static_cast<const u8*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    };
+
+    const LayoutHeader header{
+        .magic = LAYOUT_MAGIC,
+        .version = LAYOUT_VERSION,
+        .header_size = layout.header.size(),
+        .metadata_offset = layout.metadata_offset,
+        .metadata_size = layout.metadata.size(),
+        .file_count = layout.files.size(),
+    };
+    write(&header, sizeof(header));
+    write(layout.header.data(), layout.header.size());
+    write(layout.metadata.data(), layout.metadata.size());
+    for (const auto& file : layout.files) {
+        const LayoutFileEntry entry{file.offset, file.size, file.path.size()};
+        write(&entry, sizeof(entry));
+        write(file.path.data(), file.path.size());
+    }
+
+    const auto path = GetLayoutPath(key);
+    void(Common::FS::CreateParentDirs(path));
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    if (file.WriteSpan(std::span<const u8>{out}) != out.size()) {
+        LOG_ERROR(Loader, "Failed to write LayeredFS layout cache {:016X}", key);
+    }
+}
+
+// Rebuilds a layered RomFS from its cached layout. The files are opened once they are read.
+VirtualFile MakeLazyRomFS(RomFSBuildLayout&& layout,
+                          const std::shared_ptr<LayeredRomFSSources>& sources, std::string name) {
+    std::vector<std::pair<u64, VirtualFile>> out;
+    out.reserve(layout.files.size() + 2);
+    out.emplace_back(0, std::make_shared<VectorVfsFile>(std::move(layout.header)));
+    for (auto& file : layout.files) {
+        auto file_name = file.path.substr(file.path.find_last_of('/') + 1);
+        out.emplace_back(file.offset,
+                         std::make_shared<LazyVfsFile>(
+                             [sources, path = std::move(file.path)] {
+                                 return sources->OpenFile(path);
+                             },
+                             file.size, std::move(file_name)));
+    }
+    out.emplace_back(layout.metadata_offset,
+                     std::make_shared<VectorVfsFile>(std::move(layout.metadata)));
+
+    std::sort(out.begin(), out.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return ConcatenatedVfsFile::MakeConcatenatedFile(0, std::move(name), std::move(out));
+}
 } // Anonymous namespace
 
 VirtualDir ExtractRomFS(VirtualFile file) {
@@ -164,4 +411,38 @@ VirtualFile CreateRomFS(VirtualDir dir, VirtualDir ext) {
     return ConcatenatedVfsFile::MakeConcatenatedFile(0, dir->GetName(), ctx.Build());
 }
 
+VirtualFile CreateLayeredRomFS(VirtualFile base, std::vector<VirtualDir> layers,
+                               std::vector<VirtualDir> ext_layers) {
+    auto name = layers.empty() ? std::string{} : layers.front()->GetName();
+    const auto sources = std::make_shared<LayeredRomFSSources>(
+        std::move(base), std::move(layers), std::move(ext_layers));
+
+    std::optional<u64> key;
+    if (Settings::values.lazy_layeredfs.GetValue()) {
+        key = sources->HashLayout();
+        if (key) {
+            if (auto layout = LoadLayout(*key)) {
+                LOG_DEBUG(Loader, "Using cached LayeredFS layout {:016X}", *key);
+                return MakeLazyRomFS(std::move(*layout), sources, std::move(name));
+            }
+        }
+    }
+
+    const auto& dir = sources->GetDirectory();
+    if (dir == nullptr) {
+        return nullptr;
+    }
+    if (name.empty()) {
+        name = dir->GetName();
+    }
+
+    RomFSBuildContext ctx{dir, sources->GetExtDirectory()};
+    RomFSBuildLayout layout{};
+    auto out = ctx.Build(key ? &layout : nullptr);
+    if (key) {
+        SaveLayout(*key, layout);
+    }
+    return ConcatenatedVfsFile::MakeConcatenatedFile(0, std::move(name), std::move(out));
+}
+
 } // namespace FileSys
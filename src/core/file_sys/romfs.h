@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <vector>
 #include "core/file_sys/vfs/vfs.h"
 
 namespace FileSys {
@@ -15,4 +16,12 @@ VirtualDir ExtractRomFS(VirtualFile file);
 // Returns nullptr on failure
 VirtualFile CreateRomFS(VirtualDir dir, VirtualDir ext = nullptr);
 
+// Converts a RomFS binary blob overlaid with layers of directories into a RomFS binary. Earlier
+// layers take precedence, ext_layers hold the stub and IPS files applied to the result.
+// With lazy LayeredFS, the layout of the result is cached and the base is only extracted once the
+// result is first read.
+// Returns nullptr on failure
+VirtualFile CreateLayeredRomFS(VirtualFile base, std::vector<VirtualDir> layers,
+                               std::vector<VirtualDir> ext_layers);
+
 } // namespace FileSys
@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <span>
+#include <system_error>
+#include "common/common_funcs.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/fs_util.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "core/file_sys/title_metadata_index.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr u32 INDEX_MAGIC = Common::MakeMagic('S', 'T', 'M', 'I');
+constexpr u32 INDEX_VERSION = 1;
+
+struct IndexHeader {
+    u32 magic;
+    u32 version;
+    u64 entry_count;
+};
+static_assert(sizeof(IndexHeader) == 0x10, "IndexHeader has incorrect size.");
+
+// Bounds checked reader over the index file, reads fail once past its end.
+class IndexReader {
+public:
+    explicit IndexReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    bool Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (sizeof(T) > data.size() - offset) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <typename Container>
+    bool ReadSized(Container& out) {
+        u32 size{};
+        if (!Read(size) || size > data.size() - offset) {
+            return false;
+        }
+        const auto* const begin = reinterpret_cast<const typename Container::value_type*>(
+            data.data() + offset);
+        out.assign(begin, begin + size);
+        offset += size;
+        return true;
+    }
+
+private:
+    std::span<const u8> data;
+    size_t offset{};
+};
+
+template <typename T>
+void Write(std::vector<u8>& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* const bytes = reinterpret_cast<const u8*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename Container>
+void WriteSized(std::vector<u8>& out, const Container& data) {
+    Write(out, static_cast<u32>(data.size()));
+    const auto* const bytes = reinterpret_cast<const u8*>(data.data());
+    out.insert(out.end(), bytes, bytes + data.size());
+}
+
+} // Anonymous namespace
+
+TitleMetadataIndex::TitleMetadataIndex(std::filesystem::path path_) : path{std::move(path_)} {
+    Load();
+}
+
+TitleMetadataIndex::~TitleMetadataIndex() = default;
+
+TitleMetadataIndex& TitleMetadataIndex::Instance() {
+    static TitleMetadataIndex instance{
+        Common::FS::GetSudachiPath(Common::FS::SudachiPath::CacheDir) / "title_metadata.bin"};
+    return instance;
+}
+
+std::optional<TitleMetadataIndexEntry> TitleMetadataIndex::Find(
+    const std::string& file_path) const {
+    const auto stamp = GetFileStamp(file_path);
+    if (!stamp) {
+        return std::nullopt;
+    }
+
+    std::scoped_lock lk{mutex};
+    const auto iter = entries.find(file_path);
+    if (iter == entries.end() || iter->second.stamp != *stamp) {
+        return std::nullopt;
+    }
+    return iter->second.metadata;
+}
+
+void TitleMetadataIndex::Insert(const std::string& file_path, TitleMetadataIndexEntry entry) {
+    const auto stamp = GetFileStamp(file_path);
+    if (!stamp) {
+        return;
+    }
+
+    std::scoped_lock lk{mutex};
+    entries.insert_or_assign(file_path, Entry{*stamp, std::move(entry)});
+    dirty = true;
+}
+
+void TitleMetadataIndex::Save() {
+    std::scoped_lock lk{mutex};
+    if (!dirty) {
+        return;
+    }
+
+    std::erase_if(entries, [](const auto& entry) { return !GetFileStamp(entry.first); });
+
+    std::vector<u8> out;
+    Write(out, IndexHeader{INDEX_MAGIC, INDEX_VERSION, entries.size()});
+    for (const auto& [file_path, entry] : entries) {
+        WriteSized(out, file_path);
+        Write(out, entry.stamp.size);
+        Write(out, entry.stamp.last_write_time);
+        Write(out, entry.metadata.file_type);
+        Write(out, static_cast<u32>(entry.metadata.titles.size()));
+        for (const auto& title : entry.metadata.titles) {
+            Write(out, title.title_id);
+            WriteSized(out, title.name);
+            WriteSized(out, title.cnmt);
+            WriteSized(out, title.nacp);
+            WriteSized(out, title.icon);
+        }
+    }
+
+    void(Common::FS::CreateParentDirs(path));
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    if (file.WriteSpan(std::span<const u8>{out}) != out.size()) {
+        LOG_ERROR(Common_Filesystem, "Failed to write the title metadata index to {}",
+                  Common::FS::PathToUTF8String(path));
+        return;
+    }
+    dirty = false;
+}
+
+std::optional<TitleMetadataIndex::FileStamp> TitleMetadataIndex::GetFileStamp(
+    const std::string& file_path) {
+    const std::filesystem::path host_path{Common::FS::ToU8String(file_path)};
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(host_path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const auto last_write_time = std::filesystem::last_write_time(host_path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return FileStamp{
+        .size = static_cast<u64>(size),
+        .last_write_time = static_cast<s64>(last_write_time.time_since_epoch().count()),
+    };
+}
+
+void TitleMetadataIndex::Load() {
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadSpan(std::span<u8>{data}) != data.size()) {
+        return;
+    }
+
+    IndexReader reader{data};
+    IndexHeader header{};
+    if (!reader.Read(header) || header.magic != INDEX_MAGIC || header.version != INDEX_VERSION) {
+        LOG_INFO(Common_Filesystem, "Ignoring outdated title metadata index");
+        return;
+    }
+
+    for (u64 i = 0; i < header.entry_count; ++i) {
+        std::string file_path;
+        Entry entry{};
+        u32 title_count{};
+        bool ok = reader.ReadSized(file_path) && reader.Read(entry.stamp.size) &&
+                  reader.Read(entry.stamp.last_write_time) &&
+                  reader.Read(entry.metadata.file_type) && reader.Read(title_count);
+        for (u32 j = 0; ok && j < title_count; ++j) {
+            auto& title = entry.metadata.titles.emplace_back();
+            ok = reader.Read(title.title_id) && reader.ReadSized(title.name) &&
+                 reader.ReadSized(title.cnmt) && reader.ReadSized(title.nacp) &&
+                 reader.ReadSized(title.icon);
+        }
+        if (!ok) {
+            LOG_WARNING(Common_Filesystem, "Title metadata index is corrupted, ignoring it");
+            entries.clear();
+            return;
+        }
+        entries.insert_or_assign(std::move(file_path), std::move(entry));
+    }
+}
+
+} // namespace FileSys
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+namespace FileSys {
+
+// Metadata parsed out of a content file, so it does not have to be parsed again.
+struct TitleMetadata {
+    u64 title_id{};
+    std::string name;     ///< Application name, for titles with control data
+    std::vector<u8> cnmt; ///< Raw CNMT, for meta NCAs
+    std::vector<u8> nacp; ///< Raw NACP, for titles with control data
+    std::vector<u8> icon; ///< Icon image, for titles with control data
+};
+
+struct TitleMetadataIndexEntry {
+    u32 file_type{};
+    std::vector<TitleMetadata> titles;
+};
+
+// An on-disk index of the metadata of content files, keyed by their path, size and last write
+// time. Entries of files that changed since they were indexed are ignored and replaced.
+class TitleMetadataIndex {
+public:
+    explicit TitleMetadataIndex(std::filesystem::path path_);
+    ~TitleMetadataIndex();
+
+    TitleMetadataIndex(const TitleMetadataIndex&) = delete;
+    TitleMetadataIndex& operator=(const TitleMetadataIndex&) = delete;
+
+    // The index stored in the cache directory, used by the registered content caches.
+    static TitleMetadataIndex& Instance();
+
+    // Returns the indexed metadata of a file, if the file did not change since it was indexed.
+    [[nodiscard]] std::optional<TitleMetadataIndexEntry> Find(const std::string& file_path) const;
+
+    // Indexes the metadata of a file. Files that don't exist on the host are not indexed.
+    void Insert(const std::string& file_path, TitleMetadataIndexEntry entry);
+
+    // Writes the index back to disk if it changed, dropping the entries of deleted files.
+    void Save();
+
+private:
+    struct FileStamp {
+        u64 size;
+        s64 last_write_time;
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    struct Entry {
+        FileStamp stamp;
+        TitleMetadataIndexEntry metadata;
+    };
+
+    static std::optional<FileStamp> GetFileStamp(const std::string& file_path);
+
+    void Load();
+
+    std::filesystem::path path;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    bool dirty = false;
+};
+
+} // namespace FileSys
@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -117,6 +118,9 @@ public:
     // Reads all the bytes from the file into a vector. Equivalent to 'file->Read(file->GetSize(),
     // 0)'
     virtual std::vector<u8> ReadAllBytes() const;
+    // Returns a view of up to size bytes starting at offset in file without copying them, or an
+    // empty span if the file is not backed by memory. The view is valid while the file exists.
+    virtual std::span<const u8> GetSpan(std::size_t size, std::size_t offset = 0) const;
 
     // Reads an array of type T, size number_elements starting at offset.
     // Returns the number of bytes (sizeof(T)*number_elements) read successfully.
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <utility>
+
+#include "core/file_sys/vfs/vfs_lazy.h"
+
+namespace FileSys {
+
+LazyVfsFile::LazyVfsFile(Opener opener_, std::size_t size_, std::string name_)
+    : opener{std::move(opener_)}, size{size_}, name{std::move(name_)} {}
+
+LazyVfsFile::~LazyVfsFile() = default;
+
+std::string LazyVfsFile::GetName() const {
+    return name;
+}
+
+std::size_t LazyVfsFile::GetSize() const {
+    return size;
+}
+
+bool LazyVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+VirtualDir LazyVfsFile::GetContainingDirectory() const {
+    return nullptr;
+}
+
+bool LazyVfsFile::IsWritable() const {
+    return false;
+}
+
+bool LazyVfsFile::IsReadable() const {
+    return true;
+}
+
+std::size_t LazyVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (offset >= size) {
+        return 0;
+    }
+    const auto& source = GetFile();
+    if (source == nullptr) {
+        return 0;
+    }
+    return source->Read(data, std::min(length, size - offset), offset);
+}
+
+std::size_t LazyVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+std::span<const u8> LazyVfsFile::GetSpan(std::size_t length, std::size_t offset) const {
+    if (offset >= size) {
+        return {};
+    }
+    const auto& source = GetFile();
+    if (source == nullptr) {
+        return {};
+    }
+    return source->GetSpan(std::min(length, size - offset), offset);
+}
+
+bool LazyVfsFile::Rename(std::string_view new_name) {
+    name = new_name;
+    return true;
+}
+
+const VirtualFile& LazyVfsFile::GetFile() const {
+    std::call_once(open_flag, [this] {
+        file = opener();
+        // Release whatever the opener holds on to.
+        opener = nullptr;
+    });
+    return file;
+}
+
+} // namespace FileSys
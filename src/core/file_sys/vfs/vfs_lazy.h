@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "core/file_sys/vfs/vfs.h"
+
+namespace FileSys {
+
+// A read-only VfsFile of a known size whose contents are only opened when they are first read.
+// Reads are limited to the known size, a file that fails to open reads as empty.
+class LazyVfsFile : public VfsFile {
+public:
+    using Opener = std::function<VirtualFile()>;
+
+    LazyVfsFile(Opener opener, std::size_t size, std::string name);
+    ~LazyVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    VirtualDir GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    std::span<const u8> GetSpan(std::size_t length, std::size_t offset) const override;
+    bool Rename(std::string_view new_name) override;
+
+private:
+    const VirtualFile& GetFile() const;
+
+    mutable Opener opener;
+    mutable std::once_flag open_flag;
+    mutable VirtualFile file;
+    std::size_t size;
+    std::string name;
+};
+
+} // namespace FileSys
@@ -2,12 +2,15 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <utility>
 #include "common/assert.h"
 #include "common/fs/file.h"
 #include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
 #include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "core/file_sys/vfs/vfs.h"
@@ -46,6 +49,26 @@ constexpr FS::FileAccessMode ModeFlagsToFileAccessMode(OpenMode mode) {
     }
 }
 
+// Directories where the emulator writes files while they may be open for reading elsewhere.
+constexpr std::array WritableDirectories{
+    FS::SudachiPath::SudachiDir,
+    FS::SudachiPath::NANDDir,
+    FS::SudachiPath::SDMCDir,
+    FS::SudachiPath::DumpDir,
+};
+
+// Mapped files that are truncated fault on access past their new end, so only files the
+// emulator never writes, such as game dumps, are mapped. Others are read through buffered I/O.
+bool CanMapFile(std::string_view path) {
+    return std::ranges::none_of(WritableDirectories, [path](FS::SudachiPath directory) {
+        const auto directory_path = FS::SanitizePath(FS::GetSudachiPathString(directory),
+                                                     FS::DirectorySeparator::PlatformDefault);
+        return !directory_path.empty() && path.size() > directory_path.size() &&
+               path.starts_with(directory_path) &&
+               (path[directory_path.size()] == '/' || path[directory_path.size()] == '\\');
+    });
+}
+
 } // Anonymous namespace
 
 RealVfsFilesystem::RealVfsFilesystem() : VfsFilesystem(nullptr) {}
@@ -315,6 +338,16 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (const auto* const mapped = GetMapping(); mapped != nullptr) {
+        const auto span = mapped->GetSpan();
+        if (offset >= span.size()) {
+            return 0;
+        }
+        const std::size_t read_size = std::min(length, span.size() - offset);
+        std::memcpy(data, span.data() + offset, read_size);
+        return read_size;
+    }
+
     auto lk = base.RefreshReference(path, perms, *reference);
     if (!reference->file || !reference->file->Seek(static_cast<s64>(offset))) {
         return 0;
@@ -331,6 +364,28 @@ std::size_t RealVfsFile::Write(const u8* data, std::size_t length, std::size_t o
     return reference->file->WriteSpan(std::span{data, length});
 }
 
+std::span<const u8> RealVfsFile::GetSpan(std::size_t length, std::size_t offset) const {
+    const auto* const mapped = GetMapping();
+    if (mapped == nullptr || offset > mapped->GetSpan().size()) {
+        return {};
+    }
+    const auto span = mapped->GetSpan().subspan(offset);
+    return span.first(std::min(length, span.size()));
+}
+
+const FS::MappedFile* RealVfsFile::GetMapping() const {
+    std::call_once(mapping_flag, [this] {
+        if (perms != OpenMode::Read || GetSize() < MinMappedFileSize || !CanMapFile(path)) {
+            return;
+        }
+        auto file = std::make_unique<FS::MappedFile>(path);
+        if (file->IsOpen()) {
+            mapping = std::move(file);
+        }
+    });
+    return mapping.get();
+}
+
 bool RealVfsFile::Rename(std::string_view name) {
     return base.MoveFile(path, parent_path + '/' + std::string(name)) != nullptr;
 }
@@ -13,6 +13,7 @@
 
 namespace Common::FS {
 class IOFile;
+class MappedFile;
 }
 
 namespace FileSys {
@@ -87,9 +88,16 @@ public:
     bool IsReadable() const override;
     std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
     std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    std::span<const u8> GetSpan(std::size_t length, std::size_t offset) const override;
     bool Rename(std::string_view name) override;
 
 private:
+    // Files opened for reading at least this large are memory mapped, unless they are in a
+    // directory the emulator writes to.
+    static constexpr u64 MinMappedFileSize = 1ULL << 20;
+
+    const Common::FS::MappedFile* GetMapping() const;
+
     RealVfsFile(RealVfsFilesystem& base, std::unique_ptr<FileReference> reference,
                 const std::string& path, OpenMode perms = OpenMode::Read,
                 std::optional<u64> size = {}, std::optional<std::string> parent_path = {});
@@ -101,6 +109,10 @@ private:
     std::vector<std::string> path_components;
     std::optional<u64> size;
     OpenMode perms;
+
+    // Mapped on first access, as opening a directory creates files for all of its entries.
+    mutable std::once_flag mapping_flag;
+    mutable std::unique_ptr<Common::FS::MappedFile> mapping;
 };
 
 // An implementation of VfsDirectory that represents a directory on the user's computer.
@@ -1,8 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
+#include <span>
+#include <thread>
 #include <vector>
 
 #include "common/common_funcs.h"
@@ -11,6 +14,7 @@
 #include "common/lz4_compression.h"
 #include "common/settings.h"
 #include "common/swap.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/hle/kernel/code_set.h"
@@ -37,19 +41,111 @@ struct MODHeader {
 };
 static_assert(sizeof(MODHeader) == 0x1c, "MODHeader has incorrect size.");
 
-std::vector<u8> DecompressSegment(const std::vector<u8>& compressed_data,
-                                  const NSOSegmentHeader& header) {
-    std::vector<u8> uncompressed_data =
-        Common::Compression::DecompressDataLZ4(compressed_data, header.size);
+// Modules smaller than this in total are decompressed on the calling thread
+constexpr std::size_t ParallelThreshold = 0x40000;
 
-    ASSERT_MSG(uncompressed_data.size() == header.size, "{} != {}", header.size,
-               uncompressed_data.size());
+constexpr u32 PageAlignSize(u32 size) {
+    return static_cast<u32>((size + Core::Memory::SUDACHI_PAGEMASK) & ~Core::Memory::SUDACHI_PAGEMASK);
+}
 
-    return uncompressed_data;
+// A segment read from an NSO file, waiting to be decompressed into the image of its module
+struct PendingSegment {
+    NSOImage* nso;
+    std::size_t index;
+    std::vector<u8> buffer;
+    std::span<const u8> data;
+    int decompressed_size;
+};
+
+u32 SegmentEnd(const NSOHeader& header, std::size_t index, std::span<const u8> data) {
+    const auto& segment = header.segments[index];
+    return segment.location +
+           (header.IsSegmentCompressed(index) ? segment.size : static_cast<u32>(data.size()));
 }
 
-constexpr u32 PageAlignSize(u32 size) {
-    return static_cast<u32>((size + Core::Memory::SUDACHI_PAGEMASK) & ~Core::Memory::SUDACHI_PAGEMASK);
+// Reads the header and the segments of an NSO, sizing its image to fit the decoded segments
+bool ReadModule(const FileSys::VfsFile& nso_file, NSOImage& nso,
+                std::vector<PendingSegment>& segments) {
+    if (nso_file.GetSize() < sizeof(NSOHeader)) {
+        return false;
+    }
+
+    if (sizeof(NSOHeader) != nso_file.ReadObject(&nso.header)) {
+        return false;
+    }
+
+    if (nso.header.magic != Common::MakeMagic('N', 'S', 'O', '0')) {
+        return false;
+    }
+
+    nso.name = nso_file.GetName();
+    std::size_t capacity = 0;
+    for (std::size_t i = 0; i < nso.header.segments.size(); ++i) {
+        const auto& segment = nso.header.segments[i];
+        const u32 compressed_size = nso.header.segments_compressed_size[i];
+        auto& pending = segments.emplace_back();
+        pending.nso = &nso;
+        pending.index = i;
+
+        // Use the segment in place when the file is memory mapped.
+        pending.data = nso_file.GetSpan(compressed_size, segment.offset);
+        if (pending.data.size() != compressed_size) {
+            pending.buffer = nso_file.ReadBytes(compressed_size, segment.offset);
+            pending.data = pending.buffer;
+        }
+
+        capacity = std::max<std::size_t>(capacity, SegmentEnd(nso.header, i, pending.data));
+    }
+    nso.image.resize(capacity);
+    return true;
+}
+
+void DecompressSegment(PendingSegment& pending) {
+    const auto& segment = pending.nso->header.segments[pending.index];
+    u8* const out = pending.nso->image.data() + segment.location;
+    if (pending.nso->header.IsSegmentCompressed(pending.index)) {
+        pending.decompressed_size = Common::Compression::DecompressDataLZ4(
+            out, segment.size, pending.data.data(), pending.data.size());
+    } else {
+        std::memcpy(out, pending.data.data(), pending.data.size());
+        pending.decompressed_size = static_cast<int>(pending.data.size());
+    }
+}
+
+// Decompresses the segments read by ReadModule and trims the images to their final sizes
+void DecompressSegments(std::vector<PendingSegment>& segments) {
+    std::size_t total_size = 0;
+    for (const auto& pending : segments) {
+        total_size += pending.data.size();
+    }
+    const std::size_t num_workers =
+        std::min<std::size_t>(std::thread::hardware_concurrency(), segments.size());
+    if (total_size < ParallelThreshold || num_workers <= 1) {
+        std::ranges::for_each(segments, DecompressSegment);
+    } else {
+        // Largest segments first to keep the workers busy until the end
+        std::ranges::sort(segments, std::ranges::greater{},
+                          [](const PendingSegment& pending) { return pending.data.size(); });
+        Common::ThreadWorker workers(num_workers, "NSODecompression");
+        for (auto& pending : segments) {
+            workers.QueueWork([&pending] { DecompressSegment(pending); });
+        }
+        workers.WaitForRequests();
+    }
+
+    for (const auto& pending : segments) {
+        const auto& header = pending.nso->header;
+        const auto& segment = header.segments[pending.index];
+        if (header.IsSegmentCompressed(pending.index)) {
+            ASSERT_MSG(pending.decompressed_size == static_cast<int>(segment.size), "{} != {}",
+                       segment.size, pending.decompressed_size);
+        }
+
+        // The image ends with the last segment, like when the segments are decoded in order
+        if (pending.index == header.segments.size() - 1) {
+            pending.nso->image.resize(SegmentEnd(header, pending.index, pending.data));
+        }
+    }
 }
 } // Anonymous namespace
 
@@ -73,24 +169,42 @@ FileType AppLoader_NSO::IdentifyType(const FileSys::VirtualFile& in_file) {
     return FileType::NSO;
 }
 
+std::vector<std::optional<NSOImage>> AppLoader_NSO::DecodeModules(
+    std::span<const FileSys::VirtualFile> nso_files) {
+    std::vector<std::optional<NSOImage>> out(nso_files.size());
+    std::vector<PendingSegment> segments;
+    for (std::size_t i = 0; i < nso_files.size(); ++i) {
+        if (nso_files[i] != nullptr && !ReadModule(*nso_files[i], out[i].emplace(), segments)) {
+            out[i].reset();
+        }
+    }
+    DecompressSegments(segments);
+    return out;
+}
+
 std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::System& system,
                                                const FileSys::VfsFile& nso_file, VAddr load_base,
                                                bool should_pass_arguments, bool load_into_process,
                                                std::optional<FileSys::PatchManager> pm,
                                                std::vector<Core::NCE::Patcher>* patches,
                                                s32 patch_index) {
-    if (nso_file.GetSize() < sizeof(NSOHeader)) {
-        return std::nullopt;
-    }
-
-    NSOHeader nso_header{};
-    if (sizeof(NSOHeader) != nso_file.ReadObject(&nso_header)) {
+    NSOImage nso;
+    std::vector<PendingSegment> segments;
+    if (!ReadModule(nso_file, nso, segments)) {
         return std::nullopt;
     }
+    DecompressSegments(segments);
+    return LoadModule(process, system, nso, load_base, should_pass_arguments, load_into_process,
+                      std::move(pm), patches, patch_index);
+}
 
-    if (nso_header.magic != Common::MakeMagic('N', 'S', 'O', '0')) {
-        return std::nullopt;
-    }
+std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::System& system,
+                                               const NSOImage& nso, VAddr load_base,
+                                               bool should_pass_arguments, bool load_into_process,
+                                               std::optional<FileSys::PatchManager> pm,
+                                               std::vector<Core::NCE::Patcher>* patches,
+                                               s32 patch_index) {
+    const auto& nso_header = nso.header;
 
     // Allocate some space at the beginning if we are patching in PreText mode.
     const size_t module_start = [&]() -> size_t {
@@ -107,17 +221,9 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
 
     // Build program image
     Kernel::CodeSet codeset;
-    Kernel::PhysicalMemory program_image;
+    Kernel::PhysicalMemory program_image(module_start + nso.image.size());
+    std::memcpy(program_image.data() + module_start, nso.image.data(), nso.image.size());
     for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
-        std::vector<u8> data = nso_file.ReadBytes(nso_header.segments_compressed_size[i],
-                                                  nso_header.segments[i].offset);
-        if (nso_header.IsSegmentCompressed(i)) {
-            data = DecompressSegment(data, nso_header.segments[i]);
-        }
-        program_image.resize(module_start + nso_header.segments[i].location +
-                             static_cast<u32>(data.size()));
-        std::memcpy(program_image.data() + module_start + nso_header.segments[i].location,
-                    data.data(), data.size());
         codeset.segments[i].addr = module_start + nso_header.segments[i].location;
         codeset.segments[i].offset = module_start + nso_header.segments[i].location;
         codeset.segments[i].size = nso_header.segments[i].size;
@@ -147,7 +253,7 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
     }
 
     // Apply patches if necessary
-    const auto name = nso_file.GetName();
+    const auto& name = nso.name;
     if (pm && (pm->HasNSOPatch(nso_header.build_id, name) || Settings::values.dump_nso)) {
         std::span<u8> patchable_section(program_image.data() + module_start,
                                         program_image.size() - module_start);
@@ -5,10 +5,13 @@
 
 #include <array>
 #include <optional>
+#include <span>
 #include <type_traits>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/file_sys/patch_manager.h"
+#include "core/hle/kernel/physical_memory.h"
 #include "core/loader/loader.h"
 
 namespace Core {
@@ -71,6 +74,13 @@ struct NSOArgumentHeader {
 };
 static_assert(sizeof(NSOArgumentHeader) == 0x20, "NSOArgumentHeader has incorrect size.");
 
+/// An NSO with its segments decompressed, ready to be loaded into a process
+struct NSOImage {
+    std::string name;
+    NSOHeader header{};
+    Kernel::PhysicalMemory image; ///< Segments at their locations, without the bss
+};
+
 /// Loads an NSO file
 class AppLoader_NSO final : public AppLoader {
 public:
@@ -89,6 +99,15 @@ public:
         return IdentifyType(file);
     }
 
+    /**
+     * Reads and decompresses the segments of the given NSOs. The segments of all the modules are
+     * decompressed in parallel.
+     *
+     * @return The decoded modules in the order of nso_files, std::nullopt for null or invalid files
+     */
+    static std::vector<std::optional<NSOImage>> DecodeModules(
+        std::span<const FileSys::VirtualFile> nso_files);
+
     static std::optional<VAddr> LoadModule(Kernel::KProcess& process, Core::System& system,
                                            const FileSys::VfsFile& nso_file, VAddr load_base,
                                            bool should_pass_arguments, bool load_into_process,
@@ -96,6 +115,14 @@ public:
                                            std::vector<Core::NCE::Patcher>* patches = nullptr,
                                            s32 patch_index = -1);
 
+    /// Loads a module decoded by DecodeModules, which can be loaded any number of times
+    static std::optional<VAddr> LoadModule(Kernel::KProcess& process, Core::System& system,
+                                           const NSOImage& nso, VAddr load_base,
+                                           bool should_pass_arguments, bool load_into_process,
+                                           std::optional<FileSys::PatchManager> pm = {},
+                                           std::vector<Core::NCE::Patcher>* patches = nullptr,
+                                           s32 patch_index = -1);
+
     LoadResult Load(Kernel::KProcess& process, Core::System& system) override;
 
     ResultStatus ReadNSOModules(Modules& out_modules) override;
@@ -1,8 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <locale>
 #include "common/hex_util.h"
+#include "common/logging/backend.h"
 #include "common/microprofile.h"
 #include "common/swap.h"
 #include "core/arm/debug.h"
@@ -65,8 +67,23 @@ void StandardVmCallbacks::MemoryWriteUnsafe(VAddr address, const void* data, u64
         return;
     }
 
-    if (system.ApplicationMemory().WriteBlock(address, data, size)) {
-        Core::InvalidateInstructionCacheRange(system.ApplicationProcess(), address, size);
+    // Cheats mostly store the same values every tick, those writes do not touch any code the
+    // JIT could have compiled.
+    u64 previous{};
+    const bool changed = size > sizeof(previous) ||
+                         !system.ApplicationMemory().ReadBlockUnsafe(address, &previous, size) ||
+                         std::memcmp(&previous, data, size) != 0;
+
+    if (system.ApplicationMemory().WriteBlock(address, data, size) && changed) {
+        // Invalidating halts every core, batch the ranges until the program finishes.
+        if (!pending_invalidations.empty()) {
+            auto& last = pending_invalidations.back();
+            if (address >= last.base && address <= last.base + last.size) {
+                last.size = std::max(last.size, address + size - last.base);
+                return;
+            }
+        }
+        pending_invalidations.push_back({.base = address, .size = size});
     }
 }
 
@@ -111,6 +128,29 @@ void StandardVmCallbacks::CommandLog(std::string_view data) {
               data.back() == '\n' ? data.substr(0, data.size() - 1) : data);
 }
 
+bool StandardVmCallbacks::IsCommandLogEnabled() {
+    return Common::Log::IsEnabled(Common::Log::Class::CheatEngine, Common::Log::Level::Debug);
+}
+
+void StandardVmCallbacks::FlushMemoryWrites() {
+    if (pending_invalidations.empty()) {
+        return;
+    }
+    std::ranges::sort(pending_invalidations, {}, &MemoryRegionExtents::base);
+    MemoryRegionExtents range = pending_invalidations.front();
+    for (const auto& next : pending_invalidations) {
+        if (next.base > range.base + range.size) {
+            Core::InvalidateInstructionCacheRange(system.ApplicationProcess(), range.base,
+                                                  range.size);
+            range = next;
+            continue;
+        }
+        range.size = std::max(range.size, next.base + next.size - range.base);
+    }
+    Core::InvalidateInstructionCacheRange(system.ApplicationProcess(), range.base, range.size);
+    pending_invalidations.clear();
+}
+
 bool StandardVmCallbacks::IsAddressInRange(VAddr in) const {
     if ((in < metadata.main_nso_extents.base ||
          in >= metadata.main_nso_extents.base + metadata.main_nso_extents.size) &&
@@ -34,12 +34,17 @@ public:
     void ResumeProcess() override;
     void DebugLog(u8 id, u64 value) override;
     void CommandLog(std::string_view data) override;
+    bool IsCommandLogEnabled() override;
+    void FlushMemoryWrites() override;
 
 private:
     bool IsAddressInRange(VAddr address) const;
 
     const CheatProcessMetadata& metadata;
     Core::System& system;
+
+    /// Ranges written this execution whose instruction cache entries are yet to be invalidated
+    std::vector<MemoryRegionExtents> pending_invalidations;
 };
 
 // Intermediary class that parses a text file or other disk format for storing cheats into a
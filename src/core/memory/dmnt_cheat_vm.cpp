@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2019 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <optional>
+
 #include "common/assert.h"
 #include "common/scope_exit.h"
 #include "core/memory/dmnt_cheat_types.h"
@@ -634,29 +636,12 @@ bool DmntCheatVm::DecodeNextOpcode(CheatVmOpcode& out) {
     return valid;
 }
 
-void DmntCheatVm::SkipConditionalBlock(bool is_if) {
+void DmntCheatVm::SkipConditionalBlock(const CheatVmInstruction& instruction) {
     if (condition_depth > 0) {
-        // We want to continue until we're out of the current block.
-        const std::size_t desired_depth = condition_depth - 1;
-
-        CheatVmOpcode skip_opcode{};
-        while (condition_depth > desired_depth && DecodeNextOpcode(skip_opcode)) {
-            // Decode instructions until we see end of the current conditional block.
-            // NOTE: This is broken in gateway's implementation.
-            // Gateway currently checks for "0x2" instead of "0x20000000"
-            // In addition, they do a linear scan instead of correctly decoding opcodes.
-            // This causes issues if "0x2" appears as an immediate in the conditional block...
-
-            // We also support nesting of conditional blocks, and Gateway does not.
-            if (skip_opcode.begin_conditional_block) {
-                condition_depth++;
-            } else if (auto end_cond = std::get_if<EndConditionalOpcode>(&skip_opcode.opcode)) {
-                if (!end_cond->is_else) {
-                    condition_depth--;
-                } else if (is_if && condition_depth - 1 == desired_depth) {
-                    break;
-                }
-            }
+        // The landing instruction was resolved when the program was loaded.
+        instruction_ptr = instruction.skip_target;
+        if (!instruction.skip_to_else) {
+            condition_depth--;
         }
     } else {
         // Skipping, but condition_depth = 0.
@@ -668,6 +653,70 @@ void DmntCheatVm::SkipConditionalBlock(bool is_if) {
     }
 }
 
+void DmntCheatVm::CompileProgram() {
+    instructions.clear();
+    instruction_ptr = 0;
+    decode_success = true;
+
+    // Execution starts at the first opcode, and skips and loops only ever land right after an
+    // opcode, so decoding the program once from the start yields every reachable instruction.
+    // Execution stops where decoding fails, just like when decoding while executing.
+    CheatVmOpcode opcode{};
+    while (DecodeNextOpcode(opcode)) {
+        instructions.push_back({.opcode = opcode, .skip_target = 0, .skip_to_else = false});
+    }
+
+    // Resolve where skipping each conditional block lands, a skip that does not find the end of
+    // its block ends execution.
+    // NOTE: This is broken in gateway's implementation.
+    // Gateway currently checks for "0x2" instead of "0x20000000"
+    // In addition, they do a linear scan instead of correctly decoding opcodes.
+    // This causes issues if "0x2" appears as an immediate in the conditional block...
+    // We also support nesting of conditional blocks, and Gateway does not.
+    struct Block {
+        std::optional<std::size_t> begin;
+        std::vector<std::size_t> elses;
+    };
+    std::vector<Block> blocks(1);
+    for (std::size_t i = 0; i < instructions.size(); i++) {
+        instructions[i].skip_target = instructions.size();
+    }
+    for (std::size_t i = 0; i < instructions.size(); i++) {
+        const CheatVmOpcode& cur_opcode = instructions[i].opcode;
+        if (cur_opcode.begin_conditional_block) {
+            blocks.push_back({.begin = i, .elses = {}});
+            continue;
+        }
+        const auto end_cond = std::get_if<EndConditionalOpcode>(&cur_opcode.opcode);
+        if (!end_cond) {
+            continue;
+        }
+        Block& block = blocks.back();
+        if (end_cond->is_else) {
+            // Skipping an if lands after its first else, the block stays open.
+            if (block.begin && block.elses.empty()) {
+                instructions[*block.begin].skip_target = i + 1;
+                instructions[*block.begin].skip_to_else = true;
+            }
+            block.elses.push_back(i);
+            continue;
+        }
+        // Skipping an else, or an if without one, lands after the end of the block.
+        for (const std::size_t else_index : block.elses) {
+            instructions[else_index].skip_target = i + 1;
+        }
+        if (!block.begin) {
+            // Unmatched ends only close the elses before them.
+            block.elses.clear();
+            continue;
+        }
+        if (block.elses.empty()) {
+            instructions[*block.begin].skip_target = i + 1;
+        }
+        blocks.pop_back();
+    }
+}
+
 u64 DmntCheatVm::GetVmInt(VmInt value, u32 bit_width) {
     switch (bit_width) {
     case 1:
@@ -717,6 +766,7 @@ bool DmntCheatVm::LoadProgram(const std::vector<CheatEntry>& entries) {
             // Bounds check.
             if (entries[i].definition.num_opcodes + num_opcodes > MaximumProgramOpcodeCount) {
                 num_opcodes = 0;
+                instructions.clear();
                 return false;
             }
 
@@ -726,36 +776,50 @@ bool DmntCheatVm::LoadProgram(const std::vector<CheatEntry>& entries) {
         }
     }
 
+    CompileProgram();
     return true;
 }
 
 void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
-    CheatVmOpcode cur_opcode{};
+    SCOPE_EXIT {
+        callbacks->FlushMemoryWrites();
+    };
 
     // Get Keys down.
     u64 kDown = callbacks->HidKeysDown();
 
-    callbacks->CommandLog("Started VM execution.");
-    callbacks->CommandLog(fmt::format("Main NSO:  {:012X}", metadata.main_nso_extents.base));
-    callbacks->CommandLog(fmt::format("Heap:      {:012X}", metadata.main_nso_extents.base));
-    callbacks->CommandLog(fmt::format("Keys Down: {:08X}", static_cast<u32>(kDown & 0x0FFFFFFF)));
+    // Tracing formats every register for every opcode, only do it when it is going to be shown.
+    const bool log_commands = callbacks->IsCommandLogEnabled();
+    if (log_commands) {
+        callbacks->CommandLog("Started VM execution.");
+        callbacks->CommandLog(fmt::format("Main NSO:  {:012X}", metadata.main_nso_extents.base));
+        callbacks->CommandLog(fmt::format("Heap:      {:012X}", metadata.main_nso_extents.base));
+        callbacks->CommandLog(
+            fmt::format("Keys Down: {:08X}", static_cast<u32>(kDown & 0x0FFFFFFF)));
+    }
 
     // Clear VM state.
     ResetState();
 
     // Loop until program finishes.
-    while (DecodeNextOpcode(cur_opcode)) {
-        callbacks->CommandLog(
-            fmt::format("Instruction Ptr: {:04X}", static_cast<u32>(instruction_ptr)));
+    while (instruction_ptr < instructions.size()) {
+        const CheatVmInstruction& instruction = instructions[instruction_ptr++];
+        const CheatVmOpcode& cur_opcode = instruction.opcode;
 
-        for (std::size_t i = 0; i < NumRegisters; i++) {
-            callbacks->CommandLog(fmt::format("Registers[{:02X}]: {:016X}", i, registers[i]));
-        }
+        if (log_commands) {
+            callbacks->CommandLog(
+                fmt::format("Instruction Ptr: {:04X}", static_cast<u32>(instruction_ptr)));
 
-        for (std::size_t i = 0; i < NumRegisters; i++) {
-            callbacks->CommandLog(fmt::format("SavedRegs[{:02X}]: {:016X}", i, saved_values[i]));
+            for (std::size_t i = 0; i < NumRegisters; i++) {
+                callbacks->CommandLog(fmt::format("Registers[{:02X}]: {:016X}", i, registers[i]));
+            }
+
+            for (std::size_t i = 0; i < NumRegisters; i++) {
+                callbacks->CommandLog(
+                    fmt::format("SavedRegs[{:02X}]: {:016X}", i, saved_values[i]));
+            }
+            LogOpcode(cur_opcode);
         }
-        LogOpcode(cur_opcode);
 
         // Increment conditional depth, if relevant.
         if (cur_opcode.begin_conditional_block) {
@@ -814,12 +878,12 @@ void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
             }
             // Skip conditional block if condition not met.
             if (!cond_met) {
-                SkipConditionalBlock(true);
+                SkipConditionalBlock(instruction);
             }
         } else if (auto end_cond = std::get_if<EndConditionalOpcode>(&cur_opcode.opcode)) {
             if (end_cond->is_else) {
                 /* Skip to the end of the conditional block. */
-                this->SkipConditionalBlock(false);
+                SkipConditionalBlock(instruction);
             } else {
                 /* Decrement the condition depth. */
                 /* We will assume, graciously, that mismatched conditional block ends are a nop. */
@@ -933,7 +997,7 @@ void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
             // Check for keypress.
             if ((begin_keypress_cond->key_mask & kDown) != begin_keypress_cond->key_mask) {
                 // Keys not pressed. Skip conditional block.
-                SkipConditionalBlock(true);
+                SkipConditionalBlock(instruction);
             }
         } else if (auto perform_math_reg =
                        std::get_if<PerformArithmeticRegisterOpcode>(&cur_opcode.opcode)) {
@@ -1142,7 +1206,7 @@ void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
 
             // Skip conditional block if condition not met.
             if (!cond_met) {
-                SkipConditionalBlock(true);
+                SkipConditionalBlock(instruction);
             }
         } else if (auto save_restore_reg =
                        std::get_if<SaveRestoreRegisterOpcode>(&cur_opcode.opcode)) {
@@ -259,6 +259,15 @@ struct CheatVmOpcode {
         opcode{};
 };
 
+/// Opcode decoded ahead of execution, with the target of its conditional skip resolved
+struct CheatVmInstruction {
+    CheatVmOpcode opcode{};
+    /// Instruction execution continues from when the block begun or ended here is skipped
+    std::size_t skip_target{};
+    /// Whether the skip stops after an else instead of the end of the block
+    bool skip_to_else{};
+};
+
 class DmntCheatVm {
 public:
     /// Helper Type for DmntCheatVm <=> sudachi Interface
@@ -276,6 +285,10 @@ public:
 
         virtual void DebugLog(u8 id, u64 value) = 0;
         virtual void CommandLog(std::string_view data) = 0;
+        virtual bool IsCommandLogEnabled() = 0;
+
+        /// Called once per execution, after the last memory write of the program
+        virtual void FlushMemoryWrites() = 0;
     };
 
     static constexpr std::size_t MaximumProgramOpcodeCount = 0x400;
@@ -307,9 +320,11 @@ private:
     std::array<u64, NumRegisters> saved_values{};
     std::array<u64, NumStaticRegisters> static_registers{};
     std::array<std::size_t, NumRegisters> loop_tops{};
+    std::vector<CheatVmInstruction> instructions;
 
     bool DecodeNextOpcode(CheatVmOpcode& out);
-    void SkipConditionalBlock(bool is_if);
+    void CompileProgram();
+    void SkipConditionalBlock(const CheatVmInstruction& instruction);
     void ResetState();
 
     // For implementing the DebugLog opcode.
@@ -105,6 +105,7 @@ PerfStatsResults PerfStats::GetAndResetStats(microseconds current_system_time_us
         .frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                      static_cast<double>(system_frames),
         .emulation_speed = system_us_per_second.count() / 1'000'000.0,
+        .audio_latency = 0.0,
     };
 
     // Reset counters
@@ -21,6 +21,8 @@ struct PerfStatsResults {
     double frametime;
     /// Ratio of walltime / emulated time elapsed
     double emulation_speed;
+    /// Time between the audio renderer output and the host playing it, in milliseconds
+    double audio_latency;
 };
 
 /**
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <system_error>
+
+#include "common/common_types.h"
+#include "common/logging/backend.h"
+#include "common/logging/log.h"
+#include "video_core/pipeline_cache_file.h"
+#include "video_core/renderer_opengl/gl_compute_pipeline.h"
+#include "video_core/renderer_opengl/gl_graphics_pipeline.h"
+#include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
+#include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+namespace {
+struct KeySizes {
+    size_t compute;
+    size_t graphics;
+};
+} // Anonymous namespace
+
+static void PrintHelp(const char* argv0) {
+    LOG_INFO(Frontend,
+             "Usage: {}"
+             " [options] <input> [output]\n"
+             "Compacts a pipeline cache and converts legacy caches to the indexed format.\n"
+             "The input is rewritten in place when no output is given.\n"
+             "-b, --backend  vulkan or opengl, guessed from the file name by default\n"
+             "-h, --help     Display this help and exit\n",
+             argv0);
+}
+
+static std::optional<KeySizes> BackendKeySizes(const std::string& backend) {
+    if (backend == "vulkan") {
+        return KeySizes{
+            .compute = sizeof(Vulkan::ComputePipelineCacheKey),
+            .graphics = sizeof(Vulkan::GraphicsPipelineCacheKey),
+        };
+    }
+    if (backend == "opengl") {
+        return KeySizes{
+            .compute = sizeof(OpenGL::ComputePipelineKey),
+            .graphics = sizeof(OpenGL::GraphicsPipelineKey),
+        };
+    }
+    return std::nullopt;
+}
+
+int main(int argc, char** argv) {
+    Common::Log::Initialize();
+    Common::Log::SetColorConsoleBackendEnabled(true);
+    Common::Log::Start();
+
+    std::string backend;
+
+    static struct option long_options[] = {
+        // clang-format off
+        {"backend", required_argument, 0, 'b'},
+        {"help",    no_argument,       0, 'h'},
+        {0, 0, 0, 0},
+        // clang-format on
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "b:h", long_options, nullptr);
+        if (arg == -1) {
+            break;
+        }
+        switch (static_cast<char>(arg)) {
+        case 'b':
+            backend.assign(optarg);
+            break;
+        case 'h':
+            PrintHelp(argv[0]);
+            return 0;
+        default:
+            PrintHelp(argv[0]);
+            return -1;
+        }
+    }
+
+    if (optind >= argc || argc - optind > 2) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    const std::filesystem::path input{argv[optind]};
+    const bool in_place{optind + 1 == argc};
+    const std::filesystem::path output{in_place ? std::filesystem::path{input} += ".tmp"
+                                                : std::filesystem::path{argv[optind + 1]}};
+    if (backend.empty()) {
+        backend = input.stem().string();
+    }
+    const std::optional<KeySizes> key_sizes{BackendKeySizes(backend)};
+    if (!key_sizes) {
+        LOG_ERROR(Frontend, "Unknown backend \"{}\", pass --backend vulkan or --backend opengl",
+                  backend);
+        return -1;
+    }
+    if (!VideoCommon::PipelineCacheFile::Compact(input, output, key_sizes->compute,
+                                                 key_sizes->graphics)) {
+        std::error_code ec;
+        std::filesystem::remove(output, ec);
+        return -1;
+    }
+    if (in_place) {
+        std::error_code ec;
+        std::filesystem::rename(output, input, ec);
+        if (ec) {
+            LOG_ERROR(Frontend, "Failed to replace {}: {}", input.string(), ec.message());
+            return -1;
+        }
+    }
+    return 0;
+}
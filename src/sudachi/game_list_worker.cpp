@@ -1,8 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -13,6 +16,7 @@
 
 #include "common/fs/fs.h"
 #include "common/fs/path_util.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/file_sys/card_image.h"
 #include "core/file_sys/content_archive.h"
@@ -22,6 +26,7 @@
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/submission_package.h"
+#include "core/file_sys/title_metadata_index.h"
 #include "core/loader/loader.h"
 #include "sudachi/compatibility_list.h"
 #include "sudachi/game_list.h"
@@ -31,6 +36,13 @@
 
 namespace {
 
+FileSys::TitleMetadataIndex& GetGameListMetadataIndex() {
+    static FileSys::TitleMetadataIndex index{
+        Common::FS::GetSudachiPath(Common::FS::SudachiPath::CacheDir) / "game_list" /
+        "title_metadata.bin"};
+    return index;
+}
+
 QString GetGameListCachedObject(const std::string& filename, const std::string& ext,
                                 const std::function<QString()>& generator) {
     if (!UISettings::values.cache_game_list || filename == "0000000000000000") {
@@ -193,10 +205,11 @@ QString FormatPatchNameVersions(const FileSys::PatchManager& patch_manager,
 
 QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::string& name,
                                         const std::size_t size, const std::vector<u8>& icon,
-                                        Loader::AppLoader& loader, u64 program_id,
+                                        Loader::FileType file_type, u64 program_id,
                                         const CompatibilityList& compatibility_list,
                                         const PlayTime::PlayTimeManager& play_time_manager,
-                                        const FileSys::PatchManager& patch) {
+                                        const FileSys::PatchManager& patch,
+                                        const std::function<QString()>& patch_versions_generator) {
     const auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
 
     // The game list uses this as compatibility number for untested games
@@ -205,7 +218,6 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
         compatibility = it->second.first;
     }
 
-    const auto file_type = loader.GetFileType();
     const auto file_type_string = QString::fromStdString(Loader::GetFileTypeString(file_type));
 
     QList<QStandardItem*> list{
@@ -217,14 +229,63 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
         new GameListItemPlayTime(play_time_manager.GetPlayTime(program_id)),
     };
 
-    const auto patch_versions = GetGameListCachedObject(
-        fmt::format("{:016X}", patch.GetTitleID()), "pv.txt", [&patch, &loader] {
-            return FormatPatchNameVersions(patch, loader, loader.IsRomFSUpdatable());
-        });
+    const auto patch_versions = GetGameListCachedObject(fmt::format("{:016X}", patch.GetTitleID()),
+                                                        "pv.txt", patch_versions_generator);
     list.insert(2, new GameListItem(patch_versions));
 
     return list;
 }
+
+// Reads the titles of a game file, or returns std::nullopt if it is not a supported game.
+std::optional<FileSys::TitleMetadataIndexEntry> ReadGameListMetadata(
+    Core::System& system, const FileSys::VirtualFile& file) {
+    const auto loader = Loader::GetLoader(system, file);
+    if (!loader) {
+        return std::nullopt;
+    }
+
+    const auto file_type = loader->GetFileType();
+    if (file_type == Loader::FileType::Unknown || file_type == Loader::FileType::Error) {
+        return std::nullopt;
+    }
+
+    FileSys::TitleMetadataIndexEntry entry{};
+    entry.file_type = static_cast<u32>(file_type);
+
+    const auto read_title = [&entry](Loader::AppLoader& title_loader, u64 program_id) {
+        auto& title = entry.titles.emplace_back();
+        title.title_id = program_id;
+        [[maybe_unused]] const auto res1 = title_loader.ReadIcon(title.icon);
+
+        title.name = " ";
+        [[maybe_unused]] const auto res2 = title_loader.ReadTitle(title.name);
+
+        FileSys::NACP nacp;
+        if (title_loader.ReadControlData(nacp) == Loader::ResultStatus::Success) {
+            title.nacp = nacp.GetRawBytes();
+        }
+    };
+
+    u64 program_id = 0;
+    const auto res = loader->ReadProgramId(program_id);
+
+    std::vector<u64> program_ids;
+    loader->ReadProgramIds(program_ids);
+
+    if (res == Loader::ResultStatus::Success && program_ids.size() > 1 &&
+        (file_type == Loader::FileType::XCI || file_type == Loader::FileType::NSP)) {
+        for (const auto id : program_ids) {
+            const auto title_loader = Loader::GetLoader(system, file, id);
+            if (title_loader) {
+                read_title(*title_loader, id);
+            }
+        }
+    } else {
+        read_title(*loader, program_id);
+    }
+
+    return entry;
+}
 } // Anonymous namespace
 
 GameListWorker::GameListWorker(FileSys::VirtualFilesystem vfs_,
@@ -328,15 +389,68 @@ void GameListWorker::AddTitlesToGameList(GameListDir* parent_dir) {
             GetMetadataFromControlNCA(patch, *control, icon, name);
         }
 
-        auto entry = MakeGameListEntry(file->GetFullPath(), name, file->GetSize(), icon, *loader,
-                                       program_id, compatibility_list, play_time_manager, patch);
+        auto entry = MakeGameListEntry(
+            file->GetFullPath(), name, file->GetSize(), icon, loader->GetFileType(), program_id,
+            compatibility_list, play_time_manager, patch, [&patch, &loader] {
+                return FormatPatchNameVersions(patch, *loader, loader->IsRomFSUpdatable());
+            });
+        RecordEvent([=](GameList* game_list) { game_list->AddEntry(entry, parent_dir); });
+    }
+}
+
+void GameListWorker::AddFileToGameList(const std::string& physical_name,
+                                       GameListDir* parent_dir) {
+    const auto file = vfs->OpenFile(physical_name, FileSys::OpenMode::Read);
+    if (!file) {
+        return;
+    }
+
+    // Files that did not change since they were last listed are not parsed again.
+    auto& index = GetGameListMetadataIndex();
+    std::optional<FileSys::TitleMetadataIndexEntry> metadata;
+    if (UISettings::values.cache_game_list) {
+        metadata = index.Find(physical_name);
+    }
+    if (!metadata) {
+        metadata = ReadGameListMetadata(system, file);
+        if (!metadata) {
+            return;
+        }
+        if (UISettings::values.cache_game_list) {
+            index.Insert(physical_name, *metadata);
+        }
+    }
+
+    const auto file_type = static_cast<Loader::FileType>(metadata->file_type);
+    const auto size = Common::FS::GetSize(physical_name);
+    const bool has_multiple_programs = metadata->titles.size() > 1;
+    for (const auto& title : metadata->titles) {
+        const FileSys::PatchManager patch{title.title_id, system.GetFileSystemController(),
+                                          system.GetContentProvider()};
+
+        // The loader is only needed when the patch versions are not cached.
+        const auto patch_versions_generator = [this, &file, &patch, &title,
+                                               has_multiple_programs] {
+            const auto loader = has_multiple_programs
+                                    ? Loader::GetLoader(system, file, title.title_id)
+                                    : Loader::GetLoader(system, file);
+            if (!loader) {
+                return QString{};
+            }
+            return FormatPatchNameVersions(patch, *loader, loader->IsRomFSUpdatable());
+        };
+
+        auto entry = MakeGameListEntry(physical_name, title.name, size, title.icon, file_type,
+                                       title.title_id, compatibility_list, play_time_manager,
+                                       patch, patch_versions_generator);
         RecordEvent([=](GameList* game_list) { game_list->AddEntry(entry, parent_dir); });
     }
 }
 
 void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_path, bool deep_scan,
                                     GameListDir* parent_dir) {
-    const auto callback = [this, target, parent_dir](const std::filesystem::path& path) -> bool {
+    std::vector<std::string> game_files;
+    const auto callback = [this, target, &game_files](const std::filesystem::path& path) -> bool {
         if (stop_requested) {
             // Breaks the callback loop.
             return false;
@@ -347,6 +461,11 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
 
         if (!is_dir &&
             (HasSupportedFileExtension(physical_name) || IsExtractedNCAMain(physical_name))) {
+            if (target == ScanTarget::PopulateGameList) {
+                game_files.push_back(physical_name);
+                return true;
+            }
+
             const auto file = vfs->OpenFile(physical_name, FileSys::OpenMode::Read);
             if (!file) {
                 return true;
@@ -365,69 +484,22 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
             u64 program_id = 0;
             const auto res2 = loader->ReadProgramId(program_id);
 
-            if (target == ScanTarget::FillManualContentProvider) {
-                if (res2 == Loader::ResultStatus::Success && file_type == Loader::FileType::NCA) {
-                    provider->AddEntry(FileSys::TitleType::Application,
-                                       FileSys::GetCRTypeFromNCAType(FileSys::NCA{file}.GetType()),
-                                       program_id, file);
-                } else if (res2 == Loader::ResultStatus::Success &&
-                           (file_type == Loader::FileType::XCI ||
-                            file_type == Loader::FileType::NSP)) {
-                    const auto nsp = file_type == Loader::FileType::NSP
-                                         ? std::make_shared<FileSys::NSP>(file)
-                                         : FileSys::XCI{file}.GetSecurePartitionNSP();
-                    for (const auto& title : nsp->GetNCAs()) {
-                        for (const auto& entry : title.second) {
-                            provider->AddEntry(entry.first.first, entry.first.second, title.first,
-                                               entry.second->GetBaseFile());
-                        }
+            if (res2 == Loader::ResultStatus::Success && file_type == Loader::FileType::NCA) {
+                provider->AddEntry(FileSys::TitleType::Application,
+                                   FileSys::GetCRTypeFromNCAType(FileSys::NCA{file}.GetType()),
+                                   program_id, file);
+            } else if (res2 == Loader::ResultStatus::Success &&
+                       (file_type == Loader::FileType::XCI ||
+                        file_type == Loader::FileType::NSP)) {
+                const auto nsp = file_type == Loader::FileType::NSP
+                                     ? std::make_shared<FileSys::NSP>(file)
+                                     : FileSys::XCI{file}.GetSecurePartitionNSP();
+                for (const auto& title : nsp->GetNCAs()) {
+                    for (const auto& entry : title.second) {
+                        provider->AddEntry(entry.first.first, entry.first.second, title.first,
+                                           entry.second->GetBaseFile());
                     }
                 }
-            } else {
-                std::vector<u64> program_ids;
-                loader->ReadProgramIds(program_ids);
-
-                if (res2 == Loader::ResultStatus::Success && program_ids.size() > 1 &&
-                    (file_type == Loader::FileType::XCI || file_type == Loader::FileType::NSP)) {
-                    for (const auto id : program_ids) {
-                        loader = Loader::GetLoader(system, file, id);
-                        if (!loader) {
-                            continue;
-                        }
-
-                        std::vector<u8> icon;
-                        [[maybe_unused]] const auto res1 = loader->ReadIcon(icon);
-
-                        std::string name = " ";
-                        [[maybe_unused]] const auto res3 = loader->ReadTitle(name);
-
-                        const FileSys::PatchManager patch{id, system.GetFileSystemController(),
-                                                          system.GetContentProvider()};
-
-                        auto entry = MakeGameListEntry(
-                            physical_name, name, Common::FS::GetSize(physical_name), icon, *loader,
-                            id, compatibility_list, play_time_manager, patch);
-
-                        RecordEvent(
-                            [=](GameList* game_list) { game_list->AddEntry(entry, parent_dir); });
-                    }
-                } else {
-                    std::vector<u8> icon;
-                    [[maybe_unused]] const auto res1 = loader->ReadIcon(icon);
-
-                    std::string name = " ";
-                    [[maybe_unused]] const auto res3 = loader->ReadTitle(name);
-
-                    const FileSys::PatchManager patch{program_id, system.GetFileSystemController(),
-                                                      system.GetContentProvider()};
-
-                    auto entry = MakeGameListEntry(
-                        physical_name, name, Common::FS::GetSize(physical_name), icon, *loader,
-                        program_id, compatibility_list, play_time_manager, patch);
-
-                    RecordEvent(
-                        [=](GameList* game_list) { game_list->AddEntry(entry, parent_dir); });
-                }
             }
         } else if (is_dir) {
             watch_list.append(QString::fromStdString(physical_name));
@@ -442,6 +514,22 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
     } else {
         Common::FS::IterateDirEntries(dir_path, callback, Common::FS::DirEntryFilter::File);
     }
+
+    if (game_files.empty()) {
+        return;
+    }
+
+    // Parse the games across threads, entries are added to the list as they complete.
+    Common::ThreadWorker workers(std::max(std::thread::hardware_concurrency(), 1U),
+                                 "GameListWorker");
+    for (const auto& physical_name : game_files) {
+        workers.QueueWork([this, &physical_name, parent_dir] {
+            if (!stop_requested) {
+                AddFileToGameList(physical_name, parent_dir);
+            }
+        });
+    }
+    workers.WaitForRequests();
 }
 
 void GameListWorker::run() {
@@ -480,6 +568,8 @@ void GameListWorker::run() {
         }
     }
 
+    GetGameListMetadataIndex().Save();
+
     RecordEvent([this](GameList* game_list) { game_list->DonePopulating(watch_list); });
     processing_completed.Set();
 }
@@ -67,6 +67,7 @@ private:
 
 private:
     void AddTitlesToGameList(GameListDir* parent_dir);
+    void AddFileToGameList(const std::string& physical_name, GameListDir* parent_dir);
 
     enum class ScanTarget {
         FillManualContentProvider,
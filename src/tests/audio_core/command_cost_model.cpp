@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cmath>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio_core/renderer/command/command_cost_model.h"
+#include "common/common_types.h"
+
+namespace {
+using AudioCore::Renderer::CommandCostModel;
+using AudioCore::Renderer::CommandId;
+
+// Weight of a new measurement in the model's moving averages
+constexpr f64 AverageWeight = 1.0 / 32.0;
+// Takes 7200 ADSP ticks
+constexpr u64 TimeNs = 12500;
+constexpr f64 Ticks = TimeNs * CommandCostModel::DspTicksPerNs;
+
+// Scaled estimates are truncated, and the model averages in single precision
+bool IsNear(u32 value, f64 expected) {
+    return std::abs(static_cast<f64>(value) - expected) <= 1.0;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("CommandCostModel[Scale]", "[audio_core]") {
+    CommandCostModel model;
+
+    // Nothing measured yet, estimates are kept as they are
+    REQUIRE(model.Scale(CommandId::MixRamp, 1000) == 1000);
+    REQUIRE(model.Scale(CommandId::MixRamp, 0) == 0);
+
+    // Commands the tables estimate as free use the average measured time instead
+    model.Record(CommandId::MixRamp, 0, TimeNs);
+    REQUIRE(IsNear(model.Scale(CommandId::MixRamp, 0), Ticks * AverageWeight));
+    REQUIRE(model.Scale(CommandId::MixRamp, 1000) == 1000);
+
+    // Other command types are unaffected
+    REQUIRE(model.Scale(CommandId::Volume, 0) == 0);
+    REQUIRE(model.Scale(CommandId::Volume, 1000) == 1000);
+
+    // Unknown command types are not scaled
+    const auto unknown{static_cast<CommandId>(0xFF)};
+    model.Record(unknown, 1000, TimeNs);
+    REQUIRE(model.Scale(unknown, 1000) == 1000);
+}
+
+TEST_CASE("CommandCostModel[MovingAverage]", "[audio_core]") {
+    CommandCostModel model;
+
+    // Each measurement moves the average by a 32th of its distance to it
+    f64 expected_ticks{0.0};
+    for (u32 i = 0; i < 4; i++) {
+        model.Record(CommandId::Volume, 0, TimeNs);
+        expected_ticks += (Ticks - expected_ticks) * AverageWeight;
+        REQUIRE(IsNear(model.Scale(CommandId::Volume, 0), expected_ticks));
+    }
+
+    // And converges to the measured time
+    for (u32 i = 0; i < 1000; i++) {
+        model.Record(CommandId::Volume, 0, TimeNs);
+    }
+    REQUIRE(IsNear(model.Scale(CommandId::Volume, 0), Ticks));
+}
+
+TEST_CASE("CommandCostModel[ScaleCorrection]", "[audio_core]") {
+    CommandCostModel model;
+    // The host takes twice as long as the table estimates
+    constexpr u32 TableEstimate = 3600;
+
+    // The recorded estimate was already scaled, so the scale is corrected by how far off it was
+    model.Record(CommandId::MixRamp, TableEstimate, TimeNs);
+    const f64 first_scale{1.0 + (Ticks / TableEstimate - 1.0) * AverageWeight};
+    REQUIRE(IsNear(model.Scale(CommandId::MixRamp, 1000), 1000.0 * first_scale));
+
+    // Estimating with the current scale converges to the measured cost
+    for (u32 i = 0; i < 1000; i++) {
+        const auto estimate{model.Scale(CommandId::MixRamp, TableEstimate)};
+        model.Record(CommandId::MixRamp, estimate, TimeNs);
+    }
+    REQUIRE(IsNear(model.Scale(CommandId::MixRamp, TableEstimate), Ticks));
+    REQUIRE(IsNear(model.Scale(CommandId::MixRamp, 1000), 2000.0));
+}
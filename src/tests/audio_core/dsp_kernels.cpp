@@ -0,0 +1,380 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio_core/renderer/command/dsp_kernels.h"
+#include "common/common_types.h"
+#include "common/fixed_point.h"
+
+namespace {
+namespace DSP = AudioCore::Renderer::DSP;
+using DSP::Backend;
+using Ratio = Common::FixedPoint<49, 15>;
+
+constexpr std::array Backends{Backend::Scalar, Backend::SSE41, Backend::AVX2, Backend::NEON};
+constexpr std::array SampleCounts{0U, 1U, 3U, 4U, 7U, 9U, 17U, 160U, 240U};
+
+const char* BackendName(Backend backend) {
+    switch (backend) {
+    case Backend::Scalar:
+        return "Scalar";
+    case Backend::SSE41:
+        return "SSE4.1";
+    case Backend::AVX2:
+        return "AVX2";
+    case Backend::NEON:
+        return "NEON";
+    }
+    return "Unknown";
+}
+
+// Backends supported by the host, always starting with the scalar one
+std::vector<Backend> SupportedBackends() {
+    std::vector<Backend> backends;
+    for (const auto backend : Backends) {
+        DSP::SetBackend(backend);
+        if (DSP::GetBackend() == backend) {
+            backends.push_back(backend);
+        }
+    }
+    DSP::SetBackend(DSP::GetHostBackend());
+    return backends;
+}
+
+// The commands as they were written before the kernels, used as the reference for rounding
+template <size_t Q>
+void ReferenceGain(std::span<s32> output, std::span<const s32> input, f32 volume, f32 ramp_,
+                   u32 sample_count) {
+    Common::FixedPoint<64 - Q, Q> gain{volume};
+    const Common::FixedPoint<64 - Q, Q> ramp{ramp_};
+    for (u32 i = 0; i < sample_count; i++) {
+        output[i] = (input[i] * gain).to_int();
+        gain += ramp;
+    }
+}
+
+template <size_t Q>
+s32 ReferenceMix(std::span<s32> output, std::span<const s32> input, f32 volume_, f32 ramp_,
+                 u32 sample_count) {
+    Common::FixedPoint<64 - Q, Q> volume{volume_};
+    Common::FixedPoint<64 - Q, Q> sample{0};
+    const Common::FixedPoint<64 - Q, Q> ramp{ramp_};
+    for (u32 i = 0; i < sample_count; i++) {
+        sample = input[i] * volume;
+        output[i] = (output[i] + sample).to_int();
+        volume += ramp;
+    }
+    return sample.to_int();
+}
+
+template <size_t Taps>
+void ReferenceResample(std::span<s32> output, std::span<const s16> input,
+                       std::span<const f32> lut, const Ratio& sample_rate_ratio, Ratio& fraction,
+                       u32 samples_to_write) {
+    u32 read_index{0};
+    for (u32 i = 0; i < samples_to_write; i++) {
+        const auto lut_index{(fraction.get_frac() >> 8) * Taps};
+        Common::FixedPoint<56, 8> sum{0};
+        for (size_t tap = 0; tap < Taps; tap++) {
+            sum += Common::FixedPoint<56, 8>{input[read_index + tap] * lut[lut_index + tap]};
+        }
+        output[i] = sum.to_int_floor();
+        fraction += sample_rate_ratio;
+        read_index += static_cast<u32>(fraction.to_int_floor());
+        fraction.clear_int();
+    }
+}
+
+std::vector<s32> MakeSamples(std::mt19937& rng, size_t count, s32 range) {
+    std::uniform_int_distribution<s32> distribution(-range, range);
+    std::vector<s32> samples(count);
+    for (auto& sample : samples) {
+        sample = distribution(rng);
+    }
+    return samples;
+}
+
+std::vector<s16> MakePcm(std::mt19937& rng, size_t count) {
+    std::uniform_int_distribution<s32> distribution(-0x8000, 0x7FFF);
+    std::vector<s16> samples(count);
+    for (auto& sample : samples) {
+        sample = static_cast<s16>(distribution(rng));
+    }
+    return samples;
+}
+
+// A smooth filter table with both signs of coefficients, like the renderer's tables
+template <size_t Taps>
+std::vector<f32> MakeLut() {
+    std::vector<f32> lut(Taps * 128);
+    for (size_t i = 0; i < lut.size(); i++) {
+        lut[i] = static_cast<f32>(i % Taps == Taps / 2 ? 0.99606323 - i * 1e-4 : 0.1 - i * 1e-4);
+    }
+    return lut;
+}
+
+template <size_t Q>
+void CheckGain(const std::vector<Backend>& backends, std::mt19937& rng, f32 volume, f32 ramp) {
+    const auto input = MakeSamples(rng, 256, 0x7FFFFF);
+    const auto initial = MakeSamples(rng, 256, 0x7FFFFF);
+    for (const auto sample_count : SampleCounts) {
+        std::vector<s32> expected(initial);
+        ReferenceGain<Q>(expected, input, volume, ramp, sample_count);
+        std::vector<s32> expected_mix(initial);
+        const s32 expected_last = ReferenceMix<Q>(expected_mix, input, volume, ramp, sample_count);
+
+        const s64 gain = Common::FixedPoint<64 - Q, Q>{volume}.to_raw();
+        const s64 raw_ramp = Common::FixedPoint<64 - Q, Q>{ramp}.to_raw();
+        for (const auto backend : backends) {
+            DSP::SetBackend(backend);
+            std::vector<s32> output(initial);
+            DSP::ApplyGain<Q>(output, input, gain, raw_ramp, sample_count);
+            REQUIRE(output == expected);
+
+            output = initial;
+            REQUIRE(DSP::MixGain<Q>(output, input, gain, raw_ramp, sample_count) ==
+                    expected_last);
+            REQUIRE(output == expected_mix);
+        }
+    }
+}
+
+template <size_t Taps>
+void CheckResample(const std::vector<Backend>& backends, std::mt19937& rng, f32 ratio) {
+    const auto lut = MakeLut<Taps>();
+    const Ratio sample_rate_ratio{ratio};
+    for (const auto samples_to_write : SampleCounts) {
+        const auto input = MakePcm(rng, static_cast<size_t>(samples_to_write * ratio) + Taps + 2);
+        const Ratio initial_fraction = Ratio::from_base(rng() & 0x7FFF);
+
+        std::vector<s32> expected(samples_to_write);
+        Ratio expected_fraction{initial_fraction};
+        ReferenceResample<Taps>(expected, input, lut, sample_rate_ratio, expected_fraction,
+                                samples_to_write);
+        for (const auto backend : backends) {
+            DSP::SetBackend(backend);
+            std::vector<s32> output(samples_to_write);
+            Ratio fraction{initial_fraction};
+            DSP::ResampleFilter<Taps>(output, input, lut, sample_rate_ratio, fraction,
+                                      samples_to_write);
+            REQUIRE(output == expected);
+            REQUIRE(fraction.to_raw() == expected_fraction.to_raw());
+        }
+    }
+}
+
+// Compare the PCM kernels to plain loops, with the input ending right after its last frame
+void CheckPcm(const std::vector<Backend>& backends, std::mt19937& rng, u32 channel_count) {
+    constexpr s16 Untouched = 0x5A5A;
+    std::uniform_real_distribution<f32> floats(-1.5f, 1.5f);
+    for (const auto sample_count : SampleCounts) {
+        const auto pcm = MakePcm(rng, sample_count * channel_count);
+        std::vector<f32> pcm_float(sample_count * channel_count);
+        for (auto& sample : pcm_float) {
+            sample = floats(rng);
+        }
+
+        for (u32 channel = 0; channel < channel_count; channel++) {
+            std::vector<s16> expected(sample_count + 8, Untouched);
+            std::vector<s16> expected_float(sample_count + 8, Untouched);
+            for (u32 i = 0; i < sample_count; i++) {
+                const auto index = i * channel_count + channel;
+                expected[i] = pcm[index];
+                expected_float[i] = static_cast<s16>(
+                    std::clamp(static_cast<s32>(pcm_float[index] * 32767), -0x8000, 0x7FFF));
+            }
+
+            for (const auto backend : backends) {
+                DSP::SetBackend(backend);
+                std::vector<s16> output(sample_count + 8, Untouched);
+                DSP::DeinterleavePcm16(output, pcm, channel, channel_count, sample_count);
+                REQUIRE(output == expected);
+
+                std::fill(output.begin(), output.end(), Untouched);
+                DSP::ConvertPcmFloat(output, pcm_float, channel, channel_count, sample_count);
+                REQUIRE(output == expected_float);
+            }
+        }
+    }
+}
+
+// The ADPCM decoder as it was written before the kernel, one sample at a time
+u8 ReferenceAdpcm(std::span<s16> output, std::span<const u8> input,
+                  std::span<const s16, 16> coefficients, u32 frame_count, s16& yn0, s16& yn1) {
+    static constexpr std::array<s32, 16> Steps{
+        0, 1, 2, 3, 4, 5, 6, 7, -8, -7, -6, -5, -4, -3, -2, -1,
+    };
+    u8 header = 0;
+    u32 read_index = 0;
+    u32 write_index = 0;
+    for (u32 frame = 0; frame < frame_count; frame++) {
+        header = input[read_index++];
+        const s32 coeff0 = coefficients[((header >> 4) & 7) * 2 + 0];
+        const s32 coeff1 = coefficients[((header >> 4) & 7) * 2 + 1];
+        const s32 scale = header & 0xF;
+        const auto decode_sample = [&](s32 code) {
+            const auto xn = code * (1 << scale);
+            const auto sample = ((xn << 11) + 0x400 + coeff0 * yn0 + coeff1 * yn1) >> 11;
+            yn1 = yn0;
+            yn0 = static_cast<s16>(std::clamp<s32>(sample, -0x8000, 0x7FFF));
+            return yn0;
+        };
+        for (u32 i = 0; i < 7; i++) {
+            const u8 byte = input[read_index++];
+            output[write_index++] = decode_sample(Steps[byte >> 4]);
+            output[write_index++] = decode_sample(Steps[byte & 0xF]);
+        }
+    }
+    return header;
+}
+
+void CheckAdpcm(std::mt19937& rng, u32 frame_count, u8 max_scale) {
+    std::uniform_int_distribution<s32> coefficient_distribution(-8192, 8192);
+    std::array<s16, 16> coefficients;
+    for (auto& coefficient : coefficients) {
+        coefficient = static_cast<s16>(coefficient_distribution(rng));
+    }
+    std::vector<u8> input(frame_count * 8);
+    for (u32 i = 0; i < input.size(); i++) {
+        input[i] = static_cast<u8>(rng());
+        if (i % 8 == 0) {
+            input[i] = static_cast<u8>((input[i] & 0xF0) | (input[i] % (max_scale + 1)));
+        }
+    }
+    const auto initial = MakePcm(rng, 2);
+
+    std::vector<s16> expected(frame_count * 14);
+    s16 expected_yn0 = initial[0];
+    s16 expected_yn1 = initial[1];
+    const u8 expected_header = ReferenceAdpcm(expected, input, coefficients, frame_count,
+                                              expected_yn0, expected_yn1);
+
+    std::vector<s16> output(frame_count * 14);
+    s16 yn0 = initial[0];
+    s16 yn1 = initial[1];
+    REQUIRE(DSP::DecodeAdpcmFrames(output, input, coefficients, frame_count, yn0, yn1) ==
+            expected_header);
+    REQUIRE(output == expected);
+    REQUIRE(yn0 == expected_yn0);
+    REQUIRE(yn1 == expected_yn1);
+}
+
+template <typename Func>
+double NanosecondsPerCall(Func&& func) {
+    constexpr size_t Iterations = 20000;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < Iterations; i++) {
+        func();
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / Iterations;
+}
+} // Anonymous namespace
+
+TEST_CASE("DSP[Backends]", "[audio_core]") {
+    const auto backends = SupportedBackends();
+    REQUIRE(backends.front() == Backend::Scalar);
+    REQUIRE(backends.back() == DSP::GetHostBackend());
+    REQUIRE(DSP::GetBackend() == DSP::GetHostBackend());
+}
+
+TEST_CASE("DSP[Gain]", "[audio_core]") {
+    const auto backends = SupportedBackends();
+    std::mt19937 rng{0x5D5};
+    std::uniform_real_distribution<f32> volumes(-2.0f, 2.0f);
+    for (int i = 0; i < 16; i++) {
+        const f32 volume = volumes(rng);
+        const f32 ramp = (volumes(rng) - volume) / 240.0f;
+        CheckGain<15>(backends, rng, volume, ramp);
+        CheckGain<23>(backends, rng, volume, ramp);
+    }
+
+    // Unity, silence and steady volumes
+    CheckGain<15>(backends, rng, 1.0f, 0.0f);
+    CheckGain<23>(backends, rng, 0.0f, 1.0f / 240.0f);
+    CheckGain<23>(backends, rng, 0.5f, 0.0f);
+
+    // Gains too large for the 32-bit vector multiplies fall back to the scalar path
+    CheckGain<23>(backends, rng, 300.0f, -1.0f);
+    CheckGain<23>(backends, rng, 255.0f, 0.01f);
+    CheckGain<15>(backends, rng, 65000.0f, 100.0f);
+    DSP::SetBackend(DSP::GetHostBackend());
+}
+
+TEST_CASE("DSP[Resample]", "[audio_core]") {
+    const auto backends = SupportedBackends();
+    std::mt19937 rng{0x3E5};
+    for (const f32 ratio : {0.25f, 0.5f, 0.9183674f, 1.0f, 1.088435f, 1.5f, 2.0f, 3.7f}) {
+        CheckResample<4>(backends, rng, ratio);
+        CheckResample<8>(backends, rng, ratio);
+    }
+    DSP::SetBackend(DSP::GetHostBackend());
+}
+
+TEST_CASE("DSP[Pcm]", "[audio_core]") {
+    const auto backends = SupportedBackends();
+    std::mt19937 rng{0x9C3};
+    for (const u32 channel_count : {1U, 2U, 3U, 6U}) {
+        CheckPcm(backends, rng, channel_count);
+    }
+    DSP::SetBackend(DSP::GetHostBackend());
+}
+
+TEST_CASE("DSP[Adpcm]", "[audio_core]") {
+    std::mt19937 rng{0xADC};
+    for (const u32 frame_count : {0U, 1U, 2U, 17U, 160U}) {
+        // Small scales keep the predictor in range, large ones saturate it
+        CheckAdpcm(rng, frame_count, 4);
+        CheckAdpcm(rng, frame_count, 15);
+    }
+}
+
+TEST_CASE("DSP[CommandCost]", "[.][audio_core]") {
+    constexpr u32 SampleCount = 240;
+    std::mt19937 rng{0xC05};
+    const auto input = MakeSamples(rng, SampleCount, 0x7FFFFF);
+    auto output = MakeSamples(rng, SampleCount, 0x7FFFFF);
+    const auto pcm = MakePcm(rng, SampleCount * 2 + 8);
+    const auto lut4 = MakeLut<4>();
+    const auto lut8 = MakeLut<8>();
+    const s64 gain = Common::FixedPoint<41, 23>{0.75f}.to_raw();
+    const s64 ramp = Common::FixedPoint<41, 23>{-0.5f / SampleCount}.to_raw();
+    const Ratio ratio{1.088435f};
+    const std::vector<f32> pcm_float(SampleCount * 2, 0.25f);
+    std::vector<s16> decoded(SampleCount);
+
+    for (const auto backend : SupportedBackends()) {
+        DSP::SetBackend(backend);
+        const double volume = NanosecondsPerCall(
+            [&] { DSP::ApplyGain<23>(output, input, gain, ramp, SampleCount); });
+        const double mix = NanosecondsPerCall(
+            [&] { DSP::MixGain<23>(output, output, gain, ramp, SampleCount); });
+        Ratio fraction{0};
+        const double resample4 = NanosecondsPerCall([&] {
+            DSP::ResampleFilter<4>(output, pcm, lut4, ratio, fraction, SampleCount);
+        });
+        const double resample8 = NanosecondsPerCall([&] {
+            DSP::ResampleFilter<8>(output, pcm, lut8, ratio, fraction, SampleCount);
+        });
+        printf("%s: %.0f ns volume ramp, %.0f ns mix ramp, %.0f ns normal resample, "
+               "%.0f ns high resample per %u samples\n",
+               BackendName(backend), volume, mix, resample4, resample8, SampleCount);
+        const double deinterleave = NanosecondsPerCall(
+            [&] { DSP::DeinterleavePcm16(decoded, pcm, 1, 2, SampleCount); });
+        const double convert = NanosecondsPerCall(
+            [&] { DSP::ConvertPcmFloat(decoded, pcm_float, 1, 2, SampleCount); });
+        printf("%s: %.0f ns stereo s16 decode, %.0f ns stereo float decode per %u samples\n",
+               BackendName(backend), deinterleave, convert, SampleCount);
+    }
+    DSP::SetBackend(DSP::GetHostBackend());
+}
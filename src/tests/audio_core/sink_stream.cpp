@@ -0,0 +1,204 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio_core/common/common.h"
+#include "audio_core/sink/sink_stream.h"
+#include "common/common_types.h"
+#include "common/settings.h"
+#include "core/core.h"
+
+namespace {
+using namespace std::chrono_literals;
+using AudioCore::Sink::SinkBuffer;
+using AudioCore::Sink::SinkStream;
+using AudioCore::Sink::StreamType;
+
+constexpr u32 Channels = 2;
+constexpr f64 ToneFrequency = 100.0;
+constexpr f64 ToneAmplitude = 10000.0;
+// Largest step between two frames of the tone, with some room for time-stretching
+constexpr s32 MaxToneStep = 200;
+
+// A sink stream without a backend, whose callbacks are driven by the test
+class NullBackendStream final : public SinkStream {
+public:
+    explicit NullBackendStream(Core::System& system_) : SinkStream{system_, StreamType::Render} {
+        paused = false;
+    }
+
+    void Callback(std::span<s16> output_buffer, size_t num_frames,
+                  std::chrono::nanoseconds callback_time) {
+        ProcessAudioOutAndRender(output_buffer, num_frames, callback_time);
+    }
+};
+
+struct SimulationConfig {
+    bool low_latency;
+    // Largest deviation of a callback from its period
+    std::chrono::nanoseconds jitter;
+    // Deviation of the emulation speed from full speed
+    f64 speed_offset;
+    // Largest deviation of the emulation speed from the above, varying over a few seconds
+    f64 speed_drift;
+};
+
+struct SimulationResult {
+    u64 underruns;
+    s32 max_step;
+    f64 average_latency_ms;
+    f64 max_latency_ms;
+};
+
+// Run a renderer producing a tone in 5ms buffers, and a backend consuming it in 10ms callbacks,
+// in simulated time. Only the time after the first second is measured.
+SimulationResult Simulate(Core::System& system, const SimulationConfig& config) {
+    constexpr auto CallbackPeriod = 10ms;
+    constexpr size_t CallbackFrames = AudioCore::TargetSampleRate / 100;
+    constexpr auto RenderPeriod = 5ms;
+    constexpr auto Duration = 20s;
+    constexpr auto Warmup = 1s;
+
+    Settings::values.audio_low_latency.SetValue(config.low_latency);
+    NullBackendStream stream{system};
+    stream.SetRingSize(4);
+
+    std::mt19937 rng{0x1A7};
+    std::uniform_int_distribution<s64> jitter(-config.jitter.count(), config.jitter.count());
+
+    std::vector<s16> buffer(AudioCore::TargetSampleCount * Channels);
+    std::vector<s16> output(CallbackFrames * Channels);
+    u64 tone_frame{0};
+    std::chrono::nanoseconds next_render{0};
+    std::chrono::nanoseconds callback_time{0};
+    std::array<s16, Channels> last_frame{};
+
+    SimulationResult result{};
+    u64 underruns_at_warmup{0};
+    f64 total_latency_ms{0.0};
+    u64 callbacks{0};
+    for (u64 callback = 0; callback_time < Duration; callback++) {
+        stream.Callback(output, CallbackFrames, callback_time + 1s);
+        if (callback_time >= Warmup) {
+            if (callbacks == 0) {
+                underruns_at_warmup = stream.GetStatistics().underruns;
+            }
+            const auto latency_ms{static_cast<f64>(stream.GetLatency().count()) / 1000.0};
+            total_latency_ms += latency_ms;
+            result.max_latency_ms = std::max(result.max_latency_ms, latency_ms);
+            callbacks++;
+        }
+        for (size_t i = 0; i < CallbackFrames; i++) {
+            for (u32 channel = 0; channel < Channels; channel++) {
+                const auto sample{output[i * Channels + channel]};
+                if (callback_time >= Warmup) {
+                    result.max_step =
+                        std::max(result.max_step, std::abs(sample - last_frame[channel]));
+                }
+                last_frame[channel] = sample;
+            }
+        }
+
+        const auto next_callback{(callback + 1) * std::chrono::nanoseconds{CallbackPeriod} +
+                                 std::chrono::nanoseconds{jitter(rng)}};
+
+        // Render every buffer due before the next callback. A renderer held back by a full queue
+        // waits for the next callback to release a buffer.
+        while (next_render < next_callback) {
+            const auto queue_limit{config.low_latency ? stream.GetTargetQueueSize()
+                                                      : stream.GetTargetQueueSize() + 3};
+            if (stream.GetQueueSize() >= queue_limit) {
+                next_render = next_callback;
+                break;
+            }
+            for (u32 i = 0; i < AudioCore::TargetSampleCount; i++, tone_frame++) {
+                const auto sample{static_cast<s16>(
+                    ToneAmplitude * std::sin(2.0 * std::numbers::pi * ToneFrequency *
+                                             static_cast<f64>(tone_frame) /
+                                             AudioCore::TargetSampleRate))};
+                std::fill_n(buffer.begin() + i * Channels, Channels, sample);
+            }
+            SinkBuffer sink_buffer{
+                .frames = AudioCore::TargetSampleCount,
+                .frames_played = 0,
+                .tag = tone_frame,
+                .consumed = false,
+                .queued_time = {},
+            };
+            stream.AppendBuffer(sink_buffer, buffer);
+
+            const auto render_time{std::chrono::duration<f64>{next_render}.count()};
+            const auto speed{1.0 + config.speed_offset +
+                             config.speed_drift * std::sin(render_time * std::numbers::pi)};
+            next_render += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::duration<f64, std::nano>{
+                    std::chrono::nanoseconds{RenderPeriod}.count() / speed});
+        }
+        callback_time = next_callback;
+    }
+
+    result.underruns = stream.GetStatistics().underruns - underruns_at_warmup;
+    result.average_latency_ms = total_latency_ms / static_cast<f64>(callbacks);
+    Settings::values.audio_low_latency.SetValue(false);
+    return result;
+}
+
+void PrintResult(const char* name, const SimulationResult& result) {
+    printf("%s: %.1f ms average latency, %.1f ms max, %llu underruns, largest step %d\n", name,
+           result.average_latency_ms, result.max_latency_ms,
+           static_cast<unsigned long long>(result.underruns), result.max_step);
+}
+} // Anonymous namespace
+
+TEST_CASE("SinkStream[LowLatency]", "[audio_core]") {
+    Core::System system;
+
+    // Emulation running slightly fast fills the fixed queue up to its limit
+    const auto fixed = Simulate(system, {.low_latency = false,
+                                         .jitter = 2ms,
+                                         .speed_offset = 0.01,
+                                         .speed_drift = 0.0});
+    const auto steady = Simulate(system, {.low_latency = true,
+                                          .jitter = 0ms,
+                                          .speed_offset = 0.01,
+                                          .speed_drift = 0.0});
+    const auto jittery = Simulate(system, {.low_latency = true,
+                                           .jitter = 3ms,
+                                           .speed_offset = 0.01,
+                                           .speed_drift = 0.0});
+    PrintResult("Fixed queue, 2ms jitter", fixed);
+    PrintResult("Low latency, steady", steady);
+    PrintResult("Low latency, 3ms jitter", jittery);
+
+    REQUIRE(steady.underruns == 0);
+    REQUIRE(jittery.underruns == 0);
+    REQUIRE(steady.average_latency_ms < jittery.average_latency_ms);
+    REQUIRE(jittery.average_latency_ms < fixed.average_latency_ms);
+    REQUIRE(steady.max_step <= MaxToneStep);
+    REQUIRE(jittery.max_step <= MaxToneStep);
+}
+
+TEST_CASE("SinkStream[TimeStretch]", "[audio_core]") {
+    Core::System system;
+
+    // Emulation running up to 1% slow or fast is absorbed by stretching, without gaps in the tone
+    const auto drifting = Simulate(system, {.low_latency = true,
+                                            .jitter = 1ms,
+                                            .speed_offset = 0.0,
+                                            .speed_drift = 0.01});
+    PrintResult("Low latency, 1% speed drift", drifting);
+
+    REQUIRE(drifting.underruns == 0);
+    REQUIRE(drifting.max_step <= MaxToneStep);
+}
@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio_core/adsp/apps/audio_renderer/command_list_processor.h"
+#include "audio_core/adsp/apps/audio_renderer/voice_command_executor.h"
+#include "audio_core/common/common.h"
+#include "audio_core/renderer/command/commands.h"
+#include "audio_core/renderer/voice/voice_state.h"
+#include "common/common_types.h"
+#include "core/core.h"
+
+namespace {
+using namespace AudioCore::Renderer;
+using AudioCore::CpuAddr;
+using AudioCore::SrcQuality;
+using AudioCore::ADSP::AudioRenderer::CommandListProcessor;
+using AudioCore::ADSP::AudioRenderer::VoiceCommandExecutor;
+
+constexpr u32 SampleCount = 240;
+constexpr u32 TargetSampleRate = 48000;
+// Buffers the voices mix into, followed by two channel buffers per voice slot
+constexpr u32 OutputBufferCount = 4;
+constexpr u32 ChannelBufferSlots = 6;
+constexpr u32 BufferCount = OutputBufferCount + ChannelBufferSlots * 2;
+
+/**
+ * Command list of voices like the ones the command generator makes: a depop prepare, one data
+ * source per channel, volume commands on the channel buffers and a mix into the output buffers.
+ * Voices have no wave buffers, so their data sources resample the sample history and never read
+ * guest memory.
+ */
+struct VoiceList {
+    /**
+     * @param voice_count   - Number of voices.
+     * @param seed          - Seed of the initial mix buffers and voice states.
+     * @param output_writer - Voice decoding its first channel straight into an output buffer.
+     */
+    VoiceList(u32 voice_count, u32 seed, std::optional<u32> output_writer = std::nullopt)
+        : voice_states(voice_count * 2) {
+        std::mt19937 rng{seed};
+        std::uniform_int_distribution<s32> sample{-0x8000, 0x7FFF};
+
+        mix_buffers.resize(BufferCount * SampleCount);
+        for (auto& value : mix_buffers) {
+            value = sample(rng);
+        }
+        for (auto& voice_state : voice_states) {
+            for (auto& history : voice_state.sample_history) {
+                history = static_cast<s16>(sample(rng));
+            }
+            for (auto& previous_sample : voice_state.previous_samples) {
+                previous_sample = sample(rng);
+            }
+        }
+        for (u32 voice = 0; voice < voice_count; voice++) {
+            AddVoice(voice, voice == output_writer);
+        }
+    }
+
+    template <typename T>
+    T& Add(u32 node_id, CommandId type) {
+        auto command{std::make_unique<T>()};
+        command->magic = 0xCAFEBABE;
+        command->enabled = true;
+        command->type = type;
+        command->size = sizeof(T);
+        command->estimated_process_time = 1000;
+        command->node_id = node_id;
+        auto& result{*command};
+        commands.push_back(command.get());
+        storage.push_back(std::move(command));
+        return result;
+    }
+
+    void AddVoice(u32 voice, bool writes_output) {
+        const u32 node_id{voice + 1};
+        const bool is_stereo{voice % 2 == 1};
+        const u32 channel_count{is_stereo ? 2U : 1U};
+        const auto channel_buffer{[voice, writes_output](u32 channel) {
+            if (writes_output && channel == 0) {
+                return s16{0};
+            }
+            return static_cast<s16>(OutputBufferCount + (voice % ChannelBufferSlots) * 2 + channel);
+        }};
+        const auto output_buffer{[voice](u32 channel) {
+            return static_cast<s16>((voice + channel) % OutputBufferCount);
+        }};
+        auto& voice_state{voice_states[voice * 2]};
+        voice_begin.push_back(commands.size());
+
+        auto& depop{Add<DepopPrepareCommand>(node_id, CommandId::DepopPrepare)};
+        depop.buffer_count = channel_count;
+        for (u32 channel = 0; channel < channel_count; channel++) {
+            depop.inputs[channel] = output_buffer(channel);
+        }
+        depop.previous_samples = reinterpret_cast<CpuAddr>(voice_state.previous_samples.data());
+        depop.depop_buffer = reinterpret_cast<CpuAddr>(depop_buffer.data());
+
+        for (u32 channel = 0; channel < channel_count; channel++) {
+            auto& data_source{Add<PcmInt16DataSourceVersion2Command>(
+                node_id, CommandId::DataSourcePcmInt16Version2)};
+            data_source.src_quality = SrcQuality::Medium;
+            data_source.output_index = channel_buffer(channel);
+            data_source.sample_rate = 2000 + voice * 300;
+            data_source.pitch = 1.0f;
+            data_source.channel_index = static_cast<s8>(channel);
+            data_source.channel_count = static_cast<s8>(channel_count);
+            data_source.voice_state =
+                reinterpret_cast<CpuAddr>(&voice_states[voice * 2 + channel]);
+        }
+
+        auto& volume_ramp{Add<VolumeRampCommand>(node_id, CommandId::VolumeRamp)};
+        volume_ramp.precision = 15;
+        volume_ramp.input_index = channel_buffer(0);
+        volume_ramp.output_index = channel_buffer(0);
+        volume_ramp.prev_volume = 0.5f;
+        volume_ramp.volume = 0.8f + static_cast<f32>(voice) * 0.1f;
+        volume_ramps.push_back(&volume_ramp);
+
+        if (!is_stereo) {
+            auto& mix_ramp{Add<MixRampCommand>(node_id, CommandId::MixRamp)};
+            mix_ramp.precision = 15;
+            mix_ramp.input_index = channel_buffer(0);
+            mix_ramp.output_index = output_buffer(0);
+            mix_ramp.prev_volume = 0.7f;
+            mix_ramp.volume = 0.9f;
+            mix_ramp.previous_sample =
+                reinterpret_cast<CpuAddr>(voice_state.previous_samples.data());
+            return;
+        }
+
+        auto& volume{Add<VolumeCommand>(node_id, CommandId::Volume)};
+        volume.precision = 15;
+        volume.input_index = channel_buffer(1);
+        volume.output_index = channel_buffer(1);
+        volume.volume = 1.5f;
+
+        auto& mix_ramp{Add<MixRampGroupedCommand>(node_id, CommandId::MixRampGrouped)};
+        mix_ramp.precision = 15;
+        mix_ramp.buffer_count = channel_count;
+        for (u32 channel = 0; channel < channel_count; channel++) {
+            mix_ramp.inputs[channel] = channel_buffer(channel);
+            mix_ramp.outputs[channel] = output_buffer(channel);
+            mix_ramp.prev_volumes[channel] = 0.6f;
+            mix_ramp.volumes[channel] = 0.4f + static_cast<f32>(channel) * 0.5f;
+        }
+        mix_ramp.previous_samples =
+            reinterpret_cast<CpuAddr>(voice_state.previous_samples.data());
+    }
+
+    void SetUp(CommandListProcessor& processor, Core::System& system) {
+        processor.system = &system;
+        processor.memory = &system.ApplicationMemory();
+        processor.sample_count = SampleCount;
+        processor.target_sample_rate = TargetSampleRate;
+        processor.buffer_count = BufferCount;
+        processor.mix_buffers = mix_buffers;
+    }
+
+    std::vector<s32> mix_buffers;
+    std::vector<VoiceState> voice_states;
+    std::array<s32, BufferCount> depop_buffer{};
+    std::vector<std::unique_ptr<ICommand>> storage;
+    std::vector<ICommand*> commands;
+    /// Index of the first command of each voice
+    std::vector<size_t> voice_begin;
+    std::vector<VolumeRampCommand*> volume_ramps;
+};
+
+// Channel buffers are scratch space, only the output buffers are expected to match
+void RequireSameState(const VoiceList& lhs, const VoiceList& rhs) {
+    constexpr size_t OutputSamples = OutputBufferCount * SampleCount;
+    REQUIRE(std::equal(lhs.mix_buffers.begin(), lhs.mix_buffers.begin() + OutputSamples,
+                       rhs.mix_buffers.begin()));
+    REQUIRE(lhs.depop_buffer == rhs.depop_buffer);
+    for (size_t i = 0; i < lhs.voice_states.size(); i++) {
+        REQUIRE(lhs.voice_states[i].previous_samples == rhs.voice_states[i].previous_samples);
+        REQUIRE(lhs.voice_states[i].sample_history == rhs.voice_states[i].sample_history);
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("VoiceCommandExecutor[Parallel]", "[audio_core]") {
+    Core::System system;
+    // More voices than the executor needs to split them between its workers
+    constexpr u32 VoiceCount = 13;
+
+    VoiceList serial{VoiceCount, 1234};
+    CommandListProcessor serial_processor;
+    serial.SetUp(serial_processor, system);
+    const std::vector<s32> initial_mix_buffers{serial.mix_buffers};
+    for (auto* const command : serial.commands) {
+        serial_processor.ProcessCommand(*command);
+    }
+    // Make sure the voices are audible in the output buffers
+    REQUIRE(!std::equal(serial.mix_buffers.begin(),
+                        serial.mix_buffers.begin() + OutputBufferCount * SampleCount,
+                        initial_mix_buffers.begin()));
+
+    VoiceList parallel{VoiceCount, 1234};
+    CommandListProcessor parallel_processor;
+    parallel.SetUp(parallel_processor, system);
+    VoiceCommandExecutor executor{3};
+    REQUIRE(executor.Process(parallel_processor, parallel.commands) == parallel.commands.size());
+
+    RequireSameState(serial, parallel);
+}
+
+TEST_CASE("VoiceCommandExecutor[Dependencies]", "[audio_core]") {
+    Core::System system;
+    constexpr u32 VoiceCount = 10;
+    constexpr u32 DependentVoice = 5;
+
+    const auto process{[&system](VoiceList& list) {
+        CommandListProcessor processor;
+        list.SetUp(processor, system);
+        VoiceCommandExecutor executor{3};
+        return executor.Process(processor, list.commands);
+    }};
+
+    SECTION("independent voices") {
+        VoiceList list{VoiceCount, 1};
+        REQUIRE(process(list) == list.commands.size());
+    }
+
+    SECTION("reading the channel buffer of another voice") {
+        VoiceList list{VoiceCount, 1};
+        list.volume_ramps[DependentVoice]->input_index =
+            list.volume_ramps[DependentVoice - 1]->output_index;
+        REQUIRE(process(list) == list.voice_begin[DependentVoice]);
+    }
+
+    SECTION("reading a buffer mixed into by another voice") {
+        VoiceList list{VoiceCount, 1};
+        list.volume_ramps[DependentVoice]->input_index = 0;
+        REQUIRE(process(list) == list.voice_begin[DependentVoice]);
+    }
+
+    SECTION("writing a buffer mixed into by another voice") {
+        VoiceList list{VoiceCount, 1, DependentVoice};
+        REQUIRE(process(list) == list.voice_begin[DependentVoice]);
+    }
+
+    SECTION("disabled commands are ignored") {
+        VoiceList list{VoiceCount, 1};
+        list.volume_ramps[DependentVoice]->input_index = 0;
+        list.volume_ramps[DependentVoice]->enabled = false;
+        REQUIRE(process(list) == list.commands.size());
+    }
+}
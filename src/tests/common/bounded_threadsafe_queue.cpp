@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/bounded_threadsafe_queue.h"
+#include "common/common_types.h"
+
+namespace Common {
+
+TEST_CASE("BoundedSPSCQueue: Basic Tests", "[common]") {
+    SPSCQueue<u32, 4> queue;
+
+    for (u32 i = 0; i < 4; ++i) {
+        REQUIRE(queue.TryEmplace(i));
+    }
+    // The queue is full, pushing should fail without blocking
+    REQUIRE(!queue.TryEmplace(4U));
+
+    u32 value{};
+    REQUIRE(queue.TryPop(value));
+    REQUIRE(value == 0);
+    REQUIRE(queue.TryEmplace(4U));
+
+    for (u32 i = 1; i <= 4; ++i) {
+        REQUIRE(queue.PopWait() == i);
+    }
+    REQUIRE(!queue.TryPop(value));
+}
+
+TEST_CASE("BoundedSPSCQueue: Threaded Throughput", "[.][common]") {
+    constexpr u64 count = 1'000'000;
+    // Keep the queue small so both the producer and the consumer end up waiting
+    SPSCQueue<u64, 64> queue;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&queue] {
+        for (u64 i = 0; i < count; ++i) {
+            queue.EmplaceWait(i);
+        }
+    });
+
+    bool in_order = true;
+    for (u64 i = 0; i < count; ++i) {
+        in_order &= queue.PopWait() == i;
+    }
+    producer.join();
+    const auto end = std::chrono::steady_clock::now();
+
+    REQUIRE(in_order);
+
+    const double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    printf("Bounded SPSCQueue: %.1f ns per element\n", ns / static_cast<double>(count));
+}
+
+TEST_CASE("BoundedMPSCQueue: Threaded Contention", "[.][common]") {
+    constexpr u64 num_producers = 4;
+    constexpr u64 count_per_producer = 250'000;
+    MPSCQueue<u64, 1024> queue;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (u64 producer = 0; producer < num_producers; ++producer) {
+        producers.emplace_back([&queue, producer] {
+            for (u64 i = 0; i < count_per_producer; ++i) {
+                queue.EmplaceWait(producer * count_per_producer + i);
+            }
+        });
+    }
+
+    std::vector<u64> next_expected(num_producers);
+    for (u64 producer = 0; producer < num_producers; ++producer) {
+        next_expected[producer] = producer * count_per_producer;
+    }
+    bool in_order = true;
+    for (u64 i = 0; i < num_producers * count_per_producer; ++i) {
+        const u64 value = queue.PopWait();
+        u64& next = next_expected[value / count_per_producer];
+        in_order &= value == next;
+        ++next;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    REQUIRE(in_order);
+
+    const double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    printf("Bounded MPSCQueue (%llu producers): %.1f ns per element\n",
+           static_cast<unsigned long long>(num_producers),
+           ns / static_cast<double>(num_producers * count_per_producer));
+}
+
+} // namespace Common
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+
+namespace {
+enum class TestEnum : u32 {
+    Value = 7,
+};
+
+template <typename... Args>
+std::string FormatDeferred(fmt::format_string<Args...> format, const Args&... args) {
+    Common::Log::DeferredArguments deferred_args;
+    REQUIRE(deferred_args.Pack(args...));
+    return deferred_args.Format(format);
+}
+} // Anonymous namespace
+
+TEST_CASE("Logging[DeferredArguments]", "[common]") {
+    const std::string string{"string"};
+    const std::string_view view{"view"};
+    const char* const c_string = "c string";
+    char buffer[16] = "buffer";
+    const void* const pointer = &string;
+
+    REQUIRE(FormatDeferred("no arguments") == "no arguments");
+    REQUIRE(FormatDeferred("{} {:#x} {:08X} {}", 1, u64{0xdeadbeef}, u32{0xabc}, -5) ==
+            fmt::format("{} {:#x} {:08X} {}", 1, u64{0xdeadbeef}, u32{0xabc}, -5));
+    REQUIRE(FormatDeferred("{:.3f} {} {} {}", 1.5f, true, 'c', TestEnum::Value) ==
+            "1.500 true c 7");
+    REQUIRE(FormatDeferred("{} {} {} {} {}", string, view, c_string, buffer, "literal") ==
+            "string view c string buffer literal");
+    REQUIRE(FormatDeferred("{}", pointer) == fmt::format("{}", pointer));
+
+    // The arguments are copied, changing them after packing does not change the message
+    Common::Log::DeferredArguments deferred_args;
+    REQUIRE(deferred_args.Pack(buffer));
+    buffer[0] = 'B';
+    REQUIRE(deferred_args.Format("{}") == "buffer");
+
+    // Arguments that do not fit are rejected so they can be formatted at the call site
+    const std::string long_string(Common::Log::DeferredArguments::Capacity, 'x');
+    REQUIRE(!deferred_args.Pack(long_string));
+    const char* const null_string = nullptr;
+    REQUIRE(!deferred_args.Pack(null_string));
+
+    static_assert(Common::Log::DeferredArguments::IsDeferrable<int, std::string, TestEnum>);
+    static_assert(!Common::Log::DeferredArguments::IsDeferrable<std::filesystem::path>);
+    static_assert(!Common::Log::DeferredArguments::IsDeferrable<std::array<u64, 2>>);
+}
+
+TEST_CASE("Logging[Throughput]", "[.][common]") {
+    using Common::Log::Level;
+
+    Common::Log::Initialize();
+    Common::Log::Start();
+    Common::Log::Filter filter;
+    filter.ParseFilterString("*:Info");
+    Common::Log::SetGlobalFilter(filter);
+
+    constexpr int iterations = 20000;
+    const auto time_level = [](Level level, bool deferred) {
+        constexpr auto log_class = Common::Log::Class::Debug;
+        u64 value = 0x1234;
+        const char* argument = "argument";
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            if (deferred) {
+                Common::Log::FmtLogMessage(log_class, level, __FILE__, __LINE__, __func__,
+                                           "Message {} with {:#x} {}", i, value, argument);
+            } else if (Common::Log::IsEnabled(log_class, level)) {
+                Common::Log::FmtLogMessageImpl(log_class, level, __FILE__, __LINE__, __func__,
+                                               "Message {} with {:#x} {}",
+                                               fmt::make_format_args(i, value, argument));
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    };
+
+    constexpr std::array levels{Level::Trace, Level::Debug, Level::Info, Level::Warning,
+                                Level::Error};
+    for (const Level level : levels) {
+        const double deferred = time_level(level, true);
+        const double immediate = time_level(level, false);
+        printf("Log level %s: deferred %.1f ns, formatted at call site %.1f ns per call\n",
+               Common::Log::GetLevelName(level), deferred, immediate);
+    }
+
+    Common::Log::Stop();
+    Common::Log::DisableLoggingInTests();
+}
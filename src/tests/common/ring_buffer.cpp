@@ -75,6 +75,39 @@ TEST_CASE("RingBuffer: Basic Tests", "[common]") {
     REQUIRE(buf.Size() == 0U);
 }
 
+TEST_CASE("RingBuffer: Reserve Tests", "[common]") {
+    RingBuffer<char, 4> buf;
+
+    // Reserving slots in an empty ring buffer should give a single span.
+    {
+        const auto spans = buf.Reserve(3);
+        REQUIRE(spans[0].size() == 3U);
+        REQUIRE(spans[1].size() == 0U);
+        std::iota(spans[0].begin(), spans[0].end(), static_cast<char>(0));
+    }
+
+    // Reserved slots should only be pushed once committed.
+    REQUIRE(buf.Size() == 0U);
+    buf.Commit(3);
+    REQUIRE(buf.Size() == 3U);
+    REQUIRE(buf.Pop(2) == std::vector<char>{0, 1});
+
+    // Reserving slots which wrap around should split them in two spans.
+    {
+        const auto spans = buf.Reserve(8);
+        REQUIRE(spans[0].size() == 1U);
+        REQUIRE(spans[1].size() == 2U);
+        spans[0][0] = 3;
+        spans[1][0] = 4;
+        spans[1][1] = 5;
+    }
+
+    // Committing fewer slots than reserved should only push those.
+    buf.Commit(2);
+    REQUIRE(buf.Size() == 3U);
+    REQUIRE(buf.Pop() == std::vector<char>{2, 3, 4});
+}
+
 TEST_CASE("RingBuffer: Threaded Test", "[common]") {
     RingBuffer<char, 8> buf;
     const char seed = 42;
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/threadsafe_queue.h"
+
+namespace Common {
+
+TEST_CASE("SPSCQueue: Basic Tests", "[common]") {
+    SPSCQueue<std::unique_ptr<int>> queue;
+    REQUIRE(queue.Empty());
+
+    // Interleave pushes and pops so consumed elements get recycled
+    int next_push = 0;
+    int next_pop = 0;
+    for (int round = 0; round < 64; ++round) {
+        for (int i = 0; i < round % 7 + 1; ++i) {
+            queue.Push(std::make_unique<int>(next_push++));
+        }
+        while (queue.Size() > 2) {
+            std::unique_ptr<int> value;
+            REQUIRE(queue.Pop(value));
+            REQUIRE(*value == next_pop++);
+        }
+    }
+    REQUIRE(*queue.Front() == next_pop);
+    queue.Pop();
+    ++next_pop;
+    REQUIRE(*queue.PopWait() == next_pop++);
+    REQUIRE(queue.Empty());
+
+    std::unique_ptr<int> value;
+    REQUIRE(!queue.Pop(value));
+
+    queue.Push(std::make_unique<int>(42));
+    queue.Clear();
+    REQUIRE(queue.Empty());
+    queue.Push(std::make_unique<int>(43));
+    REQUIRE(*queue.PopWait() == 43);
+}
+
+TEST_CASE("SPSCQueue: Threaded Throughput", "[.][common]") {
+    constexpr u64 count = 1'000'000;
+    SPSCQueue<u64> queue;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&queue] {
+        for (u64 i = 0; i < count; ++i) {
+            queue.Push(i);
+        }
+    });
+
+    bool in_order = true;
+    for (u64 i = 0; i < count; ++i) {
+        in_order &= queue.PopWait() == i;
+    }
+    producer.join();
+    const auto end = std::chrono::steady_clock::now();
+
+    REQUIRE(in_order);
+    REQUIRE(queue.Empty());
+
+    const double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    printf("SPSCQueue: %.1f ns per element\n", ns / static_cast<double>(count));
+}
+
+TEST_CASE("MPSCQueue: Threaded Contention", "[.][common]") {
+    constexpr u64 num_producers = 4;
+    constexpr u64 count_per_producer = 250'000;
+    MPSCQueue<u64> queue;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (u64 producer = 0; producer < num_producers; ++producer) {
+        producers.emplace_back([&queue, producer] {
+            for (u64 i = 0; i < count_per_producer; ++i) {
+                queue.Push(producer * count_per_producer + i);
+            }
+        });
+    }
+
+    // Every producer's elements must arrive in its own push order
+    std::vector<u64> next_expected(num_producers);
+    for (u64 producer = 0; producer < num_producers; ++producer) {
+        next_expected[producer] = producer * count_per_producer;
+    }
+    bool in_order = true;
+    for (u64 i = 0; i < num_producers * count_per_producer; ++i) {
+        const u64 value = queue.PopWait();
+        u64& next = next_expected[value / count_per_producer];
+        in_order &= value == next;
+        ++next;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    REQUIRE(in_order);
+    REQUIRE(queue.Empty());
+
+    const double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    printf("MPSCQueue (%llu producers): %.1f ns per element\n",
+           static_cast<unsigned long long>(num_producers),
+           ns / static_cast<double>(num_producers * count_per_producer));
+}
+
+} // namespace Common
@@ -4,12 +4,16 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cstdlib>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
+
+#include <fmt/format.h>
 
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -139,3 +143,49 @@ TEST_CASE("CoreTiming[BasicOrderNoPausing]", "[core]") {
     printf("HostTimer No Pausing Timer Time: %.3f %.6f\n", timer_time / 1000.f,
            timer_time / 1000000.f);
 }
+
+TEST_CASE("CoreTiming[UnscheduleThroughput]", "[.][core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+    core_timing.SyncPause(true);
+
+    static std::atomic<u64> callbacks_ran{};
+    callbacks_ran = 0;
+    const auto callback = [](s64, std::chrono::nanoseconds) {
+        ++callbacks_ran;
+        return std::optional<std::chrono::nanoseconds>{};
+    };
+
+    constexpr size_t num_events = 10000;
+    constexpr int iterations = 100000;
+    constexpr auto far_future = std::chrono::seconds{10};
+    std::vector<std::shared_ptr<Core::Timing::EventType>> events;
+    events.reserve(num_events);
+    for (size_t i = 0; i < num_events; ++i) {
+        events.push_back(Core::Timing::CreateEvent(fmt::format("event{}", i), callback));
+        core_timing.ScheduleEvent(far_future + std::chrono::nanoseconds{i}, events[i]);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t index = 0;
+    for (int i = 0; i < iterations; ++i) {
+        // Cancel and re-arm the events in a scattered order
+        index = (index + 7919) % num_events;
+        core_timing.UnscheduleEvent(events[index], Core::Timing::UnscheduleEventType::NoWait);
+        core_timing.ScheduleEvent(far_future, events[index]);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ns_per_iteration =
+        std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    printf("CoreTiming unschedule and schedule with %zu live events: %.1f ns\n", num_events,
+           ns_per_iteration);
+
+    for (const auto& event : events) {
+        core_timing.UnscheduleEvent(event, Core::Timing::UnscheduleEventType::NoWait);
+    }
+    core_timing.SyncPause(false);
+    core_timing.ScheduleEvent(std::chrono::nanoseconds{0}, events[0]);
+    while (core_timing.HasPendingEvents())
+        ;
+    REQUIRE(callbacks_ran == 1);
+}
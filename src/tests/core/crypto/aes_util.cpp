@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/crypto/aes_hardware.h"
+#include "core/crypto/aes_util.h"
+#include "core/crypto/key_manager.h"
+#include "tests/core/test_util.h"
+
+namespace {
+using namespace Core::Crypto;
+using Tests::MakeData;
+
+using Block = std::array<u8, 16>;
+
+constexpr std::size_t NcaSectorSize = 0x200;
+constexpr std::size_t XtsLayerSectorSize = 0x4000;
+
+template <std::size_t Size>
+std::array<u8, Size> MakeKey(u8 multiplier, u8 offset) {
+    std::array<u8, Size> key;
+    for (std::size_t i = 0; i < Size; ++i) {
+        key[i] = static_cast<u8>(i * multiplier + offset);
+    }
+    return key;
+}
+
+void IncrementCounter(Block& counter) {
+    for (std::size_t i = counter.size(); i-- > 0;) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+void MultiplyTweak(Block& tweak) {
+    u8 carry = 0;
+    for (u8& byte : tweak) {
+        const u8 next_carry = byte >> 7;
+        byte = static_cast<u8>((byte << 1) | carry);
+        carry = next_carry;
+    }
+    if (carry != 0) {
+        tweak[0] ^= 0x87;
+    }
+}
+
+/// CTR built from single blocks of the mbedtls ECB cipher
+std::vector<u8> ReferenceCTR(const Key128& key, Block counter, const std::vector<u8>& data) {
+    AESCipher<Key128> ecb(key, Mode::ECB);
+    std::vector<u8> out(data.size());
+    for (std::size_t offset = 0; offset < data.size(); offset += counter.size()) {
+        Block key_stream;
+        ecb.Transcode(counter.data(), counter.size(), key_stream.data(), Op::Encrypt);
+        const std::size_t length = std::min(counter.size(), data.size() - offset);
+        for (std::size_t i = 0; i < length; ++i) {
+            out[offset + i] = data[offset + i] ^ key_stream[i];
+        }
+        IncrementCounter(counter);
+    }
+    return out;
+}
+
+/// XTS with Nintendo tweaks built from single blocks of the mbedtls ECB cipher
+std::vector<u8> ReferenceXTS(const Key256& key, std::size_t sector_id, std::size_t sector_size,
+                             const std::vector<u8>& data, Op op) {
+    Key128 data_key;
+    Key128 tweak_key;
+    std::memcpy(data_key.data(), key.data(), data_key.size());
+    std::memcpy(tweak_key.data(), key.data() + data_key.size(), tweak_key.size());
+    AESCipher<Key128> data_cipher(data_key, Mode::ECB);
+    AESCipher<Key128> tweak_cipher(tweak_key, Mode::ECB);
+
+    std::vector<u8> out(data.size());
+    for (std::size_t sector = 0; sector < data.size(); sector += sector_size) {
+        Block tweak{};
+        std::size_t tweak_sector = sector_id + sector / sector_size;
+        for (std::size_t i = tweak.size(); i-- > 0;) {
+            tweak[i] = static_cast<u8>(tweak_sector);
+            tweak_sector >>= 8;
+        }
+        tweak_cipher.Transcode(tweak.data(), tweak.size(), tweak.data(), Op::Encrypt);
+
+        for (std::size_t offset = sector; offset < sector + sector_size; offset += tweak.size()) {
+            Block block;
+            for (std::size_t i = 0; i < block.size(); ++i) {
+                block[i] = data[offset + i] ^ tweak[i];
+            }
+            data_cipher.Transcode(block.data(), block.size(), block.data(), op);
+            for (std::size_t i = 0; i < block.size(); ++i) {
+                out[offset + i] = block[i] ^ tweak[i];
+            }
+            MultiplyTweak(tweak);
+        }
+    }
+    return out;
+}
+
+double MegabytesPerSecond(std::size_t size, std::chrono::steady_clock::duration duration) {
+    return static_cast<double>(size) / std::chrono::duration<double>(duration).count() / 1e6;
+}
+} // Anonymous namespace
+
+TEST_CASE("AES[CTR]", "[core]") {
+    const Key128 key = MakeKey<0x10>(7, 1);
+    const Block iv = MakeKey<0x10>(1, 0xF0);
+
+    // Large enough to be split across threads, with a partial block at the end
+    const std::vector<u8> data = MakeData(0x100005, 1);
+    const std::vector<u8> expected = ReferenceCTR(key, iv, data);
+
+    AESCipher<Key128> cipher(key, Mode::CTR);
+    std::vector<u8> out(data.size());
+    cipher.SetIV(iv);
+    cipher.Transcode(data.data(), data.size(), out.data(), Op::Decrypt);
+    REQUIRE(out == expected);
+
+    // The counter carries over between transcodes
+    const std::size_t split = 0x4000;
+    cipher.SetIV(iv);
+    cipher.Transcode(data.data(), split, out.data(), Op::Decrypt);
+    cipher.Transcode(data.data() + split, data.size() - split, out.data() + split, Op::Decrypt);
+    REQUIRE(out == expected);
+
+    // Transcodes smaller than a block use the first bytes of the key stream
+    cipher.SetIV(iv);
+    cipher.Transcode(data.data(), 5, out.data(), Op::Decrypt);
+    REQUIRE(std::memcmp(out.data(), expected.data(), 5) == 0);
+}
+
+TEST_CASE("AES[XTS]", "[core]") {
+    const Key256 key = MakeKey<0x20>(13, 5);
+    const std::size_t sector_id = 0x1234;
+    const std::vector<u8> data = MakeData(0x100000, 2);
+
+    AESCipher<Key256> cipher(key, Mode::XTS);
+    for (const std::size_t sector_size : {NcaSectorSize, XtsLayerSectorSize}) {
+        const std::vector<u8> encrypted =
+            ReferenceXTS(key, sector_id, sector_size, data, Op::Encrypt);
+        std::vector<u8> out(data.size());
+        cipher.XTSTranscode(data.data(), data.size(), out.data(), sector_id, sector_size,
+                            Op::Encrypt);
+        REQUIRE(out == encrypted);
+
+        cipher.XTSTranscode(encrypted.data(), encrypted.size(), out.data(), sector_id,
+                            sector_size, Op::Decrypt);
+        REQUIRE(out == data);
+    }
+
+    // A single data unit with the tweak set through the IV
+    const std::vector<u8> sector(data.begin(), data.begin() + NcaSectorSize);
+    const std::vector<u8> expected = ReferenceXTS(key, 0, NcaSectorSize, sector, Op::Decrypt);
+    std::vector<u8> out(sector.size());
+    cipher.SetIV(Block{});
+    cipher.Transcode(sector.data(), sector.size(), out.data(), Op::Decrypt);
+    REQUIRE(out == expected);
+}
+
+TEST_CASE("AES[Throughput]", "[.][core]") {
+    using Clock = std::chrono::steady_clock;
+
+    // Synthetic NCA content, decrypted a sector at a time as the encryption layers did and as
+    // whole reads that can be split across threads
+    constexpr std::size_t size = 0x2000000;
+    const Key256 xts_key = MakeKey<0x20>(13, 5);
+    const Key128 ctr_key = MakeKey<0x10>(7, 1);
+    const Block iv = MakeKey<0x10>(1, 0xF0);
+    const std::vector<u8> nca = MakeData(size, 3);
+    std::vector<u8> out(size);
+
+    AESCipher<Key256> xts(xts_key, Mode::XTS);
+    auto start = Clock::now();
+    for (std::size_t offset = 0; offset < size; offset += XtsLayerSectorSize) {
+        xts.XTSTranscode(nca.data() + offset, XtsLayerSectorSize, out.data() + offset,
+                         offset / XtsLayerSectorSize, XtsLayerSectorSize, Op::Decrypt);
+    }
+    const auto xts_sectors = Clock::now() - start;
+    const std::vector<u8> xts_expected = out;
+
+    start = Clock::now();
+    xts.XTSTranscode(nca.data(), size, out.data(), 0, XtsLayerSectorSize, Op::Decrypt);
+    const auto xts_whole = Clock::now() - start;
+    REQUIRE(out == xts_expected);
+
+    AESCipher<Key128> ctr(ctr_key, Mode::CTR);
+    ctr.SetIV(iv);
+    start = Clock::now();
+    for (std::size_t offset = 0; offset < size; offset += XtsLayerSectorSize) {
+        ctr.Transcode(nca.data() + offset, XtsLayerSectorSize, out.data() + offset, Op::Decrypt);
+    }
+    const auto ctr_sectors = Clock::now() - start;
+    const std::vector<u8> ctr_expected = out;
+
+    ctr.SetIV(iv);
+    start = Clock::now();
+    ctr.Transcode(nca.data(), size, out.data(), Op::Decrypt);
+    const auto ctr_whole = Clock::now() - start;
+    REQUIRE(out == ctr_expected);
+
+    printf("AES hardware acceleration: %s\n", Hardware::IsSupported() ? "yes" : "no");
+    printf("AES-XTS: %.0f MB/s per sector, %.0f MB/s whole reads\n",
+           MegabytesPerSecond(size, xts_sectors), MegabytesPerSecond(size, xts_whole));
+    printf("AES-CTR: %.0f MB/s per sector, %.0f MB/s whole reads\n",
+           MegabytesPerSecond(size, ctr_sectors), MegabytesPerSecond(size, ctr_whole));
+}
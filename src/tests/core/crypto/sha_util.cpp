@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <mbedtls/sha256.h>
+
+#include "common/common_types.h"
+#include "common/hex_util.h"
+#include "core/crypto/sha_util.h"
+#include "tests/core/test_util.h"
+
+namespace {
+using namespace Core::Crypto;
+using Tests::MakeData;
+
+SHA256Hash ReferenceSHA256(const u8* data, std::size_t size) {
+    SHA256Hash out;
+    mbedtls_sha256_ret(data, size, out.data(), 0);
+    return out;
+}
+
+SHA256Hash HashString(std::string_view text) {
+    return CalculateSHA256(reinterpret_cast<const u8*>(text.data()), text.size());
+}
+} // Anonymous namespace
+
+TEST_CASE("SHA256[Vectors]", "[core]") {
+    REQUIRE(HashString("") ==
+            Common::HexStringToArray<0x20>(
+                "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+    REQUIRE(HashString("abc") ==
+            Common::HexStringToArray<0x20>(
+                "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    REQUIRE(HashString("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+            Common::HexStringToArray<0x20>(
+                "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+}
+
+TEST_CASE("SHA256[Lengths]", "[core]") {
+    // Every padding case, hashed with the host instructions when available
+    const std::vector<u8> data = MakeData(0x1000);
+    for (std::size_t size = 0; size <= 0x200; ++size) {
+        REQUIRE(CalculateSHA256(data.data(), size) == ReferenceSHA256(data.data(), size));
+    }
+    REQUIRE(CalculateSHA256(data.data(), data.size()) ==
+            ReferenceSHA256(data.data(), data.size()));
+}
+
+TEST_CASE("SHA256[Blocks]", "[core]") {
+    // Large enough to be hashed in parallel, with a short last block
+    constexpr std::size_t block_size = 0x4000;
+    const std::vector<u8> data = MakeData(block_size * 40 + 0x123);
+    std::vector<SHA256Hash> hashes(41);
+    CalculateSHA256Blocks(data.data(), data.size(), block_size, hashes.data());
+    for (std::size_t i = 0; i < hashes.size(); ++i) {
+        const std::size_t offset = i * block_size;
+        const std::size_t size = std::min(block_size, data.size() - offset);
+        REQUIRE(hashes[i] == ReferenceSHA256(data.data() + offset, size));
+    }
+}
@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/memory/dmnt_cheat_types.h"
+#include "core/memory/dmnt_cheat_vm.h"
+
+namespace {
+using Core::Memory::CheatEntry;
+using Core::Memory::DmntCheatVm;
+
+/// Flat memory starting at address zero, every region of the test process is based there
+class TestCallbacks final : public DmntCheatVm::Callbacks {
+public:
+    void MemoryReadUnsafe(VAddr address, void* data, u64 size) override {
+        if (address + size > memory.size()) {
+            std::memset(data, 0, size);
+            return;
+        }
+        std::memcpy(data, memory.data() + address, size);
+    }
+
+    void MemoryWriteUnsafe(VAddr address, const void* data, u64 size) override {
+        if (address + size > memory.size()) {
+            return;
+        }
+        std::memcpy(memory.data() + address, data, size);
+    }
+
+    u64 HidKeysDown() override {
+        return 0;
+    }
+
+    void PauseProcess() override {}
+    void ResumeProcess() override {}
+    void DebugLog(u8 id, u64 value) override {}
+    void CommandLog(std::string_view data) override {}
+
+    bool IsCommandLogEnabled() override {
+        return false;
+    }
+
+    void FlushMemoryWrites() override {
+        ++num_flushes;
+    }
+
+    u32 Read32(VAddr address) const {
+        u32 value;
+        std::memcpy(&value, memory.data() + address, sizeof(value));
+        return value;
+    }
+
+    void Write32(VAddr address, u32 value) {
+        std::memcpy(memory.data() + address, &value, sizeof(value));
+    }
+
+    std::vector<u8> memory = std::vector<u8>(0x1000);
+    u32 num_flushes = 0;
+};
+
+struct TestVm {
+    TestVm() {
+        auto callbacks_ = std::make_unique<TestCallbacks>();
+        callbacks = callbacks_.get();
+        vm = std::make_unique<DmntCheatVm>(std::move(callbacks_));
+    }
+
+    bool Load(const std::vector<u32>& program) {
+        // Programs are spread over several cheats to exercise their concatenation
+        std::vector<CheatEntry> entries;
+        for (std::size_t offset = 0; offset < program.size(); offset += 0x100) {
+            CheatEntry& entry = entries.emplace_back();
+            entry.enabled = true;
+            entry.definition.num_opcodes =
+                static_cast<u32>(std::min<std::size_t>(0x100, program.size() - offset));
+            std::copy_n(program.begin() + offset, entry.definition.num_opcodes,
+                        entry.definition.opcodes.begin());
+        }
+        return vm->LoadProgram(entries);
+    }
+
+    void Execute() {
+        vm->Execute(metadata);
+    }
+
+    TestCallbacks* callbacks;
+    std::unique_ptr<DmntCheatVm> vm;
+    Core::Memory::CheatProcessMetadata metadata{};
+};
+
+enum class Cond : u32 {
+    GT = 1,
+    GE = 2,
+    LT = 3,
+    LE = 4,
+    EQ = 5,
+    NE = 6,
+};
+
+void StoreStatic32(std::vector<u32>& program, u32 address, u32 value) {
+    program.insert(program.end(), {0x04000000, address, value});
+}
+
+void BeginConditional32(std::vector<u32>& program, Cond cond, u32 address, u32 value) {
+    program.insert(program.end(), {0x14000000 | (static_cast<u32>(cond) << 16), address, value});
+}
+
+void Else(std::vector<u32>& program) {
+    program.push_back(0x21000000);
+}
+
+void EndConditional(std::vector<u32>& program) {
+    program.push_back(0x20000000);
+}
+
+void StartLoop(std::vector<u32>& program, u32 reg, u32 num_iters) {
+    program.insert(program.end(), {0x30000000 | (reg << 20), num_iters});
+}
+
+void EndLoop(std::vector<u32>& program, u32 reg) {
+    program.push_back(0x31000000 | (reg << 20));
+}
+
+void AddStatic32(std::vector<u32>& program, u32 reg, u32 value) {
+    program.insert(program.end(), {0x74000000 | (reg << 16), value});
+}
+
+void StoreRegister32(std::vector<u32>& program, u32 reg, u32 address) {
+    program.insert(program.end(), {0xA4000400 | (reg << 20), address});
+}
+} // Anonymous namespace
+
+TEST_CASE("DmntCheatVm[ConditionalBlocks]", "[core]") {
+    std::vector<u32> program;
+    BeginConditional32(program, Cond::EQ, 0x100, 5);
+    {
+        StoreStatic32(program, 0x200, 1);
+        BeginConditional32(program, Cond::NE, 0x100, 5);
+        StoreStatic32(program, 0x204, 2);
+        Else(program);
+        StoreStatic32(program, 0x208, 3);
+        EndConditional(program);
+    }
+    Else(program);
+    StoreStatic32(program, 0x20C, 4);
+    EndConditional(program);
+    StoreStatic32(program, 0x210, 5);
+
+    TestVm test;
+    REQUIRE(test.Load(program));
+    TestCallbacks& callbacks = *test.callbacks;
+
+    callbacks.Write32(0x100, 5);
+    test.Execute();
+    REQUIRE(callbacks.Read32(0x200) == 1);
+    REQUIRE(callbacks.Read32(0x204) == 0);
+    REQUIRE(callbacks.Read32(0x208) == 3);
+    REQUIRE(callbacks.Read32(0x20C) == 0);
+    REQUIRE(callbacks.Read32(0x210) == 5);
+
+    std::ranges::fill(callbacks.memory, u8{0});
+    callbacks.Write32(0x100, 6);
+    test.Execute();
+    REQUIRE(callbacks.Read32(0x200) == 0);
+    REQUIRE(callbacks.Read32(0x208) == 0);
+    REQUIRE(callbacks.Read32(0x20C) == 4);
+    REQUIRE(callbacks.Read32(0x210) == 5);
+    REQUIRE(callbacks.num_flushes == 2);
+}
+
+TEST_CASE("DmntCheatVm[Loop]", "[core]") {
+    std::vector<u32> program;
+    StartLoop(program, 0, 10);
+    AddStatic32(program, 1, 3);
+    BeginConditional32(program, Cond::EQ, 0x100, 1);
+    AddStatic32(program, 2, 1);
+    EndConditional(program);
+    EndLoop(program, 0);
+    StoreRegister32(program, 1, 0x300);
+    StoreRegister32(program, 2, 0x304);
+
+    TestVm test;
+    REQUIRE(test.Load(program));
+    test.Execute();
+    REQUIRE(test.callbacks->Read32(0x300) == 30);
+    REQUIRE(test.callbacks->Read32(0x304) == 0);
+
+    test.callbacks->Write32(0x100, 1);
+    test.Execute();
+    REQUIRE(test.callbacks->Read32(0x300) == 30);
+    REQUIRE(test.callbacks->Read32(0x304) == 10);
+}
+
+TEST_CASE("DmntCheatVm[Truncated]", "[core]") {
+    TestVm test;
+    std::vector<u32> program;
+    StoreStatic32(program, 0x400, 7);
+    BeginConditional32(program, Cond::EQ, 0x100, 1);
+    StoreStatic32(program, 0x404, 8);
+    // The block is never closed, skipping it ends the program
+    StoreStatic32(program, 0x408, 9);
+    program.pop_back();
+
+    REQUIRE(test.Load(program));
+    test.Execute();
+    REQUIRE(test.callbacks->Read32(0x400) == 7);
+    REQUIRE(test.callbacks->Read32(0x404) == 0);
+
+    test.callbacks->Write32(0x100, 1);
+    test.Execute();
+    REQUIRE(test.callbacks->Read32(0x404) == 8);
+    REQUIRE(test.callbacks->Read32(0x408) == 0);
+}
+
+TEST_CASE("DmntCheatVm[Throughput]", "[.][core]") {
+    // Typical cheat lists are made of conditional stores with a few register operations
+    std::vector<u32> program;
+    for (u32 i = 0; program.size() + 11 <= 990; ++i) {
+        const u32 address = (i * 4) % 0x800;
+        BeginConditional32(program, i % 2 == 0 ? Cond::EQ : Cond::NE, 0x800 + address, 0);
+        StoreStatic32(program, address, i);
+        Else(program);
+        StoreStatic32(program, address, ~i);
+        EndConditional(program);
+    }
+    while (program.size() < 1000) {
+        AddStatic32(program, 1, 1);
+    }
+    REQUIRE(program.size() == 1000);
+
+    TestVm test;
+    REQUIRE(test.Load(program));
+
+    constexpr int iterations = 10000;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        test.Execute();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double microseconds = std::chrono::duration<double, std::micro>(end - start).count();
+    printf("DmntCheatVm %zu dwords: %.2f us per execution\n", program.size(),
+           microseconds / iterations);
+}
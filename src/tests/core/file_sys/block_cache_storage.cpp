@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/file_sys/fssystem/fssystem_block_cache_storage.h"
+#include "tests/core/test_util.h"
+
+namespace {
+using namespace FileSys;
+using Tests::CountingStorage;
+using Tests::MakeData;
+using Tests::ReadMatches;
+
+constexpr size_t BlockSize = BlockCache::BlockSize;
+} // Anonymous namespace
+
+TEST_CASE("BlockCacheStorage[Read]", "[core]") {
+    BlockCache cache(1_MiB);
+    auto base = std::make_shared<CountingStorage>(MakeData(BlockSize * 8 + 0x123));
+    BlockCacheStorage storage(base, cache, false);
+    REQUIRE(storage.GetSize() == base->GetSize());
+
+    // Missing blocks are read at once, then served from the cache
+    REQUIRE(ReadMatches(storage, base->data, base->GetSize(), 0));
+    REQUIRE(base->reads == 1);
+    REQUIRE(ReadMatches(storage, base->data, base->GetSize(), 0));
+    REQUIRE(ReadMatches(storage, base->data, 0x345, BlockSize - 0x10));
+    REQUIRE(ReadMatches(storage, base->data, BlockSize, base->GetSize() - 0x20));
+    REQUIRE(base->reads == 1);
+
+    const BlockCacheStatistics stats = cache.GetStatistics();
+    REQUIRE(stats.misses == 9);
+    REQUIRE(stats.hits == 9 + 2 + 1);
+    REQUIRE(stats.HitRate() > 0.5);
+
+    // Reads past the end are clamped
+    u8 byte{};
+    REQUIRE(storage.Read(&byte, 1, base->GetSize()) == 0);
+}
+
+TEST_CASE("BlockCacheStorage[Eviction]", "[core]") {
+    // One block per shard
+    BlockCache cache(BlockSize * BlockCache::ShardCount);
+    auto base = std::make_shared<CountingStorage>(MakeData(BlockSize * 64));
+    BlockCacheStorage storage(base, cache, false);
+
+    REQUIRE(ReadMatches(storage, base->data, base->GetSize(), 0));
+    REQUIRE(ReadMatches(storage, base->data, base->GetSize(), 0));
+    REQUIRE(base->reads > 1);
+
+    // Shrinking the cache evicts blocks, disabling it reads through
+    cache.SetCapacity(0);
+    REQUIRE(cache.GetCapacity() == 0);
+    const size_t reads = base->reads;
+    REQUIRE(ReadMatches(storage, base->data, BlockSize, 0));
+    REQUIRE(ReadMatches(storage, base->data, BlockSize, 0));
+    REQUIRE(base->reads == reads + 2);
+}
+
+TEST_CASE("BlockCacheStorage[ReadAhead]", "[core]") {
+    BlockCache cache(4_MiB);
+    auto base = std::make_shared<CountingStorage>(MakeData(BlockSize * 128));
+    BlockCacheStorage storage(base, cache, true);
+
+    // Sequential reads start reading ahead
+    size_t offset = 0;
+    for (u32 i = 0; i <= BlockCacheStorage::SequentialReadsForReadAhead; ++i) {
+        REQUIRE(ReadMatches(storage, base->data, BlockSize, offset));
+        offset += BlockSize;
+    }
+    cache.WaitForReadAhead();
+    REQUIRE(cache.GetStatistics().read_ahead_blocks > 0);
+
+    // The following blocks were read ahead
+    const size_t reads = base->reads;
+    REQUIRE(ReadMatches(storage, base->data, BlockSize * 4, offset));
+    REQUIRE(base->reads == reads);
+    REQUIRE(cache.GetStatistics().read_ahead_hits >= 4);
+
+    // Random reads do not read ahead
+    cache.WaitForReadAhead();
+    cache.ResetStatistics();
+    REQUIRE(ReadMatches(storage, base->data, BlockSize, BlockSize * 100));
+    REQUIRE(ReadMatches(storage, base->data, BlockSize, BlockSize * 90));
+    cache.WaitForReadAhead();
+    REQUIRE(cache.GetStatistics().read_ahead_blocks == 0);
+}
+
+TEST_CASE("BlockCacheStorage[ReadAheadAfterDestruction]", "[core]") {
+    BlockCache cache(4_MiB);
+    auto base = std::make_shared<CountingStorage>(MakeData(BlockSize * 128));
+
+    // Hold the read ahead worker until the storage is gone
+    std::promise<void> release;
+    cache.QueueReadAhead([ready = release.get_future().share()] { ready.wait(); });
+    size_t reads;
+    {
+        BlockCacheStorage storage(base, cache, true);
+        size_t offset = 0;
+        for (u32 i = 0; i <= BlockCacheStorage::SequentialReadsForReadAhead; ++i) {
+            REQUIRE(ReadMatches(storage, base->data, BlockSize, offset));
+            offset += BlockSize;
+        }
+        reads = base->reads;
+    }
+    release.set_value();
+    cache.WaitForReadAhead();
+
+    // The queued read ahead neither read nor cached the blocks of the destroyed storage
+    REQUIRE(base->reads == reads);
+    REQUIRE(cache.GetStatistics().read_ahead_blocks == 0);
+}
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/path_util.h"
+#include "common/settings.h"
+#include "core/file_sys/romfs.h"
+#include "core/file_sys/vfs/vfs_lazy.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+#include "tests/core/test_util.h"
+
+namespace {
+using FileSys::VectorVfsDirectory;
+using FileSys::VectorVfsFile;
+using FileSys::VirtualDir;
+using FileSys::VirtualFile;
+using Tests::MakeData;
+
+std::shared_ptr<VectorVfsDirectory> MakeDir(std::string name,
+                                            std::vector<VirtualFile> files = {},
+                                            std::vector<VirtualDir> dirs = {}) {
+    return std::make_shared<VectorVfsDirectory>(std::move(files), std::move(dirs),
+                                                std::move(name));
+}
+
+VirtualFile MakeFile(std::string name, std::vector<u8> data) {
+    return std::make_shared<VectorVfsFile>(std::move(data), std::move(name));
+}
+
+// An IPS patch writing 0xEE over the 4 bytes at offset 0x10.
+std::vector<u8> MakeIPS() {
+    std::vector<u8> ips{'P', 'A', 'T', 'C', 'H', 0x00, 0x00, 0x10, 0x00, 0x04};
+    ips.insert(ips.end(), 4, 0xEE);
+    ips.insert(ips.end(), {'E', 'O', 'F'});
+    return ips;
+}
+
+VirtualFile BuildLayered(const VirtualFile& base_romfs, std::size_t mod_size) {
+    const auto mod = MakeDir(
+        "romfs", {MakeFile("new.bin", MakeData(0x30, 5))},
+        {MakeDir("dir", {MakeFile("b.bin", MakeData(mod_size, 6))})});
+    const auto mod_ext =
+        MakeDir("romfs_ext", {MakeFile("a.bin.ips", MakeIPS())},
+                {MakeDir("dir", {MakeFile("c.bin.stub", {})})});
+    return FileSys::CreateLayeredRomFS(base_romfs, {mod}, {mod_ext});
+}
+
+void CheckLayered(const VirtualFile& romfs, std::size_t mod_size) {
+    REQUIRE(romfs != nullptr);
+    const auto root = FileSys::ExtractRomFS(romfs);
+    REQUIRE(root != nullptr);
+
+    auto patched = MakeData(0x40, 1);
+    std::fill(patched.begin() + 0x10, patched.begin() + 0x14, u8{0xEE});
+    REQUIRE(root->GetFileRelative("a.bin")->ReadAllBytes() == patched);
+    REQUIRE(root->GetFileRelative("new.bin")->ReadAllBytes() == MakeData(0x30, 5));
+    REQUIRE(root->GetFileRelative("dir/b.bin")->ReadAllBytes() == MakeData(mod_size, 6));
+    REQUIRE(root->GetFileRelative("dir/c.bin") == nullptr);
+    REQUIRE(root->GetFileRelative("dir/sub/d.bin")->ReadAllBytes() == MakeData(0x1234, 4));
+}
+} // Anonymous namespace
+
+TEST_CASE("LazyVfsFile[Open]", "[core]") {
+    int opened = 0;
+    const auto data = MakeData(0x100, 3);
+    const FileSys::LazyVfsFile file(
+        [&] {
+            ++opened;
+            return MakeFile("source", data);
+        },
+        0x80, "lazy");
+
+    REQUIRE(file.GetSize() == 0x80);
+    REQUIRE(file.GetName() == "lazy");
+    REQUIRE(opened == 0);
+
+    // Reads are limited to the size of the lazy file
+    std::vector<u8> buffer(0x100);
+    REQUIRE(file.Read(buffer.data(), buffer.size(), 0x40) == 0x40);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + 0x40, data.begin() + 0x40));
+    REQUIRE(file.ReadAllBytes().size() == 0x80);
+    REQUIRE(opened == 1);
+}
+
+TEST_CASE("RomFSBuildContext[Layered]", "[core]") {
+    const auto cache_dir = std::filesystem::temp_directory_path() / "sudachi_layeredfs_test";
+    std::filesystem::remove_all(cache_dir);
+    std::filesystem::create_directories(cache_dir);
+    const auto old_cache_dir = Common::FS::GetSudachiPath(Common::FS::SudachiPath::CacheDir);
+    Common::FS::SetSudachiPath(Common::FS::SudachiPath::CacheDir, cache_dir);
+    Settings::values.lazy_layeredfs = true;
+
+    const auto base = MakeDir(
+        "base", {MakeFile("a.bin", MakeData(0x40, 1))},
+        {MakeDir("dir", {MakeFile("b.bin", MakeData(0x100, 2)), MakeFile("c.bin", {1, 2})},
+                 {MakeDir("sub", {MakeFile("d.bin", MakeData(0x1234, 4))})})});
+    const auto base_romfs = FileSys::CreateRomFS(base);
+    REQUIRE(base_romfs != nullptr);
+
+    // The first build walks the layers and caches the layout
+    const auto built = BuildLayered(base_romfs, 0x200);
+    CheckLayered(built, 0x200);
+    REQUIRE(std::filesystem::exists(cache_dir / "layeredfs"));
+
+    // The second build uses the cached layout and produces the same RomFS
+    const auto cached = BuildLayered(base_romfs, 0x200);
+    REQUIRE(cached->ReadAllBytes() == built->ReadAllBytes());
+    CheckLayered(cached, 0x200);
+
+    // Changing the size of a layer file changes the layout
+    CheckLayered(BuildLayered(base_romfs, 0x321), 0x321);
+
+    // The eager build matches the cached layout
+    Settings::values.lazy_layeredfs = false;
+    REQUIRE(BuildLayered(base_romfs, 0x200)->ReadAllBytes() == built->ReadAllBytes());
+    Settings::values.lazy_layeredfs = true;
+
+    Common::FS::SetSudachiPath(Common::FS::SudachiPath::CacheDir, old_cache_dir);
+    std::filesystem::remove_all(cache_dir);
+}
@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <mbedtls/sha256.h>
+
+#include "common/common_types.h"
+#include "common/settings.h"
+#include "core/crypto/sha_util.h"
+#include "core/file_sys/errors.h"
+#include "core/file_sys/fssystem/fssystem_hierarchical_sha256_storage.h"
+#include "core/file_sys/fssystem/fssystem_integrity_verification_storage.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+#include "tests/core/test_util.h"
+
+namespace {
+using namespace FileSys;
+using Tests::CountingStorage;
+using Tests::MakeData;
+using Tests::ReadMatches;
+
+constexpr size_t BlockSize = 0x4000;
+constexpr size_t HashSize = VerifiedBlockBitmap::HashSize;
+
+/// Hashes each block of data, padding the last block with zeros or hashing it as is
+std::vector<u8> MakeHashes(const std::vector<u8>& data, bool pad_last_block) {
+    std::vector<u8> hashes;
+    std::vector<u8> block(BlockSize);
+    for (size_t offset = 0; offset < data.size(); offset += BlockSize) {
+        const size_t size = std::min(BlockSize, data.size() - offset);
+        std::fill(block.begin(), block.end(), u8{0});
+        std::memcpy(block.data(), data.data() + offset, size);
+        hashes.resize(hashes.size() + HashSize);
+        mbedtls_sha256_ret(block.data(), pad_last_block ? BlockSize : size,
+                           hashes.data() + hashes.size() - HashSize, 0);
+    }
+    return hashes;
+}
+} // Anonymous namespace
+
+TEST_CASE("IntegrityVerificationStorage[Read]", "[core]") {
+    Settings::values.vfs_verify_integrity.SetValue(true);
+    const std::vector<u8> data = MakeData(BlockSize * 10 + 0x321);
+    auto data_storage = std::make_shared<CountingStorage>(data);
+    auto hash_storage = std::make_shared<CountingStorage>(MakeHashes(data, true));
+    IntegrityVerificationStorage storage;
+    storage.Initialize(hash_storage, data_storage, BlockSize, BlockSize, true);
+
+    // Unaligned reads verify the blocks they touch
+    REQUIRE(ReadMatches(storage, data, 0x100, BlockSize - 0x80));
+    REQUIRE(hash_storage->reads == 1);
+    REQUIRE(ReadMatches(storage, data, data.size(), 0));
+    REQUIRE(hash_storage->reads == 2);
+
+    // Verified blocks are not hashed again
+    REQUIRE(ReadMatches(storage, data, data.size(), 0));
+    REQUIRE(ReadMatches(storage, data, 0x10, data.size() - 0x10));
+    REQUIRE(hash_storage->reads == 2);
+    Settings::values.vfs_verify_integrity.SetValue(false);
+}
+
+TEST_CASE("HierarchicalSha256Storage[Read]", "[core]") {
+    Settings::values.vfs_verify_integrity.SetValue(true);
+    const std::vector<u8> data = MakeData(BlockSize * 10 + 0x321);
+    std::vector<u8> hashes = MakeHashes(data, false);
+    const auto master_hash = Core::Crypto::CalculateSHA256(hashes.data(), hashes.size());
+    std::vector<u8> hash_buffer(hashes.size());
+
+    auto data_storage = std::make_shared<CountingStorage>(data);
+    std::array<VirtualFile, HierarchicalSha256Storage::LayerCount> layers{
+        std::make_shared<VectorVfsFile>(std::vector<u8>(master_hash.begin(), master_hash.end())),
+        std::make_shared<VectorVfsFile>(hashes),
+        data_storage,
+    };
+    HierarchicalSha256Storage storage;
+    REQUIRE(storage.Initialize(layers.data(), HierarchicalSha256Storage::LayerCount, BlockSize,
+                               hash_buffer.data(), hash_buffer.size()) == ResultSuccess);
+
+    REQUIRE(ReadMatches(storage, data, 0x100, BlockSize - 0x80));
+    REQUIRE(ReadMatches(storage, data, data.size(), 0));
+    REQUIRE(ReadMatches(storage, data, BlockSize, data.size() - 0x10));
+
+    // Hash tables that don't match the master hash are rejected
+    hashes[0] ^= 1;
+    layers[1] = std::make_shared<VectorVfsFile>(hashes);
+    HierarchicalSha256Storage corrupted_storage;
+    REQUIRE(corrupted_storage.Initialize(layers.data(), HierarchicalSha256Storage::LayerCount,
+                                         BlockSize, hash_buffer.data(), hash_buffer.size()) ==
+            ResultHierarchicalSha256HashVerificationFailed);
+
+    // Without verification they are only logged, and the data is read as is
+    Settings::values.vfs_verify_integrity.SetValue(false);
+    HierarchicalSha256Storage unverified_storage;
+    REQUIRE(unverified_storage.Initialize(layers.data(), HierarchicalSha256Storage::LayerCount,
+                                          BlockSize, hash_buffer.data(), hash_buffer.size()) ==
+            ResultSuccess);
+    REQUIRE(ReadMatches(unverified_storage, data, data.size(), 0));
+}
+
+TEST_CASE("VerifiedBlockBitmap[Verify]", "[core]") {
+    const std::vector<u8> data = MakeData(BlockSize * 4);
+    std::vector<u8> hashes = MakeHashes(data, true);
+    hashes[HashSize * 2] ^= 1;
+
+    VerifiedBlockBitmap bitmap;
+    bitmap.Initialize(4, BlockSize);
+    REQUIRE(!bitmap.IsVerified(0, 1));
+
+    // Blocks are hashed once, corrupted or not
+    REQUIRE(bitmap.Verify(1, data.data() + BlockSize, BlockSize, hashes.data() + HashSize) == 0);
+    REQUIRE(bitmap.IsVerified(1, 1));
+    REQUIRE(!bitmap.IsVerified(0, 4));
+    REQUIRE(bitmap.Verify(0, data.data(), data.size(), hashes.data()) == 1);
+    REQUIRE(bitmap.Verify(0, data.data(), data.size(), hashes.data()) == 0);
+    REQUIRE(bitmap.IsVerified(0, 4));
+}
+
+TEST_CASE("IntegrityVerificationStorage[Throughput]", "[.][core]") {
+    using Clock = std::chrono::steady_clock;
+
+    // Synthetic RomFS data read twice in 1 MiB reads, hashing every block with mbedtls on each
+    // read and through the verification storage
+    constexpr size_t size = 0x2000000;
+    constexpr size_t read_size = 0x100000;
+    const std::vector<u8> data = MakeData(size);
+    const std::vector<u8> hashes = MakeHashes(data, true);
+    std::vector<u8> buffer(read_size);
+
+    auto start = Clock::now();
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t offset = 0; offset < size; offset += read_size) {
+            std::memcpy(buffer.data(), data.data() + offset, read_size);
+            for (size_t block = 0; block < read_size; block += BlockSize) {
+                std::array<u8, HashSize> hash;
+                mbedtls_sha256_ret(buffer.data() + block, BlockSize, hash.data(), 0);
+                REQUIRE(std::memcmp(hash.data(),
+                                    hashes.data() + (offset + block) / BlockSize * HashSize,
+                                    HashSize) == 0);
+            }
+        }
+    }
+    const auto rehashed = Clock::now() - start;
+
+    Settings::values.vfs_verify_integrity.SetValue(true);
+    IntegrityVerificationStorage storage;
+    storage.Initialize(std::make_shared<CountingStorage>(hashes),
+                       std::make_shared<CountingStorage>(data), BlockSize, BlockSize, true);
+    Settings::values.vfs_verify_integrity.SetValue(false);
+    std::array<Clock::duration, 2> verified;
+    for (auto& duration : verified) {
+        start = Clock::now();
+        for (size_t offset = 0; offset < size; offset += read_size) {
+            REQUIRE(storage.Read(buffer.data(), read_size, offset) == read_size);
+        }
+        duration = Clock::now() - start;
+    }
+
+    const auto megabytes_per_second = [](size_t bytes, Clock::duration duration) {
+        return static_cast<double>(bytes) / 1e6 /
+               std::chrono::duration<double>(duration).count();
+    };
+    printf("SHA-256 hardware acceleration: %s\n",
+           Core::Crypto::IsSHA256HardwareSupported() ? "yes" : "no");
+    printf("Integrity verification: %.0f MB/s rehashing every read, %.0f MB/s first read, "
+           "%.0f MB/s verified reads\n",
+           megabytes_per_second(size * 2, rehashed), megabytes_per_second(size, verified[0]),
+           megabytes_per_second(size, verified[1]));
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/path_util.h"
+#include "core/file_sys/title_metadata_index.h"
+
+namespace {
+std::string WriteTestFile(const char* name, std::size_t size) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    const std::vector<u8> data(size, 0xA5);
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write};
+    REQUIRE(file.WriteSpan(std::span{data}) == data.size());
+    return Common::FS::PathToUTF8String(path);
+}
+
+FileSys::TitleMetadataIndexEntry MakeEntry(u64 title_id) {
+    FileSys::TitleMetadataIndexEntry entry{};
+    entry.file_type = 7;
+    auto& title = entry.titles.emplace_back();
+    title.title_id = title_id;
+    title.name = "Title";
+    title.cnmt = {1, 2, 3};
+    title.nacp = std::vector<u8>(0x4000, 0x5A);
+    title.icon = {4, 5};
+    return entry;
+}
+} // Anonymous namespace
+
+TEST_CASE("TitleMetadataIndex[Persistence]", "[core]") {
+    const auto index_path = std::filesystem::temp_directory_path() / "sudachi_title_index.bin";
+    std::filesystem::remove(index_path);
+    const auto file_path = WriteTestFile("sudachi_title_index_file.nsp", 0x100);
+    const auto deleted_path = WriteTestFile("sudachi_title_index_deleted.nsp", 0x100);
+
+    {
+        FileSys::TitleMetadataIndex index{index_path};
+        REQUIRE(!index.Find(file_path));
+        index.Insert(file_path, MakeEntry(0x0100000000010000));
+        index.Insert(deleted_path, MakeEntry(0x0100000000020000));
+
+        // Files that don't exist on the host are not indexed
+        index.Insert(file_path + ".missing", MakeEntry(0x0100000000030000));
+        REQUIRE(!index.Find(file_path + ".missing"));
+
+        std::filesystem::remove(deleted_path);
+        index.Save();
+    }
+
+    {
+        FileSys::TitleMetadataIndex index{index_path};
+        const auto entry = index.Find(file_path);
+        REQUIRE(entry);
+        REQUIRE(entry->file_type == 7);
+        REQUIRE(entry->titles.size() == 1);
+        const auto expected = MakeEntry(0x0100000000010000).titles.front();
+        REQUIRE(entry->titles[0].title_id == expected.title_id);
+        REQUIRE(entry->titles[0].name == expected.name);
+        REQUIRE(entry->titles[0].cnmt == expected.cnmt);
+        REQUIRE(entry->titles[0].nacp == expected.nacp);
+        REQUIRE(entry->titles[0].icon == expected.icon);
+
+        // Entries of deleted files are dropped when saving
+        WriteTestFile("sudachi_title_index_deleted.nsp", 0x100);
+        REQUIRE(!index.Find(deleted_path));
+
+        // Entries of files that changed since they were indexed are ignored
+        WriteTestFile("sudachi_title_index_file.nsp", 0x200);
+        REQUIRE(!index.Find(file_path));
+    }
+
+    {
+        // Corrupted indexes are discarded
+        Common::FS::IOFile file{index_path, Common::FS::FileAccessMode::Write};
+        const std::vector<u8> garbage(0x40, 0xFF);
+        REQUIRE(file.WriteSpan(std::span{garbage}) == garbage.size());
+    }
+    {
+        FileSys::TitleMetadataIndex index{index_path};
+        WriteTestFile("sudachi_title_index_file.nsp", 0x100);
+        REQUIRE(!index.Find(file_path));
+    }
+
+    std::filesystem::remove(index_path);
+    std::filesystem::remove(file_path);
+    std::filesystem::remove(deleted_path);
+}
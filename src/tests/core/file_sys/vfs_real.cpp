@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/path_util.h"
+#include "core/file_sys/vfs/vfs_offset.h"
+#include "core/file_sys/vfs/vfs_real.h"
+#include "tests/core/test_util.h"
+
+namespace {
+using Tests::MakeData;
+
+std::filesystem::path WriteTestFile(const char* name, const std::vector<u8>& data,
+                                    const std::filesystem::path& directory =
+                                        std::filesystem::temp_directory_path()) {
+    const auto path = directory / name;
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write};
+    REQUIRE(file.WriteSpan(std::span{data}) == data.size());
+    return path;
+}
+} // Anonymous namespace
+
+TEST_CASE("RealVfsFile[MappedRead]", "[core]") {
+    const std::vector<u8> data = MakeData((2 << 20) + 0x123);
+    const auto path = WriteTestFile("sudachi_vfs_real_mapped.bin", data);
+    {
+        FileSys::RealVfsFilesystem filesystem;
+        const auto file = filesystem.OpenFile(path.string(), FileSys::OpenMode::Read);
+        REQUIRE(file != nullptr);
+
+        // Large read-only files are mapped and hand out views of their contents
+        const auto span = file->GetSpan(0x1000, 0x10);
+        REQUIRE(span.size() == 0x1000);
+        REQUIRE(std::equal(span.begin(), span.end(), data.begin() + 0x10));
+        REQUIRE(file->GetSpan(0x1000, data.size() - 0x10).size() == 0x10);
+        REQUIRE(file->GetSpan(1, data.size() + 1).empty());
+
+        std::vector<u8> buffer(0x2000);
+        REQUIRE(file->Read(buffer.data(), buffer.size(), data.size() - 0x1000) == 0x1000);
+        REQUIRE(std::equal(buffer.begin(), buffer.begin() + 0x1000, data.end() - 0x1000));
+        REQUIRE(file->ReadAllBytes() == data);
+
+        // Views are forwarded through offset files
+        const FileSys::OffsetVfsFile offset_file(file, 0x800, 0x400);
+        const auto offset_span = offset_file.GetSpan(0x1000, 0x10);
+        REQUIRE(offset_span.size() == 0x800 - 0x10);
+        REQUIRE(offset_span.data() == file->GetSpan(1, 0x410).data());
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("RealVfsFile[UnmappedRead]", "[core]") {
+    const std::vector<u8> data = MakeData(0x4000);
+    const auto path = WriteTestFile("sudachi_vfs_real_small.bin", data);
+    {
+        // Small files are read through the file stream
+        FileSys::RealVfsFilesystem filesystem;
+        const auto file = filesystem.OpenFile(path.string(), FileSys::OpenMode::Read);
+        REQUIRE(file != nullptr);
+        REQUIRE(file->GetSpan(0x10, 0).empty());
+        REQUIRE(file->ReadAllBytes() == data);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("RealVfsFile[WritableDirectoryRead]", "[core]") {
+    using Common::FS::SudachiPath;
+    const std::filesystem::path nand_path = Common::FS::GetSudachiPath(SudachiPath::NANDDir);
+    const auto directory = std::filesystem::temp_directory_path() / "sudachi_vfs_real_nand";
+    std::filesystem::create_directories(directory);
+    Common::FS::SetSudachiPath(SudachiPath::NANDDir, directory);
+
+    const std::vector<u8> data = MakeData((2 << 20) + 0x123);
+    const auto path = WriteTestFile("sudachi_vfs_real_nand.bin", data, directory);
+    {
+        // The emulator may truncate files in its own directories, so they are never mapped
+        FileSys::RealVfsFilesystem filesystem;
+        const auto file = filesystem.OpenFile(path.string(), FileSys::OpenMode::Read);
+        REQUIRE(file != nullptr);
+        REQUIRE(file->GetSpan(0x10, 0).empty());
+        REQUIRE(file->ReadAllBytes() == data);
+    }
+    std::filesystem::remove_all(directory);
+    Common::FS::SetSudachiPath(SudachiPath::NANDDir, nand_path);
+}
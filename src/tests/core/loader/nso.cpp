@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/lz4_compression.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+#include "core/loader/nso.h"
+
+namespace {
+using Loader::AppLoader_NSO;
+using Loader::NSOHeader;
+
+// Compressible data resembling code, repeating with small variations
+std::vector<u8> MakeSegment(std::size_t size, u32 seed) {
+    std::vector<u8> data(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<u8>((i % 61) * seed + (i / 4096) + ((i * seed) % 7 == 0 ? i : 0));
+    }
+    return data;
+}
+
+struct SyntheticNSO {
+    FileSys::VirtualFile file;
+    std::vector<u8> image;
+};
+
+// Builds an NSO with compressed .text and .rodata and an uncompressed .data segment
+SyntheticNSO MakeNSO(std::string name, std::size_t text_size, u32 seed) {
+    const std::array sizes{text_size, text_size / 4, std::size_t{0x3000}};
+
+    NSOHeader header{};
+    header.magic = Common::MakeMagic('N', 'S', 'O', '0');
+    header.flags = 0b011;
+    std::vector<u8> contents(sizeof(NSOHeader));
+    std::vector<u8> image;
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        const auto segment = MakeSegment(sizes[i], seed + static_cast<u32>(i));
+        const auto stored = header.IsSegmentCompressed(i)
+                                ? Common::Compression::CompressDataLZ4(segment.data(),
+                                                                       segment.size())
+                                : segment;
+        header.segments[i].offset = static_cast<u32>(contents.size());
+        header.segments[i].location = static_cast<u32>(image.size());
+        header.segments[i].size = static_cast<u32>(segment.size());
+        header.segments_compressed_size[i] = static_cast<u32>(stored.size());
+        contents.insert(contents.end(), stored.begin(), stored.end());
+        image.insert(image.end(), segment.begin(), segment.end());
+    }
+    header.segments[2].bss_size = 0x1000;
+    std::memcpy(contents.data(), &header, sizeof(NSOHeader));
+
+    return {std::make_shared<FileSys::VectorVfsFile>(std::move(contents), std::move(name)),
+            std::move(image)};
+}
+
+// An ExeFS as shipped by large titles, with a big main module and many small sdk modules
+std::vector<SyntheticNSO> MakeExeFS() {
+    std::vector<SyntheticNSO> exefs;
+    exefs.push_back(MakeNSO("rtld", 0x8000, 3));
+    exefs.push_back(MakeNSO("main", 0x1000000, 5));
+    for (u32 i = 0; i < 10; ++i) {
+        exefs.push_back(MakeNSO("subsdk" + std::to_string(i), 0x80000, 7 + i));
+    }
+    exefs.push_back(MakeNSO("sdk", 0x400000, 19));
+    return exefs;
+}
+
+// Decodes a module one segment after another, as the loader did before decoding in parallel
+std::vector<u8> DecodeSerially(const FileSys::VfsFile& file) {
+    NSOHeader header{};
+    file.ReadObject(&header);
+    std::vector<u8> image;
+    for (std::size_t i = 0; i < header.segments.size(); ++i) {
+        const auto& segment = header.segments[i];
+        const auto data = file.ReadBytes(header.segments_compressed_size[i], segment.offset);
+        image.resize(segment.location + segment.size);
+        if (header.IsSegmentCompressed(i)) {
+            REQUIRE(Common::Compression::DecompressDataLZ4(image.data() + segment.location,
+                                                           segment.size, data.data(),
+                                                           data.size()) ==
+                    static_cast<int>(segment.size));
+        } else {
+            std::memcpy(image.data() + segment.location, data.data(), data.size());
+        }
+    }
+    return image;
+}
+
+bool ImageMatches(const std::optional<Loader::NSOImage>& nso, const std::vector<u8>& expected) {
+    return nso && nso->image.size() == expected.size() &&
+           std::memcmp(nso->image.data(), expected.data(), expected.size()) == 0;
+}
+} // Anonymous namespace
+
+TEST_CASE("AppLoader_NSO[DecodeModules]", "[core]") {
+    const auto small = MakeNSO("small", 0x2000, 1);
+    const auto large = MakeNSO("large", 0x100000, 2);
+    const auto invalid = std::make_shared<FileSys::VectorVfsFile>(std::vector<u8>(0x200), "bad");
+
+    const std::vector<FileSys::VirtualFile> files{small.file, nullptr, invalid, large.file};
+    const auto decoded = AppLoader_NSO::DecodeModules(files);
+    REQUIRE(decoded.size() == files.size());
+    REQUIRE(ImageMatches(decoded[0], small.image));
+    REQUIRE(!decoded[1]);
+    REQUIRE(!decoded[2]);
+    REQUIRE(ImageMatches(decoded[3], large.image));
+    REQUIRE(decoded[3]->name == "large");
+    REQUIRE(decoded[3]->header.segments[2].bss_size == 0x1000);
+}
+
+TEST_CASE("AppLoader_NSO[StartupTime]", "[.][core]") {
+    using Clock = std::chrono::steady_clock;
+
+    const auto exefs = MakeExeFS();
+    std::vector<FileSys::VirtualFile> files;
+    std::size_t image_size = 0;
+    for (const auto& nso : exefs) {
+        files.push_back(nso.file);
+        image_size += nso.image.size();
+    }
+
+    auto start = Clock::now();
+    for (const auto& nso : exefs) {
+        REQUIRE(DecodeSerially(*nso.file) == nso.image);
+    }
+    const auto serial = Clock::now() - start;
+
+    start = Clock::now();
+    for (const auto& nso : exefs) {
+        REQUIRE(ImageMatches(AppLoader_NSO::DecodeModules({&nso.file, 1})[0], nso.image));
+    }
+    const auto per_module = Clock::now() - start;
+
+    start = Clock::now();
+    const auto decoded = AppLoader_NSO::DecodeModules(files);
+    const auto whole_exefs = Clock::now() - start;
+    for (std::size_t i = 0; i < exefs.size(); ++i) {
+        REQUIRE(ImageMatches(decoded[i], exefs[i].image));
+    }
+
+    const auto milliseconds = [](Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+    printf("NSO decoding of %zu modules (%zu MiB): %.1f ms serial, %.1f ms per module, "
+           "%.1f ms whole ExeFS\n",
+           exefs.size(), image_size >> 20, milliseconds(serial), milliseconds(per_module),
+           milliseconds(whole_exefs));
+}
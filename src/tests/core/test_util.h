@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/file_sys/fssystem/fs_i_storage.h"
+
+namespace Tests {
+
+/// Makes pseudo-random data, the same for each size and seed
+inline std::vector<u8> MakeData(std::size_t size, u32 seed = 0) {
+    std::vector<u8> data(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = static_cast<u8>(seed >> 16);
+    }
+    return data;
+}
+
+/// Storage over a vector, counting the reads made to it
+class CountingStorage : public FileSys::IReadOnlyStorage {
+public:
+    explicit CountingStorage(std::vector<u8> data_) : data(std::move(data_)) {}
+
+    size_t Read(u8* buffer, size_t size, size_t offset) const override {
+        ++reads;
+        if (offset >= data.size()) {
+            return 0;
+        }
+        size = std::min(size, data.size() - offset);
+        std::memcpy(buffer, data.data() + offset, size);
+        return size;
+    }
+
+    size_t GetSize() const override {
+        return data.size();
+    }
+
+    std::vector<u8> data;
+    mutable std::atomic<size_t> reads{};
+};
+
+/// Returns true if reading the storage gives the expected data, cut short at its end
+inline bool ReadMatches(const FileSys::IReadOnlyStorage& storage, const std::vector<u8>& data,
+                        size_t size, size_t offset) {
+    std::vector<u8> buffer(size);
+    const size_t expected_size = std::min(size, data.size() - offset);
+    return storage.Read(buffer.data(), size, offset) == expected_size &&
+           std::equal(buffer.begin(), buffer.begin() + expected_size, data.begin() + offset);
+}
+
+} // namespace Tests
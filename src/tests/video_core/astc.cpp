@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/cityhash.h"
+#include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "video_core/textures/astc.h"
+
+namespace {
+using Block = std::array<u8, 16>;
+
+/// Void extent blocks fill the whole block with a single RGBA16 color.
+Block MakeVoidExtentBlock(u16 r, u16 g, u16 b, u16 a) {
+    const u64 low = 0xFFFF'FFFF'FFFF'FDFCULL;
+    const u64 high = (static_cast<u64>(a) << 48) | (static_cast<u64>(b) << 32) |
+                     (static_cast<u64>(g) << 16) | static_cast<u64>(r);
+    Block block;
+    std::memcpy(block.data(), &low, sizeof(low));
+    std::memcpy(block.data() + sizeof(low), &high, sizeof(high));
+    return block;
+}
+
+/**
+ * Builds a valid LDR block out of random bits. Only the block mode, partition count and color
+ * endpoint mode are fixed, every color and weight bit pattern decodes to something valid.
+ * Partitions all share the same color endpoint mode.
+ */
+Block MakeBlock(u32& state, u32 block_mode, u32 num_partitions, u32 color_endpoint_mode) {
+    Block block;
+    for (u8& value : block) {
+        state = state * 1664525 + 1013904223;
+        value = static_cast<u8>(state >> 24);
+    }
+    u32 header = block_mode | ((num_partitions - 1) << 11);
+    u32 header_mask;
+    if (num_partitions == 1) {
+        header |= color_endpoint_mode << 13;
+        header_mask = (1U << 17) - 1;
+    } else {
+        // Keep the random partition index, the endpoint mode follows it
+        header |= (color_endpoint_mode << 2) << 23;
+        header_mask = ((1U << 29) - 1) & ~(0x3FFU << 13);
+    }
+    u32 low;
+    std::memcpy(&low, block.data(), sizeof(low));
+    low = (low & ~header_mask) | header;
+    std::memcpy(block.data(), &low, sizeof(low));
+    return block;
+}
+
+Block MakeRandomBlock(u32& state, u32 kind) {
+    // 4x4 weight grid with 3 bit weights
+    static constexpr u32 SINGLE_PLANE_MODE = 0x053;
+    // 4x4 weight grid with 2 bit weights in two planes
+    static constexpr u32 DUAL_PLANE_MODE = 0x442;
+    static constexpr u32 CEM_LDR_RGBA_DIRECT = 12;
+
+    switch (kind % 3) {
+    case 0:
+        return MakeBlock(state, SINGLE_PLANE_MODE, 1, CEM_LDR_RGBA_DIRECT);
+    case 1:
+        return MakeBlock(state, SINGLE_PLANE_MODE, 2, CEM_LDR_RGBA_DIRECT);
+    default:
+        return MakeBlock(state, DUAL_PLANE_MODE, 1, CEM_LDR_RGBA_DIRECT);
+    }
+}
+
+std::vector<u8> MakeRandomSurface(u32 num_blocks) {
+    std::vector<u8> data(num_blocks * sizeof(Block));
+    u32 state = 0x2545F491;
+    for (u32 i = 0; i < num_blocks; ++i) {
+        const Block block = MakeRandomBlock(state, i);
+        std::memcpy(data.data() + i * sizeof(Block), block.data(), sizeof(Block));
+    }
+    return data;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ASTC[VoidExtent]", "[video_core]") {
+    constexpr u32 width = 29;
+    constexpr u32 height = 13;
+    constexpr u32 depth = 3;
+    constexpr u32 block_width = 6;
+    constexpr u32 block_height = 5;
+    constexpr u32 cols = Common::DivCeil(width, block_width);
+    constexpr u32 rows = Common::DivCeil(height, block_height);
+
+    // Every slice gets its own color, so misplaced slices and edge blocks are caught
+    constexpr std::array<u32, depth> colors{0x80FF4020, 0x00102030, 0xFFFFFFFF};
+    std::vector<u8> data;
+    for (const u32 color : colors) {
+        const auto channel = [color](u32 shift) {
+            return static_cast<u16>(((color >> shift) & 0xFF) * 0x101);
+        };
+        const Block block = MakeVoidExtentBlock(channel(0), channel(8), channel(16), channel(24));
+        for (u32 i = 0; i < rows * cols; ++i) {
+            data.insert(data.end(), block.begin(), block.end());
+        }
+    }
+
+    std::vector<u8> output(width * height * depth * 4);
+    Tegra::Texture::ASTC::Decompress(data, width, height, depth, block_width, block_height,
+                                     output);
+
+    for (u32 z = 0; z < depth; ++z) {
+        for (u32 texel = 0; texel < width * height; ++texel) {
+            u32 value;
+            std::memcpy(&value, &output[(z * width * height + texel) * 4], sizeof(value));
+            REQUIRE(value == colors[z]);
+        }
+    }
+}
+
+TEST_CASE("ASTC[Golden]", "[video_core]") {
+    struct GoldenCase {
+        u32 block_width;
+        u32 block_height;
+        u32 block_mode;
+        u32 num_partitions;
+        u32 color_endpoint_mode;
+        u64 hash;
+    };
+    // Hashes of the output of the decoder this test was written against. Any change to them is a
+    // change in the decoded texels.
+    static constexpr std::array<GoldenCase, 13> cases{{
+        // 4x4 grid, 3 bit weights, RGBA direct
+        {4, 4, 0x053, 1, 12, 0x22F1ED228F884893ULL},
+        // 5x4 grid, trit weights, RGB direct
+        {5, 4, 0x0D1, 2, 8, 0x8AF612212B35BA0AULL},
+        // 6x5 grid, quint weights, luminance alpha direct
+        {6, 6, 0x172, 1, 4, 0x1B393FC84CCD9834ULL},
+        // 3x5 grid, trit and 1 bit weights in two planes, RGBA direct
+        {8, 6, 0x5EF, 1, 12, 0x97E697FD32AF3466ULL},
+        // 8x5 grid, 2 bit weights, luminance direct
+        {8, 8, 0x066, 1, 0, 0x9EBF7B4B4707B923ULL},
+        // 4x4 grid, 4 bit weights, RGB base and scale
+        {10, 10, 0x242, 3, 6, 0x0EE7A0D7C3BD67DAULL},
+        // 12x4 grid, 1 bit weights, RGB base and scale plus two alphas
+        {12, 12, 0x044, 2, 10, 0x1D86950E7A636257ULL},
+        // 4x4 grid, trit and 1 bit weights in two planes, luminance alpha direct
+        {6, 6, 0x443, 1, 4, 0x45504CBAFF008FA0ULL},
+        // 8x8 grid, 1 bit weights, RGBA base and offset
+        {12, 10, 0x544, 1, 13, 0xF9E7D62AFE6818A5ULL},
+        // 6x10 grid, 1 bit weights, RGB base and offset
+        {10, 10, 0x184, 1, 9, 0xE9CAC01AC9F75C81ULL},
+        // 5x8 grid, trit weights, luminance base and offset
+        {8, 8, 0x079, 2, 1, 0xE9897C193B93BCB2ULL},
+        // 4x6 grid, 3 bit weights, luminance alpha base and offset
+        {8, 6, 0x05F, 1, 5, 0x156CB9991CADD425ULL},
+        // 3x3 grid, 5 bit weights, luminance direct
+        {5, 5, 0x3BF, 4, 0, 0x9E52CCC0DC7F8FBEULL},
+    }};
+    // Partial blocks on the right and bottom edges are cropped
+    constexpr u32 cols = 8;
+    constexpr u32 rows = 6;
+
+    for (const GoldenCase& test : cases) {
+        const u32 width = cols * test.block_width - 1;
+        const u32 height = rows * test.block_height - 1;
+        std::vector<u8> data;
+        u32 state = test.block_mode;
+        for (u32 i = 0; i < rows * cols; ++i) {
+            const Block block =
+                MakeBlock(state, test.block_mode, test.num_partitions, test.color_endpoint_mode);
+            data.insert(data.end(), block.begin(), block.end());
+        }
+
+        std::vector<u8> output(width * height * 4);
+        Tegra::Texture::ASTC::Decompress(data, width, height, 1, test.block_width,
+                                         test.block_height, output);
+
+        INFO("Block mode " << test.block_mode);
+        REQUIRE(Common::CityHash64(reinterpret_cast<const char*>(output.data()), output.size()) ==
+                test.hash);
+    }
+}
+
+TEST_CASE("ASTC[Throughput]", "[.][video_core]") {
+    static constexpr std::array<std::pair<u32, u32>, 3> block_sizes{{{4, 4}, {6, 6}, {8, 8}}};
+    static constexpr std::array<u32, 3> surface_sizes{64, 256, 1024};
+
+    for (const auto [block_width, block_height] : block_sizes) {
+        for (const u32 size : surface_sizes) {
+            const u32 num_blocks =
+                Common::DivCeil(size, block_width) * Common::DivCeil(size, block_height);
+            const std::vector<u8> data = MakeRandomSurface(num_blocks);
+            std::vector<u8> output(size * size * 4);
+
+            const int iterations = static_cast<int>(std::max(1U, (1024U * 1024U) / (size * size)));
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                Tegra::Texture::ASTC::Decompress(data, size, size, 1, block_width, block_height,
+                                                 output);
+            }
+            const auto end = std::chrono::steady_clock::now();
+
+            const double seconds = std::chrono::duration<double>(end - start).count();
+            const double megabytes = static_cast<double>(output.size()) * iterations / 1048576.0;
+            printf("ASTC %ux%u %ux%u: %.1f MB/s\n", block_width, block_height, size, size,
+                   megabytes / seconds);
+        }
+    }
+}
@@ -0,0 +1,428 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/device_memory.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/host1x/gpu_device_memory_manager.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_interpreter.h"
+#include "video_core/macro/macro_trace_cache.h"
+#include "video_core/memory_manager.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/macro/macro_jit_x64.h"
+#endif
+
+namespace {
+using Tegra::Macro::ALUOperation;
+using Tegra::Macro::BranchCondition;
+using Tegra::Macro::Operation;
+using Tegra::Macro::ResultOperation;
+
+#ifdef ARCHITECTURE_x86_64
+using MacroJIT = Tegra::MacroJITx64;
+#else
+using MacroJIT = Tegra::MacroInterpreter;
+#endif
+
+using Scratch = std::array<u32, 0x100>;
+
+// Macros in these tests only send to the scratch registers, which have no side effects
+constexpr u32 SCRATCH =
+    static_cast<u32>(offsetof(Tegra::Engines::Maxwell3D::Regs, shadow_scratch) / sizeof(u32));
+constexpr u32 MACRO_METHOD = 0;
+
+u32 Method(u32 offset, u32 increment = 1) {
+    return (SCRATCH + offset) | (increment << 12);
+}
+
+u32 Alu(ALUOperation operation, ResultOperation result, u32 dst, u32 src_a, u32 src_b) {
+    Tegra::Macro::Opcode opcode{};
+    opcode.operation.Assign(Operation::ALU);
+    opcode.alu_operation.Assign(operation);
+    opcode.result_operation.Assign(result);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.src_b.Assign(src_b);
+    return opcode.raw;
+}
+
+u32 AddImmediate(ResultOperation result, u32 dst, u32 src_a, s32 immediate) {
+    Tegra::Macro::Opcode opcode{};
+    opcode.operation.Assign(Operation::AddImmediate);
+    opcode.result_operation.Assign(result);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(immediate);
+    return opcode.raw;
+}
+
+u32 Bitfield(Operation operation, ResultOperation result, u32 dst, u32 src_a, u32 src_b,
+             u32 src_bit, u32 size, u32 dst_bit) {
+    Tegra::Macro::Opcode opcode{};
+    opcode.operation.Assign(operation);
+    opcode.result_operation.Assign(result);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.src_b.Assign(src_b);
+    opcode.bf_src_bit.Assign(src_bit);
+    opcode.bf_size.Assign(size);
+    opcode.bf_dst_bit.Assign(dst_bit);
+    return opcode.raw;
+}
+
+u32 Read(u32 dst, u32 src_a, s32 immediate) {
+    Tegra::Macro::Opcode opcode{};
+    opcode.operation.Assign(Operation::Read);
+    opcode.result_operation.Assign(ResultOperation::Move);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(immediate);
+    return opcode.raw;
+}
+
+u32 Branch(BranchCondition condition, u32 src_a, s32 offset, bool annul) {
+    Tegra::Macro::Opcode opcode{};
+    opcode.operation.Assign(Operation::Branch);
+    opcode.branch_condition.Assign(condition);
+    opcode.branch_annul.Assign(annul ? 1 : 0);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(offset);
+    return opcode.raw;
+}
+
+u32 Exit(u32 raw) {
+    Tegra::Macro::Opcode opcode{raw};
+    opcode.is_exit.Assign(1);
+    return opcode.raw;
+}
+
+u32 Nop() {
+    return AddImmediate(ResultOperation::Move, 0, 0, 0);
+}
+
+struct Fixture {
+    const char* name;
+    std::vector<u32> code;
+    std::vector<u32> parameters;
+    /// Scratch register offsets and the values the macro leaves in them
+    std::vector<std::pair<u32, u32>> expected;
+};
+
+std::vector<Fixture> MakeFixtures() {
+    constexpr u32 a = 0x12345678;
+    constexpr u32 b = 0x0F0F00FF;
+    constexpr u32 x = 0xDEADBEEF;
+    constexpr u32 v = 0x1234;
+    const u32 set_method = AddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, Method(0));
+    const u32 fetch_r2 = AddImmediate(ResultOperation::IgnoreAndFetch, 2, 0, 0);
+
+    const auto send_alu = [](ALUOperation operation, u32 src_a, u32 src_b) {
+        return Alu(operation, ResultOperation::MoveAndSend, 0, src_a, src_b);
+    };
+    const auto send_immediate = [](u32 src_a, s32 immediate) {
+        return AddImmediate(ResultOperation::MoveAndSend, 0, src_a, immediate);
+    };
+    const auto send_bitfield = [](Operation operation, u32 src_a, u32 src_b, u32 src_bit,
+                                  u32 size, u32 dst_bit) {
+        return Bitfield(operation, ResultOperation::MoveAndSend, 0, src_a, src_b, src_bit, size,
+                        dst_bit);
+    };
+
+    std::vector<Fixture> fixtures;
+    fixtures.push_back({
+        "Sends",
+        {
+            set_method,
+            send_alu(ALUOperation::Add, 1, 0),
+            AddImmediate(ResultOperation::FetchAndSend, 2, 1, 2),
+            Exit(send_alu(ALUOperation::Add, 2, 1)),
+            Nop(),
+        },
+        {5, 9},
+        {{0, 5}, {1, 7}, {2, 14}},
+    });
+    fixtures.push_back({
+        "Alu",
+        {
+            set_method,
+            fetch_r2,
+            send_alu(ALUOperation::Add, 1, 2),
+            send_alu(ALUOperation::Subtract, 1, 2),
+            send_alu(ALUOperation::Xor, 1, 2),
+            send_alu(ALUOperation::Or, 1, 2),
+            send_alu(ALUOperation::And, 1, 2),
+            send_alu(ALUOperation::AndNot, 1, 2),
+            send_alu(ALUOperation::Nand, 1, 2),
+            send_alu(ALUOperation::Subtract, 2, 1),
+            Exit(send_alu(ALUOperation::Add, 1, 0)),
+            Nop(),
+        },
+        {a, b},
+        {{0, a + b},
+         {1, a - b},
+         {2, a ^ b},
+         {3, a | b},
+         {4, a & b},
+         {5, a & ~b},
+         {6, ~(a & b)},
+         {7, b - a},
+         {8, a}},
+    });
+    fixtures.push_back({
+        "Carry",
+        {
+            set_method,
+            fetch_r2,
+            Alu(ALUOperation::Add, ResultOperation::Move, 3, 1, 2),
+            send_alu(ALUOperation::AddWithCarry, 1, 2),
+            send_alu(ALUOperation::AddWithCarry, 2, 2),
+            Alu(ALUOperation::Subtract, ResultOperation::Move, 3, 2, 1),
+            send_alu(ALUOperation::SubtractWithBorrow, 2, 2),
+            send_alu(ALUOperation::SubtractWithBorrow, 1, 2),
+            send_alu(ALUOperation::AddWithCarry, 3, 2),
+            Exit(send_immediate(3, 0)),
+            Nop(),
+        },
+        {0xFFFFFFFF, 1},
+        {{0, 1}, {1, 3}, {2, 0xFFFFFFFF}, {3, 0xFFFFFFFD}, {4, 4}, {5, 2}},
+    });
+    fixtures.push_back({
+        "Bitfield",
+        {
+            set_method,
+            fetch_r2,
+            send_bitfield(Operation::ExtractInsert, 2, 1, 8, 8, 16),
+            send_bitfield(Operation::ExtractInsert, 1, 1, 28, 12, 24),
+            send_bitfield(Operation::ExtractShiftLeftImmediate, 2, 1, 0, 12, 4),
+            send_bitfield(Operation::ExtractShiftLeftRegister, 2, 1, 20, 8, 0),
+            send_bitfield(Operation::ExtractInsert, 1, 2, 0, 0, 0),
+            Exit(send_bitfield(Operation::ExtractShiftLeftImmediate, 2, 1, 0, 8, 28)),
+            Nop(),
+        },
+        {x, 4},
+        {{0, 0x00BE0004},
+         {1, 0x0DADBEEF},
+         {2, 0xBEE0},
+         {3, 0xEA0},
+         {4, 0xDEADBEEF},
+         {5, 0xE0000000}},
+    });
+    fixtures.push_back({
+        "Read",
+        {
+            AddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, Method(2)),
+            send_alu(ALUOperation::Add, 1, 0),
+            AddImmediate(ResultOperation::Move, 3, 0, SCRATCH),
+            Read(4, 3, 2),
+            set_method,
+            send_alu(ALUOperation::Add, 4, 0),
+            Read(5, 0, SCRATCH + 2),
+            Read(6, 3, 1),
+            send_alu(ALUOperation::Add, 5, 6),
+            Exit(send_immediate(3, 3)),
+            Nop(),
+        },
+        {v},
+        {{0, v}, {1, v}, {2, SCRATCH + 3}},
+    });
+    fixtures.push_back({
+        "DelayedLoop",
+        {
+            set_method,
+            AddImmediate(ResultOperation::Move, 2, 1, 0),
+            AddImmediate(ResultOperation::MoveAndSend, 2, 2, -1),
+            Branch(BranchCondition::NotZero, 2, -1, false),
+            AddImmediate(ResultOperation::Move, 3, 3, 1),
+            Exit(send_immediate(3, 0)),
+            Nop(),
+        },
+        {5},
+        {{0, 4}, {1, 3}, {2, 2}, {3, 1}, {4, 0}, {5, 5}},
+    });
+    for (const u32 condition : {0U, 1U}) {
+        fixtures.push_back({
+            condition == 0 ? "AnnulTaken" : "AnnulNotTaken",
+            {
+                set_method,
+                Branch(BranchCondition::Zero, 1, 3, true),
+                send_immediate(0, 0x11),
+                Branch(BranchCondition::Zero, 0, 2, true),
+                send_immediate(0, 0x22),
+                Exit(send_immediate(0, 0x33)),
+                Nop(),
+            },
+            {condition},
+            {{0, condition == 0 ? 0x22U : 0x11U}, {1, 0x33}, {2, 0}},
+        });
+    }
+    fixtures.push_back({
+        "ExitDelaySlot",
+        {
+            set_method,
+            Exit(send_immediate(0, 1)),
+            send_immediate(0, 2),
+            send_immediate(0, 3),
+        },
+        {0},
+        {{0, 1}, {1, 2}, {2, 0}},
+    });
+    fixtures.push_back({
+        "MethodAddress",
+        {
+            AddImmediate(ResultOperation::MoveAndSetMethodSend, 0, 0, Method(0x10, 3)),
+            send_immediate(0, 7),
+            AddImmediate(ResultOperation::FetchAndSetMethod, 2, 0, Method(0x20)),
+            send_alu(ALUOperation::Add, 2, 0),
+            AddImmediate(ResultOperation::MoveAndSetMethodFetchAndSend, 0, 0, Method(0x30, 2)),
+            AddImmediate(ResultOperation::IgnoreAndFetch, 3, 0, 0),
+            Exit(send_alu(ALUOperation::Add, 3, 0)),
+            Nop(),
+        },
+        {0, 0xAA, 0xBB, 0xCC},
+        {{0x10, 3}, {0x13, 7}, {0x20, 0xAA}, {0x30, 0xBB}, {0x32, 0xCC}},
+    });
+    return fixtures;
+}
+
+class MacroEnvironment {
+public:
+    template <typename Engine>
+    Scratch Run(const std::vector<u32>& code, const std::vector<u32>& parameters) {
+        maxwell3d.regs.shadow_scratch.fill(0);
+        Engine engine{maxwell3d};
+        for (const u32 word : code) {
+            engine.AddCode(MACRO_METHOD, word);
+        }
+        engine.Execute(MACRO_METHOD, parameters);
+        return maxwell3d.regs.shadow_scratch;
+    }
+
+    template <typename Engine>
+    double Time(const std::vector<u32>& code, const std::vector<u32>& parameters,
+                int iterations) {
+        Engine engine{maxwell3d};
+        for (const u32 word : code) {
+            engine.AddCode(MACRO_METHOD, word);
+        }
+        // The first execution compiles the macro
+        engine.Execute(MACRO_METHOD, parameters);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            engine.Execute(MACRO_METHOD, parameters);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+    }
+
+    Tegra::Engines::Maxwell3D& GetMaxwell3D() {
+        return maxwell3d;
+    }
+
+private:
+    Core::System system;
+    Core::DeviceMemory device_memory;
+    Tegra::MaxwellDeviceMemoryManager device_memory_manager{device_memory};
+    Tegra::MemoryManager memory_manager{system, device_memory_manager, 32, 1ULL << 31};
+    Tegra::Engines::Maxwell3D maxwell3d{system, memory_manager};
+};
+
+// Sends its second parameter to the scratch register selected by the first one
+class CountingMacro final : public Tegra::CachedMacro {
+public:
+    explicit CountingMacro(Tegra::Engines::Maxwell3D& maxwell3d_) : maxwell3d{maxwell3d_} {}
+
+    void Execute(const std::vector<u32>& parameters, [[maybe_unused]] u32 method) override {
+        ++executions;
+        maxwell3d.CallMethod(SCRATCH + parameters[0], parameters[1], true);
+    }
+
+    int executions{};
+
+private:
+    Tegra::Engines::Maxwell3D& maxwell3d;
+};
+} // Anonymous namespace
+
+TEST_CASE("Macro[Parity]", "[video_core]") {
+    const auto environment = std::make_unique<MacroEnvironment>();
+    for (const Fixture& fixture : MakeFixtures()) {
+        INFO(fixture.name);
+        const Scratch interpreted =
+            environment->Run<Tegra::MacroInterpreter>(fixture.code, fixture.parameters);
+        for (const auto& [offset, value] : fixture.expected) {
+            REQUIRE(interpreted[offset] == value);
+        }
+        const Scratch compiled = environment->Run<MacroJIT>(fixture.code, fixture.parameters);
+        REQUIRE(compiled == interpreted);
+    }
+}
+
+TEST_CASE("Macro[Throughput]", "[.][video_core]") {
+    // Arithmetic loop without sends, so the time is spent executing macro instructions
+    const std::vector<u32> code{
+        AddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, Method(0)),
+        AddImmediate(ResultOperation::Move, 2, 1, 0),
+        Alu(ALUOperation::Add, ResultOperation::Move, 3, 3, 2),
+        Alu(ALUOperation::Xor, ResultOperation::Move, 4, 4, 3),
+        Bitfield(Operation::ExtractInsert, ResultOperation::Move, 5, 5, 4, 3, 7, 9),
+        AddImmediate(ResultOperation::Move, 2, 2, -1),
+        Branch(BranchCondition::NotZero, 2, -4, true),
+        AddImmediate(ResultOperation::MoveAndSend, 0, 3, 0),
+        Exit(Alu(ALUOperation::Xor, ResultOperation::MoveAndSend, 0, 4, 5)),
+        Nop(),
+    };
+    const std::vector<u32> parameters{1000};
+
+    const auto environment = std::make_unique<MacroEnvironment>();
+    REQUIRE(environment->Run<MacroJIT>(code, parameters) ==
+            environment->Run<Tegra::MacroInterpreter>(code, parameters));
+
+    constexpr int iterations = 1000;
+    const double interpreter =
+        environment->Time<Tegra::MacroInterpreter>(code, parameters, iterations);
+    const double jit = environment->Time<MacroJIT>(code, parameters, iterations);
+    printf("Macro %u loop iterations: interpreter %.2f us, JIT %.2f us per execution\n",
+           parameters[0], interpreter, jit);
+}
+
+TEST_CASE("Macro[TraceCache]", "[video_core]") {
+    REQUIRE(Tegra::MacroTraceCache::IsPure(std::vector<u32>{
+        AddImmediate(ResultOperation::MoveAndSetMethodSend, 0, 1, Method(0)), Exit(Nop()), Nop()}));
+    REQUIRE(!Tegra::MacroTraceCache::IsPure(
+        std::vector<u32>{Read(1, 0, SCRATCH), Exit(Nop()), Nop()}));
+
+    const auto environment = std::make_unique<MacroEnvironment>();
+    Tegra::Engines::Maxwell3D& maxwell3d = environment->GetMaxwell3D();
+    auto& scratch = maxwell3d.regs.shadow_scratch;
+    CountingMacro program{maxwell3d};
+    Tegra::MacroTraceCache cache;
+
+    cache.Execute(maxwell3d, program, {1, 0x1234}, MACRO_METHOD);
+    REQUIRE(program.executions == 1);
+    REQUIRE(scratch[1] == 0x1234);
+
+    // The same parameters replay the recorded method without running the macro
+    scratch.fill(0);
+    cache.Execute(maxwell3d, program, {1, 0x1234}, MACRO_METHOD);
+    REQUIRE(program.executions == 1);
+    REQUIRE(cache.Hits() == 1);
+    REQUIRE(scratch[1] == 0x1234);
+    REQUIRE(!maxwell3d.IsTracingMacro());
+
+    cache.Execute(maxwell3d, program, {2, 0x5678}, MACRO_METHOD);
+    REQUIRE(program.executions == 2);
+    REQUIRE(scratch[2] == 0x5678);
+}
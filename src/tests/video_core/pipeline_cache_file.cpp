@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "shader_recompiler/stage.h"
+#include "video_core/pipeline_cache_file.h"
+
+namespace {
+constexpr u32 CACHE_VERSION = 7;
+constexpr std::array<char, 8> LEGACY_MAGIC_NUMBER{'y', 'u', 'z', 'u', 'c', 'a', 'c', 'h'};
+
+using Key = std::array<u64, 2>;
+
+/// Serializes a compute environment the way the legacy cache stored it, with its code inline
+void WriteLegacyComputeEnvironment(VideoCommon::PipelineCacheWriter& writer,
+                                   std::span<const u64> code) {
+    const u64 code_size{code.size_bytes()};
+    const u32 read_highest{static_cast<u32>(code_size - sizeof(u64))};
+    writer.Write(code_size)
+        .Write(u64{0})
+        .Write(u64{0})
+        .Write(u64{0})
+        .Write(u64{0})
+        .Write(u32{0})    // local_memory_size
+        .Write(u32{0})    // texture_bound
+        .Write(u32{0})    // start_address
+        .Write(u32{0})    // read_lowest
+        .Write(read_highest)
+        .Write(u32{1})    // viewport_transform_state
+        .Write(Shader::Stage::Compute)
+        .WriteBytes(std::span(reinterpret_cast<const char*>(code.data()), code.size_bytes()))
+        .Write(std::array<u32, 3>{32, 1, 1})
+        .Write(u32{0}); // shared_memory_size
+}
+
+void WriteFile(const std::filesystem::path& path, std::span<const char> data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+struct LoadedPipeline {
+    Key key;
+    u64 first_instruction;
+};
+
+std::vector<LoadedPipeline> Load(VideoCommon::PipelineCacheFile& cache,
+                                 const std::filesystem::path& path,
+                                 const VideoCommon::PipelineUsage& usage = {}) {
+    std::vector<LoadedPipeline> loaded;
+    cache.Load<Key, Key>(
+        std::stop_token{}, path, CACHE_VERSION, usage,
+        [&loaded](const Key& key, VideoCommon::FileEnvironment env) {
+            loaded.push_back({key, env.ReadInstruction(0)});
+        },
+        [](const Key&, std::vector<VideoCommon::FileEnvironment>) { FAIL("Unexpected pipeline"); });
+    return loaded;
+}
+
+class TemporaryCache {
+public:
+    TemporaryCache() {
+        path = std::filesystem::temp_directory_path() / "sudachi_pipeline_cache_test.bin";
+        std::filesystem::remove(path);
+    }
+
+    ~TemporaryCache() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        std::filesystem::remove(std::filesystem::path{path} += ".compact", ec);
+    }
+
+    std::filesystem::path path;
+};
+} // Anonymous namespace
+
+TEST_CASE("PipelineCacheFile[LegacyConversion]", "[video_core]") {
+    TemporaryCache temp;
+
+    // Three pipelines, two of them sharing the same program
+    const std::array<u64, 2> shared_code{0x1111, 0x2222};
+    const std::array<u64, 1> other_code{0x3333};
+    std::vector<char> legacy;
+    VideoCommon::PipelineCacheWriter writer{legacy};
+    writer.WriteBytes(LEGACY_MAGIC_NUMBER).Write(CACHE_VERSION);
+    for (u64 i = 0; i < 3; ++i) {
+        writer.Write(u32{1});
+        WriteLegacyComputeEnvironment(writer, i == 1 ? std::span<const u64>(other_code)
+                                                     : std::span<const u64>(shared_code));
+        writer.Write(Key{i, i});
+    }
+    // Torn record at the end of the file
+    writer.Write(u32{1}).Write(u64{0x100});
+    WriteFile(temp.path, legacy);
+
+    VideoCommon::PipelineCacheFile cache;
+    const auto loaded{Load(cache, temp.path)};
+    REQUIRE(loaded.size() == 3);
+    for (const LoadedPipeline& pipeline : loaded) {
+        REQUIRE(pipeline.key[0] == pipeline.key[1]);
+        REQUIRE(pipeline.first_instruction == (pipeline.key[0] == 1 ? 0x3333 : 0x1111));
+    }
+
+    // The converted cache is loaded as is on the next boot
+    const u64 converted_size{std::filesystem::file_size(temp.path)};
+    VideoCommon::PipelineCacheFile reloaded;
+    REQUIRE(Load(reloaded, temp.path).size() == 3);
+    REQUIRE(std::filesystem::file_size(temp.path) == converted_size);
+}
+
+TEST_CASE("PipelineCacheFile[TornTail]", "[video_core]") {
+    TemporaryCache temp;
+    {
+        std::vector<char> legacy;
+        VideoCommon::PipelineCacheWriter writer{legacy};
+        const std::array<u64, 1> code{0x4444};
+        writer.WriteBytes(LEGACY_MAGIC_NUMBER).Write(CACHE_VERSION).Write(u32{1});
+        WriteLegacyComputeEnvironment(writer, code);
+        writer.Write(Key{5, 5});
+        WriteFile(temp.path, legacy);
+        VideoCommon::PipelineCacheFile cache;
+        REQUIRE(Load(cache, temp.path).size() == 1);
+    }
+    const u64 valid_size{std::filesystem::file_size(temp.path)};
+    {
+        std::ofstream file(temp.path, std::ios::binary | std::ios::app);
+        file << "partial chunk";
+    }
+    VideoCommon::PipelineCacheFile cache;
+    REQUIRE(Load(cache, temp.path).size() == 1);
+    REQUIRE(std::filesystem::file_size(temp.path) == valid_size);
+
+    const auto compacted{std::filesystem::path{temp.path} += ".compact"};
+    REQUIRE(VideoCommon::PipelineCacheFile::Compact(temp.path, compacted, sizeof(Key),
+                                                    sizeof(Key)));
+    VideoCommon::PipelineCacheFile compacted_cache;
+    const auto loaded{Load(compacted_cache, compacted)};
+    REQUIRE(loaded.size() == 1);
+    REQUIRE(loaded[0].first_instruction == 0x4444);
+}
+
+TEST_CASE("PipelineCacheFile[TornHeader]", "[video_core]") {
+    TemporaryCache temp;
+    {
+        std::vector<char> legacy;
+        VideoCommon::PipelineCacheWriter writer{legacy};
+        const std::array<u64, 1> code{0x5555};
+        writer.WriteBytes(LEGACY_MAGIC_NUMBER).Write(CACHE_VERSION).Write(u32{1});
+        WriteLegacyComputeEnvironment(writer, code);
+        writer.Write(Key{6, 6});
+        WriteFile(temp.path, legacy);
+        VideoCommon::PipelineCacheFile cache;
+        REQUIRE(Load(cache, temp.path).size() == 1);
+    }
+    std::vector<char> converted(std::filesystem::file_size(temp.path));
+    std::ifstream{temp.path, std::ios::binary}.read(converted.data(),
+                                                    static_cast<std::streamsize>(converted.size()));
+
+    // Torn header writes keeping the magic, cache version and format version are discarded
+    for (const size_t size : {13U, 15U}) {
+        WriteFile(temp.path, std::span{converted}.first(size));
+        VideoCommon::PipelineCacheFile cache;
+        REQUIRE(Load(cache, temp.path).empty());
+        REQUIRE(!std::filesystem::exists(temp.path));
+    }
+}
+
+TEST_CASE("PipelineCacheFile[UsageOrder]", "[video_core]") {
+    TemporaryCache temp;
+    std::vector<char> legacy;
+    VideoCommon::PipelineCacheWriter writer{legacy};
+    const std::array<u64, 1> code{0x5555};
+    writer.WriteBytes(LEGACY_MAGIC_NUMBER).Write(CACHE_VERSION);
+    for (u64 i = 0; i < 8; ++i) {
+        writer.Write(u32{1});
+        WriteLegacyComputeEnvironment(writer, code);
+        writer.Write(Key{i, 0});
+    }
+    WriteFile(temp.path, legacy);
+
+    VideoCommon::PipelineUsage usage;
+    usage.Record(Key{6, 0});
+    usage.Record(Key{3, 0});
+    VideoCommon::PipelineCacheFile cache;
+    const auto loaded{Load(cache, temp.path, usage)};
+    REQUIRE(loaded.size() == 8);
+    REQUIRE(loaded[0].key[0] == 6);
+    REQUIRE(loaded[1].key[0] == 3);
+}
@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "video_core/textures/decoders.h"
+
+namespace {
+using namespace Tegra::Texture;
+
+constexpr SwizzleTable SWIZZLE_TABLE = MakeSwizzleTable();
+
+struct Layout {
+    u32 gobs_in_x;
+    u32 height;
+    u32 block_height;
+    u32 block_depth;
+};
+
+/// Straightforward per byte block linear addressing, used as the reference for the fast paths.
+u32 SwizzledOffset(const Layout& layout, u32 x, u32 y, u32 z) {
+    const u32 block_bytes = GOB_SIZE << (layout.block_height + layout.block_depth);
+    const u32 block_row_bytes = layout.gobs_in_x * block_bytes;
+    const u32 slice_bytes =
+        Common::DivCeil(layout.height, GOB_SIZE_Y << layout.block_height) * block_row_bytes;
+    const u32 gob_y = y / GOB_SIZE_Y;
+    const u32 gob_y_in_block = gob_y & ((1U << layout.block_height) - 1);
+    const u32 z_in_block = z & ((1U << layout.block_depth) - 1);
+    return (z >> layout.block_depth) * slice_bytes +
+           (gob_y >> layout.block_height) * block_row_bytes + (x / GOB_SIZE_X) * block_bytes +
+           z_in_block * (GOB_SIZE << layout.block_height) + gob_y_in_block * GOB_SIZE +
+           SWIZZLE_TABLE[y % GOB_SIZE_Y][x % GOB_SIZE_X];
+}
+
+std::vector<u8> MakePattern(std::size_t size) {
+    std::vector<u8> data(size);
+    u32 state = 0x12345678;
+    for (u8& value : data) {
+        state = state * 1664525 + 1013904223;
+        value = static_cast<u8>(state >> 24);
+    }
+    return data;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Swizzle[Texture]", "[video_core]") {
+    for (const u32 bytes_per_pixel : {1U, 2U, 4U, 8U, 16U}) {
+        for (const u32 width : {1U, 16U, 33U, 64U, 100U, 256U}) {
+            for (const u32 height : {1U, 7U, 16U, 45U}) {
+                for (const auto [depth, block_depth] : {std::pair{1U, 0U}, {3U, 1U}, {5U, 2U}}) {
+                    for (u32 block_height = 0; block_height <= 5; ++block_height) {
+                        const u32 pitch = width * bytes_per_pixel;
+                        const Layout layout{
+                            .gobs_in_x = Common::DivCeil(pitch, GOB_SIZE_X),
+                            .height = height,
+                            .block_height = block_height,
+                            .block_depth = block_depth,
+                        };
+                        const std::size_t swizzled_size = CalculateSize(
+                            true, bytes_per_pixel, width, height, depth, block_height, block_depth);
+                        const std::size_t linear_size = pitch * height * depth;
+
+                        const std::vector<u8> swizzled = MakePattern(swizzled_size);
+                        std::vector<u8> linear(linear_size);
+                        UnswizzleTexture(linear, swizzled, bytes_per_pixel, width, height, depth,
+                                         block_height, block_depth);
+
+                        std::vector<u8> reswizzled(swizzled_size);
+                        SwizzleTexture(reswizzled, linear, bytes_per_pixel, width, height, depth,
+                                       block_height, block_depth);
+
+                        bool matches = true;
+                        for (u32 z = 0; z < depth; ++z) {
+                            for (u32 y = 0; y < height; ++y) {
+                                for (u32 x = 0; x < pitch; ++x) {
+                                    const u32 offset = SwizzledOffset(layout, x, y, z);
+                                    const u8 expected = swizzled[offset];
+                                    matches &= linear[(z * height + y) * pitch + x] == expected;
+                                    matches &= reswizzled[offset] == expected;
+                                }
+                            }
+                        }
+                        INFO("bpp=" << bytes_per_pixel << " width=" << width
+                                    << " height=" << height << " depth=" << depth
+                                    << " block_height=" << block_height
+                                    << " block_depth=" << block_depth);
+                        REQUIRE(matches);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Swizzle[Subrect]", "[video_core]") {
+    constexpr u32 width = 300;
+    constexpr u32 height = 70;
+    for (const u32 bytes_per_pixel : {1U, 2U, 3U, 4U, 6U, 8U, 12U, 16U}) {
+        for (u32 block_height = 0; block_height <= 4; ++block_height) {
+            for (const auto [origin_x, origin_y] : {std::pair{0U, 0U}, {5U, 3U}, {64U, 8U}}) {
+                for (const auto [extent_x, extent_y] :
+                     {std::pair{1U, 1U}, {130U, 17U}, {200U, 40U}}) {
+                    const u32 pitch = extent_x * bytes_per_pixel;
+                    const Layout layout{
+                        .gobs_in_x = Common::DivCeil(width * bytes_per_pixel, GOB_SIZE_X),
+                        .height = height,
+                        .block_height = block_height,
+                        .block_depth = 0,
+                    };
+                    const std::size_t swizzled_size =
+                        CalculateSize(true, bytes_per_pixel, width, height, 1, block_height, 0);
+
+                    const std::vector<u8> swizzled = MakePattern(swizzled_size);
+                    std::vector<u8> linear(pitch * extent_y);
+                    UnswizzleSubrect(linear, swizzled, bytes_per_pixel, width, height, 1,
+                                     origin_x, origin_y, extent_x, extent_y, block_height, 0,
+                                     pitch);
+
+                    std::vector<u8> reswizzled(swizzled_size);
+                    SwizzleSubrect(reswizzled, linear, bytes_per_pixel, width, height, 1,
+                                   origin_x, origin_y, extent_x, extent_y, block_height, 0, pitch);
+
+                    // Pixels are moved as a whole from the address of their first byte, pixels of
+                    // non power of two sizes may overlap their neighbours when swizzled.
+                    const bool exact_pixels = std::has_single_bit(bytes_per_pixel);
+                    bool matches = true;
+                    for (u32 line = 0; line < extent_y; ++line) {
+                        for (u32 column = 0; column < extent_x; ++column) {
+                            const u32 offset = SwizzledOffset(
+                                layout, (origin_x + column) * bytes_per_pixel, origin_y + line, 0);
+                            for (u32 byte = 0; byte < bytes_per_pixel; ++byte) {
+                                const u8 expected = swizzled[offset + byte];
+                                matches &=
+                                    linear[line * pitch + column * bytes_per_pixel + byte] ==
+                                    expected;
+                                matches &= !exact_pixels || reswizzled[offset + byte] == expected;
+                            }
+                        }
+                    }
+                    INFO("bpp=" << bytes_per_pixel << " block_height=" << block_height
+                                << " origin=" << origin_x << "," << origin_y
+                                << " extent=" << extent_x << "," << extent_y);
+                    REQUIRE(matches);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Swizzle[Throughput]", "[.][video_core]") {
+    constexpr u32 width = 512;
+    constexpr u32 height = 256;
+    constexpr u32 bytes_per_pixel = 4;
+    constexpr u32 block_height = 4;
+    constexpr int iterations = 256;
+
+    const std::size_t swizzled_size =
+        CalculateSize(true, bytes_per_pixel, width, height, 1, block_height, 0);
+    const std::vector<u8> swizzled = MakePattern(swizzled_size);
+    std::vector<u8> linear(width * height * bytes_per_pixel);
+    std::vector<u8> reswizzled(swizzled_size);
+
+    const auto measure = [&](const char* name, auto&& func) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            func();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        const double megabytes = static_cast<double>(linear.size()) * iterations / (1024 * 1024);
+        printf("%s: %.1f MB/s\n", name, megabytes / seconds);
+    };
+    measure("UnswizzleTexture", [&] {
+        UnswizzleTexture(linear, swizzled, bytes_per_pixel, width, height, 1, block_height, 0);
+    });
+    measure("SwizzleTexture", [&] {
+        SwizzleTexture(reswizzled, linear, bytes_per_pixel, width, height, 1, block_height, 0);
+    });
+    REQUIRE(reswizzled == swizzled);
+}
@@ -411,6 +411,10 @@ void Maxwell3D::CallMacroMethod(u32 method, const std::vector<u32>& parameters)
 }
 
 void Maxwell3D::CallMethod(u32 method, u32 method_argument, bool is_last_call) {
+    if (macro_trace) [[unlikely]] {
+        macro_trace->push_back({method, method_argument});
+    }
+
     // It is an error to write to a register other than the current macro's ARG register before
     // it has finished execution.
     if (executing_macro != 0) {
@@ -3117,6 +3117,15 @@ public:
         return current_macro_dirty;
     }
 
+    /// Records every method written through CallMethod into trace, or stops recording on nullptr
+    void SetMacroTrace(std::vector<Macro::MethodCall>* trace) {
+        macro_trace = trace;
+    }
+
+    bool IsTracingMacro() const {
+        return macro_trace != nullptr;
+    }
+
     u32 GetMaxCurrentVertices();
 
     size_t EstimateIndexBufferSize();
@@ -3201,6 +3210,8 @@ private:
 
     /// Interpreter for the macro codes uploaded to the GPU.
     std::unique_ptr<MacroEngine> macro_engine;
+    /// Output of the macro being recorded by a macro trace cache, if any.
+    std::vector<Macro::MethodCall>* macro_trace = nullptr;
 
     Upload::State upload_state;
 
@@ -36,14 +36,13 @@ static void RunThread(std::stop_token stop_token, Core::System& system,
 
     CommandDataContainer next;
 
-    while (!stop_token.stop_requested()) {
-        state.queue.PopWait(next, stop_token);
-        if (stop_token.stop_requested()) {
-            break;
-        }
+    const auto execute = [&] {
         if (auto* submit_list = std::get_if<SubmitListCommand>(&next.data)) {
             scheduler.Push(submit_list->channel, std::move(submit_list->entries));
         } else if (std::holds_alternative<GPUTickCommand>(next.data)) {
+            // Sync requests registered from now on may be missed and need a tick of their own
+            u64 expected = next.fence;
+            state.pending_tick_fence.compare_exchange_strong(expected, 0);
             system.GPU().TickWork();
         } else if (const auto* flush = std::get_if<FlushRegionCommand>(&next.data)) {
             rasterizer->FlushRegion(flush->addr, flush->size);
@@ -59,6 +58,25 @@ static void RunThread(std::stop_token stop_token, Core::System& system,
             std::scoped_lock lk{state.write_lock};
             state.cv.notify_all();
         }
+    };
+
+    while (!stop_token.stop_requested()) {
+        state.queue.PopWait(next, stop_token);
+        if (stop_token.stop_requested()) {
+            break;
+        }
+        // Drain everything queued while we were busy before going back to sleep
+        u64 batch_size = 0;
+        do {
+            execute();
+            ++batch_size;
+        } while (!stop_token.stop_requested() && state.queue.TryPop(next));
+
+        state.batches.fetch_add(1, std::memory_order_relaxed);
+        state.commands.fetch_add(batch_size, std::memory_order_relaxed);
+        if (batch_size > state.largest_batch.load(std::memory_order_relaxed)) {
+            state.largest_batch.store(batch_size, std::memory_order_relaxed);
+        }
     }
 }
 
@@ -95,6 +113,16 @@ void ThreadManager::FlushRegion(DAddr addr, u64 size) {
 }
 
 void ThreadManager::TickGPU() {
+    if (is_async) {
+        // A tick that is still the last queued command and has not started yet will process every
+        // sync request registered so far, queueing another one behind it would be redundant.
+        std::scoped_lock lk{state.write_lock};
+        const u64 pending_tick_fence = state.pending_tick_fence.load();
+        if (pending_tick_fence != 0 && pending_tick_fence == state.last_fence) {
+            state.coalesced_ticks.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
     PushCommand(GPUTickCommand());
 }
 
@@ -115,6 +143,9 @@ u64 ThreadManager::PushCommand(CommandData&& command_data, bool block) {
 
     std::unique_lock lk(state.write_lock);
     const u64 fence{++state.last_fence};
+    if (std::holds_alternative<GPUTickCommand>(command_data)) {
+        state.pending_tick_fence.store(fence);
+    }
     state.queue.EmplaceWait(std::move(command_data), fence, block);
 
     if (block) {
@@ -126,4 +157,13 @@ u64 ThreadManager::PushCommand(CommandData&& command_data, bool block) {
     return fence;
 }
 
+CommandStatistics ThreadManager::GetStatistics() const {
+    return {
+        .batches = state.batches.load(std::memory_order_relaxed),
+        .commands = state.commands.load(std::memory_order_relaxed),
+        .largest_batch = state.largest_batch.load(std::memory_order_relaxed),
+        .coalesced_ticks = state.coalesced_ticks.load(std::memory_order_relaxed),
+    };
+}
+
 } // namespace VideoCommon::GPUThread
@@ -87,6 +87,14 @@ struct CommandDataContainer {
     bool block{};
 };
 
+/// Counters describing how commands reach the GPU thread
+struct CommandStatistics {
+    u64 batches{};         ///< Number of times the GPU thread drained the queue
+    u64 commands{};        ///< Number of commands executed
+    u64 largest_batch{};   ///< Most commands executed in a single drain
+    u64 coalesced_ticks{}; ///< GPU ticks folded into a tick already waiting in the queue
+};
+
 /// Struct used to synchronize the GPU thread
 struct SynchState final {
     using CommandQueue = Common::MPSCQueue<CommandDataContainer>;
@@ -94,7 +102,13 @@ struct SynchState final {
     CommandQueue queue;
     u64 last_fence{};
     std::atomic<u64> signaled_fence{};
+    std::atomic<u64> pending_tick_fence{};
     std::condition_variable_any cv;
+
+    std::atomic<u64> batches{};
+    std::atomic<u64> commands{};
+    std::atomic<u64> largest_batch{};
+    std::atomic<u64> coalesced_ticks{};
 };
 
 /// Class used to manage the GPU thread
@@ -121,6 +135,9 @@ public:
 
     void TickGPU();
 
+    /// Returns the command submission counters of the GPU thread
+    [[nodiscard]] CommandStatistics GetStatistics() const;
+
 private:
     /// Pushes a command to be executed by the GPU thread
     u64 PushCommand(CommandData&& command_data, bool block = false);
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2020 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <fstream>
 #include <optional>
@@ -18,6 +20,7 @@
 #include "video_core/macro/macro.h"
 #include "video_core/macro/macro_hle.h"
 #include "video_core/macro/macro_interpreter.h"
+#include "video_core/macro/macro_trace_cache.h"
 
 #ifdef ARCHITECTURE_x86_64
 #include "video_core/macro/macro_jit_x64.h"
@@ -57,7 +60,11 @@ static void Dump(u64 hash, std::span<const u32> code, bool decompiled = false) {
 MacroEngine::MacroEngine(Engines::Maxwell3D& maxwell3d_)
     : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d_)}, maxwell3d{maxwell3d_} {}
 
-MacroEngine::~MacroEngine() = default;
+MacroEngine::~MacroEngine() {
+    if (!profile.empty()) {
+        ReportProfile();
+    }
+}
 
 void MacroEngine::AddCode(u32 method, u32 data) {
     uploaded_macro_code[method].push_back(data);
@@ -71,59 +78,110 @@ void MacroEngine::ClearCode(u32 method) {
 void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
     auto compiled_macro = macro_cache.find(method);
     if (compiled_macro != macro_cache.end()) {
-        const auto& cache_info = compiled_macro->second;
-        if (cache_info.has_hle_program) {
-            MICROPROFILE_SCOPE(MacroHLE);
-            cache_info.hle_program->Execute(parameters, method);
-        } else {
-            maxwell3d.RefreshParameters();
-            cache_info.lle_program->Execute(parameters, method);
-        }
-    } else {
-        // Macro not compiled, check if it's uploaded and if so, compile it
-        std::optional<u32> mid_method;
-        const auto macro_code = uploaded_macro_code.find(method);
-        if (macro_code == uploaded_macro_code.end()) {
-            for (const auto& [method_base, code] : uploaded_macro_code) {
-                if (method >= method_base && (method - method_base) < code.size()) {
-                    mid_method = method_base;
-                    break;
-                }
-            }
-            if (!mid_method.has_value()) {
-                ASSERT_MSG(false, "Macro 0x{0:x} was not uploaded", method);
-                return;
+        ExecuteCached(compiled_macro->second, method, parameters);
+        return;
+    }
+    // Macro not compiled, check if it's uploaded and if so, compile it
+    CacheInfo* const cache_info = CompileMacro(method);
+    if (!cache_info) {
+        return;
+    }
+    ExecuteCached(*cache_info, method, parameters);
+
+    if (Settings::values.dump_macros) {
+        Dump(cache_info->hash, uploaded_macro_code[method], cache_info->has_hle_program);
+    }
+}
+
+MacroEngine::CacheInfo* MacroEngine::CompileMacro(u32 method) {
+    std::optional<u32> mid_method;
+    const auto macro_code = uploaded_macro_code.find(method);
+    if (macro_code == uploaded_macro_code.end()) {
+        for (const auto& [method_base, code] : uploaded_macro_code) {
+            if (method >= method_base && (method - method_base) < code.size()) {
+                mid_method = method_base;
+                break;
             }
         }
-        auto& cache_info = macro_cache[method];
-
         if (!mid_method.has_value()) {
-            cache_info.lle_program = Compile(macro_code->second);
-            cache_info.hash = Common::HashValue(macro_code->second);
-        } else {
-            const auto& macro_cached = uploaded_macro_code[mid_method.value()];
-            const auto rebased_method = method - mid_method.value();
-            auto& code = uploaded_macro_code[method];
-            code.resize(macro_cached.size() - rebased_method);
-            std::memcpy(code.data(), macro_cached.data() + rebased_method,
-                        code.size() * sizeof(u32));
-            cache_info.hash = Common::HashValue(code);
-            cache_info.lle_program = Compile(code);
+            ASSERT_MSG(false, "Macro 0x{0:x} was not uploaded", method);
+            return nullptr;
         }
+    }
+    auto& cache_info = macro_cache[method];
+
+    if (mid_method.has_value()) {
+        const auto& macro_cached = uploaded_macro_code[mid_method.value()];
+        const auto rebased_method = method - mid_method.value();
+        auto& code = uploaded_macro_code[method];
+        code.resize(macro_cached.size() - rebased_method);
+        std::memcpy(code.data(), macro_cached.data() + rebased_method, code.size() * sizeof(u32));
+    }
+    const auto& code = uploaded_macro_code[method];
+    cache_info.hash = Common::HashValue(code);
+    cache_info.lle_program = Compile(code);
+
+    auto hle_program = hle_macros->GetHLEProgram(cache_info.hash);
+    if (hle_program && !Settings::values.disable_macro_hle) {
+        cache_info.has_hle_program = true;
+        cache_info.hle_program = std::move(hle_program);
+    } else if (Settings::values.memoize_macros && MacroTraceCache::IsPure(code)) {
+        cache_info.trace_cache = std::make_unique<MacroTraceCache>();
+    }
+    return &cache_info;
+}
+
+void MacroEngine::ExecuteCached(CacheInfo& cache_info, u32 method,
+                                const std::vector<u32>& parameters) {
+    const bool profiling = Settings::values.profile_macros.GetValue();
+    const auto start_time = profiling ? std::chrono::steady_clock::now()
+                                      : std::chrono::steady_clock::time_point{};
+
+    if (cache_info.has_hle_program) {
+        MICROPROFILE_SCOPE(MacroHLE);
+        cache_info.hle_program->Execute(parameters, method);
+    } else if (cache_info.trace_cache) {
+        maxwell3d.RefreshParameters();
+        cache_info.trace_cache->Execute(maxwell3d, *cache_info.lle_program, parameters, method);
+    } else {
+        maxwell3d.RefreshParameters();
+        cache_info.lle_program->Execute(parameters, method);
+    }
 
-        auto hle_program = hle_macros->GetHLEProgram(cache_info.hash);
-        if (!hle_program || Settings::values.disable_macro_hle) {
-            maxwell3d.RefreshParameters();
-            cache_info.lle_program->Execute(parameters, method);
-        } else {
-            cache_info.has_hle_program = true;
-            cache_info.hle_program = std::move(hle_program);
-            MICROPROFILE_SCOPE(MacroHLE);
-            cache_info.hle_program->Execute(parameters, method);
+    if (profiling) {
+        auto& entry = profile[cache_info.hash];
+        if (entry.invocations == 0) {
+            entry.code = uploaded_macro_code[method];
+            entry.has_hle_program = cache_info.has_hle_program;
         }
+        ++entry.invocations;
+        entry.time += std::chrono::steady_clock::now() - start_time;
+    }
+}
+
+void MacroEngine::ReportProfile() const {
+    static constexpr size_t MAX_REPORTED_MACROS = 16;
+
+    std::vector<std::pair<u64, const ProfileEntry*>> entries;
+    entries.reserve(profile.size());
+    for (const auto& [hash, entry] : profile) {
+        entries.emplace_back(hash, &entry);
+    }
+    std::ranges::sort(entries, [](const auto& lhs, const auto& rhs) {
+        return lhs.second->time > rhs.second->time;
+    });
+    if (entries.size() > MAX_REPORTED_MACROS) {
+        entries.resize(MAX_REPORTED_MACROS);
+    }
 
-        if (Settings::values.dump_macros) {
-            Dump(cache_info.hash, macro_code->second, cache_info.has_hle_program);
+    LOG_INFO(HW_GPU, "Macro profile, {} unique macros:", profile.size());
+    for (const auto& [hash, entry] : entries) {
+        const auto total_us = std::chrono::duration<double, std::micro>(entry->time).count();
+        LOG_INFO(HW_GPU, "  {:016x}: {} calls, {:.1f} us total, {:.2f} us per call{}", hash,
+                 entry->invocations, total_us, total_us / static_cast<double>(entry->invocations),
+                 entry->has_hle_program ? " (HLE)" : "");
+        if (!entry->has_hle_program) {
+            Dump(hash, entry->code);
         }
     }
 }
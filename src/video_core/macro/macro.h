@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -93,9 +94,18 @@ union MethodAddress {
     BitField<12, 6, u32> increment;
 };
 
+/// Method write issued by a macro
+struct MethodCall {
+    u32 method;
+    u32 argument;
+
+    bool operator==(const MethodCall&) const = default;
+};
+
 } // namespace Macro
 
 class HLEMacro;
+class MacroTraceCache;
 
 class CachedMacro {
 public:
@@ -130,11 +140,28 @@ private:
     struct CacheInfo {
         std::unique_ptr<CachedMacro> lle_program{};
         std::unique_ptr<CachedMacro> hle_program{};
+        std::unique_ptr<MacroTraceCache> trace_cache{};
         u64 hash{};
         bool has_hle_program{};
     };
 
+    struct ProfileEntry {
+        std::vector<u32> code;
+        u64 invocations{};
+        std::chrono::nanoseconds time{};
+        bool has_hle_program{};
+    };
+
+    /// Compiles the macro bound to method, returns nullptr when no code was uploaded for it
+    CacheInfo* CompileMacro(u32 method);
+
+    void ExecuteCached(CacheInfo& cache_info, u32 method, const std::vector<u32>& parameters);
+
+    /// Logs the macros that took the most time and dumps the hottest ones without HLE
+    void ReportProfile() const;
+
     std::unordered_map<u32, CacheInfo> macro_cache;
+    std::unordered_map<u64, ProfileEntry> profile;
     std::unordered_map<u32, std::vector<u32>> uploaded_macro_code;
     std::unique_ptr<HLEMacro> hle_macros;
     Engines::Maxwell3D& maxwell3d;
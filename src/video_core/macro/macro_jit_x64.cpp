@@ -173,13 +173,15 @@ void MacroJITx64Impl::Compile_ALU(Macro::Opcode opcode) {
             has_emitted = true;
         }
         if (!optimizer.can_skip_carry && has_emitted) {
-            setc(byte[STATE + offsetof(JITState, carry_flag)]);
+            // The carry of a subtraction is set when it doesn't borrow
+            setnc(byte[STATE + offsetof(JITState, carry_flag)]);
         }
         break;
     case Macro::ALUOperation::SubtractWithBorrow:
         bt(dword[STATE + offsetof(JITState, carry_flag)], 0);
+        cmc();
         sbb(src_a, src_b);
-        setc(byte[STATE + offsetof(JITState, carry_flag)]);
+        setnc(byte[STATE + offsetof(JITState, carry_flag)]);
         break;
     case Macro::ALUOperation::Xor:
         if (optimizer.zero_reg_skip) {
@@ -264,7 +266,7 @@ void MacroJITx64Impl::Compile_AddImmediate(Macro::Opcode opcode) {
         }
     } else {
         auto result = Compile_GetRegister(opcode.src_a, RESULT);
-        if (opcode.immediate > 2) {
+        if (opcode.immediate > 1) {
             add(result, opcode.immediate);
         } else if (opcode.immediate == 1) {
             inc(result);
@@ -320,7 +322,7 @@ void MacroJITx64Impl::Compile_Read(Macro::Opcode opcode) {
         }
     } else {
         auto result = Compile_GetRegister(opcode.src_a, RESULT);
-        if (opcode.immediate > 2) {
+        if (opcode.immediate > 1) {
             add(result, opcode.immediate);
         } else if (opcode.immediate == 1) {
             inc(result);
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+
+#include "common/cityhash.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro_trace_cache.h"
+
+namespace Tegra {
+
+bool MacroTraceCache::IsPure(std::span<const u32> code) {
+    return std::ranges::none_of(code, [](u32 raw) {
+        const Macro::Opcode opcode{.raw = raw};
+        return opcode.operation == Macro::Operation::Read;
+    });
+}
+
+void MacroTraceCache::Execute(Engines::Maxwell3D& maxwell3d, CachedMacro& program,
+                              const std::vector<u32>& parameters, u32 method) {
+    // Macros called from a macro being recorded are part of its trace
+    if (!enabled || maxwell3d.IsTracingMacro() || parameters.size() > MAX_PARAMETERS) {
+        program.Execute(parameters, method);
+        return;
+    }
+    ++lookups;
+
+    const u64 hash = Common::CityHash64(reinterpret_cast<const char*>(parameters.data()),
+                                        parameters.size() * sizeof(u32));
+    if (const auto it = entries.find(hash); it != entries.end()) {
+        if (it->second.parameters != parameters) {
+            program.Execute(parameters, method);
+            return;
+        }
+        ++hits;
+        for (const Macro::MethodCall& call : it->second.calls) {
+            maxwell3d.CallMethod(call.method, call.argument, true);
+        }
+        return;
+    }
+    if (lookups >= MIN_LOOKUPS && hits * 4 < lookups) {
+        Disable();
+        program.Execute(parameters, method);
+        return;
+    }
+
+    trace.clear();
+    maxwell3d.SetMacroTrace(&trace);
+    program.Execute(parameters, method);
+    maxwell3d.SetMacroTrace(nullptr);
+
+    const bool calls_macro = std::ranges::any_of(trace, [](const Macro::MethodCall& call) {
+        return call.method >= Engines::Maxwell3D::Regs::NUM_REGS;
+    });
+    if (calls_macro) {
+        Disable();
+        return;
+    }
+    if (trace.size() <= MAX_CALLS && entries.size() < MAX_ENTRIES) {
+        entries.emplace(hash, Entry{parameters, trace});
+    }
+}
+
+void MacroTraceCache::Disable() {
+    enabled = false;
+    entries.clear();
+    trace.clear();
+    trace.shrink_to_fit();
+}
+
+} // namespace Tegra
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/macro/macro.h"
+
+namespace Tegra {
+
+namespace Engines {
+class Maxwell3D;
+}
+
+/**
+ * Memoizes the methods sent by a macro that never reads GPU registers, keyed by its parameters.
+ * Later calls with the same parameters replay the recorded methods instead of running the macro.
+ * Macros that call other macros, or whose parameters rarely repeat, stop being memoized.
+ */
+class MacroTraceCache {
+public:
+    /// Returns true when the output of the macro only depends on its parameters
+    [[nodiscard]] static bool IsPure(std::span<const u32> code);
+
+    void Execute(Engines::Maxwell3D& maxwell3d, CachedMacro& program,
+                 const std::vector<u32>& parameters, u32 method);
+
+    [[nodiscard]] bool IsEnabled() const noexcept {
+        return enabled;
+    }
+
+    [[nodiscard]] u64 Hits() const noexcept {
+        return hits;
+    }
+
+private:
+    static constexpr size_t MAX_PARAMETERS = 64;
+    static constexpr size_t MAX_ENTRIES = 256;
+    static constexpr size_t MAX_CALLS = 1024;
+    /// Lookups after which memoization is dropped if fewer than a quarter of them hit
+    static constexpr u64 MIN_LOOKUPS = 1024;
+
+    struct Entry {
+        std::vector<u32> parameters;
+        std::vector<Macro::MethodCall> calls;
+    };
+
+    void Disable();
+
+    std::unordered_map<u64, Entry> entries;
+    std::vector<Macro::MethodCall> trace;
+    u64 lookups{};
+    u64 hits{};
+    bool enabled{true};
+};
+
+} // namespace Tegra
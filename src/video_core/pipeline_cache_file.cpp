@@ -0,0 +1,686 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "common/cityhash.h"
+#include "common/div_ceil.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/polyfill_ranges.h"
+#include "common/thread_worker.h"
+#include "common/zstd_compression.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/pipeline_cache_file.h"
+
+namespace VideoCommon {
+
+constexpr std::array<char, 8> LEGACY_MAGIC_NUMBER{'y', 'u', 'z', 'u', 'c', 'a', 'c', 'h'};
+
+constexpr std::array<char, 8> MAGIC_NUMBER{'y', 'u', 'z', 'u', 'p', 'c', 'a', 'c'};
+
+constexpr std::array<char, 8> USAGE_MAGIC_NUMBER{'y', 'u', 'z', 'u', 'u', 's', 'e', 's'};
+
+/// Number of pipelines from the start of the last session built strictly in first-use order
+constexpr u32 WARMUP_PIPELINES = 512;
+
+constexpr size_t PIPELINES_PER_DECODE_BATCH = 16;
+
+constexpr u32 MAX_PIPELINE_STAGES = Tegra::Engines::Maxwell3D::Regs::MaxShaderProgram;
+
+namespace {
+enum class ChunkType : u32 {
+    Code = 1,
+    Pipeline = 2,
+};
+
+struct FileHeader {
+    std::array<char, 8> magic_number;
+    u32 cache_version;
+    u32 format_version;
+};
+static_assert(sizeof(FileHeader) == 16);
+
+struct ChunkHeader {
+    ChunkType type;
+    u32 size;      ///< Size of the compressed payload following the header
+    u64 hash;      ///< Hash of the shader code or of the pipeline key
+    u64 checksum;  ///< Hash of the compressed payload
+};
+static_assert(sizeof(ChunkHeader) == 24);
+
+struct Chunk {
+    ChunkHeader header;
+    std::span<const char> payload;
+};
+
+/// Shader code chunk, decompressed on first use by whichever decoder needs it
+struct CodeChunk {
+    std::span<const char> payload;
+    std::once_flag decompressed;
+    std::vector<u8> code;
+};
+
+struct PipelineEntry {
+    std::span<const char> payload;
+    u64 rank;
+};
+
+struct DecodedPipeline {
+    std::vector<u8> record;
+    std::span<const char> key;
+    std::vector<FileEnvironment> envs;
+};
+
+/// Shader stage ready to be written, its environment serialized without the code
+struct PipelineStage {
+    std::span<const char> code;
+    std::vector<char> env;
+};
+
+/// Legacy records stored each environment with its code inline, followed by the raw key
+struct LegacyPipeline {
+    std::vector<std::span<const char>> envs;
+    std::span<const char> key;
+};
+} // Anonymous namespace
+
+static std::span<const char> AsChars(std::span<const u8> data) {
+    return std::span(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+static std::vector<u8> Decompress(std::span<const char> payload) {
+    return Common::Compression::DecompressDataZSTD(
+        std::span(reinterpret_cast<const u8*>(payload.data()), payload.size()));
+}
+
+static u64 HashCode(std::span<const char> code) {
+    return Common::CityHash64(code.data(), code.size());
+}
+
+/// Reads a whole cache file into memory, returns std::nullopt when it does not exist.
+/// The file is not mapped, as Load truncates torn tails while the records are still in use.
+static std::optional<std::vector<char>> ReadCacheFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    file.exceptions(std::ifstream::failbit);
+    std::vector<char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(data.data(), data.size());
+    return data;
+}
+
+static void RemoveCacheFile(const std::filesystem::path& path) {
+    if (!Common::FS::RemoveFile(path)) {
+        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
+                  Common::FS::PathToUTF8String(path));
+    }
+}
+
+static void WriteFileHeader(std::ofstream& file, u32 cache_version) {
+    const FileHeader header{
+        .magic_number = MAGIC_NUMBER,
+        .cache_version = cache_version,
+        .format_version = PipelineCacheFile::FORMAT_VERSION,
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+static void WriteChunk(std::ofstream& file, const ChunkHeader& header,
+                       std::span<const char> payload) {
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header))
+        .write(payload.data(), payload.size());
+}
+
+static void WriteChunk(std::ofstream& file, ChunkType type, u64 hash, std::span<const char> data) {
+    const std::vector<u8> compressed{Common::Compression::CompressDataZSTDDefault(
+        reinterpret_cast<const u8*>(data.data()), data.size())};
+    if (compressed.empty()) {
+        throw std::ios_base::failure("Failed to compress pipeline cache chunk");
+    }
+    const std::span<const char> payload{AsChars(compressed)};
+    const ChunkHeader header{
+        .type = type,
+        .size = static_cast<u32>(payload.size()),
+        .hash = hash,
+        .checksum = Common::CityHash64(payload.data(), payload.size()),
+    };
+    WriteChunk(file, header, payload);
+}
+
+/// Writes the code chunks a pipeline needs that are not stored yet, then the pipeline itself.
+/// Hashes of the written code are appended to new_code and not inserted into stored_code, so
+/// the caller can discard them if the write fails.
+static void WritePipeline(std::ofstream& file, std::span<const char> key, u64 key_hash,
+                          std::span<const PipelineStage> stages,
+                          const std::unordered_set<u64>& stored_code, std::vector<u64>& new_code) {
+    std::vector<char> record;
+    PipelineCacheWriter writer{record};
+    writer.Write(static_cast<u32>(stages.size()));
+    for (const PipelineStage& stage : stages) {
+        const u64 code_hash{HashCode(stage.code)};
+        const bool is_stored{stored_code.contains(code_hash) ||
+                             std::ranges::find(new_code, code_hash) != new_code.end()};
+        if (!is_stored) {
+            WriteChunk(file, ChunkType::Code, code_hash, stage.code);
+            new_code.push_back(code_hash);
+        }
+        writer.Write(code_hash).Write(static_cast<u64>(stage.env.size())).WriteBytes(stage.env);
+    }
+    writer.WriteBytes(key);
+    WriteChunk(file, ChunkType::Pipeline, key_hash, record);
+}
+
+/// Walks the chunks of a container, returns the offset where the valid chunks end
+static size_t ReadChunks(std::span<const char> data, std::vector<Chunk>& chunks) {
+    size_t offset{sizeof(FileHeader)};
+    while (offset + sizeof(ChunkHeader) <= data.size()) {
+        ChunkHeader header;
+        std::memcpy(&header, data.data() + offset, sizeof(header));
+        const size_t payload_offset{offset + sizeof(header)};
+        if (header.size > data.size() - payload_offset) {
+            break;
+        }
+        if (header.type != ChunkType::Code && header.type != ChunkType::Pipeline) {
+            break;
+        }
+        const std::span<const char> payload{data.subspan(payload_offset, header.size)};
+        if (Common::CityHash64(payload.data(), payload.size()) != header.checksum) {
+            break;
+        }
+        chunks.push_back(Chunk{header, payload});
+        offset = payload_offset + header.size;
+    }
+    return offset;
+}
+
+/// Returns the code hashes a pipeline record refers to
+static std::vector<u64> ReadPipelineCode(std::span<const u8> record) {
+    PipelineCacheReader reader{AsChars(record)};
+    u32 num_envs{};
+    reader.Read(num_envs);
+    if (num_envs == 0 || num_envs > MAX_PIPELINE_STAGES) {
+        throw std::ios_base::failure("Invalid number of pipeline cache stages");
+    }
+    std::vector<u64> code_hashes(num_envs);
+    for (u64& code_hash : code_hashes) {
+        u64 env_size{};
+        reader.Read(code_hash).Read(env_size).Skip(env_size, 1);
+    }
+    return code_hashes;
+}
+
+static std::optional<DecodedPipeline> DecodePipeline(
+    std::span<const char> payload, std::unordered_map<u64, CodeChunk>& code_chunks) try {
+    DecodedPipeline pipeline{.record = Decompress(payload), .key = {}, .envs = {}};
+    PipelineCacheReader reader{AsChars(pipeline.record)};
+    u32 num_envs{};
+    reader.Read(num_envs);
+    if (num_envs == 0 || num_envs > MAX_PIPELINE_STAGES) {
+        throw std::ios_base::failure("Invalid number of pipeline cache stages");
+    }
+    pipeline.envs.resize(num_envs);
+    for (FileEnvironment& env : pipeline.envs) {
+        u64 code_hash{};
+        u64 env_size{};
+        reader.Read(code_hash).Read(env_size);
+        const std::span<const char> env_data{reader.Take(env_size)};
+        const auto it{code_chunks.find(code_hash)};
+        if (it == code_chunks.end()) {
+            throw std::ios_base::failure("Pipeline cache record refers to missing code");
+        }
+        CodeChunk& code_chunk{it->second};
+        std::call_once(code_chunk.decompressed,
+                       [&code_chunk] { code_chunk.code = Decompress(code_chunk.payload); });
+        if (env.Deserialize(env_data, AsChars(code_chunk.code)) != env_data.size()) {
+            throw std::ios_base::failure("Pipeline cache environment size mismatch");
+        }
+    }
+    pipeline.key = reader.Remaining();
+    return pipeline;
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "Skipping pipeline cache record: {}", e.what());
+    return std::nullopt;
+}
+
+/// Splits the records of a legacy cache, a corrupt record ends the list
+static std::vector<LegacyPipeline> ReadLegacyPipelines(std::span<const char> data,
+                                                       size_t compute_key_size,
+                                                       size_t graphics_key_size) {
+    std::vector<LegacyPipeline> pipelines;
+    try {
+        PipelineCacheReader reader{data.subspan(LEGACY_MAGIC_NUMBER.size() + sizeof(u32))};
+        while (!reader.AtEnd()) {
+            u32 num_envs{};
+            reader.Read(num_envs);
+            if (num_envs == 0 || num_envs > MAX_PIPELINE_STAGES) {
+                throw std::ios_base::failure("Invalid number of pipeline cache stages");
+            }
+            LegacyPipeline pipeline;
+            Shader::Stage first_stage{};
+            for (u32 i = 0; i < num_envs; ++i) {
+                const auto layout{FileEnvironment::ParseSerialized(reader.Remaining())};
+                if (i == 0) {
+                    first_stage = layout.stage;
+                }
+                pipeline.envs.push_back(reader.Take(layout.size));
+            }
+            const bool is_compute{first_stage == Shader::Stage::Compute};
+            pipeline.key = reader.Take(is_compute ? compute_key_size : graphics_key_size);
+            pipelines.push_back(std::move(pipeline));
+        }
+    } catch (const std::ios_base::failure& e) {
+        LOG_ERROR(Common_Filesystem, "Legacy pipeline cache is truncated: {}", e.what());
+    }
+    return pipelines;
+}
+
+/// Splits a legacy environment into its code and the environment serialized without code
+static PipelineStage SplitLegacyEnvironment(std::span<const char> env) {
+    const auto layout{FileEnvironment::ParseSerialized(env)};
+    const size_t code_end{layout.code_offset + layout.code_size};
+    PipelineStage stage{.code = env.subspan(layout.code_offset, layout.code_size), .env = {}};
+    stage.env.reserve(layout.size - layout.code_size);
+    stage.env.insert(stage.env.end(), env.begin(), env.begin() + layout.code_offset);
+    stage.env.insert(stage.env.end(), env.begin() + code_end, env.begin() + layout.size);
+    return stage;
+}
+
+void PipelineUsage::RecordHash(u64 key_hash) {
+    const auto [it, is_new]{
+        entries.try_emplace(key_hash, Entry{static_cast<u32>(entries.size()), 0})};
+    if (it->second.hits != std::numeric_limits<u32>::max()) {
+        ++it->second.hits;
+    }
+}
+
+u64 PipelineUsage::Rank(u64 key_hash) const {
+    const auto it{entries.find(key_hash)};
+    if (it == entries.end()) {
+        // Pipelines unused in the last session keep their place at the end of the file
+        return std::numeric_limits<u64>::max();
+    }
+    const Entry& entry{it->second};
+    if (entry.first_use < WARMUP_PIPELINES) {
+        return entry.first_use;
+    }
+    // After the boot window, build the pipelines that were looked up most often first
+    return (u64{1} << 32) + (std::numeric_limits<u32>::max() - entry.hits);
+}
+
+void PipelineUsage::Load(const std::filesystem::path& filename, u32 expected_cache_version) try {
+    entries.clear();
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return;
+    }
+    file.exceptions(std::ifstream::failbit);
+
+    std::array<char, 8> magic_number;
+    u32 cache_version;
+    u64 num_entries;
+    file.read(magic_number.data(), magic_number.size())
+        .read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version))
+        .read(reinterpret_cast<char*>(&num_entries), sizeof(num_entries));
+    if (magic_number != USAGE_MAGIC_NUMBER || cache_version != expected_cache_version) {
+        return;
+    }
+    for (u64 i = 0; i < num_entries; ++i) {
+        u64 key_hash;
+        Entry entry;
+        file.read(reinterpret_cast<char*>(&key_hash), sizeof(key_hash))
+            .read(reinterpret_cast<char*>(&entry.first_use), sizeof(entry.first_use))
+            .read(reinterpret_cast<char*>(&entry.hits), sizeof(entry.hits));
+        entries.emplace(key_hash, entry);
+    }
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "Failed to load pipeline usage file: {}", e.what());
+    entries.clear();
+}
+
+void PipelineUsage::Save(const std::filesystem::path& filename, u32 cache_version) const try {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR(Common_Filesystem, "Failed to open pipeline usage file {}",
+                  Common::FS::PathToUTF8String(filename));
+        return;
+    }
+    file.exceptions(std::ifstream::failbit);
+    const u64 num_entries{static_cast<u64>(entries.size())};
+    file.write(USAGE_MAGIC_NUMBER.data(), USAGE_MAGIC_NUMBER.size())
+        .write(reinterpret_cast<const char*>(&cache_version), sizeof(cache_version))
+        .write(reinterpret_cast<const char*>(&num_entries), sizeof(num_entries));
+    for (const auto& [key_hash, entry] : entries) {
+        file.write(reinterpret_cast<const char*>(&key_hash), sizeof(key_hash))
+            .write(reinterpret_cast<const char*>(&entry.first_use), sizeof(entry.first_use))
+            .write(reinterpret_cast<const char*>(&entry.hits), sizeof(entry.hits));
+    }
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "Failed to save pipeline usage file: {}", e.what());
+}
+
+u64 PipelineUsage::HashKey(std::span<const char> key) {
+    return Common::CityHash64(key.data(), key.size());
+}
+
+void PipelineCacheFile::Load(
+    std::stop_token stop_loading, const std::filesystem::path& cache_filename,
+    u32 expected_cache_version, const PipelineUsage& usage, size_t compute_key_size,
+    size_t graphics_key_size,
+    Common::UniqueFunction<void, std::span<const char>, FileEnvironment> load_compute,
+    Common::UniqueFunction<void, std::span<const char>, std::vector<FileEnvironment>>
+        load_graphics) {
+    {
+        std::scoped_lock lock{mutex};
+        filename = cache_filename;
+        cache_version = expected_cache_version;
+        stored_code.clear();
+        stored_pipelines.clear();
+    }
+    std::optional<std::vector<char>> data;
+    try {
+        data = ReadCacheFile(cache_filename);
+    } catch (const std::ios_base::failure& e) {
+        LOG_ERROR(Common_Filesystem, "{}", e.what());
+        RemoveCacheFile(cache_filename);
+        return;
+    }
+    if (!data) {
+        return;
+    }
+    FileHeader header{};
+    std::memcpy(&header, data->data(), std::min(sizeof(header), data->size()));
+    const bool is_legacy{data->size() >= LEGACY_MAGIC_NUMBER.size() + sizeof(u32) &&
+                         header.magic_number == LEGACY_MAGIC_NUMBER};
+    if (is_legacy && header.cache_version == expected_cache_version) {
+        // The format version field overlaps the first legacy record, only the cache version
+        // is meaningful here
+        LOG_INFO(Common_Filesystem, "Converting pipeline cache to the indexed format");
+        std::filesystem::path converted{cache_filename};
+        converted += ".tmp";
+        std::error_code ec;
+        const bool is_converted{
+            Compact(cache_filename, converted, compute_key_size, graphics_key_size)};
+        if (is_converted) {
+            std::filesystem::rename(converted, cache_filename, ec);
+        }
+        if (!is_converted || ec) {
+            LOG_ERROR(Common_Filesystem, "Failed to convert pipeline cache");
+            Common::FS::RemoveFile(converted);
+            RemoveCacheFile(cache_filename);
+            return;
+        }
+        try {
+            data = ReadCacheFile(cache_filename);
+        } catch (const std::ios_base::failure& e) {
+            LOG_ERROR(Common_Filesystem, "{}", e.what());
+            data.reset();
+        }
+        if (!data || data->size() < sizeof(header)) {
+            RemoveCacheFile(cache_filename);
+            return;
+        }
+        std::memcpy(&header, data->data(), sizeof(header));
+    }
+    // A torn header write can leave a valid magic and version in a file too short for the header
+    const bool is_truncated{data->size() < sizeof(header)};
+    if (is_truncated || header.magic_number != MAGIC_NUMBER ||
+        header.cache_version != expected_cache_version || header.format_version != FORMAT_VERSION) {
+        if (Common::FS::RemoveFile(cache_filename)) {
+            if ((is_truncated || header.magic_number != MAGIC_NUMBER) && !is_legacy) {
+                LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
+            } else {
+                LOG_INFO(Common_Filesystem, "Deleting old pipeline cache");
+            }
+        } else {
+            LOG_ERROR(Common_Filesystem,
+                      "Invalid pipeline cache file and failed to delete it in \"{}\"",
+                      Common::FS::PathToUTF8String(cache_filename));
+        }
+        return;
+    }
+
+    std::vector<Chunk> chunks;
+    const size_t valid_size{ReadChunks(*data, chunks)};
+    if (valid_size != data->size()) {
+        // Drop the torn tail so new pipelines are appended after the last valid chunk
+        LOG_WARNING(Common_Filesystem, "Truncating pipeline cache from {} to {} bytes",
+                    data->size(), valid_size);
+        std::error_code ec;
+        std::filesystem::resize_file(cache_filename, valid_size, ec);
+        if (ec) {
+            LOG_ERROR(Common_Filesystem, "Failed to truncate pipeline cache: {}", ec.message());
+            RemoveCacheFile(cache_filename);
+            return;
+        }
+    }
+
+    // Index the chunks by hash without decompressing them
+    std::unordered_map<u64, CodeChunk> code_chunks;
+    std::vector<PipelineEntry> pipelines;
+    {
+        std::scoped_lock lock{mutex};
+        for (const Chunk& chunk : chunks) {
+            if (chunk.header.type == ChunkType::Code) {
+                if (stored_code.insert(chunk.header.hash).second) {
+                    code_chunks[chunk.header.hash].payload = chunk.payload;
+                }
+            } else if (stored_pipelines.insert(chunk.header.hash).second) {
+                pipelines.push_back(PipelineEntry{
+                    .payload = chunk.payload,
+                    .rank = usage.Rank(chunk.header.hash),
+                });
+            }
+        }
+    }
+    if (!usage.Empty()) {
+        std::ranges::stable_sort(pipelines, {}, &PipelineEntry::rank);
+    }
+
+    // Decode pipelines in parallel, hand them out in warm-up order as batches complete
+    const size_t num_batches{Common::DivCeil(pipelines.size(), PIPELINES_PER_DECODE_BATCH)};
+    std::vector<std::optional<DecodedPipeline>> decoded(pipelines.size());
+    const auto batch_ready{std::make_unique<std::atomic_bool[]>(num_batches)};
+    {
+        const u32 num_decoders{std::clamp(std::thread::hardware_concurrency() / 4, 1U, 4U)};
+        Common::ThreadWorker decoders(num_decoders, "PipelineDecoder");
+        for (size_t batch = 0; batch < num_batches; ++batch) {
+            decoders.QueueWork([&, batch] {
+                const size_t begin{batch * PIPELINES_PER_DECODE_BATCH};
+                const size_t end{std::min(begin + PIPELINES_PER_DECODE_BATCH, pipelines.size())};
+                for (size_t index = begin; index < end && !stop_loading.stop_requested();
+                     ++index) {
+                    decoded[index] = DecodePipeline(pipelines[index].payload, code_chunks);
+                }
+                batch_ready[batch].store(true, std::memory_order_release);
+                batch_ready[batch].notify_one();
+            });
+        }
+        for (size_t batch = 0; batch < num_batches; ++batch) {
+            batch_ready[batch].wait(false, std::memory_order_acquire);
+            const size_t begin{batch * PIPELINES_PER_DECODE_BATCH};
+            const size_t end{std::min(begin + PIPELINES_PER_DECODE_BATCH, pipelines.size())};
+            for (size_t index = begin; index < end; ++index) {
+                if (stop_loading.stop_requested()) {
+                    return;
+                }
+                if (!decoded[index]) {
+                    continue;
+                }
+                DecodedPipeline& pipeline{*decoded[index]};
+                const bool is_compute{pipeline.envs.front().ShaderStage() ==
+                                      Shader::Stage::Compute};
+                if (pipeline.key.size() != (is_compute ? compute_key_size : graphics_key_size)) {
+                    LOG_ERROR(Common_Filesystem, "Skipping pipeline cache record with bad key");
+                    continue;
+                }
+                if (is_compute) {
+                    load_compute(std::span{pipeline.key}, std::move(pipeline.envs.front()));
+                } else {
+                    load_graphics(std::span{pipeline.key}, std::move(pipeline.envs));
+                }
+                decoded[index].reset();
+            }
+        }
+    }
+}
+
+void PipelineCacheFile::Append(std::span<const char> key,
+                               std::span<const GenericEnvironment* const> envs) {
+    if (!std::ranges::all_of(envs, &GenericEnvironment::CanBeSerialized)) {
+        return;
+    }
+    std::vector<PipelineStage> stages;
+    stages.reserve(envs.size());
+    for (const GenericEnvironment* const env : envs) {
+        PipelineStage& stage{stages.emplace_back()};
+        stage.code = env->CachedCode();
+        env->Serialize(stage.env);
+    }
+    const u64 key_hash{PipelineUsage::HashKey(key)};
+
+    std::scoped_lock lock{mutex};
+    if (filename.empty() || stored_pipelines.contains(key_hash)) {
+        return;
+    }
+    std::vector<u64> new_code;
+    std::streamoff previous_size{};
+    try {
+        std::ofstream file(filename, std::ios::binary | std::ios::ate | std::ios::app);
+        if (!file.is_open()) {
+            LOG_ERROR(Common_Filesystem, "Failed to open pipeline cache file {}",
+                      Common::FS::PathToUTF8String(filename));
+            return;
+        }
+        file.exceptions(std::ifstream::failbit);
+        previous_size = file.tellp();
+        if (previous_size == 0) {
+            WriteFileHeader(file, cache_version);
+        }
+        WritePipeline(file, key, key_hash, stages, stored_code, new_code);
+        file.flush();
+    } catch (const std::ios_base::failure& e) {
+        LOG_ERROR(Common_Filesystem, "{}", e.what());
+        // Drop the partial write so later appends do not land after a torn chunk
+        std::error_code ec;
+        std::filesystem::resize_file(filename, static_cast<std::uintmax_t>(previous_size), ec);
+        return;
+    }
+    stored_code.insert(new_code.begin(), new_code.end());
+    stored_pipelines.insert(key_hash);
+}
+
+bool PipelineCacheFile::Compact(const std::filesystem::path& input,
+                                const std::filesystem::path& output, size_t compute_key_size,
+                                size_t graphics_key_size) try {
+    const std::optional<std::vector<char>> data{ReadCacheFile(input)};
+    if (!data) {
+        LOG_ERROR(Common_Filesystem, "Failed to open pipeline cache file {}",
+                  Common::FS::PathToUTF8String(input));
+        return false;
+    }
+    FileHeader header{};
+    std::memcpy(&header, data->data(), std::min(sizeof(header), data->size()));
+    const bool is_legacy{data->size() >= LEGACY_MAGIC_NUMBER.size() + sizeof(u32) &&
+                         header.magic_number == LEGACY_MAGIC_NUMBER};
+    if (!is_legacy && (header.magic_number != MAGIC_NUMBER ||
+                       header.format_version != FORMAT_VERSION || data->size() < sizeof(header))) {
+        LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file {}",
+                  Common::FS::PathToUTF8String(input));
+        return false;
+    }
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR(Common_Filesystem, "Failed to open pipeline cache file {}",
+                  Common::FS::PathToUTF8String(output));
+        return false;
+    }
+    file.exceptions(std::ifstream::failbit);
+    WriteFileHeader(file, header.cache_version);
+
+    std::unordered_set<u64> written_code;
+    std::unordered_set<u64> written_pipelines;
+    size_t num_dropped{};
+    if (is_legacy) {
+        const auto legacy_pipelines{
+            ReadLegacyPipelines(*data, compute_key_size, graphics_key_size)};
+        for (const LegacyPipeline& pipeline : legacy_pipelines) {
+            const u64 key_hash{PipelineUsage::HashKey(pipeline.key)};
+            if (!written_pipelines.insert(key_hash).second) {
+                ++num_dropped;
+                continue;
+            }
+            std::vector<PipelineStage> stages;
+            for (const std::span<const char> env : pipeline.envs) {
+                stages.push_back(SplitLegacyEnvironment(env));
+            }
+            std::vector<u64> new_code;
+            WritePipeline(file, pipeline.key, key_hash, stages, written_code, new_code);
+            written_code.insert(new_code.begin(), new_code.end());
+        }
+    } else {
+        std::vector<Chunk> chunks;
+        const size_t valid_size{ReadChunks(*data, chunks)};
+        if (valid_size != data->size()) {
+            LOG_WARNING(Common_Filesystem, "Dropping {} bytes of torn pipeline cache data",
+                        data->size() - valid_size);
+        }
+        std::unordered_map<u64, const Chunk*> code_chunks;
+        for (const Chunk& chunk : chunks) {
+            if (chunk.header.type == ChunkType::Code) {
+                code_chunks.emplace(chunk.header.hash, &chunk);
+            }
+        }
+        // Copy chunks as they are, each code chunk right before the first pipeline using it
+        for (const Chunk& chunk : chunks) {
+            if (chunk.header.type != ChunkType::Pipeline) {
+                continue;
+            }
+            if (written_pipelines.contains(chunk.header.hash)) {
+                ++num_dropped;
+                continue;
+            }
+            std::vector<u64> code_hashes;
+            try {
+                code_hashes = ReadPipelineCode(Decompress(chunk.payload));
+            } catch (const std::ios_base::failure&) {
+                ++num_dropped;
+                continue;
+            }
+            if (!std::ranges::all_of(code_hashes, [&](u64 hash) {
+                    return code_chunks.contains(hash);
+                })) {
+                ++num_dropped;
+                continue;
+            }
+            for (const u64 code_hash : code_hashes) {
+                if (written_code.insert(code_hash).second) {
+                    const Chunk& code_chunk{*code_chunks.at(code_hash)};
+                    WriteChunk(file, code_chunk.header, code_chunk.payload);
+                }
+            }
+            WriteChunk(file, chunk.header, chunk.payload);
+            written_pipelines.insert(chunk.header.hash);
+        }
+    }
+    LOG_INFO(Common_Filesystem, "Compacted pipeline cache: {} pipelines, {} shaders, {} dropped",
+             written_pipelines.size(), written_code.size(), num_dropped);
+    return true;
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "Failed to compact pipeline cache: {}", e.what());
+    return false;
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstring>
+#include <filesystem>
+#include <ios>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "common/unique_function.h"
+#include "video_core/shader_environment.h"
+
+namespace VideoCommon {
+
+/// Bounds checked reader over an in-memory pipeline cache, throws std::ios_base::failure when
+/// reading past the end of the buffer
+class PipelineCacheReader {
+public:
+    explicit PipelineCacheReader(std::span<const char> data_) : data{data_} {}
+
+    template <typename T>
+    PipelineCacheReader& Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::memcpy(&value, Take(sizeof(value)).data(), sizeof(value));
+        return *this;
+    }
+
+    PipelineCacheReader& Skip(u64 count, size_t element_size) {
+        if (count > (data.size() - offset) / element_size) {
+            throw std::ios_base::failure("Unexpected end of pipeline cache");
+        }
+        offset += static_cast<size_t>(count) * element_size;
+        return *this;
+    }
+
+    std::span<const char> Take(u64 size) {
+        Skip(size, 1);
+        return data.subspan(offset - static_cast<size_t>(size), static_cast<size_t>(size));
+    }
+
+    [[nodiscard]] std::span<const char> Remaining() const noexcept {
+        return data.subspan(offset);
+    }
+
+    [[nodiscard]] size_t Offset() const noexcept {
+        return offset;
+    }
+
+    [[nodiscard]] bool AtEnd() const noexcept {
+        return offset == data.size();
+    }
+
+private:
+    std::span<const char> data;
+    size_t offset{};
+};
+
+/// Appends trivially copyable values to an in-memory pipeline cache record
+class PipelineCacheWriter {
+public:
+    explicit PipelineCacheWriter(std::vector<char>& out_) : out{out_} {}
+
+    template <typename T>
+    PipelineCacheWriter& Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return WriteBytes(std::span(reinterpret_cast<const char*>(&value), sizeof(value)));
+    }
+
+    PipelineCacheWriter& WriteBytes(std::span<const char> bytes) {
+        out.insert(out.end(), bytes.begin(), bytes.end());
+        return *this;
+    }
+
+private:
+    std::vector<char>& out;
+};
+
+/// Records the order in which pipelines are first bound and how many times they are switched to,
+/// so the next boot can build the pipelines needed for the first frames before the rest of the
+/// cache. Caches only record lookups that change the bound pipeline, not every draw or dispatch.
+class PipelineUsage {
+public:
+    template <typename Key>
+    void Record(const Key& key) {
+        static_assert(std::is_trivially_copyable_v<Key>);
+        RecordHash(HashKey(std::span(reinterpret_cast<const char*>(&key), sizeof(key))));
+    }
+
+    void RecordHash(u64 key_hash);
+
+    /// Returns the warm-up rank of a pipeline, lower ranks are built first
+    [[nodiscard]] u64 Rank(u64 key_hash) const;
+
+    [[nodiscard]] bool Empty() const noexcept {
+        return entries.empty();
+    }
+
+    void Load(const std::filesystem::path& filename, u32 expected_cache_version);
+
+    void Save(const std::filesystem::path& filename, u32 cache_version) const;
+
+    [[nodiscard]] static u64 HashKey(std::span<const char> key);
+
+private:
+    struct Entry {
+        u32 first_use;
+        u32 hits;
+    };
+
+    std::unordered_map<u64, Entry> entries;
+};
+
+/**
+ * Transferable pipeline cache stored as a sequence of checksummed, zstd compressed chunks.
+ *
+ * Shader code is stored once per unique program in its own chunk and pipeline records refer to
+ * it by hash, so pipelines sharing stages do not duplicate their code. Every chunk header carries
+ * the hash of its code or pipeline key, which indexes the file without decompressing it. Chunks
+ * are only ever appended, and a torn write at the end of the file is truncated on the next load.
+ */
+class PipelineCacheFile {
+public:
+    /// Container format revision, independent from the backend cache version
+    static constexpr u32 FORMAT_VERSION = 1;
+
+    /**
+     * Loads the pipelines in a cache file and remembers it for later appends.
+     * Caches in the legacy flat format are converted in place first.
+     */
+    void Load(std::stop_token stop_loading, const std::filesystem::path& cache_filename,
+              u32 expected_cache_version, const PipelineUsage& usage, size_t compute_key_size,
+              size_t graphics_key_size,
+              Common::UniqueFunction<void, std::span<const char>, FileEnvironment> load_compute,
+              Common::UniqueFunction<void, std::span<const char>, std::vector<FileEnvironment>>
+                  load_graphics);
+
+    template <typename ComputeKey, typename GraphicsKey>
+    void Load(std::stop_token stop_loading, const std::filesystem::path& cache_filename,
+              u32 expected_cache_version, const PipelineUsage& usage,
+              Common::UniqueFunction<void, const ComputeKey&, FileEnvironment> load_compute,
+              Common::UniqueFunction<void, const GraphicsKey&, std::vector<FileEnvironment>>
+                  load_graphics) {
+        static_assert(std::is_trivially_copyable_v<ComputeKey>);
+        static_assert(std::is_trivially_copyable_v<GraphicsKey>);
+        Load(
+            stop_loading, cache_filename, expected_cache_version, usage, sizeof(ComputeKey),
+            sizeof(GraphicsKey),
+            [&load_compute](std::span<const char> key_data, FileEnvironment env) {
+                ComputeKey key;
+                std::memcpy(&key, key_data.data(), sizeof(key));
+                load_compute(key, std::move(env));
+            },
+            [&load_graphics](std::span<const char> key_data, std::vector<FileEnvironment> envs) {
+                GraphicsKey key;
+                std::memcpy(&key, key_data.data(), sizeof(key));
+                load_graphics(key, std::move(envs));
+            });
+    }
+
+    /// Appends a pipeline to the cache, writing only the shader code it does not hold yet
+    void Append(std::span<const char> key, std::span<const GenericEnvironment* const> envs);
+
+    template <typename Key, typename Envs>
+    void Append(const Key& key, const Envs& envs) {
+        static_assert(std::is_trivially_copyable_v<Key>);
+        static_assert(std::has_unique_object_representations_v<Key>);
+        Append(std::span(reinterpret_cast<const char*>(&key), sizeof(key)),
+               std::span(envs.data(), envs.size()));
+    }
+
+    /**
+     * Rewrites a cache keeping only its valid chunks, dropping duplicated pipelines and code no
+     * pipeline refers to. Legacy caches are converted, which needs the backend key sizes to find
+     * their record boundaries.
+     *
+     * @returns true on success
+     */
+    static bool Compact(const std::filesystem::path& input, const std::filesystem::path& output,
+                        size_t compute_key_size, size_t graphics_key_size);
+
+private:
+    std::mutex mutex;
+    std::filesystem::path filename;
+    u32 cache_version{};
+    std::unordered_set<u64> stored_code;
+    std::unordered_set<u64> stored_pipelines;
+};
+
+} // namespace VideoCommon
@@ -47,8 +47,6 @@ using VideoCommon::ComputeEnvironment;
 using VideoCommon::FileEnvironment;
 using VideoCommon::GenericEnvironment;
 using VideoCommon::GraphicsEnvironment;
-using VideoCommon::LoadPipelines;
-using VideoCommon::SerializePipeline;
 using Context = ShaderContext::Context;
 
 constexpr u32 CACHE_VERSION = 10;
@@ -247,13 +245,18 @@ ShaderCache::ShaderCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
           .min_ssbo_alignment = static_cast<u32>(device.GetShaderStorageBufferAlignment()),
           .support_geometry_shader_passthrough = device.HasGeometryShaderPassthrough(),
           .support_conditional_barrier = device.SupportsConditionalBarriers(),
-      } {
+      },
+      serialization_thread(1, "GLPipelineSerialization") {
     if (use_asynchronous_shaders) {
         workers = CreateWorkers();
     }
 }
 
-ShaderCache::~ShaderCache() = default;
+ShaderCache::~ShaderCache() {
+    if (!pipeline_usage_filename.empty()) {
+        pipeline_usage.Save(pipeline_usage_filename, CACHE_VERSION);
+    }
+}
 
 void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                                     const VideoCore::DiskResourceLoadCallback& callback) {
@@ -267,6 +270,10 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         return;
     }
     shader_cache_filename = base_dir / "opengl.bin";
+    pipeline_usage_filename = base_dir / "opengl_usage.bin";
+
+    VideoCommon::PipelineUsage previous_usage;
+    previous_usage.Load(pipeline_usage_filename, CACHE_VERSION);
 
     if (!workers && !strict_context_required) {
         workers = CreateWorkers();
@@ -290,9 +297,7 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
             workers->QueueWork(std::move(work));
         }
     }};
-    const auto load_compute{[&](std::ifstream& file, FileEnvironment env) {
-        ComputePipelineKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+    const auto load_compute{[&](const ComputePipelineKey& key, FileEnvironment env) {
         queue_work([this, key, env_ = std::move(env), &state, &callback](Context* ctx) mutable {
             ctx->pools.ReleaseContents();
             auto pipeline{CreateComputePipeline(ctx->pools, key, env_, true)};
@@ -307,9 +312,8 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         });
         ++state.total;
     }};
-    const auto load_graphics{[&](std::ifstream& file, std::vector<FileEnvironment> envs) {
-        GraphicsPipelineKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+    const auto load_graphics{[&](const GraphicsPipelineKey& key,
+                                 std::vector<FileEnvironment> envs) {
         queue_work([this, key, envs_ = std::move(envs), &state, &callback](Context* ctx) mutable {
             boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
             for (auto& env : envs_) {
@@ -328,7 +332,9 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         });
         ++state.total;
     }};
-    LoadPipelines(stop_loading, shader_cache_filename, CACHE_VERSION, load_compute, load_graphics);
+    pipeline_cache_file.Load<ComputePipelineKey, GraphicsPipelineKey>(
+        stop_loading, shader_cache_filename, CACHE_VERSION, previous_usage, load_compute,
+        load_graphics);
 
     LOG_INFO(Render_OpenGL, "Total Pipeline Count: {}", state.total);
 
@@ -380,6 +386,7 @@ GraphicsPipeline* ShaderCache::CurrentGraphicsPipelineSlowPath() {
     if (!pipeline) {
         return nullptr;
     }
+    pipeline_usage.Record(graphics_key);
     current_pipeline = pipeline.get();
     return BuiltPipeline(current_pipeline);
 }
@@ -419,10 +426,14 @@ ComputePipeline* ShaderCache::CurrentComputePipeline() {
     };
     const auto [pair, is_new]{compute_cache.try_emplace(key)};
     auto& pipeline{pair->second};
-    if (!is_new) {
-        return pipeline.get();
+    if (is_new) {
+        pipeline = CreateComputePipeline(key, shader);
+    }
+    if (pipeline && pipeline.get() != current_compute_pipeline) {
+        // Like graphics pipelines, usage is recorded when the bound pipeline changes
+        pipeline_usage.Record(key);
+        current_compute_pipeline = pipeline.get();
     }
-    pipeline = CreateComputePipeline(key, shader);
     return pipeline.get();
 }
 
@@ -436,13 +447,16 @@ std::unique_ptr<GraphicsPipeline> ShaderCache::CreateGraphicsPipeline() {
     if (!pipeline || shader_cache_filename.empty()) {
         return pipeline;
     }
-    boost::container::static_vector<const GenericEnvironment*, Maxwell::MaxShaderProgram> env_ptrs;
-    for (size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
-        if (graphics_key.unique_hashes[index] != 0) {
-            env_ptrs.push_back(&environments.envs[index]);
+    serialization_thread.QueueWork([this, key = graphics_key, envs = std::move(environments.envs)] {
+        boost::container::static_vector<const GenericEnvironment*, Maxwell::MaxShaderProgram>
+            env_ptrs;
+        for (size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+            if (key.unique_hashes[index] != 0) {
+                env_ptrs.push_back(&envs[index]);
+            }
         }
-    }
-    SerializePipeline(graphics_key, env_ptrs, shader_cache_filename, CACHE_VERSION);
+        pipeline_cache_file.Append(key, env_ptrs);
+    });
     return pipeline;
 }
 
@@ -564,8 +578,9 @@ std::unique_ptr<ComputePipeline> ShaderCache::CreateComputePipeline(
     if (!pipeline || shader_cache_filename.empty()) {
         return pipeline;
     }
-    SerializePipeline(key, std::array<const GenericEnvironment*, 1>{&env}, shader_cache_filename,
-                      CACHE_VERSION);
+    serialization_thread.QueueWork([this, key, env_ = std::move(env)] {
+        pipeline_cache_file.Append(key, std::array<const GenericEnvironment*, 1>{&env_});
+    });
     return pipeline;
 }
 
@@ -13,6 +13,7 @@
 #include "video_core/renderer_opengl/gl_compute_pipeline.h"
 #include "video_core/renderer_opengl/gl_graphics_pipeline.h"
 #include "video_core/renderer_opengl/gl_shader_context.h"
+#include "video_core/pipeline_cache_file.h"
 #include "video_core/shader_cache.h"
 
 namespace Tegra {
@@ -76,6 +77,7 @@ private:
 
     GraphicsPipelineKey graphics_key{};
     GraphicsPipeline* current_pipeline{};
+    ComputePipeline* current_compute_pipeline{};
 
     ShaderContext::ShaderPools main_pools;
     std::unordered_map<GraphicsPipelineKey, std::unique_ptr<GraphicsPipeline>> graphics_cache;
@@ -85,7 +87,11 @@ private:
     Shader::HostTranslateInfo host_info;
 
     std::filesystem::path shader_cache_filename;
+    VideoCommon::PipelineCacheFile pipeline_cache_file;
+    std::filesystem::path pipeline_usage_filename;
+    VideoCommon::PipelineUsage pipeline_usage;
     std::unique_ptr<ShaderWorker> workers;
+    Common::ThreadWorker serialization_thread;
 };
 
 } // namespace OpenGL
@@ -26,6 +26,7 @@
 #include "video_core/renderer_vulkan/vk_compute_pipeline.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_texture_cache.h"
+#include "video_core/pipeline_cache_file.h"
 #include "video_core/shader_cache.h"
 
 namespace Core {
@@ -153,6 +154,7 @@ private:
 
     GraphicsPipelineCacheKey graphics_key{};
     GraphicsPipeline* current_pipeline{};
+    ComputePipeline* current_compute_pipeline{};
 
     std::unordered_map<ComputePipelineCacheKey, std::unique_ptr<ComputePipeline>> compute_cache;
     std::unordered_map<GraphicsPipelineCacheKey, std::unique_ptr<GraphicsPipeline>> graphics_cache;
@@ -163,6 +165,10 @@ private:
     Shader::HostTranslateInfo host_info;
 
     std::filesystem::path pipeline_cache_filename;
+    VideoCommon::PipelineCacheFile pipeline_cache_file;
+
+    std::filesystem::path pipeline_usage_filename;
+    VideoCommon::PipelineUsage pipeline_usage;
 
     std::filesystem::path vulkan_pipeline_cache_filename;
     vk::PipelineCache vulkan_pipeline_cache;
@@ -2,8 +2,10 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <ios>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -19,14 +21,13 @@
 #include "shader_recompiler/environment.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/memory_manager.h"
+#include "video_core/pipeline_cache_file.h"
 #include "video_core/shader_environment.h"
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/textures/texture.h"
 
 namespace VideoCommon {
 
-constexpr std::array<char, 8> MAGIC_NUMBER{'y', 'u', 'z', 'u', 'c', 'a', 'c', 'h'};
-
 constexpr size_t INST_SIZE = sizeof(u64);
 
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
@@ -193,57 +194,52 @@ void GenericEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
     DumpImpl(pipeline_hash, shader_hash, code, read_highest, read_lowest, initial_offset, stage);
 }
 
-void GenericEnvironment::Serialize(std::ofstream& file) const {
+void GenericEnvironment::Serialize(std::vector<char>& out) const {
     const u64 code_size{static_cast<u64>(CachedSizeBytes())};
     const u64 num_texture_types{static_cast<u64>(texture_types.size())};
     const u64 num_texture_pixel_formats{static_cast<u64>(texture_pixel_formats.size())};
     const u64 num_cbuf_values{static_cast<u64>(cbuf_values.size())};
     const u64 num_cbuf_replacement_values{static_cast<u64>(cbuf_replacements.size())};
 
-    file.write(reinterpret_cast<const char*>(&code_size), sizeof(code_size))
-        .write(reinterpret_cast<const char*>(&num_texture_types), sizeof(num_texture_types))
-        .write(reinterpret_cast<const char*>(&num_texture_pixel_formats),
-               sizeof(num_texture_pixel_formats))
-        .write(reinterpret_cast<const char*>(&num_cbuf_values), sizeof(num_cbuf_values))
-        .write(reinterpret_cast<const char*>(&num_cbuf_replacement_values),
-               sizeof(num_cbuf_replacement_values))
-        .write(reinterpret_cast<const char*>(&local_memory_size), sizeof(local_memory_size))
-        .write(reinterpret_cast<const char*>(&texture_bound), sizeof(texture_bound))
-        .write(reinterpret_cast<const char*>(&start_address), sizeof(start_address))
-        .write(reinterpret_cast<const char*>(&cached_lowest), sizeof(cached_lowest))
-        .write(reinterpret_cast<const char*>(&cached_highest), sizeof(cached_highest))
-        .write(reinterpret_cast<const char*>(&viewport_transform_state),
-               sizeof(viewport_transform_state))
-        .write(reinterpret_cast<const char*>(&stage), sizeof(stage))
-        .write(reinterpret_cast<const char*>(code.data()), code_size);
+    PipelineCacheWriter writer{out};
+    writer.Write(code_size)
+        .Write(num_texture_types)
+        .Write(num_texture_pixel_formats)
+        .Write(num_cbuf_values)
+        .Write(num_cbuf_replacement_values)
+        .Write(local_memory_size)
+        .Write(texture_bound)
+        .Write(start_address)
+        .Write(cached_lowest)
+        .Write(cached_highest)
+        .Write(viewport_transform_state)
+        .Write(stage);
     for (const auto& [key, type] : texture_types) {
-        file.write(reinterpret_cast<const char*>(&key), sizeof(key))
-            .write(reinterpret_cast<const char*>(&type), sizeof(type));
+        writer.Write(key).Write(type);
     }
     for (const auto& [key, format] : texture_pixel_formats) {
-        file.write(reinterpret_cast<const char*>(&key), sizeof(key))
-            .write(reinterpret_cast<const char*>(&format), sizeof(format));
+        writer.Write(key).Write(format);
     }
     for (const auto& [key, type] : cbuf_values) {
-        file.write(reinterpret_cast<const char*>(&key), sizeof(key))
-            .write(reinterpret_cast<const char*>(&type), sizeof(type));
+        writer.Write(key).Write(type);
     }
     for (const auto& [key, type] : cbuf_replacements) {
-        file.write(reinterpret_cast<const char*>(&key), sizeof(key))
-            .write(reinterpret_cast<const char*>(&type), sizeof(type));
+        writer.Write(key).Write(type);
     }
     if (stage == Shader::Stage::Compute) {
-        file.write(reinterpret_cast<const char*>(&workgroup_size), sizeof(workgroup_size))
-            .write(reinterpret_cast<const char*>(&shared_memory_size), sizeof(shared_memory_size));
+        writer.Write(workgroup_size).Write(shared_memory_size);
     } else {
-        file.write(reinterpret_cast<const char*>(&sph), sizeof(sph));
+        writer.Write(sph);
         if (stage == Shader::Stage::Geometry) {
-            file.write(reinterpret_cast<const char*>(&gp_passthrough_mask),
-                       sizeof(gp_passthrough_mask));
+            writer.Write(gp_passthrough_mask);
         }
     }
 }
 
+std::span<const char> GenericEnvironment::CachedCode() const noexcept {
+    return std::span(reinterpret_cast<const char*>(code.data()), CachedSizeBytes());
+}
+
 std::optional<u64> GenericEnvironment::TryFindSize() {
     static constexpr size_t BLOCK_SIZE = 0x1000;
     static constexpr size_t MAXIMUM_SIZE = 0x100000;
@@ -448,68 +444,105 @@ u32 ComputeEnvironment::ReadViewportTransformState() {
     return viewport_transform_state;
 }
 
-void FileEnvironment::Deserialize(std::ifstream& file) {
+size_t FileEnvironment::Deserialize(std::span<const char> data, std::span<const char> shared_code) {
+    PipelineCacheReader reader{data};
     u64 code_size{};
     u64 num_texture_types{};
     u64 num_texture_pixel_formats{};
     u64 num_cbuf_values{};
     u64 num_cbuf_replacement_values{};
-    file.read(reinterpret_cast<char*>(&code_size), sizeof(code_size))
-        .read(reinterpret_cast<char*>(&num_texture_types), sizeof(num_texture_types))
-        .read(reinterpret_cast<char*>(&num_texture_pixel_formats),
-              sizeof(num_texture_pixel_formats))
-        .read(reinterpret_cast<char*>(&num_cbuf_values), sizeof(num_cbuf_values))
-        .read(reinterpret_cast<char*>(&num_cbuf_replacement_values),
-              sizeof(num_cbuf_replacement_values))
-        .read(reinterpret_cast<char*>(&local_memory_size), sizeof(local_memory_size))
-        .read(reinterpret_cast<char*>(&texture_bound), sizeof(texture_bound))
-        .read(reinterpret_cast<char*>(&start_address), sizeof(start_address))
-        .read(reinterpret_cast<char*>(&read_lowest), sizeof(read_lowest))
-        .read(reinterpret_cast<char*>(&read_highest), sizeof(read_highest))
-        .read(reinterpret_cast<char*>(&viewport_transform_state), sizeof(viewport_transform_state))
-        .read(reinterpret_cast<char*>(&stage), sizeof(stage));
+    reader.Read(code_size)
+        .Read(num_texture_types)
+        .Read(num_texture_pixel_formats)
+        .Read(num_cbuf_values)
+        .Read(num_cbuf_replacement_values)
+        .Read(local_memory_size)
+        .Read(texture_bound)
+        .Read(start_address)
+        .Read(read_lowest)
+        .Read(read_highest)
+        .Read(viewport_transform_state)
+        .Read(stage);
+    if (shared_code.size() != code_size) {
+        throw std::ios_base::failure("Pipeline cache code size mismatch");
+    }
     code.resize(Common::DivCeil(code_size, sizeof(u64)));
-    file.read(reinterpret_cast<char*>(code.data()), code_size);
+    std::memcpy(code.data(), shared_code.data(), shared_code.size());
+    texture_types.reserve(num_texture_types);
     for (size_t i = 0; i < num_texture_types; ++i) {
         u32 key;
         Shader::TextureType type;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&type), sizeof(type));
+        reader.Read(key).Read(type);
         texture_types.emplace(key, type);
     }
+    texture_pixel_formats.reserve(num_texture_pixel_formats);
     for (size_t i = 0; i < num_texture_pixel_formats; ++i) {
         u32 key;
         Shader::TexturePixelFormat format;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&format), sizeof(format));
+        reader.Read(key).Read(format);
         texture_pixel_formats.emplace(key, format);
     }
+    cbuf_values.reserve(num_cbuf_values);
     for (size_t i = 0; i < num_cbuf_values; ++i) {
         u64 key;
         u32 value;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&value), sizeof(value));
+        reader.Read(key).Read(value);
         cbuf_values.emplace(key, value);
     }
+    cbuf_replacements.reserve(num_cbuf_replacement_values);
     for (size_t i = 0; i < num_cbuf_replacement_values; ++i) {
         u64 key;
         Shader::ReplaceConstant value;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&value), sizeof(value));
+        reader.Read(key).Read(value);
         cbuf_replacements.emplace(key, value);
     }
     if (stage == Shader::Stage::Compute) {
-        file.read(reinterpret_cast<char*>(&workgroup_size), sizeof(workgroup_size))
-            .read(reinterpret_cast<char*>(&shared_memory_size), sizeof(shared_memory_size));
+        reader.Read(workgroup_size).Read(shared_memory_size);
         initial_offset = 0;
     } else {
-        file.read(reinterpret_cast<char*>(&sph), sizeof(sph));
+        reader.Read(sph);
         initial_offset = sizeof(sph);
         if (stage == Shader::Stage::Geometry) {
-            file.read(reinterpret_cast<char*>(&gp_passthrough_mask), sizeof(gp_passthrough_mask));
+            reader.Read(gp_passthrough_mask);
         }
     }
     is_proprietary_driver = texture_bound == 2;
+    return reader.Offset();
+}
+
+FileEnvironment::SerializedLayout FileEnvironment::ParseSerialized(std::span<const char> data) {
+    PipelineCacheReader reader{data};
+    u64 code_size{};
+    u64 num_texture_types{};
+    u64 num_texture_pixel_formats{};
+    u64 num_cbuf_values{};
+    u64 num_cbuf_replacement_values{};
+    SerializedLayout layout{};
+    reader.Read(code_size)
+        .Read(num_texture_types)
+        .Read(num_texture_pixel_formats)
+        .Read(num_cbuf_values)
+        .Read(num_cbuf_replacement_values)
+        .Skip(1, sizeof(local_memory_size) + sizeof(texture_bound) + sizeof(start_address) +
+                     sizeof(read_lowest) + sizeof(read_highest) +
+                     sizeof(viewport_transform_state))
+        .Read(layout.stage);
+    layout.code_offset = reader.Offset();
+    layout.code_size = reader.Take(code_size).size();
+    reader.Skip(num_texture_types, sizeof(u32) + sizeof(Shader::TextureType))
+        .Skip(num_texture_pixel_formats, sizeof(u32) + sizeof(Shader::TexturePixelFormat))
+        .Skip(num_cbuf_values, sizeof(u64) + sizeof(u32))
+        .Skip(num_cbuf_replacement_values, sizeof(u64) + sizeof(Shader::ReplaceConstant));
+    if (layout.stage == Shader::Stage::Compute) {
+        reader.Skip(1, sizeof(workgroup_size) + sizeof(shared_memory_size));
+    } else {
+        reader.Skip(1, sizeof(sph));
+        if (layout.stage == Shader::Stage::Geometry) {
+            reader.Skip(1, sizeof(gp_passthrough_mask));
+        }
+    }
+    layout.size = reader.Offset();
+    return layout;
 }
 
 void FileEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
@@ -582,93 +615,4 @@ std::optional<Shader::ReplaceConstant> FileEnvironment::GetReplaceConstBuffer(u3
     return it->second;
 }
 
-void SerializePipeline(std::span<const char> key, std::span<const GenericEnvironment* const> envs,
-                       const std::filesystem::path& filename, u32 cache_version) try {
-    std::ofstream file(filename, std::ios::binary | std::ios::ate | std::ios::app);
-    file.exceptions(std::ifstream::failbit);
-    if (!file.is_open()) {
-        LOG_ERROR(Common_Filesystem, "Failed to open pipeline cache file {}",
-                  Common::FS::PathToUTF8String(filename));
-        return;
-    }
-    if (file.tellp() == 0) {
-        // Write header
-        file.write(MAGIC_NUMBER.data(), MAGIC_NUMBER.size())
-            .write(reinterpret_cast<const char*>(&cache_version), sizeof(cache_version));
-    }
-    if (!std::ranges::all_of(envs, &GenericEnvironment::CanBeSerialized)) {
-        return;
-    }
-    const u32 num_envs{static_cast<u32>(envs.size())};
-    file.write(reinterpret_cast<const char*>(&num_envs), sizeof(num_envs));
-    for (const GenericEnvironment* const env : envs) {
-        env->Serialize(file);
-    }
-    file.write(key.data(), key.size_bytes());
-
-} catch (const std::ios_base::failure& e) {
-    LOG_ERROR(Common_Filesystem, "{}", e.what());
-    if (!Common::FS::RemoveFile(filename)) {
-        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
-                  Common::FS::PathToUTF8String(filename));
-    }
-}
-
-void LoadPipelines(
-    std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics) try {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-        return;
-    }
-    file.exceptions(std::ifstream::failbit);
-    const auto end{file.tellg()};
-    file.seekg(0, std::ios::beg);
-
-    std::array<char, 8> magic_number;
-    u32 cache_version;
-    file.read(magic_number.data(), magic_number.size())
-        .read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version));
-    if (magic_number != MAGIC_NUMBER || cache_version != expected_cache_version) {
-        file.close();
-        if (Common::FS::RemoveFile(filename)) {
-            if (magic_number != MAGIC_NUMBER) {
-                LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
-            }
-            if (cache_version != expected_cache_version) {
-                LOG_INFO(Common_Filesystem, "Deleting old pipeline cache");
-            }
-        } else {
-            LOG_ERROR(Common_Filesystem,
-                      "Invalid pipeline cache file and failed to delete it in \"{}\"",
-                      Common::FS::PathToUTF8String(filename));
-        }
-        return;
-    }
-    while (file.tellg() != end) {
-        if (stop_loading.stop_requested()) {
-            return;
-        }
-        u32 num_envs{};
-        file.read(reinterpret_cast<char*>(&num_envs), sizeof(num_envs));
-        std::vector<FileEnvironment> envs(num_envs);
-        for (FileEnvironment& env : envs) {
-            env.Deserialize(file);
-        }
-        if (envs.front().ShaderStage() == Shader::Stage::Compute) {
-            load_compute(file, std::move(envs.front()));
-        } else {
-            load_graphics(file, std::move(envs));
-        }
-    }
-
-} catch (const std::ios_base::failure& e) {
-    LOG_ERROR(Common_Filesystem, "{}", e.what());
-    if (!Common::FS::RemoveFile(filename)) {
-        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
-                  Common::FS::PathToUTF8String(filename));
-    }
-}
-
 } // namespace VideoCommon
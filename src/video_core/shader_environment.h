@@ -60,7 +60,10 @@ public:
 
     void Dump(u64 pipeline_hash, u64 shader_hash) override;
 
-    void Serialize(std::ofstream& file) const;
+    /// Appends the environment to a pipeline cache record, the code is stored separately
+    void Serialize(std::vector<char>& out) const;
+
+    [[nodiscard]] std::span<const char> CachedCode() const noexcept;
 
     bool HasHLEMacroState() const override {
         return has_hle_engine_state;
@@ -165,7 +168,20 @@ public:
     FileEnvironment& operator=(const FileEnvironment&) = delete;
     FileEnvironment(const FileEnvironment&) = delete;
 
-    void Deserialize(std::ifstream& file);
+    /// Layout of a serialized environment with its code stored inline
+    struct SerializedLayout {
+        size_t size;
+        size_t code_offset;
+        size_t code_size;
+        Shader::Stage stage;
+    };
+
+    /// Deserializes an environment whose code is stored separately, returns the bytes consumed
+    size_t Deserialize(std::span<const char> data, std::span<const char> shared_code);
+
+    /// Returns the layout of the serialized environment with inline code at the start of the
+    /// buffer without decoding it
+    [[nodiscard]] static SerializedLayout ParseSerialized(std::span<const char> data);
 
     [[nodiscard]] u64 ReadInstruction(u32 address) override;
 
@@ -212,21 +228,4 @@ private:
     u32 viewport_transform_state = 1;
 };
 
-void SerializePipeline(std::span<const char> key, std::span<const GenericEnvironment* const> envs,
-                       const std::filesystem::path& filename, u32 cache_version);
-
-template <typename Key, typename Envs>
-void SerializePipeline(const Key& key, const Envs& envs, const std::filesystem::path& filename,
-                       u32 cache_version) {
-    static_assert(std::is_trivially_copyable_v<Key>);
-    static_assert(std::has_unique_object_representations_v<Key>);
-    SerializePipeline(std::span(reinterpret_cast<const char*>(&key), sizeof(key)),
-                      std::span(envs.data(), envs.size()), filename, cache_version);
-}
-
-void LoadPipelines(
-    std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics);
-
 } // namespace VideoCommon
@@ -1619,35 +1619,40 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
 
     // Now that we have endpoints and weights, we can interpolate and generate
     // the proper decoding...
+    // Expand the endpoints once per block, so the per texel work is just the weighted blend.
+    u32 endpointLow[4][4];
+    u32 endpointHigh[4][4];
+    for (u32 partition = 0; partition < nPartitions; partition++) {
+        for (u32 c = 0; c < 4; c++) {
+            endpointLow[partition][c] = ReplicateByteTo16(endpoints[partition][0].Component(c));
+            endpointHigh[partition][c] = ReplicateByteTo16(endpoints[partition][1].Component(c));
+        }
+    }
+
+    // Components are stored as ARGB, while texels are packed as ABGR
+    static constexpr u32 componentShift[4] = {24, 0, 8, 16};
+    const u32 dualPlaneComponent = weightParams.m_bDualPlane ? ((planeIdx + 1) & 3) : 4;
+
     for (u32 j = 0; j < blockHeight; j++)
         for (u32 i = 0; i < blockWidth; i++) {
+            const u32 texel = j * blockWidth + i;
             u32 partition = Select2DPartition(partitionIndex, i, j, nPartitions,
                                               (blockHeight * blockWidth) < 32);
             assert(partition < nPartitions);
 
-            Pixel p;
+            u32 packed = 0;
             for (u32 c = 0; c < 4; c++) {
-                u32 C0 = endpoints[partition][0].Component(c);
-                C0 = ReplicateByteTo16(C0);
-                u32 C1 = endpoints[partition][1].Component(c);
-                C1 = ReplicateByteTo16(C1);
-
-                u32 plane = 0;
-                if (weightParams.m_bDualPlane && (((planeIdx + 1) & 3) == c)) {
-                    plane = 1;
-                }
-
-                u32 weight = weights[plane][j * blockWidth + i];
-                u32 C = (C0 * (64 - weight) + C1 * weight + 32) / 64;
-                if (C == 65535) {
-                    p.Component(c) = 255;
-                } else {
-                    double Cf = static_cast<double>(C);
-                    p.Component(c) = static_cast<u16>(255.0 * (Cf / 65536.0) + 0.5);
-                }
+                const u32 plane = c == dualPlaneComponent ? 1 : 0;
+                const u32 weight = weights[plane][texel];
+                const u32 C0 = endpointLow[partition][c];
+                const u32 C1 = endpointHigh[partition][c];
+                const u32 C = (C0 * (64 - weight) + C1 * weight + 32) / 64;
+
+                // Exact integer form of round(255 * C / 65536), which also maps 65535 to 255
+                packed |= ((C * 255 + 32768) >> 16) << componentShift[c];
             }
 
-            outBuf[j * blockWidth + i] = p.Pack();
+            outBuf[texel] = packed;
         }
 }
 
@@ -1656,26 +1661,34 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
     const u32 rows = Common::DivideUp(height, block_height);
     const u32 cols = Common::DivideUp(width, block_width);
 
+    // Split the surface in bands of block rows spanning every slice, sized so that narrow
+    // textures don't drown in queueing overhead and a single wait covers the whole surface.
+    static constexpr u32 MIN_BLOCKS_PER_TASK = 256;
+    const u32 total_rows = rows * depth;
+    const u32 rows_per_task = std::max(1U, MIN_BLOCKS_PER_TASK / std::max(cols, 1U));
+
     Common::ThreadWorker& workers{GetThreadWorkers()};
 
-    for (u32 z = 0; z < depth; ++z) {
-        const u32 depth_offset = z * height * width * 4;
-        for (u32 y_index = 0; y_index < rows; ++y_index) {
-            auto decompress_stride = [data, width, height, block_width, block_height, output, rows,
-                                      cols, z, depth_offset, y_index] {
+    for (u32 first_row = 0; first_row < total_rows; first_row += rows_per_task) {
+        const u32 last_row = std::min(first_row + rows_per_task, total_rows);
+        auto decompress_band = [data, width, height, block_width, block_height, output, rows,
+                                cols, first_row, last_row] {
+            // Blocks can be at most 12x12
+            std::array<u32, 12 * 12> uncompData;
+            for (u32 row = first_row; row < last_row; ++row) {
+                const u32 z = row / rows;
+                const u32 y_index = row % rows;
+                const u32 depth_offset = z * height * width * 4;
                 const u32 y = y_index * block_height;
+                const u32 decompHeight = std::min(block_height, height - y);
                 for (u32 x_index = 0; x_index < cols; ++x_index) {
-                    const u32 block_index = (z * rows * cols) + (y_index * cols) + x_index;
+                    const u32 block_index = row * cols + x_index;
                     const u32 x = x_index * block_width;
 
                     const std::span<const u8, 16> blockPtr{data.subspan(block_index * 16, 16)};
-
-                    // Blocks can be at most 12x12
-                    std::array<u32, 12 * 12> uncompData;
                     DecompressBlock(blockPtr, block_width, block_height, uncompData);
 
-                    u32 decompWidth = std::min(block_width, width - x);
-                    u32 decompHeight = std::min(block_height, height - y);
+                    const u32 decompWidth = std::min(block_width, width - x);
 
                     const std::span<u8> outRow = output.subspan(depth_offset + (y * width + x) * 4);
                     for (u32 h = 0; h < decompHeight; ++h) {
@@ -1683,11 +1696,11 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
                                     uncompData.data() + h * block_width, decompWidth * 4);
                     }
                 }
-            };
-            workers.QueueWork(std::move(decompress_stride));
-        }
-        workers.WaitForRequests();
+            }
+        };
+        workers.QueueWork(std::move(decompress_band));
     }
+    workers.WaitForRequests();
 }
 
 } // namespace Tegra::Texture::ASTC
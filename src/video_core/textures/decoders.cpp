@@ -2,10 +2,19 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <array>
+#include <bit>
 #include <cmath>
 #include <cstring>
 #include <span>
 
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
@@ -13,6 +22,16 @@
 #include "video_core/gpu.h"
 #include "video_core/textures/decoders.h"
 
+#if defined(ARCHITECTURE_x86_64)
+#include "common/x64/cpu_detect.h"
+#endif
+
+#if defined(ARCHITECTURE_x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
 namespace Tegra::Texture {
 namespace {
 template <u32 mask>
@@ -33,6 +52,167 @@ void incrpdep(u32& value) {
     value = ((value | ~mask) + swizzled_incr) & mask;
 }
 
+/**
+ * Copies an even line and the line below it across 'num_gobs' horizontally consecutive GOBs.
+ * Inside a GOB, each of these line pairs is stored as two contiguous 64 byte runs, 256 bytes
+ * apart, where 16 byte sectors of both lines are interleaved.
+ */
+using GobLinePairCopyFn = void (*)(u8* dst, const u8* src, u32 pitch, u32 num_gobs,
+                                   u32 gob_stride);
+
+template <bool TO_LINEAR>
+void CopyGobLinePair(u8* dst, const u8* src, u32 pitch, u32 num_gobs, u32 gob_stride) {
+    for (u32 gob = 0; gob < num_gobs; ++gob) {
+        for (u32 line = 0; line < 2; ++line) {
+            for (u32 sector = 0; sector < 4; ++sector) {
+                const u32 swizzled_offset =
+                    gob * gob_stride + line * 16 + (sector & 1) * 32 + (sector >> 1) * 256;
+                const u32 unswizzled_offset = line * pitch + gob * GOB_SIZE_X + sector * 16;
+                std::memcpy(&dst[TO_LINEAR ? swizzled_offset : unswizzled_offset],
+                            &src[TO_LINEAR ? unswizzled_offset : swizzled_offset], 16);
+            }
+        }
+    }
+}
+
+#if defined(ARCHITECTURE_x86_64)
+template <bool TO_LINEAR>
+TARGET_AVX2 void CopyGobLinePairAVX2(u8* dst, const u8* src, u32 pitch, u32 num_gobs,
+                                     u32 gob_stride) {
+    for (u32 gob = 0; gob < num_gobs; ++gob) {
+        for (u32 half = 0; half < 2; ++half) {
+            // swizzled_lo = [line0 sector0 | line1 sector0]
+            // swizzled_hi = [line0 sector1 | line1 sector1]
+            const u32 swizzled_offset = gob * gob_stride + half * 256;
+            const u32 unswizzled_offset = gob * GOB_SIZE_X + half * 32;
+            if constexpr (TO_LINEAR) {
+                const u8* const line0 = src + unswizzled_offset;
+                const u8* const line1 = line0 + pitch;
+                const __m256i row0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line0));
+                const __m256i row1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line1));
+                u8* const swizzled = dst + swizzled_offset;
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(swizzled),
+                                    _mm256_permute2x128_si256(row0, row1, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(swizzled + 32),
+                                    _mm256_permute2x128_si256(row0, row1, 0x31));
+            } else {
+                const u8* const swizzled = src + swizzled_offset;
+                const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(swizzled));
+                const __m256i hi =
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(swizzled + 32));
+                u8* const line0 = dst + unswizzled_offset;
+                u8* const line1 = line0 + pitch;
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(line0),
+                                    _mm256_permute2x128_si256(lo, hi, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(line1),
+                                    _mm256_permute2x128_si256(lo, hi, 0x31));
+            }
+        }
+    }
+}
+#endif
+
+template <bool TO_LINEAR>
+GobLinePairCopyFn GetGobLinePairCopy() {
+    // The generic path copies whole 16 byte sectors, which compilers lower to single SSE2 or
+    // NEON moves. AVX2 additionally lets us deinterleave two sectors with one lane permute.
+    static const GobLinePairCopyFn copy = [] {
+#if defined(ARCHITECTURE_x86_64)
+        if (Common::GetCPUCaps().avx2) {
+            return &CopyGobLinePairAVX2<TO_LINEAR>;
+        }
+#endif
+        return &CopyGobLinePair<TO_LINEAR>;
+    }();
+    return copy;
+}
+
+template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
+void SwizzleLinePixels(u8* output, const u8* input, u32 base_swizzled_offset, u32 swizzled_y,
+                       u32 x_shift, u32 origin_x, u32 unswizzled_line_offset, u32 column_begin,
+                       u32 column_end) {
+    u32 swizzled_x = pdep<SWIZZLE_X_BITS>((column_begin + origin_x) * BYTES_PER_PIXEL);
+    for (u32 column = column_begin; column < column_end;
+         ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
+        const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
+        const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
+
+        const u32 swizzled_offset = base_swizzled_offset + offset_x + (swizzled_x | swizzled_y);
+        const u32 unswizzled_offset = unswizzled_line_offset + column * BYTES_PER_PIXEL;
+
+        u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
+        const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
+
+        std::memcpy(dst, src, BYTES_PER_PIXEL);
+    }
+}
+
+/**
+ * Transforms 'num_lines' lines of 'extent_x' pixels of a single slice.
+ * Whole GOBs are copied a line pair at a time, only the unaligned edges are walked per pixel.
+ */
+template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
+void SwizzleLines(u8* output, const u8* input, u32 origin_x, u32 origin_y, u32 extent_x,
+                  u32 num_lines, u32 offset_z, u32 unswizzled_slice_offset, u32 pitch,
+                  u32 block_height, u32 block_size, u32 x_shift) {
+    const u32 block_height_mask = (1U << block_height) - 1;
+
+    // Pixels of non power of two sizes straddle GOB boundaries, keep them on the slow path
+    u32 first_gob = 0;
+    u32 num_gobs = 0;
+    u32 fast_begin = extent_x;
+    u32 fast_end = extent_x;
+    if constexpr (std::has_single_bit(BYTES_PER_PIXEL)) {
+        const u32 x_begin = origin_x * BYTES_PER_PIXEL;
+        const u32 x_end = (origin_x + extent_x) * BYTES_PER_PIXEL;
+        first_gob = Common::DivCeilLog2(x_begin, GOB_SIZE_X_SHIFT);
+        const u32 last_gob = x_end >> GOB_SIZE_X_SHIFT;
+        if (first_gob < last_gob) {
+            num_gobs = last_gob - first_gob;
+            fast_begin = (first_gob << GOB_SIZE_X_SHIFT) / BYTES_PER_PIXEL - origin_x;
+            fast_end = (last_gob << GOB_SIZE_X_SHIFT) / BYTES_PER_PIXEL - origin_x;
+        }
+    }
+    const GobLinePairCopyFn copy_line_pair = GetGobLinePairCopy<TO_LINEAR>();
+
+    u32 line = 0;
+    while (line < num_lines) {
+        const u32 y = line + origin_y;
+        const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
+        const u32 offset_y = (block_y >> block_height) * block_size +
+                             ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
+        const u32 base_swizzled_offset = offset_z + offset_y;
+        const u32 unswizzled_line_offset = unswizzled_slice_offset + line * pitch;
+
+        if (num_gobs == 0 || (y & 1) != 0 || line + 1 == num_lines) {
+            SwizzleLinePixels<TO_LINEAR, BYTES_PER_PIXEL>(
+                output, input, base_swizzled_offset, pdep<SWIZZLE_Y_BITS>(y), x_shift, origin_x,
+                unswizzled_line_offset, 0, extent_x);
+            ++line;
+            continue;
+        }
+
+        const u32 swizzled_offset =
+            base_swizzled_offset + (first_gob << x_shift) + pdep<SWIZZLE_Y_BITS>(y);
+        const u32 unswizzled_offset = unswizzled_line_offset + fast_begin * BYTES_PER_PIXEL;
+        copy_line_pair(&output[TO_LINEAR ? swizzled_offset : unswizzled_offset],
+                       &input[TO_LINEAR ? unswizzled_offset : swizzled_offset], pitch, num_gobs,
+                       1U << x_shift);
+
+        for (u32 pair_line = 0; pair_line < 2; ++pair_line) {
+            const u32 swizzled_y = pdep<SWIZZLE_Y_BITS>(y + pair_line);
+            const u32 line_offset = unswizzled_line_offset + pair_line * pitch;
+            SwizzleLinePixels<TO_LINEAR, BYTES_PER_PIXEL>(output, input, base_swizzled_offset,
+                                                          swizzled_y, x_shift, origin_x,
+                                                          line_offset, 0, fast_begin);
+            SwizzleLinePixels<TO_LINEAR, BYTES_PER_PIXEL>(output, input, base_swizzled_offset,
+                                                          swizzled_y, x_shift, origin_x,
+                                                          line_offset, fast_end, extent_x);
+        }
+        line += 2;
+    }
+}
+
 template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
 void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height, u32 depth,
                  u32 block_height, u32 block_depth, u32 stride) {
@@ -51,7 +231,6 @@ void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32
     const u32 slice_size =
         Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT) * block_size;
 
-    const u32 block_height_mask = (1U << block_height) - 1;
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
 
@@ -59,32 +238,9 @@ void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32
         const u32 z = slice + origin_z;
         const u32 offset_z = (z >> block_depth) * slice_size +
                              ((z & block_depth_mask) << (GOB_SIZE_SHIFT + block_height));
-        for (u32 line = 0; line < height; ++line) {
-            const u32 y = line + origin_y;
-            const u32 swizzled_y = pdep<SWIZZLE_Y_BITS>(y);
-
-            const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
-            const u32 offset_y = (block_y >> block_height) * block_size +
-                                 ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
-
-            u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
-            for (u32 column = 0; column < width;
-                 ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
-                const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
-
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * BYTES_PER_PIXEL;
-
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
-
-                std::memcpy(dst, src, BYTES_PER_PIXEL);
-            }
-        }
+        SwizzleLines<TO_LINEAR, BYTES_PER_PIXEL>(output.data(), input.data(), origin_x, origin_y,
+                                                 width, height, offset_z, slice * pitch * height,
+                                                 pitch, block_height, block_size, x_shift);
     }
 }
 
@@ -106,7 +262,6 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
     const u32 slice_size =
         Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT) * block_size;
 
-    const u32 block_height_mask = (1U << block_height) - 1;
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
 
@@ -118,32 +273,10 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
         const u32 offset_z = (z >> block_depth) * slice_size +
                              ((z & block_depth_mask) << (GOB_SIZE_SHIFT + block_height));
         const u32 lines_in_y = std::min(unprocessed_lines, extent_y);
-        for (u32 line = 0; line < lines_in_y; ++line) {
-            const u32 y = line + origin_y;
-            const u32 swizzled_y = pdep<SWIZZLE_Y_BITS>(y);
-
-            const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
-            const u32 offset_y = (block_y >> block_height) * block_size +
-                                 ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
-
-            u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
-            for (u32 column = 0; column < extent_x;
-                 ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
-                const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
-
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * BYTES_PER_PIXEL;
-
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
-
-                std::memcpy(dst, src, BYTES_PER_PIXEL);
-            }
-        }
+        SwizzleLines<TO_LINEAR, BYTES_PER_PIXEL>(output.data(), input.data(), origin_x, origin_y,
+                                                 extent_x, lines_in_y, offset_z,
+                                                 slice * pitch * height, pitch, block_height,
+                                                 block_size, x_shift);
         unprocessed_lines -= lines_in_y;
         if (unprocessed_lines == 0) {
             return;